@@ -9,6 +9,7 @@
 #include "Utils/CubismDebug.hpp"
 #include "Utils/CubismJson.hpp"
 #include "Id/CubismIdManager.hpp"
+#include "Model/CubismMocCache.hpp"
 #include "Rendering/CubismRenderer.hpp"
 
 #ifdef CSM_DEBUG_MEMORY_LEAKING
@@ -34,6 +35,7 @@ csmBool                           s_isInitialized = false;
 ICubismAllocator*                 s_allocator = NULL;
 const CubismFramework::Option*    s_option = NULL;
 CubismIdManager*                  s_cubismIdManager = NULL;
+CubismMocCache*                   s_cubismMocCache = NULL;
 
 }
 
@@ -100,6 +102,7 @@ void CubismFramework::CleanUp()
     s_allocator = NULL;
     s_option = NULL;
     s_cubismIdManager = NULL;
+    s_cubismMocCache = NULL;
 #ifdef CSM_DEBUG_MEMORY_LEAKING
     s_allocationList = NULL;
 #endif
@@ -137,6 +140,12 @@ void CubismFramework::Initialize()
 
     s_cubismIdManager = CSM_NEW CubismIdManager();
 
+    // 前回の Dispose() でモデルがまだ MOC を共有していた場合は、そのキャッシュを使い続ける
+    if (s_cubismMocCache == NULL)
+    {
+        s_cubismMocCache = CSM_NEW CubismMocCache();
+    }
+
     s_isInitialized = true;
 
     CubismLogInfo("CubismFramework::Initialize() is complete.");
@@ -164,6 +173,17 @@ void CubismFramework::Dispose()
 
     CSM_DELETE(s_cubismIdManager);
 
+    // 残っているモデルは破棄時にキャッシュへ MOC を返すため、参照がある間はキャッシュを破棄しない
+    if (s_cubismMocCache->GetMocCount() == 0)
+    {
+        CSM_DELETE(s_cubismMocCache);
+        s_cubismMocCache = NULL;
+    }
+    else
+    {
+        CubismLogWarning("CubismMocCache: %d MOC(s) are still referenced. The cache is kept until they are released.", s_cubismMocCache->GetMocCount());
+    }
+
     //レンダラの静的リソース（シェーダプログラム他）を解放する
     Rendering::CubismRenderer::StaticRelease();
 
@@ -218,6 +238,11 @@ CubismIdManager* CubismFramework::GetIdManager()
     return s_cubismIdManager;
 }
 
+CubismMocCache* CubismFramework::GetMocCache()
+{
+    return s_cubismMocCache;
+}
+
 #ifdef CSM_DEBUG_MEMORY_LEAKING
 
 void* CubismFramework::Allocate(csmSizeType size, const csmChar* fileName, csmInt32 lineNumber)
@@ -127,6 +127,7 @@ void CsmDelete(T* address)
 namespace Live2D { namespace Cubism { namespace Framework {
 
 class CubismIdManager;
+class CubismMocCache;
 
 }}}
 
@@ -314,6 +315,16 @@ public:
      */
     static CubismIdManager* GetIdManager();
 
+    /**
+     * Returns the instance of CubismMocCache.
+     *
+     * @note Model instances that load the same MOC file share it through this cache.<br>
+     *           ex) CubismUserModel::LoadSharedModel(key)
+     *
+     * @return Instance of CubismMocCache.
+     */
+    static CubismMocCache* GetMocCache();
+
 #ifdef CSM_DEBUG_MEMORY_LEAKING
 
     /**
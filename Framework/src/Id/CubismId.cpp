@@ -11,13 +11,16 @@
 namespace Live2D { namespace Cubism { namespace Framework {
 
 CubismId::CubismId()
+                        : _hash(0)
 { }
 
 CubismId::CubismId(const CubismId& c)
                         : _id(c._id)
+                        , _hash(c._hash)
 { }
 
-CubismId::CubismId(const csmChar* id)
+CubismId::CubismId(const csmChar* id, csmUint32 hash)
+                        : _hash(hash)
 {
     _id = id;
 }
@@ -30,6 +33,7 @@ CubismId& CubismId::operator=(const CubismId& c)
     if (this != &c)
     {
         _id = c._id;
+        _hash = c._hash;
     }
 
     return *this;
@@ -37,12 +41,12 @@ CubismId& CubismId::operator=(const CubismId& c)
 
 csmBool CubismId::operator==(const CubismId& c) const
 {
-    return (_id == c._id);
+    return (_hash == c._hash) && (_id == c._id);
 }
 
 csmBool CubismId::operator!=(const CubismId& c) const
 {
-    return !(_id == c._id);
+    return !(*this == c);
 }
 
 const csmString& CubismId::GetString() const
@@ -50,4 +54,9 @@ const csmString& CubismId::GetString() const
     return _id;
 }
 
+csmUint32 CubismId::GetHash() const
+{
+    return _hash;
+}
+
 }}}
@@ -54,16 +54,24 @@ struct CubismId
      */
     csmBool operator!=(const CubismId& c) const;
 
+    /**
+     * Returns the hash of the ID string computed at registration.
+     *
+     * @return Hash of the ID string
+     */
+    csmUint32 GetHash() const;
+
 private:
     CubismId();
 
-    CubismId(const csmChar* id);
+    CubismId(const csmChar* id, csmUint32 hash);
 
     ~CubismId();
 
     CubismId(const CubismId& c);
 
     csmString _id;
+    csmUint32 _hash;
 };
 
 typedef const CubismId* CubismIdHandle;
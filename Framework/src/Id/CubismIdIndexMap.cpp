@@ -0,0 +1,147 @@
+/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#include "CubismIdIndexMap.hpp"
+#include "CubismFramework.hpp"
+#include "Utils/CubismDebug.hpp"
+
+namespace Live2D { namespace Cubism { namespace Framework {
+
+namespace {
+const csmUint32 MinimumCapacity = 16;
+}
+
+CubismIdIndexMap::CubismIdIndexMap()
+    : _slots(NULL)
+    , _capacity(0)
+    , _size(0)
+{ }
+
+CubismIdIndexMap::~CubismIdIndexMap()
+{
+    Clear();
+}
+
+void CubismIdIndexMap::Reserve(csmInt32 count)
+{
+    // 負荷率を 1/2 以下に保つ
+    csmUint32 capacity = MinimumCapacity;
+    while (capacity < static_cast<csmUint32>(count) * 2)
+    {
+        capacity <<= 1;
+    }
+
+    if (capacity > _capacity)
+    {
+        Rehash(capacity);
+    }
+}
+
+void CubismIdIndexMap::Insert(CubismIdHandle id, csmInt32 index)
+{
+    CSM_ASSERT(id != NULL);
+
+    if (static_cast<csmUint32>(_size + 1) * 2 > _capacity)
+    {
+        Rehash(_capacity == 0 ? MinimumCapacity : _capacity << 1);
+    }
+
+    const csmUint32 mask = _capacity - 1;
+    for (csmUint32 i = Hash(id) & mask; ; i = (i + 1) & mask)
+    {
+        if (_slots[i].Id == id)
+        {
+            _slots[i].Index = index;
+            return;
+        }
+
+        if (_slots[i].Id == NULL)
+        {
+            _slots[i].Id = id;
+            _slots[i].Index = index;
+            ++_size;
+            return;
+        }
+    }
+}
+
+csmInt32 CubismIdIndexMap::Find(CubismIdHandle id) const
+{
+    if (_size == 0)
+    {
+        return -1;
+    }
+
+    const csmUint32 mask = _capacity - 1;
+    for (csmUint32 i = Hash(id) & mask; ; i = (i + 1) & mask)
+    {
+        if (_slots[i].Id == id)
+        {
+            return _slots[i].Index;
+        }
+
+        if (_slots[i].Id == NULL)
+        {
+            return -1;
+        }
+    }
+}
+
+csmInt32 CubismIdIndexMap::GetSize() const
+{
+    return _size;
+}
+
+void CubismIdIndexMap::Clear()
+{
+    if (_slots != NULL)
+    {
+        CSM_FREE(_slots);
+        _slots = NULL;
+    }
+
+    _capacity = 0;
+    _size = 0;
+}
+
+csmUint32 CubismIdIndexMap::Hash(CubismIdHandle id)
+{
+    // CubismId は少なくとも 8 バイト境界に配置されるため下位ビットを捨ててから混ぜる
+    const csmUint64 key = static_cast<csmUint64>(reinterpret_cast<csmSizeType>(id)) >> 3;
+    return static_cast<csmUint32>((key * 0x9E3779B97F4A7C15ULL) >> 32);
+}
+
+void CubismIdIndexMap::Rehash(csmUint32 capacity)
+{
+    Slot* oldSlots = _slots;
+    const csmUint32 oldCapacity = _capacity;
+
+    _slots = static_cast<Slot*>(CSM_MALLOC(sizeof(Slot) * capacity));
+    _capacity = capacity;
+    _size = 0;
+
+    for (csmUint32 i = 0; i < capacity; ++i)
+    {
+        _slots[i].Id = NULL;
+        _slots[i].Index = -1;
+    }
+
+    for (csmUint32 i = 0; i < oldCapacity; ++i)
+    {
+        if (oldSlots[i].Id != NULL)
+        {
+            Insert(oldSlots[i].Id, oldSlots[i].Index);
+        }
+    }
+
+    if (oldSlots != NULL)
+    {
+        CSM_FREE(oldSlots);
+    }
+}
+
+}}}
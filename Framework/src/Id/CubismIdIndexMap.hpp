@@ -0,0 +1,88 @@
+/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#pragma once
+
+#include "Type/CubismBasicType.hpp"
+#include "CubismId.hpp"
+
+namespace Live2D { namespace Cubism { namespace Framework {
+
+/**
+ * Open-addressed hash table that maps ID handles to indices.
+ *
+ * @note IDs are interned by CubismIdManager, so the handle address alone identifies an ID.
+ */
+class CubismIdIndexMap
+{
+public:
+    /**
+     * Constructor
+     */
+    CubismIdIndexMap();
+
+    /**
+     * Destructor
+     */
+    ~CubismIdIndexMap();
+
+    /**
+     * Reserves enough slots to hold the given number of IDs without rehashing.
+     *
+     * @param count Number of IDs
+     */
+    void Reserve(csmInt32 count);
+
+    /**
+     * Associates an index with an ID. An existing association is overwritten.
+     *
+     * @param id ID handle
+     * @param index Index to associate
+     */
+    void Insert(CubismIdHandle id, csmInt32 index);
+
+    /**
+     * Returns the index associated with an ID.
+     *
+     * @param id ID handle
+     *
+     * @return Associated index; -1 if the ID is not registered.
+     */
+    csmInt32 Find(CubismIdHandle id) const;
+
+    /**
+     * Returns the number of registered IDs.
+     *
+     * @return Number of registered IDs
+     */
+    csmInt32 GetSize() const;
+
+    /**
+     * Removes all entries and releases the slots.
+     */
+    void Clear();
+
+private:
+    CubismIdIndexMap(const CubismIdIndexMap&);
+    CubismIdIndexMap& operator=(const CubismIdIndexMap&);
+
+    struct Slot
+    {
+        CubismIdHandle Id;      ///< ID handle; NULL for an empty slot
+        csmInt32 Index;         ///< Associated index
+    };
+
+    static csmUint32 Hash(CubismIdHandle id);
+
+    void Rehash(csmUint32 capacity);
+
+    Slot* _slots;           ///< Slot array; the capacity is always a power of two
+    csmUint32 _capacity;    ///< Number of slots
+    csmInt32 _size;         ///< Number of registered IDs
+};
+
+}}}
@@ -10,11 +10,19 @@
 
 namespace Live2D { namespace Cubism { namespace Framework {
 
+namespace {
+const csmUint32 InitialTableCapacity = 256;
+}
+
 CubismIdManager::CubismIdManager()
+    : _table(CreateTable(InitialTableCapacity))
+    , _idCount(0)
 { }
 
 CubismIdManager::~CubismIdManager()
 {
+    DeleteTable(_table.load(std::memory_order_relaxed));
+
     for (csmUint32 i = 0; i < _ids.GetSize(); ++i)
     {
         CSM_DELETE_SELF(CubismId, _ids[i]);
@@ -56,18 +64,53 @@ csmBool CubismIdManager::IsExist(const csmChar* id) const
     return (FindId(id) != NULL);
 }
 
+csmUint32 CubismIdManager::GetIdCount() const
+{
+    return _idCount.load(std::memory_order_acquire);
+}
+
 const CubismId* CubismIdManager::RegisterId(const csmChar* id)
 {
+    const csmUint32 hash = HashId(id);
     CubismId* result = NULL;
 
-    if ((result = FindId(id)) != NULL)
+    // 登録済みならロックを取らずに返す
+    if ((result = FindId(id, hash)) != NULL)
+    {
+        return result;
+    }
+
+    std::lock_guard<std::mutex> lock(_registerMutex);
+
+    // ロック待ちの間に他スレッドが登録した可能性がある
+    if ((result = FindId(id, hash)) != NULL)
     {
         return result;
     }
 
-    result = CSM_NEW CubismId(id);
+    result = CSM_NEW CubismId(id, hash);
     _ids.PushBack(result);
 
+    IdTable* table = _table.load(std::memory_order_relaxed);
+
+    // 負荷率を 1/2 以下に保つ。古いテーブルは読み取り中のスレッドのために破棄しない
+    if ((_ids.GetSize() * 2) > table->Capacity)
+    {
+        IdTable* grown = CreateTable(table->Capacity * 2);
+        for (csmUint32 i = 0; i < _ids.GetSize(); ++i)
+        {
+            InsertToTable(grown, _ids[i]);
+        }
+        grown->Retired = table;
+        _table.store(grown, std::memory_order_release);
+    }
+    else
+    {
+        InsertToTable(table, result);
+    }
+
+    _idCount.store(_ids.GetSize(), std::memory_order_release);
+
     return result;
 }
 
@@ -78,15 +121,80 @@ const CubismId* CubismIdManager::RegisterId(const csmString& id)
 
 CubismId* CubismIdManager::FindId(const csmChar* id) const
 {
-    for (csmUint32 i = 0; i < _ids.GetSize(); ++i)
+    return FindId(id, HashId(id));
+}
+
+CubismId* CubismIdManager::FindId(const csmChar* id, csmUint32 hash) const
+{
+    const IdTable* table = _table.load(std::memory_order_acquire);
+    const csmUint32 mask = table->Capacity - 1;
+
+    for (csmUint32 i = hash & mask; ; i = (i + 1) & mask)
     {
-        if (_ids[i]->GetString() == id)
+        CubismId* candidate = table->Slots[i].load(std::memory_order_acquire);
+
+        if (candidate == NULL)
         {
-            return _ids[i];
+            return NULL;
         }
+
+        if (candidate->_hash == hash && candidate->GetString() == id)
+        {
+            return candidate;
+        }
+    }
+}
+
+csmUint32 CubismIdManager::HashId(const csmChar* id)
+{
+    // FNV-1a
+    csmUint32 hash = 2166136261u;
+    for (const csmUchar* p = reinterpret_cast<const csmUchar*>(id); *p != '\0'; ++p)
+    {
+        hash ^= *p;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+CubismIdManager::IdTable* CubismIdManager::CreateTable(csmUint32 capacity)
+{
+    IdTable* table = CSM_NEW IdTable();
+    table->Capacity = capacity;
+    table->Retired = NULL;
+    table->Slots = static_cast<std::atomic<CubismId*>*>(CSM_MALLOC(sizeof(std::atomic<CubismId*>) * capacity));
+
+    for (csmUint32 i = 0; i < capacity; ++i)
+    {
+        CSM_PLACEMENT_NEW(&table->Slots[i]) std::atomic<CubismId*>(NULL);
     }
 
-    return NULL;
+    return table;
+}
+
+void CubismIdManager::DeleteTable(IdTable* table)
+{
+    while (table != NULL)
+    {
+        IdTable* retired = table->Retired;
+        CSM_FREE(table->Slots);
+        CSM_DELETE(table);
+        table = retired;
+    }
+}
+
+void CubismIdManager::InsertToTable(IdTable* table, CubismId* id)
+{
+    const csmUint32 mask = table->Capacity - 1;
+
+    for (csmUint32 i = id->_hash & mask; ; i = (i + 1) & mask)
+    {
+        if (table->Slots[i].load(std::memory_order_relaxed) == NULL)
+        {
+            table->Slots[i].store(id, std::memory_order_release);
+            return;
+        }
+    }
 }
 
 }}}
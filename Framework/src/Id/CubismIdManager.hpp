@@ -10,6 +10,8 @@
 #include "Type/CubismBasicType.hpp"
 #include "Type/csmString.hpp"
 #include "Type/csmVector.hpp"
+#include <atomic>
+#include <mutex>
 
 namespace Live2D { namespace Cubism { namespace Framework {
 
@@ -17,6 +19,10 @@ struct CubismId;
 
 /**
  * Handles ID names.
+ *
+ * @note IDs are interned in an open-addressed hash table. Lookups of registered IDs
+ *       (GetId / IsExist) never take a lock and may be called from any thread;
+ *       registration of new IDs is serialized internally.
  */
 class CubismIdManager
 {
@@ -105,13 +111,47 @@ public:
      */
     csmBool IsExist(const csmChar* id) const;
 
+    /**
+     * Returns the number of registered IDs.
+     *
+     * @return Number of registered IDs
+     */
+    csmUint32 GetIdCount() const;
+
 private:
+    /**
+     * Hash table of registered IDs.
+     *
+     * Tables are never modified in place except for filling empty slots,
+     * and a grown table replaces the current one atomically. Replaced tables
+     * are kept until the manager is destroyed so that concurrent readers stay valid.
+     */
+    struct IdTable
+    {
+        csmUint32 Capacity;                 ///< Number of slots (power of two)
+        std::atomic<CubismId*>* Slots;      ///< Slots; NULL for an empty slot
+        IdTable* Retired;                   ///< Previously replaced table
+    };
+
     CubismIdManager(const CubismIdManager&);
     CubismIdManager& operator=(const CubismIdManager&);
 
+    static csmUint32 HashId(const csmChar* id);
+
+    static IdTable* CreateTable(csmUint32 capacity);
+
+    static void DeleteTable(IdTable* table);
+
+    static void InsertToTable(IdTable* table, CubismId* id);
+
     CubismId* FindId(const csmChar* id) const;
 
+    CubismId* FindId(const csmChar* id, csmUint32 hash) const;
+
     csmVector<CubismId*> _ids;
+    std::atomic<IdTable*> _table;       ///< Current hash table
+    std::atomic<csmUint32> _idCount;    ///< Number of registered IDs
+    std::mutex _registerMutex;          ///< Serializes the registration of new IDs
 };
 
 }}}
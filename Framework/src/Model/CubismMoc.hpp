@@ -8,6 +8,7 @@
 #pragma once
 
 #include "CubismFramework.hpp"
+#include <atomic>
 
 namespace Live2D { namespace Cubism { namespace Framework {
 
@@ -91,7 +92,7 @@ private:
     virtual ~CubismMoc();
 
     Core::csmMoc*     _moc;
-    csmInt32          _modelCount;
+    std::atomic<csmInt32> _modelCount; ///< A MOC shared through CubismMocCache creates models on several threads
     csmUint32         _mocVersion;
 };
 
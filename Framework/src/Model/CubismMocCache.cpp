@@ -0,0 +1,110 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#include "CubismMocCache.hpp"
+#include "CubismMoc.hpp"
+#include "Utils/CubismDebug.hpp"
+
+namespace Live2D { namespace Cubism { namespace Framework {
+
+CubismMocCache::CubismMocCache()
+{ }
+
+CubismMocCache::~CubismMocCache()
+{
+    // CubismFramework::Dispose() は参照が残っている間は破棄しない
+    CSM_ASSERT(_entries.empty());
+}
+
+CubismMoc* CubismMocCache::Acquire(const csmString& key)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    std::unordered_map<std::string, Entry>::iterator iter = _entries.find(key.GetRawString());
+    if (iter == _entries.end())
+    {
+        return NULL;
+    }
+
+    ++iter->second.RefCount;
+    return iter->second.Moc;
+}
+
+CubismMoc* CubismMocCache::Register(const csmString& key, const csmByte* mocBytes, csmSizeInt size, csmBool shouldCheckMocConsistency)
+{
+    // revive はロックの外で行い、その間に同じキーが登録されていたらそちらを使う
+    CubismMoc* moc = CubismMoc::Create(mocBytes, size, shouldCheckMocConsistency);
+
+    if (moc == NULL)
+    {
+        return NULL;
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    std::unordered_map<std::string, Entry>::iterator iter = _entries.find(key.GetRawString());
+    if (iter != _entries.end())
+    {
+        CubismMoc::Delete(moc);
+
+        ++iter->second.RefCount;
+        return iter->second.Moc;
+    }
+
+    Entry& entry = _entries[key.GetRawString()];
+    entry.Moc = moc;
+    entry.RefCount = 1;
+    entry.Size = size;
+    return moc;
+}
+
+void CubismMocCache::Release(CubismMoc* moc)
+{
+    if (moc == NULL)
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    for (std::unordered_map<std::string, Entry>::iterator iter = _entries.begin(); iter != _entries.end(); ++iter)
+    {
+        if (iter->second.Moc != moc)
+        {
+            continue;
+        }
+
+        if (--iter->second.RefCount == 0)
+        {
+            CubismMoc::Delete(moc);
+            _entries.erase(iter);
+        }
+        return;
+    }
+
+    CubismLogError("CubismMocCache: released a MOC that is not cached.");
+}
+
+csmInt32 CubismMocCache::GetMocCount() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return static_cast<csmInt32>(_entries.size());
+}
+
+csmSizeInt CubismMocCache::GetMocBytes() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    csmSizeInt bytes = 0;
+    for (std::unordered_map<std::string, Entry>::const_iterator iter = _entries.begin(); iter != _entries.end(); ++iter)
+    {
+        bytes += iter->second.Size;
+    }
+    return bytes;
+}
+
+}}}
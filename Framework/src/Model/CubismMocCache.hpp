@@ -0,0 +1,103 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#pragma once
+
+#include "CubismFramework.hpp"
+#include "Type/csmString.hpp"
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace Live2D { namespace Cubism { namespace Framework {
+
+class CubismMoc;
+
+/**
+ * Process-wide cache of revived MOC data.
+ *
+ * Model instances that load the same MOC file share one immutable `CubismMoc`
+ * and only allocate their own `csmModel`. The MOC is destroyed when the last
+ * instance releases it.
+ *
+ * @note All functions may be called from any thread.
+ * @note `CubismFramework::Dispose` keeps the cache while models still reference
+ *       MOCs, so that they can be released afterwards.
+ */
+class CubismMocCache
+{
+public:
+    /**
+     * Constructor
+     */
+    CubismMocCache();
+
+    /**
+     * Destructor
+     */
+    ~CubismMocCache();
+
+    /**
+     * Returns a cached MOC and adds a reference to it.
+     *
+     * @param key Key identifying the MOC file, typically its canonical path
+     *
+     * @return Cached MOC; NULL if the key is not cached.
+     */
+    CubismMoc* Acquire(const csmString& key);
+
+    /**
+     * Revives a MOC, registers it under the given key and adds a reference to it.
+     * If another thread registered the same key first, that MOC is returned instead.
+     *
+     * @param key Key identifying the MOC file
+     * @param mocBytes Buffer containing the loaded MOC file
+     * @param size Size of the buffer in bytes
+     * @param shouldCheckMocConsistency Whether to check the consistency of the MOC file
+     *
+     * @return Registered MOC; NULL if the MOC could not be revived.
+     */
+    CubismMoc* Register(const csmString& key, const csmByte* mocBytes, csmSizeInt size, csmBool shouldCheckMocConsistency = false);
+
+    /**
+     * Removes a reference added by `Acquire` or `Register`.
+     * The MOC is destroyed when no reference remains.
+     *
+     * @param moc MOC to release
+     */
+    void Release(CubismMoc* moc);
+
+    /**
+     * Returns the number of cached MOCs.
+     *
+     * @return Number of cached MOCs
+     */
+    csmInt32 GetMocCount() const;
+
+    /**
+     * Returns the total size of the cached MOC files in bytes.
+     *
+     * @return Total size in bytes
+     */
+    csmSizeInt GetMocBytes() const;
+
+private:
+    CubismMocCache(const CubismMocCache&);
+    CubismMocCache& operator=(const CubismMocCache&);
+
+    struct Entry
+    {
+        CubismMoc* Moc;         ///< Revived MOC
+        csmInt32 RefCount;      ///< Number of references
+        csmSizeInt Size;        ///< Size of the MOC file in bytes
+    };
+
+    std::unordered_map<std::string, Entry> _entries;    ///< Cached MOCs by key. `csmMap` does not destruct erased keys
+    mutable std::mutex _mutex;          ///< Guards `_entries`
+};
+
+}}}
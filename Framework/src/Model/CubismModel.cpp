@@ -27,6 +27,9 @@ CubismModel::CubismModel(Core::csmModel* model)
     , _isOverwrittenModelScreenColors(false)
     , _isOverwrittenCullings(false)
     , _modelOpacity(1.0f)
+    , _coreUpdateCount(0)
+    , _skippedCoreUpdateCount(0)
+    , _isDrawableSnapshotEnabled(false)
 { }
 
 CubismModel::~CubismModel()
@@ -71,11 +74,109 @@ void CubismModel::MultiplyParameterValue(csmInt32 parameterIndex, csmFloat32 val
 
 void CubismModel::Update() const
 {
+    const csmInt32 parameterCount = Core::csmGetParameterCount(_model);
+    const csmInt32 partCount = Core::csmGetPartCount(_model);
+
+    // コアの更新はパラメータとパーツの不透明度だけから決まるので、前回から変わっていなければ省略する
+    // 物理演算はコアの配列に直接書き込むため、書き込み時のフラグではなく値を比較する
+    if (_coreUpdateCount > 0
+        && (parameterCount == 0 || memcmp(_updatedParameterValues.GetPtr(), _parameterValues, sizeof(csmFloat32) * parameterCount) == 0)
+        && (partCount == 0 || memcmp(_updatedPartOpacities.GetPtr(), _partOpacities, sizeof(csmFloat32) * partCount) == 0))
+    {
+        ++_skippedCoreUpdateCount;
+        return;
+    }
+
     // Update model.
     Core::csmUpdateModel(_model);
 
     // Reset dynamic drawable flags.
     Core::csmResetDrawableDynamicFlags(_model);
+
+    ++_coreUpdateCount;
+
+    // パラメータ数とパーツ数はモデル固有で変わらないため、確保は初回のみ
+    if (parameterCount > 0)
+    {
+        if (_updatedParameterValues.GetSize() != static_cast<csmUint32>(parameterCount))
+        {
+            _updatedParameterValues.Resize(parameterCount);
+        }
+        memcpy(_updatedParameterValues.GetPtr(), _parameterValues, sizeof(csmFloat32) * parameterCount);
+    }
+    if (partCount > 0)
+    {
+        if (_updatedPartOpacities.GetSize() != static_cast<csmUint32>(partCount))
+        {
+            _updatedPartOpacities.Resize(partCount);
+        }
+        memcpy(_updatedPartOpacities.GetPtr(), _partOpacities, sizeof(csmFloat32) * partCount);
+    }
+}
+
+csmUint64 CubismModel::GetCoreUpdateCount() const
+{
+    return _coreUpdateCount;
+}
+
+csmUint64 CubismModel::GetSkippedCoreUpdateCount() const
+{
+    return _skippedCoreUpdateCount;
+}
+
+void CubismModel::SnapshotDrawables()
+{
+    const csmInt32 drawableCount = Core::csmGetDrawableCount(_model);
+    const csmInt32* vertexCounts = Core::csmGetDrawableVertexCounts(_model);
+
+    // 頂点数はモデル固有で変わらないため、バッファの確保は初回のみ
+    if (_snapshotVertexOffsets.GetSize() != static_cast<csmUint32>(drawableCount))
+    {
+        csmInt32 vertexTotal = 0;
+        _snapshotVertexOffsets.Resize(drawableCount);
+        for (csmInt32 i = 0; i < drawableCount; ++i)
+        {
+            _snapshotVertexOffsets[i] = vertexTotal;
+            vertexTotal += vertexCounts[i];
+        }
+
+        _snapshotVertexPositions.Resize(vertexTotal);
+        _snapshotOpacities.Resize(drawableCount);
+        _snapshotRenderOrders.Resize(drawableCount);
+        _snapshotDynamicFlags.Resize(drawableCount);
+        _snapshotMultiplyColors.Resize(drawableCount);
+        _snapshotScreenColors.Resize(drawableCount);
+    }
+
+    if (drawableCount == 0)
+    {
+        return;
+    }
+
+    const Core::csmVector2** positions = Core::csmGetDrawableVertexPositions(_model);
+    for (csmInt32 i = 0; i < drawableCount; ++i)
+    {
+        if (vertexCounts[i] > 0)
+        {
+            memcpy(&_snapshotVertexPositions[_snapshotVertexOffsets[i]], positions[i], sizeof(Core::csmVector2) * vertexCounts[i]);
+        }
+    }
+
+    memcpy(_snapshotOpacities.GetPtr(), Core::csmGetDrawableOpacities(_model), sizeof(csmFloat32) * drawableCount);
+    memcpy(_snapshotRenderOrders.GetPtr(), Core::csmGetDrawableRenderOrders(_model), sizeof(csmInt32) * drawableCount);
+    memcpy(_snapshotDynamicFlags.GetPtr(), Core::csmGetDrawableDynamicFlags(_model), sizeof(Core::csmFlags) * drawableCount);
+    memcpy(_snapshotMultiplyColors.GetPtr(), Core::csmGetDrawableMultiplyColors(_model), sizeof(Core::csmVector4) * drawableCount);
+    memcpy(_snapshotScreenColors.GetPtr(), Core::csmGetDrawableScreenColors(_model), sizeof(Core::csmVector4) * drawableCount);
+}
+
+void CubismModel::SetDrawableSnapshotEnabled(csmBool enabled)
+{
+    _isDrawableSnapshotEnabled = enabled;
+}
+
+csmBool CubismModel::IsDrawableSnapshotEnabled() const
+{
+    return _isDrawableSnapshotEnabled;
 }
 
 void CubismModel::SetPartOpacity(CubismIdHandle partId, csmFloat32 opacity)
@@ -93,7 +194,7 @@ void CubismModel::SetPartOpacity(CubismIdHandle partId, csmFloat32 opacity)
 
 void CubismModel::SetPartOpacity(csmInt32 partIndex, csmFloat32 opacity)
 {
-    if (_notExistPartOpacities.IsExist(partIndex))
+    if (partIndex >= Core::csmGetPartCount(_model) && _notExistPartOpacities.IsExist(partIndex))
     {
         _notExistPartOpacities[partIndex] = opacity;
         return;
@@ -120,7 +221,7 @@ csmFloat32 CubismModel::GetPartOpacity(CubismIdHandle partId)
 
 csmFloat32 CubismModel::GetPartOpacity(csmInt32 partIndex)
 {
-    if (_notExistPartOpacities.IsExist(partIndex))
+    if (partIndex >= Core::csmGetPartCount(_model) && _notExistPartOpacities.IsExist(partIndex))
     {
         // モデルに存在しないパーツIDの場合、非存在パーツリストから不透明度を返す
         return _notExistPartOpacities[partIndex];
@@ -159,31 +260,20 @@ csmFloat32 CubismModel::GetParameterMinimumValue(csmUint32 parameterIndex) const
 
 csmInt32 CubismModel::GetParameterIndex(CubismIdHandle parameterId)
 {
-    csmInt32            parameterIndex;
-    const csmInt32      idCount = Core::csmGetParameterCount(_model);
+    // モデルに存在するパラメータと、既に登録済みの非存在パラメータは索引から引く
+    csmInt32 parameterIndex = _parameterIndices.Find(parameterId);
 
-
-    for (parameterIndex = 0; parameterIndex < idCount; ++parameterIndex)
+    if (parameterIndex >= 0)
     {
-        if (parameterId != _parameterIds[parameterIndex])
-        {
-            continue;
-        }
-
         return parameterIndex;
     }
 
-    // モデルに存在していない場合、非存在パラメータIDリスト内を検索し、そのインデックスを返す
-    if (_notExistParameterId.IsExist(parameterId))
-    {
-        return _notExistParameterId[parameterId];
-    }
-
     // 非存在パラメータIDリストにない場合、新しく要素を追加する
     parameterIndex = Core::csmGetParameterCount(_model) + _notExistParameterId.GetSize();
 
     _notExistParameterId[parameterId] = parameterIndex;
     _notExistParameterValues.AppendKey(parameterIndex);
+    _parameterIndices.Insert(parameterId, parameterIndex);
 
     return parameterIndex;
 }
@@ -196,7 +286,7 @@ CubismIdHandle CubismModel::GetParameterId(csmUint32 parameterIndex)
 
 csmFloat32 CubismModel::GetParameterValue(csmInt32 parameterIndex)
 {
-    if (_notExistParameterValues.IsExist(parameterIndex))
+    if (parameterIndex >= Core::csmGetParameterCount(_model) && _notExistParameterValues.IsExist(parameterIndex))
     {
         return _notExistParameterValues[parameterIndex];
     }
@@ -209,7 +299,7 @@ csmFloat32 CubismModel::GetParameterValue(csmInt32 parameterIndex)
 
 void CubismModel::SetParameterValue(csmInt32 parameterIndex, csmFloat32 value, csmFloat32 weight)
 {
-    if (_notExistParameterValues.IsExist(parameterIndex))
+    if (parameterIndex >= Core::csmGetParameterCount(_model) && _notExistParameterValues.IsExist(parameterIndex))
     {
         _notExistParameterValues[parameterIndex] = (weight == 1)
                                                          ? value
@@ -317,17 +407,7 @@ csmFloat32 CubismModel::GetCanvasHeight() const
 
 csmInt32 CubismModel::GetDrawableIndex(CubismIdHandle drawableId) const
 {
-    const csmInt32 drawableCount = Core::csmGetDrawableCount(_model);
-
-    for (csmInt32 drawableIndex = 0; drawableIndex < drawableCount; ++drawableIndex)
-    {
-        if (_drawableIds[drawableIndex] == drawableId)
-        {
-            return drawableIndex;
-        }
-    }
-
-    return -1;
+    return _drawableIndices.Find(drawableId);
 }
 
 const csmFloat32* CubismModel::GetDrawableVertices(csmInt32 drawableIndex) const
@@ -337,30 +417,20 @@ const csmFloat32* CubismModel::GetDrawableVertices(csmInt32 drawableIndex) const
 
 csmInt32 CubismModel::GetPartIndex(CubismIdHandle partId)
 {
-    csmInt32            partIndex;
-    const csmInt32      idCount = Core::csmGetPartCount(_model);
-
-    for (partIndex = 0; partIndex < idCount; ++partIndex)
-    {
-        if (partId == _partIds[partIndex])
-        {
-            return partIndex;
-        }
-    }
+    // モデルに存在するパーツと、既に登録済みの非存在パーツは索引から引く
+    csmInt32 partIndex = _partIndices.Find(partId);
 
-    const csmInt32 partCount = Core::csmGetPartCount(_model);
-
-    // モデルに存在していない場合、非存在パーツIDリスト内にあるかを検索し、そのインデックスを返す
-    if (_notExistPartId.IsExist(partId))
+    if (partIndex >= 0)
     {
-        return _notExistPartId[partId];
+        return partIndex;
     }
 
     // 非存在パーツIDリストにない場合、新しく要素を追加する
-    partIndex = partCount + _notExistPartId.GetSize();
+    partIndex = Core::csmGetPartCount(_model) + _notExistPartId.GetSize();
 
     _notExistPartId[partId] = partIndex;
     _notExistPartOpacities.AppendKey(partIndex);
+    _partIndices.Insert(partId, partIndex);
 
     return partIndex;
 }
@@ -379,9 +449,11 @@ void CubismModel::Initialize()
         const csmInt32  parameterCount = Core::csmGetParameterCount(_model);
 
         _parameterIds.PrepareCapacity(parameterCount);
+        _parameterIndices.Reserve(parameterCount);
         for (csmInt32 i = 0; i < parameterCount; ++i)
         {
             _parameterIds.PushBack(CubismFramework::GetIdManager()->GetId(parameterIds[i]));
+            _parameterIndices.Insert(_parameterIds[i], i);
         }
     }
 
@@ -390,9 +462,11 @@ void CubismModel::Initialize()
         const csmChar** partIds = Core::csmGetPartIds(_model);
 
         _partIds.PrepareCapacity(partCount);
+        _partIndices.Reserve(partCount);
         for (csmInt32 i = 0; i < partCount; ++i)
         {
             _partIds.PushBack(CubismFramework::GetIdManager()->GetId(partIds[i]));
+            _partIndices.Insert(_partIds[i], i);
         }
 
         _userPartMultiplyColors.PrepareCapacity(partCount);
@@ -405,6 +479,7 @@ void CubismModel::Initialize()
         const csmInt32  drawableCount = Core::csmGetDrawableCount(_model);
 
         _drawableIds.PrepareCapacity(drawableCount);
+        _drawableIndices.Reserve(drawableCount);
         _userMultiplyColors.PrepareCapacity(drawableCount);
         _userScreenColors.PrepareCapacity(drawableCount);
         _userCullings.PrepareCapacity(drawableCount);
@@ -462,6 +537,7 @@ void CubismModel::Initialize()
             for (csmInt32 i = 0; i < drawableCount; ++i)
             {
                 _drawableIds.PushBack(CubismFramework::GetIdManager()->GetId(drawableIds[i]));
+                _drawableIndices.Insert(_drawableIds[i], i);
                 _userMultiplyColors.PushBack(userMultiplyColor);
                 _userScreenColors.PushBack(userScreenColor);
                 _userCullings.PushBack(userCulling);
@@ -496,6 +572,11 @@ csmInt32 CubismModel::GetPartCount() const
 
 const csmInt32* CubismModel::GetDrawableRenderOrders() const
 {
+    if (_isDrawableSnapshotEnabled)
+    {
+        return _snapshotRenderOrders.GetPtr();
+    }
+
     const csmInt32* renderOrders = Core::csmGetDrawableRenderOrders(_model);
     return renderOrders;
 }
@@ -537,6 +618,11 @@ const csmUint16* CubismModel::GetDrawableVertexIndices(csmInt32 drawableIndex) c
 
 const Core::csmVector2* CubismModel::GetDrawableVertexPositions(csmInt32 drawableIndex) const
 {
+    if (_isDrawableSnapshotEnabled)
+    {
+        return _snapshotVertexPositions.GetPtr() + _snapshotVertexOffsets[drawableIndex];
+    }
+
     const Core::csmVector2** verticesArray = Core::csmGetDrawableVertexPositions(_model);
     return verticesArray[drawableIndex];
 }
@@ -549,18 +635,33 @@ const Core::csmVector2* CubismModel::GetDrawableVertexUvs(csmInt32 drawableIndex
 
 csmFloat32 CubismModel::GetDrawableOpacity(csmInt32 drawableIndex) const
 {
+    if (_isDrawableSnapshotEnabled)
+    {
+        return _snapshotOpacities[drawableIndex];
+    }
+
     const csmFloat32* opacities = Core::csmGetDrawableOpacities(_model);
     return opacities[drawableIndex];
 }
 
 Core::csmVector4 CubismModel::GetDrawableMultiplyColor(csmInt32 drawableIndex) const
 {
+    if (_isDrawableSnapshotEnabled)
+    {
+        return _snapshotMultiplyColors[drawableIndex];
+    }
+
     const Core::csmVector4* multiplyColors = Core::csmGetDrawableMultiplyColors(_model);
     return multiplyColors[drawableIndex];
 }
 
 Core::csmVector4 CubismModel::GetDrawableScreenColor(csmInt32 drawableIndex) const
 {
+    if (_isDrawableSnapshotEnabled)
+    {
+        return _snapshotScreenColors[drawableIndex];
+    }
+
     const Core::csmVector4* screenColors = Core::csmGetDrawableScreenColors(_model);
     return screenColors[drawableIndex];
 }
@@ -570,45 +671,55 @@ csmInt32 CubismModel::GetDrawableParentPartIndex(csmUint32 drawableIndex) const
     return Core::csmGetDrawableParentPartIndices(_model)[drawableIndex];
 }
 
+const Core::csmFlags* CubismModel::GetDrawableDynamicFlags() const
+{
+    if (_isDrawableSnapshotEnabled)
+    {
+        return _snapshotDynamicFlags.GetPtr();
+    }
+
+    return Core::csmGetDrawableDynamicFlags(_model);
+}
+
 csmBool CubismModel::GetDrawableDynamicFlagIsVisible(csmInt32 drawableIndex) const
 {
-    const Core::csmFlags* dynamicFlags = Core::csmGetDrawableDynamicFlags(_model);
+    const Core::csmFlags* dynamicFlags = GetDrawableDynamicFlags();
     return IsBitSet(dynamicFlags[drawableIndex], Core::csmIsVisible)!=0 ? true : false;
 }
 
 csmBool CubismModel::GetDrawableDynamicFlagVisibilityDidChange(csmInt32 drawableIndex) const
 {
-    const Core::csmFlags* dynamicFlags = Core::csmGetDrawableDynamicFlags(_model);
+    const Core::csmFlags* dynamicFlags = GetDrawableDynamicFlags();
     return IsBitSet(dynamicFlags[drawableIndex], Core::csmVisibilityDidChange)!=0 ? true : false;
 }
 
 csmBool CubismModel::GetDrawableDynamicFlagOpacityDidChange(csmInt32 drawableIndex) const
 {
-    const Core::csmFlags* dynamicFlags = Core::csmGetDrawableDynamicFlags(_model);
+    const Core::csmFlags* dynamicFlags = GetDrawableDynamicFlags();
     return IsBitSet(dynamicFlags[drawableIndex], Core::csmOpacityDidChange) != 0 ? true : false;
 }
 
 csmBool CubismModel::GetDrawableDynamicFlagDrawOrderDidChange(csmInt32 drawableIndex) const
 {
-    const Core::csmFlags* dynamicFlags = Core::csmGetDrawableDynamicFlags(_model);
+    const Core::csmFlags* dynamicFlags = GetDrawableDynamicFlags();
     return IsBitSet(dynamicFlags[drawableIndex], Core::csmDrawOrderDidChange) != 0 ? true : false;
 }
 
 csmBool CubismModel::GetDrawableDynamicFlagRenderOrderDidChange(csmInt32 drawableIndex) const
 {
-    const Core::csmFlags* dynamicFlags = Core::csmGetDrawableDynamicFlags(_model);
+    const Core::csmFlags* dynamicFlags = GetDrawableDynamicFlags();
     return IsBitSet(dynamicFlags[drawableIndex], Core::csmRenderOrderDidChange) != 0 ? true : false;
 }
 
 csmBool CubismModel::GetDrawableDynamicFlagVertexPositionsDidChange(csmInt32 drawableIndex) const
 {
-    const Core::csmFlags* dynamicFlags = Core::csmGetDrawableDynamicFlags(_model);
+    const Core::csmFlags* dynamicFlags = GetDrawableDynamicFlags();
     return IsBitSet(dynamicFlags[drawableIndex], Core::csmVertexPositionsDidChange) != 0 ? true : false;
 }
 
 csmBool CubismModel::GetDrawableDynamicFlagBlendColorDidChange(csmInt32 drawableIndex) const
 {
-    const Core::csmFlags* dynamicFlags = Core::csmGetDrawableDynamicFlags(_model);
+    const Core::csmFlags* dynamicFlags = GetDrawableDynamicFlags();
     return IsBitSet(dynamicFlags[drawableIndex], Core::csmBlendColorDidChange) != 0 ? true : false;
 }
 
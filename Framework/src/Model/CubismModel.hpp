@@ -12,6 +12,7 @@
 #include "Type/csmVector.hpp"
 #include "Rendering/CubismRenderer.hpp"
 #include "Id/CubismId.hpp"
+#include "Id/CubismIdIndexMap.hpp"
 
 namespace Live2D { namespace Cubism { namespace Framework {
 
@@ -121,9 +122,50 @@ public:
 
     /**
      * Calculates and updates the model state based on the set parameters.
+     *
+     * The core update is skipped when neither the parameter values nor the part opacities have changed since the last one,
+     * because its result would be the same. The values are compared instead of tracking the setters,
+     * since some components such as physics write to the arrays of the core directly.
      */
     void    Update() const;
 
+    /**
+     * Returns the number of Update() calls that ran the core update.
+     *
+     * @return Number of core updates performed
+     */
+    csmUint64   GetCoreUpdateCount() const;
+
+    /**
+     * Returns the number of Update() calls that skipped the core update because its inputs had not changed.
+     *
+     * @return Number of core updates skipped
+     */
+    csmUint64   GetSkippedCoreUpdateCount() const;
+
+    /**
+     * Copies the dynamic drawable data produced by the last Update() into buffers owned by the model.
+     *
+     * The copied data are the vertex positions, opacities, render orders, dynamic flags, multiply colors and screen colors.
+     * While the snapshot is enabled, the getters for these values read the copy,
+     * so the next Update() can run on another thread while the renderer draws the copied frame.
+     */
+    void    SnapshotDrawables();
+
+    /**
+     * Sets whether the dynamic drawable getters read the snapshot taken by SnapshotDrawables().
+     *
+     * @param enabled true to read the snapshot; false to read the values of the core
+     */
+    void    SetDrawableSnapshotEnabled(csmBool enabled);
+
+    /**
+     * Returns whether the dynamic drawable getters read the snapshot.
+     *
+     * @return true if the snapshot is read; otherwise false
+     */
+    csmBool IsDrawableSnapshotEnabled() const;
+
     /**
      * Returns the width of the canvas.
      *
@@ -849,6 +891,8 @@ private:
 
     void Initialize();
 
+    const Core::csmFlags* GetDrawableDynamicFlags() const;
+
     void SetPartColor(
         csmUint32 partIndex,
         csmFloat32 r, csmFloat32 g, csmFloat32 b, csmFloat32 a,
@@ -882,6 +926,9 @@ private:
     csmVector<CubismIdHandle> _parameterIds;
     csmVector<CubismIdHandle> _partIds;
     csmVector<CubismIdHandle> _drawableIds;
+    CubismIdIndexMap _parameterIndices;     ///< パラメータIDからインデックスへの索引（非存在パラメータを含む）
+    CubismIdIndexMap _partIndices;          ///< パーツIDからインデックスへの索引（非存在パーツを含む）
+    CubismIdIndexMap _drawableIndices;      ///< DrawableIDからインデックスへの索引
     csmVector<DrawableColorData> _userScreenColors;
     csmVector<DrawableColorData> _userMultiplyColors;
     csmVector<DrawableCullingData> _userCullings;
@@ -891,6 +938,20 @@ private:
     csmBool _isOverwrittenModelMultiplyColors;
     csmBool _isOverwrittenModelScreenColors;
     csmBool _isOverwrittenCullings;
+
+    mutable csmVector<csmFloat32> _updatedParameterValues;  ///< 最後にコアを更新した時のパラメータの値
+    mutable csmVector<csmFloat32> _updatedPartOpacities;    ///< 最後にコアを更新した時のパーツの不透明度
+    mutable csmUint64 _coreUpdateCount;                     ///< コアを更新した回数
+    mutable csmUint64 _skippedCoreUpdateCount;              ///< 入力が変わっていないためコアの更新を省略した回数
+
+    csmBool _isDrawableSnapshotEnabled;                     ///< 動的なDrawable情報をスナップショットから読むか
+    csmVector<csmInt32> _snapshotVertexOffsets;             ///< Drawableごとの頂点座標の先頭位置
+    csmVector<Core::csmVector2> _snapshotVertexPositions;   ///< 全Drawableの頂点座標
+    csmVector<csmFloat32> _snapshotOpacities;
+    csmVector<csmInt32> _snapshotRenderOrders;
+    csmVector<Core::csmFlags> _snapshotDynamicFlags;
+    csmVector<Core::csmVector4> _snapshotMultiplyColors;
+    csmVector<Core::csmVector4> _snapshotScreenColors;
 };
 
 }}}
@@ -8,11 +8,13 @@
 #include "CubismUserModel.hpp"
 #include "Motion/CubismMotion.hpp"
 #include "Physics/CubismPhysics.hpp"
+#include "Model/CubismMocCache.hpp"
 
 namespace Live2D { namespace Cubism { namespace Framework {
 
 CubismUserModel::CubismUserModel()
     : _moc(NULL)
+    , _mocShared(false)
     , _model(NULL)
     , _motionManager(NULL)
     , _expressionManager(NULL)
@@ -58,7 +60,14 @@ CubismUserModel::~CubismUserModel()
     {
         _moc->DeleteModel(_model);
     }
-    CubismMoc::Delete(_moc);
+    if (_mocShared)
+    {
+        CubismFramework::GetMocCache()->Release(_moc);
+    }
+    else
+    {
+        CubismMoc::Delete(_moc);
+    }
     CSM_DELETE(_modelMatrix);
     CubismPose::Delete(_pose);
     CubismEyeBlink::Delete(_eyeBlink);
@@ -87,6 +96,43 @@ void CubismUserModel::LoadModel(const csmByte* buffer, csmSizeInt size, csmBool
         return;
     }
 
+    CreateModelInstance();
+}
+
+csmBool CubismUserModel::LoadSharedModel(const csmString& key)
+{
+    CubismMoc* moc = CubismFramework::GetMocCache()->Acquire(key);
+
+    if (moc == NULL)
+    {
+        return false;
+    }
+
+    _moc = moc;
+    _mocShared = true;
+
+    CreateModelInstance();
+
+    return true;
+}
+
+void CubismUserModel::LoadSharedModel(const csmString& key, const csmByte* buffer, csmSizeInt size, csmBool shouldCheckMocConsistency)
+{
+    _moc = CubismFramework::GetMocCache()->Register(key, buffer, size, shouldCheckMocConsistency);
+
+    if (_moc == NULL)
+    {
+        CubismLogError("Failed to CubismMoc::Create().");
+        return;
+    }
+
+    _mocShared = true;
+
+    CreateModelInstance();
+}
+
+void CubismUserModel::CreateModelInstance()
+{
     _model = _moc->CreateModel();
 
     if (_model == NULL)
@@ -113,6 +113,26 @@ public:
      */
     virtual void            LoadModel(const csmByte* buffer, csmSizeInt size, csmBool shouldCheckMocConsistency = false);
 
+    /**
+     * Loads the model from a MOC already cached in CubismMocCache.
+     * The MOC is shared with other instances and only the model instance is allocated.
+     *
+     * @param key Cache key of the MOC3 file, typically its canonical path
+     *
+     * @return true if the MOC was cached; false otherwise, in which case nothing is loaded.
+     */
+    csmBool                 LoadSharedModel(const csmString& key);
+
+    /**
+     * Loads the model from a MOC3 file and registers the MOC in CubismMocCache
+     * so that other instances loading the same key can share it.
+     *
+     * @param key Cache key of the MOC3 file, typically its canonical path
+     * @param buffer Buffer where the MOC3 file is loaded
+     * @param size Number of bytes in the buffer
+     */
+    void                    LoadSharedModel(const csmString& key, const csmByte* buffer, csmSizeInt size, csmBool shouldCheckMocConsistency = false);
+
     /**
      * Loads motion from a motion file.
      * If a fade value is defined in model3.json, the fade value defined in motion3.json will be overwritten.
@@ -223,6 +243,7 @@ public:
     static void   CubismDefaultMotionEventCallback(const CubismMotionQueueManager* caller, const csmString& eventValue, void* customData);
 protected:
     CubismMoc*              _moc;
+    csmBool                 _mocShared;         ///< Whether `_moc` is owned by CubismMocCache
     CubismModel*            _model;
 
     CubismMotionManager*    _motionManager;
@@ -249,6 +270,11 @@ protected:
     csmBool     _debugMode;
 
 private:
+    /**
+     * Creates the model instance from `_moc` and sets up the model matrix.
+     */
+    void CreateModelInstance();
+
     Rendering::CubismRenderer* _renderer;
 };
 
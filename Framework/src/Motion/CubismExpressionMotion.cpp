@@ -7,6 +7,7 @@
 
 #include "CubismExpressionMotion.hpp"
 #include "CubismMotionQueueEntry.hpp"
+#include "CubismMotionInternal.hpp"
 #include "Id/CubismIdManager.hpp"
 #include "Math/CubismMath.hpp"
 
@@ -100,7 +101,7 @@ void CubismExpressionMotion::CalculateExpressionParameters(CubismModel* model, c
         const csmFloat32 currentParameterValue = expressionParameterValue.OverwriteValue =
             model->GetParameterValue(expressionParameterValue.ParameterId);
 
-        csmVector<ExpressionParameter> expressionParameters = GetExpressionParameters();
+        const csmVector<ExpressionParameter>& expressionParameters = _parameters;
         csmInt32 parameterIndex = -1;
         for (csmInt32 j = 0; j < expressionParameters.GetSize(); ++j)
         {
@@ -140,9 +141,9 @@ void CubismExpressionMotion::CalculateExpressionParameters(CubismModel* model, c
         }
 
         // 値を計算
-        csmFloat32 value = expressionParameters.At(parameterIndex).Value;
+        csmFloat32 value = expressionParameters[parameterIndex].Value;
         csmFloat32 newAdditiveValue, newMultiplyValue, newSetValue;
-        switch (expressionParameters.At(parameterIndex).BlendType) {
+        switch (expressionParameters[parameterIndex].BlendType) {
         case Additive:
             newAdditiveValue = value;
             newMultiplyValue = DefaultMultiplyValue;
@@ -175,7 +176,117 @@ void CubismExpressionMotion::CalculateExpressionParameters(CubismModel* model, c
     }
 }
 
-csmVector<CubismExpressionMotion::ExpressionParameter> CubismExpressionMotion::GetExpressionParameters()
+void CubismExpressionMotion::BlendExpressionParameters(csmFloat32 userTimeSeconds, CubismMotionQueueEntry* motionQueueEntry,
+    csmVector<CubismExpressionMotionManager::ExpressionParameterValue>* expressionParameterValues, const csmFloat32* currentParameterValues,
+    csmInt32 expressionIndex, csmFloat32 fadeWeight)
+{
+    if (motionQueueEntry == NULL || expressionParameterValues == NULL)
+    {
+        return;
+    }
+
+    CubismExpressionBinding* binding = motionQueueEntry->_expressionBinding;
+
+    if (!motionQueueEntry->IsAvailable() || binding == NULL)
+    {
+        return;
+    }
+
+    // CubismExpressionMotion._fadeWeight は廃止予定です。
+    // 互換性のために処理は残りますが、実際には使用しておりません。
+    _fadeWeight = UpdateFadeWeight(motionQueueEntry, userTimeSeconds);
+
+    CubismExpressionMotionManager::ExpressionParameterValue* values = expressionParameterValues->GetPtr();
+    const csmInt32 valueCount = static_cast<csmInt32>(expressionParameterValues->GetSize());
+    const csmInt32* valueIndices = binding->ValueIndices.GetPtr();
+    csmFloat32* blendedValues = binding->BlendedValues.GetPtr();
+    const csmFloat32 inverseWeight = 1.0f - fadeWeight;
+
+    // 参照しているパラメータの値を先に計算しておく（前回までの値を使うため）
+    for (csmUint32 i = 0; i < _parameters.GetSize(); ++i)
+    {
+        const csmInt32 valueIndex = valueIndices[i];
+
+        if (valueIndex < 0)
+        {
+            continue;
+        }
+
+        const csmFloat32 value = _parameters[i].Value;
+        const csmFloat32 currentParameterValue = currentParameterValues[valueIndex];
+        csmFloat32 newAdditiveValue = DefaultAdditiveValue;
+        csmFloat32 newMultiplyValue = DefaultMultiplyValue;
+        csmFloat32 newSetValue = currentParameterValue;
+
+        switch (_parameters[i].BlendType)
+        {
+        case Additive:
+            newAdditiveValue = value;
+            break;
+        case Multiply:
+            newMultiplyValue = value;
+            break;
+        case Overwrite:
+            newSetValue = value;
+            break;
+        default:
+            break;
+        }
+
+        csmFloat32* blended = blendedValues + i * 3;
+
+        if (expressionIndex == 0)
+        {
+            blended[0] = newAdditiveValue;
+            blended[1] = newMultiplyValue;
+            blended[2] = newSetValue;
+        }
+        else
+        {
+            blended[0] = (values[valueIndex].AdditiveValue * inverseWeight) + newAdditiveValue * fadeWeight;
+            blended[1] = (values[valueIndex].MultiplyValue * inverseWeight) + newMultiplyValue * fadeWeight;
+            blended[2] = (currentParameterValue * inverseWeight) + newSetValue * fadeWeight;
+        }
+    }
+
+    // 再生中のExpressionが参照していないパラメータは初期値を適用
+    if (expressionIndex == 0)
+    {
+        for (csmInt32 i = 0; i < valueCount; ++i)
+        {
+            values[i].AdditiveValue = DefaultAdditiveValue;
+            values[i].MultiplyValue = DefaultMultiplyValue;
+            values[i].OverwriteValue = currentParameterValues[i];
+        }
+    }
+    else
+    {
+        for (csmInt32 i = 0; i < valueCount; ++i)
+        {
+            values[i].AdditiveValue = CalculateValue(values[i].AdditiveValue, DefaultAdditiveValue, fadeWeight);
+            values[i].MultiplyValue = CalculateValue(values[i].MultiplyValue, DefaultMultiplyValue, fadeWeight);
+            values[i].OverwriteValue = CalculateValue(currentParameterValues[i], currentParameterValues[i], fadeWeight);
+        }
+    }
+
+    // 参照しているパラメータは計算済みの値で上書き
+    for (csmUint32 i = 0; i < _parameters.GetSize(); ++i)
+    {
+        const csmInt32 valueIndex = valueIndices[i];
+
+        if (valueIndex < 0)
+        {
+            continue;
+        }
+
+        const csmFloat32* blended = blendedValues + i * 3;
+        values[valueIndex].AdditiveValue = blended[0];
+        values[valueIndex].MultiplyValue = blended[1];
+        values[valueIndex].OverwriteValue = blended[2];
+    }
+}
+
+const csmVector<CubismExpressionMotion::ExpressionParameter>& CubismExpressionMotion::GetExpressionParameters() const
 {
     return _parameters;
 }
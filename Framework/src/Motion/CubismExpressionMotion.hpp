@@ -72,10 +72,27 @@ public:
     void CalculateExpressionParameters(CubismModel* model, csmFloat32 userTimeSeconds, CubismMotionQueueEntry* motionQueueEntry,
         csmVector<CubismExpressionMotionManager::ExpressionParameterValue>* expressionParameterValues, csmInt32 expressionIndex, csmFloat32 fadeWeight);
 
+    /**
+     * Blends the facial expression into the values to be applied to the model.
+     *
+     * Same calculation as CalculateExpressionParameters(), but uses the indices resolved by
+     * CubismExpressionMotionManager for the motion queue entry instead of searching by ID.
+     *
+     * @param userTimeSeconds cumulative delta time in seconds
+     * @param motionQueueEntry motion managed by the CubismMotionQueueManager
+     * @param expressionParameterValues values of each parameter to be applied to the model
+     * @param currentParameterValues current model value of each entry of expressionParameterValues
+     * @param expressionIndex index of the facial expression
+     * @param fadeWeight fade weight of the facial expression
+     */
+    void BlendExpressionParameters(csmFloat32 userTimeSeconds, CubismMotionQueueEntry* motionQueueEntry,
+        csmVector<CubismExpressionMotionManager::ExpressionParameterValue>* expressionParameterValues, const csmFloat32* currentParameterValues,
+        csmInt32 expressionIndex, csmFloat32 fadeWeight);
+
     /**
      * Returns the parameters referenced by the facial expression.
      */
-    csmVector<ExpressionParameter> GetExpressionParameters();
+    const csmVector<ExpressionParameter>& GetExpressionParameters() const;
 
     /**
      * Returns the current fade weight value of the facial expression.
@@ -8,6 +8,7 @@
 #include "CubismExpressionMotionManager.hpp"
 #include "CubismExpressionMotion.hpp"
 #include "CubismMotionQueueEntry.hpp"
+#include "CubismMotionInternal.hpp"
 #include "CubismFramework.hpp"
 #include "Math/CubismMath.hpp"
 
@@ -18,6 +19,9 @@ CubismExpressionMotionManager::CubismExpressionMotionManager()
     , _reservePriority(0)
     , _expressionParameterValues(CSM_NEW csmVector<ExpressionParameterValue>())
     , _fadeWeights(CSM_NEW csmVector<csmFloat32>())
+    , _currentParameterValues(CSM_NEW csmVector<csmFloat32>())
+    , _valueIndices(CSM_NEW csmVector<csmInt32>())
+    , _model(NULL)
 { }
 
 CubismExpressionMotionManager::~CubismExpressionMotionManager()
@@ -35,6 +39,20 @@ CubismExpressionMotionManager::~CubismExpressionMotionManager()
 
         _fadeWeights = NULL;
     }
+
+    if (_currentParameterValues)
+    {
+        CSM_DELETE(_currentParameterValues);
+
+        _currentParameterValues = NULL;
+    }
+
+    if (_valueIndices)
+    {
+        CSM_DELETE(_valueIndices);
+
+        _valueIndices = NULL;
+    }
 }
 
 csmInt32 CubismExpressionMotionManager::GetCurrentPriority() const
@@ -90,6 +108,17 @@ csmBool CubismExpressionMotionManager::UpdateMotion(CubismModel* model, csmFloat
         _fadeWeights->PushBack(0.0f);
     }
 
+    if (_model != model)
+    {
+        BindValues(model);
+    }
+
+    // 各パラメータの現在値はExpressionの計算中に変化しないため先にまとめて取得する
+    for (csmUint32 i = 0; i < _expressionParameterValues->GetSize(); ++i)
+    {
+        _currentParameterValues->At(i) = model->GetParameterValue(_expressionParameterValues->At(i).ParameterIndex);
+    }
+
     // ------- 処理を行う --------
     // 既にモーションがあれば終了フラグを立てる
     for (csmVector<CubismMotionQueueEntry*>::iterator ite = motions->Begin(); ite != motions->End();)
@@ -111,51 +140,18 @@ csmBool CubismExpressionMotionManager::UpdateMotion(CubismModel* model, csmFloat
             continue;
         }
 
-        csmVector<CubismExpressionMotion::ExpressionParameter> expressionParameters = expressionMotion->GetExpressionParameters();
         if (motionQueueEntry->IsAvailable())
         {
             // 再生中のExpressionが参照しているパラメータをすべてリストアップ
-            for (csmInt32 i = 0; i < expressionParameters.GetSize(); ++i)
-            {
-                if (expressionParameters[i].ParameterId == NULL)
-                {
-                    continue;
-                }
-
-                csmInt32 index = -1;
-                // リストにパラメータIDが存在するか検索
-                for (csmInt32 j = 0; j < _expressionParameterValues->GetSize(); ++j)
-                {
-                    if (_expressionParameterValues->At(j).ParameterId != expressionParameters[i].ParameterId)
-                    {
-                        continue;
-                    }
-
-                    index = j;
-                    break;
-                }
-
-                if (index >= 0)
-                {
-                    continue;
-                }
-
-                // パラメータがリストに存在しないなら新規追加
-                ExpressionParameterValue item;
-                item.ParameterId = expressionParameters[i].ParameterId;
-                item.AdditiveValue = CubismExpressionMotion::DefaultAdditiveValue;
-                item.MultiplyValue = CubismExpressionMotion::DefaultMultiplyValue;
-                item.OverwriteValue = model->GetParameterValue(item.ParameterId);
-                _expressionParameterValues->PushBack(item);
-            }
+            BindExpression(model, motionQueueEntry, expressionMotion);
         }
 
         // ------ 値を計算する ------
         expressionMotion->SetupMotionQueueEntry(motionQueueEntry, _userTimeSeconds);
 
         SetFadeWeight(expressionIndex, expressionMotion->UpdateFadeWeight(motionQueueEntry, _userTimeSeconds));
-        expressionMotion->CalculateExpressionParameters(model, _userTimeSeconds, motionQueueEntry,
-            _expressionParameterValues, expressionIndex, GetFadeWeight(expressionIndex));
+        expressionMotion->BlendExpressionParameters(_userTimeSeconds, motionQueueEntry,
+            _expressionParameterValues, _currentParameterValues->GetPtr(), expressionIndex, GetFadeWeight(expressionIndex));
 
         expressionWeight += expressionMotion->GetFadeInTime() == 0.0f
             ? 1.0f
@@ -199,7 +195,7 @@ csmBool CubismExpressionMotionManager::UpdateMotion(CubismModel* model, csmFloat
     // モデルに各値を適用
     for (csmInt32 i = 0; i < _expressionParameterValues->GetSize(); ++i)
     {
-        model->SetParameterValue(_expressionParameterValues->At(i).ParameterId,
+        model->SetParameterValue(_expressionParameterValues->At(i).ParameterIndex,
             (_expressionParameterValues->At(i).OverwriteValue + _expressionParameterValues->At(i).AdditiveValue) * _expressionParameterValues->At(i).MultiplyValue,
             expressionWeight);
 
@@ -232,4 +228,93 @@ void CubismExpressionMotionManager::SetFadeWeight(csmInt32 index, csmFloat32 exp
     _fadeWeights->At(index) = expressionFadeWeight;
 }
 
+void CubismExpressionMotionManager::BindValues(CubismModel* model)
+{
+    _model = model;
+    _valueIndices->Assign(0, -1, false);
+    _currentParameterValues->Resize(_expressionParameterValues->GetSize(), 0.0f);
+
+    for (csmUint32 i = 0; i < _expressionParameterValues->GetSize(); ++i)
+    {
+        const csmInt32 parameterIndex = model->GetParameterIndex(_expressionParameterValues->At(i).ParameterId);
+
+        if (parameterIndex >= static_cast<csmInt32>(_valueIndices->GetSize()))
+        {
+            _valueIndices->UpdateSize(parameterIndex + 1, -1, false);
+        }
+
+        _expressionParameterValues->At(i).ParameterIndex = parameterIndex;
+        _valueIndices->At(parameterIndex) = i;
+    }
+}
+
+void CubismExpressionMotionManager::BindExpression(CubismModel* model, CubismMotionQueueEntry* motionQueueEntry, CubismExpressionMotion* expressionMotion)
+{
+    CubismExpressionBinding* binding = motionQueueEntry->_expressionBinding;
+
+    if (binding != NULL && binding->Model == model)
+    {
+        return;
+    }
+
+    if (binding == NULL)
+    {
+        binding = CSM_NEW CubismExpressionBinding();
+        motionQueueEntry->_expressionBinding = binding;
+    }
+
+    const csmVector<CubismExpressionMotion::ExpressionParameter>& expressionParameters = expressionMotion->GetExpressionParameters();
+
+    binding->Model = model;
+    binding->ValueIndices.Resize(expressionParameters.GetSize(), -1);
+    binding->BlendedValues.Resize(expressionParameters.GetSize() * 3, 0.0f);
+
+    for (csmUint32 i = 0; i < expressionParameters.GetSize(); ++i)
+    {
+        binding->ValueIndices[i] = -1;
+
+        if (expressionParameters[i].ParameterId == NULL)
+        {
+            continue;
+        }
+
+        const csmInt32 parameterIndex = model->GetParameterIndex(expressionParameters[i].ParameterId);
+
+        if (parameterIndex >= static_cast<csmInt32>(_valueIndices->GetSize()))
+        {
+            _valueIndices->UpdateSize(parameterIndex + 1, -1, false);
+        }
+
+        csmInt32 valueIndex = _valueIndices->At(parameterIndex);
+
+        if (valueIndex < 0)
+        {
+            // パラメータがリストに存在しないなら新規追加
+            ExpressionParameterValue item;
+            item.ParameterId = expressionParameters[i].ParameterId;
+            item.ParameterIndex = parameterIndex;
+            item.AdditiveValue = CubismExpressionMotion::DefaultAdditiveValue;
+            item.MultiplyValue = CubismExpressionMotion::DefaultMultiplyValue;
+            item.OverwriteValue = model->GetParameterValue(parameterIndex);
+            _expressionParameterValues->PushBack(item);
+            _currentParameterValues->PushBack(item.OverwriteValue);
+
+            valueIndex = _expressionParameterValues->GetSize() - 1;
+            _valueIndices->At(parameterIndex) = valueIndex;
+        }
+
+        // 同じパラメータが複数回指定されている場合は先頭のものだけを使う
+        for (csmUint32 j = 0; j < i; ++j)
+        {
+            if (binding->ValueIndices[j] == valueIndex)
+            {
+                valueIndex = -1;
+                break;
+            }
+        }
+
+        binding->ValueIndices[i] = valueIndex;
+    }
+}
+
 }}}
@@ -13,6 +13,9 @@
 
 namespace Live2D { namespace Cubism { namespace Framework {
 
+class CubismExpressionMotion;
+struct CubismExpressionBinding;
+
 /**
  * Handles the management of facial expression motions.
  */
@@ -25,6 +28,7 @@ public:
     struct ExpressionParameterValue
     {
         CubismIdHandle      ParameterId;        ///< Parameter ID
+        csmInt32            ParameterIndex;     ///< Parameter index in the model the values are applied to
         csmFloat32          AdditiveValue;      ///< Added value
         csmFloat32          MultiplyValue;      ///< Multiplied value
         csmFloat32          OverwriteValue;     ///< Overwritten value
@@ -108,12 +112,39 @@ private:
      */
     void SetFadeWeight(csmInt32 index, csmFloat32 expressionFadeWeight);
 
+    /**
+     * Resolves the parameter indices of the value list against the model.
+     *
+     * @param[in]    model  Model the values are applied to
+     */
+    void BindValues(CubismModel* model);
+
+    /**
+     * Resolves the value list entries referenced by a playing facial expression.
+     *
+     * Parameters missing from the value list are added to it.
+     *
+     * @param[in]    model  Model the values are applied to
+     * @param[in]    motionQueueEntry   Entry of the facial expression motion
+     * @param[in]    expressionMotion   Facial expression motion played by the entry
+     */
+    void BindExpression(CubismModel* model, CubismMotionQueueEntry* motionQueueEntry, CubismExpressionMotion* expressionMotion);
+
     // Values of each parameter to be applied to the model
     csmVector<ExpressionParameterValue>* _expressionParameterValues;
 
     // Weights of the currently playing expression
     csmVector<csmFloat32>* _fadeWeights;
 
+    // Current model value of each entry of _expressionParameterValues
+    csmVector<csmFloat32>* _currentParameterValues;
+
+    // Index into _expressionParameterValues per model parameter index; -1 if not listed
+    csmVector<csmInt32>* _valueIndices;
+
+    // Model the parameter indices of _expressionParameterValues were resolved against
+    const CubismModel* _model;
+
     csmInt32 _currentPriority;    ///< @deprecated This variable is deprecated because a priority value is not actually used during expression motion playback.
     csmInt32 _reservePriority;    ///< @deprecated This variable is deprecated because a priority value is not actually used during expression motion playback.
 };
@@ -9,6 +9,7 @@
 #include <float.h>
 #include "CubismFramework.hpp"
 #include "CubismMotionInternal.hpp"
+#include "CubismMotionBinary.hpp"
 #include "CubismMotionJson.hpp"
 #include "CubismMotionQueueManager.hpp"
 #include "CubismMotionQueueEntry.hpp"
@@ -16,6 +17,11 @@
 #include "Type/csmVector.hpp"
 #include "Id/CubismIdManager.hpp"
 
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define CSM_MOTION_BAKED_SSE
+#include <xmmintrin.h>
+#endif
+
 namespace Live2D { namespace Cubism { namespace Framework {
 
 namespace {
@@ -187,41 +193,212 @@ csmFloat32 InverseSteppedEvaluate(const CubismMotionPoint* points, const csmFloa
     return points[1].Value;
 }
 
-csmFloat32 EvaluateCurve(const CubismMotionData* motionData, const csmInt32 index, csmFloat32 time)
+// セグメントの終端、つまり次のセグメントの先頭の点の時刻を取得
+csmFloat32 GetSegmentEndTime(const CubismMotionData* motionData, const csmInt32 segmentIndex)
+{
+    const CubismMotionSegment& segment = motionData->Segments[segmentIndex];
+
+    return motionData->PointData[segment.BasePointIndex
+        + (segment.SegmentType == CubismMotionSegmentType_Bezier
+            ? 3
+            : 1)].Time;
+}
+
+// [begin, end) の中で終端時刻が time を超える最初のセグメントを二分探索する。見つからなければ end を返す
+csmInt32 FindSegment(const CubismMotionData* motionData, csmInt32 begin, csmInt32 end, const csmFloat32 time)
+{
+    while (begin < end)
+    {
+        const csmInt32 middle = begin + (end - begin) / 2;
+
+        if (GetSegmentEndTime(motionData, middle) > time)
+        {
+            end = middle;
+        }
+        else
+        {
+            begin = middle + 1;
+        }
+    }
+
+    return begin;
+}
+
+/**
+ * Evaluates a curve.
+ *
+ * The segment found for the previous frame is kept in segmentCursor. While time moves forward
+ * the search resumes from there; seeks, loops and restarts fall back to a binary search.
+ *
+ * @param motionData motion data
+ * @param index curve index
+ * @param time time to evaluate at [seconds]
+ * @param segmentCursor segment found by the previous call; -1 if none
+ *
+ * @return value of the curve
+ */
+csmFloat32 EvaluateCurve(const CubismMotionData* motionData, const csmInt32 index, csmFloat32 time, csmInt32& segmentCursor)
 {
     // Find segment to evaluate.
     const CubismMotionCurve& curve = motionData->Curves[index];
 
-    csmInt32 target = -1;
-    const csmInt32 totalSegmentCount = curve.BaseSegmentIndex + curve.SegmentCount;
-    csmInt32 pointPosition = 0;
-    for (csmInt32 i = curve.BaseSegmentIndex; i < totalSegmentCount; ++i)
+    if (curve.SegmentCount <= 0)
     {
-        // Get first point of next segment.
-        pointPosition = motionData->Segments[i].BasePointIndex
-            + (motionData->Segments[i].SegmentType == CubismMotionSegmentType_Bezier
-                ? 3
-                : 1);
+        return motionData->PointData[0].Value;
+    }
 
+    const csmInt32 baseSegmentIndex = curve.BaseSegmentIndex;
+    const csmInt32 totalSegmentCount = curve.BaseSegmentIndex + curve.SegmentCount;
+    csmInt32 target = segmentCursor;
 
-        // Break if time lies within current segment.
-        if (motionData->Points[pointPosition].Time > time)
+    if (target < baseSegmentIndex || target > totalSegmentCount)
+    {
+        // カーソルが無効なら全体を探索
+        target = FindSegment(motionData, baseSegmentIndex, totalSegmentCount, time);
+    }
+    else if (target > baseSegmentIndex && GetSegmentEndTime(motionData, target - 1) > time)
+    {
+        // 時間が巻き戻った（ループ、シーク）
+        target = FindSegment(motionData, baseSegmentIndex, target, time);
+    }
+    else
+    {
+        // 時間が進んだ場合は数セグメントだけ順に進め、それでも届かなければ残りを二分探索
+        const csmInt32 MaxForwardSteps = 4;
+        csmInt32 steps = 0;
+
+        while (target < totalSegmentCount && GetSegmentEndTime(motionData, target) <= time)
         {
-            target = i;
-            break;
+            if (++steps > MaxForwardSteps)
+            {
+                target = FindSegment(motionData, target, totalSegmentCount, time);
+                break;
+            }
+
+            ++target;
         }
     }
 
+    segmentCursor = target;
 
-    if (target == -1)
+    if (target == totalSegmentCount)
     {
-        return motionData->Points[pointPosition].Value;
+        const CubismMotionSegment& lastSegment = motionData->Segments[totalSegmentCount - 1];
+
+        return motionData->PointData[lastSegment.BasePointIndex
+            + (lastSegment.SegmentType == CubismMotionSegmentType_Bezier
+                ? 3
+                : 1)].Value;
     }
 
 
     const CubismMotionSegment& segment = motionData->Segments[target];
 
-    return segment.Evaluate(&motionData->Points[segment.BasePointIndex], time);
+    return segment.Evaluate(&motionData->PointData[segment.BasePointIndex], time);
+}
+
+// コンパイル済みモーションの評価関数の種類と関数の対応
+const csmMotionSegmentEvaluationFunction BinaryEvaluators[] =
+{
+    LinearEvaluate,
+    BezierEvaluate,
+    BezierEvaluateCardanoInterpretation,
+    SteppedEvaluate,
+    InverseSteppedEvaluate,
+};
+
+const csmInt32 BinaryEvaluatorCount = sizeof(BinaryEvaluators) / sizeof(BinaryEvaluators[0]);
+
+// 評価関数ごとに読むセグメントの種類。評価関数が読む制御点の数はこれで決まる
+const csmInt32 BinaryEvaluatorSegmentTypes[] =
+{
+    CubismMotionSegmentType_Linear,
+    CubismMotionSegmentType_Bezier,
+    CubismMotionSegmentType_Bezier,
+    CubismMotionSegmentType_Stepped,
+    CubismMotionSegmentType_InverseStepped,
+};
+
+// offset から count 個の要素が 4 バイト境界に揃ってバッファ内に収まっているか
+csmBool IsBinaryTableInBuffer(const csmUint32 offset, const csmInt32 count, const csmSizeInt elementSize, const csmSizeInt bufferSize)
+{
+    if (count < 0 || (offset & 3) != 0)
+    {
+        return false;
+    }
+
+    return static_cast<csmUint64>(offset) + static_cast<csmUint64>(count) * elementSize <= bufferSize;
+}
+
+// 文字列テーブルに NUL 終端の文字列を追加し、そのオフセットを返す
+csmUint32 AppendBinaryString(csmVector<csmByte>& strings, const csmChar* value)
+{
+    const csmUint32 offset = strings.GetSize();
+
+    for (const csmChar* c = value; *c != '\0'; ++c)
+    {
+        strings.PushBack(static_cast<csmByte>(*c));
+    }
+    strings.PushBack('\0');
+
+    return offset;
+}
+
+// コンパイル元の .motion3.json を識別するハッシュ（FNV-1a）
+csmUint32 HashBinarySource(const csmByte* motionJson, const csmSizeInt size)
+{
+    csmUint32 hash = 2166136261u;
+    for (csmSizeInt i = 0; i < size; ++i)
+    {
+        hash ^= motionJson[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// 焼き込んだサンプルから全カーブの値を一度に線形補間する。values には Stride 個分の領域が必要
+void LerpBakedSamples(const CubismMotionBakedData* bakedData, csmFloat32 time, csmFloat32* values)
+{
+    csmFloat32 position = time / bakedData->Interval;
+
+    if (!(position > 0.0f))
+    {
+        position = 0.0f;
+    }
+
+    csmInt32 row = static_cast<csmInt32>(position);
+
+    if (row > bakedData->SampleCount - 2)
+    {
+        row = bakedData->SampleCount - 2;
+    }
+
+    csmFloat32 t = position - static_cast<csmFloat32>(row);
+
+    if (t > 1.0f)
+    {
+        t = 1.0f;
+    }
+
+    const csmInt32 stride = bakedData->Stride;
+    const csmFloat32* a = &bakedData->Samples[row * stride];
+    const csmFloat32* b = a + stride;
+
+#ifdef CSM_MOTION_BAKED_SSE
+    const __m128 weight = _mm_set1_ps(t);
+
+    for (csmInt32 i = 0; i < stride; i += 4)
+    {
+        const __m128 from = _mm_loadu_ps(a + i);
+        const __m128 to = _mm_loadu_ps(b + i);
+        _mm_storeu_ps(values + i, _mm_add_ps(from, _mm_mul_ps(_mm_sub_ps(to, from), weight)));
+    }
+#else
+    for (csmInt32 i = 0; i < stride; ++i)
+    {
+        values[i] = a[i] + (b[i] - a[i]) * t;
+    }
+#endif
 }
 
 }
@@ -233,6 +410,10 @@ CubismMotion::CubismMotion()
     , _isLoopFadeIn(true)           // ループ時にフェードインが有効かどうかのフラグ
     , _lastWeight(0.0f)
     , _motionData(NULL)
+    , _bakedData(NULL)
+    , _binaryBuffer(NULL)
+    , _binaryBufferSize(0)
+    , _releaseBinaryBuffer(NULL)
     , _modelCurveIdEyeBlink(NULL)
     , _modelCurveIdLipSync(NULL)
     , _modelCurveIdOpacity(NULL)
@@ -241,11 +422,22 @@ CubismMotion::CubismMotion()
 
 CubismMotion::~CubismMotion()
 {
+    ReleaseBakedData();
     CSM_DELETE(_motionData);
+
+    if (_releaseBinaryBuffer != NULL)
+    {
+        _releaseBinaryBuffer(_binaryBuffer, _binaryBufferSize);
+    }
 }
 
 CubismMotion* CubismMotion::Create(const csmByte* buffer, csmSizeInt size, FinishedMotionCallback onFinishedMotionHandler, BeganMotionCallback onBeganMotionHandler)
 {
+    if (IsBinary(buffer, size))
+    {
+        return CreateFromBinary(buffer, size, NULL, onFinishedMotionHandler, onBeganMotionHandler);
+    }
+
     CubismMotion* ret = CSM_NEW CubismMotion();
 
     ret->Parse(buffer, size);
@@ -260,6 +452,175 @@ CubismMotion* CubismMotion::Create(const csmByte* buffer, csmSizeInt size, Finis
     return ret;
 }
 
+CubismMotion* CubismMotion::CreateFromBinary(const csmByte* buffer, csmSizeInt size, BinaryBufferReleaseFunction releaseBuffer, FinishedMotionCallback onFinishedMotionHandler, BeganMotionCallback onBeganMotionHandler)
+{
+    CubismMotion* ret = CSM_NEW CubismMotion();
+
+    if (!ret->ParseBinary(buffer, size, releaseBuffer == NULL))
+    {
+        CubismLogError("Failed to parse the compiled motion.");
+        ACubismMotion::Delete(ret);
+        return NULL;
+    }
+
+    if (releaseBuffer != NULL)
+    {
+        ret->_binaryBuffer = const_cast<csmByte*>(buffer);
+        ret->_binaryBufferSize = size;
+        ret->_releaseBinaryBuffer = releaseBuffer;
+    }
+
+    ret->_sourceFrameRate = ret->_motionData->Fps;
+    ret->_loopDurationSeconds = ret->_motionData->Duration;
+    ret->_onFinishedMotion = onFinishedMotionHandler;
+    ret->_onBeganMotion = onBeganMotionHandler;
+
+    return ret;
+}
+
+csmBool CubismMotion::IsBinary(const csmByte* buffer, csmSizeInt size)
+{
+    if (buffer == NULL || size < sizeof(CubismMotionBinaryHeader))
+    {
+        return false;
+    }
+
+    csmUint32 magic;
+    memcpy(&magic, buffer, sizeof(magic));
+
+    return magic == CubismMotionBinaryMagic;
+}
+
+csmBool CubismMotion::IsBinaryCompiledFrom(const csmByte* buffer, csmSizeInt size, const csmByte* motionJson, csmSizeInt jsonSize)
+{
+    if (!IsBinary(buffer, size))
+    {
+        return false;
+    }
+
+    CubismMotionBinaryHeader header;
+    memcpy(&header, buffer, sizeof(header));
+
+    // サイズが違えばハッシュは計算しない
+    return header.Version == CubismMotionBinaryVersion
+        && header.SourceSize == jsonSize
+        && header.SourceHash == HashBinarySource(motionJson, jsonSize);
+}
+
+csmBool CubismMotion::ConvertToBinary(const csmByte* motionJson, csmSizeInt size, csmVector<csmByte>& outBinary)
+{
+    {
+        CubismMotionJson json(motionJson, size);
+
+        if (!json.IsValid())
+        {
+            return false;
+        }
+    }
+
+    CubismMotion* motion = Create(motionJson, size);
+    const CubismMotionData* motionData = motion->_motionData;
+
+    CubismMotionBinaryHeader header;
+    memset(&header, 0, sizeof(header));
+    header.Magic = CubismMotionBinaryMagic;
+    header.Version = CubismMotionBinaryVersion;
+    header.Duration = motionData->Duration;
+    header.Fps = motionData->Fps;
+    header.FadeInTime = motion->_fadeInSeconds;
+    header.FadeOutTime = motion->_fadeOutSeconds;
+    header.Loop = motionData->Loop;
+    header.CurveCount = motionData->CurveCount;
+    header.SegmentCount = motionData->Segments.GetSize();
+    header.PointCount = motionData->Points.GetSize();
+    header.EventCount = motionData->EventCount;
+    header.SourceSize = size;
+    header.SourceHash = HashBinarySource(motionJson, size);
+
+    csmVector<CubismMotionBinaryCurve> curves(header.CurveCount);
+    csmVector<CubismMotionBinarySegment> segments(header.SegmentCount);
+    csmVector<CubismMotionBinaryEvent> events(header.EventCount);
+    csmVector<csmByte> strings;
+
+    for (csmInt32 i = 0; i < header.CurveCount; ++i)
+    {
+        const CubismMotionCurve& curve = motionData->Curves[i];
+        CubismMotionBinaryCurve binaryCurve;
+        binaryCurve.Type = curve.Type;
+        binaryCurve.IdOffset = AppendBinaryString(strings, curve.Id->GetString().GetRawString());
+        binaryCurve.BaseSegmentIndex = curve.BaseSegmentIndex;
+        binaryCurve.SegmentCount = curve.SegmentCount;
+        binaryCurve.FadeInTime = curve.FadeInTime;
+        binaryCurve.FadeOutTime = curve.FadeOutTime;
+        curves.PushBack(binaryCurve);
+    }
+
+    for (csmInt32 i = 0; i < header.SegmentCount; ++i)
+    {
+        const CubismMotionSegment& segment = motionData->Segments[i];
+        CubismMotionBinarySegment binarySegment;
+        binarySegment.BasePointIndex = segment.BasePointIndex;
+        binarySegment.SegmentType = segment.SegmentType;
+        binarySegment.Evaluator = CubismMotionBinaryEvaluator_Linear;
+
+        for (csmInt32 e = 0; e < BinaryEvaluatorCount; ++e)
+        {
+            if (segment.Evaluate == BinaryEvaluators[e])
+            {
+                binarySegment.Evaluator = e;
+                break;
+            }
+        }
+
+        segments.PushBack(binarySegment);
+    }
+
+    for (csmInt32 i = 0; i < header.EventCount; ++i)
+    {
+        CubismMotionBinaryEvent binaryEvent;
+        binaryEvent.FireTime = motionData->Events[i].FireTime;
+        binaryEvent.ValueOffset = AppendBinaryString(strings, motionData->Events[i].Value.GetRawString());
+        events.PushBack(binaryEvent);
+    }
+
+    header.CurveOffset = sizeof(CubismMotionBinaryHeader);
+    header.SegmentOffset = header.CurveOffset + sizeof(CubismMotionBinaryCurve) * header.CurveCount;
+    header.PointOffset = header.SegmentOffset + sizeof(CubismMotionBinarySegment) * header.SegmentCount;
+    header.EventOffset = header.PointOffset + sizeof(CubismMotionPoint) * header.PointCount;
+    header.StringOffset = header.EventOffset + sizeof(CubismMotionBinaryEvent) * header.EventCount;
+    header.StringSize = strings.GetSize();
+
+    outBinary.Clear();
+    outBinary.Resize(header.StringOffset + header.StringSize, 0);
+
+    csmByte* output = outBinary.GetPtr();
+    memcpy(output, &header, sizeof(header));
+    if (header.CurveCount > 0)
+    {
+        memcpy(output + header.CurveOffset, curves.GetPtr(), sizeof(CubismMotionBinaryCurve) * header.CurveCount);
+    }
+    if (header.SegmentCount > 0)
+    {
+        memcpy(output + header.SegmentOffset, segments.GetPtr(), sizeof(CubismMotionBinarySegment) * header.SegmentCount);
+    }
+    if (header.PointCount > 0)
+    {
+        memcpy(output + header.PointOffset, motionData->PointData, sizeof(CubismMotionPoint) * header.PointCount);
+    }
+    if (header.EventCount > 0)
+    {
+        memcpy(output + header.EventOffset, events.GetPtr(), sizeof(CubismMotionBinaryEvent) * header.EventCount);
+    }
+    if (header.StringSize > 0)
+    {
+        memcpy(output + header.StringOffset, strings.GetPtr(), header.StringSize);
+    }
+
+    ACubismMotion::Delete(motion);
+
+    return true;
+}
+
 csmFloat32 CubismMotion::GetDuration()
 {
     return _isLoop ? -1.0f : _loopDurationSeconds;
@@ -315,6 +676,9 @@ void CubismMotion::DoUpdateParameters(CubismModel* model, csmFloat32 userTimeSec
                                       ? 1.0f
                                       : CubismMath::GetEasingSine((motionQueueEntry->GetEndTime() - userTimeSeconds) / _fadeOutSeconds);
 
+    CubismMotionBinding* binding = BindModel(model, motionQueueEntry);
+    const csmFloat32* bakedValues = NULL;
+
     csmFloat32 value;
     csmInt32 c, parameterIndex;
 
@@ -331,11 +695,20 @@ void CubismMotion::DoUpdateParameters(CubismModel* model, csmFloat32 userTimeSec
 
     csmVector<CubismMotionCurve>& curves = _motionData->Curves;
 
+    if (_bakedData != NULL)
+    {
+        binding->CurveValues.Resize(_bakedData->Stride, 0.0f);
+        LerpBakedSamples(_bakedData, time, binding->CurveValues.GetPtr());
+        bakedValues = binding->CurveValues.GetPtr();
+    }
+
     // Evaluate model curves.
     for (c = 0; c < _motionData->CurveCount && curves[c].Type == CubismMotionCurveTarget_Model; ++c)
     {
         // Evaluate curve and call handler.
-        value = EvaluateCurve(_motionData, c, time);
+        value = (bakedValues != NULL && _bakedData->CurveBaked[c])
+                    ? bakedValues[c]
+                    : EvaluateCurve(_motionData, c, time, binding->CurveSegmentCursors[c]);
 
         if (curves[c].Id == _modelCurveIdEyeBlink)
         {
@@ -361,7 +734,7 @@ void CubismMotion::DoUpdateParameters(CubismModel* model, csmFloat32 userTimeSec
         parameterMotionCurveCount++;
 
         // Find parameter index.
-        parameterIndex = model->GetParameterIndex(curves[c].Id);
+        parameterIndex = binding->CurveParameterIndices[c];
 
         // Skip curve evaluation if no value in sink.
         if (parameterIndex == -1)
@@ -372,32 +745,20 @@ void CubismMotion::DoUpdateParameters(CubismModel* model, csmFloat32 userTimeSec
         const csmFloat32 sourceValue = model->GetParameterValue(parameterIndex);
 
         // Evaluate curve and apply value.
-        value = EvaluateCurve(_motionData, c, time);
+        value = (bakedValues != NULL && _bakedData->CurveBaked[c])
+                    ? bakedValues[c]
+                    : EvaluateCurve(_motionData, c, time, binding->CurveSegmentCursors[c]);
 
-        if (eyeBlinkValue != FLT_MAX)
+        if (eyeBlinkValue != FLT_MAX && binding->CurveEyeBlinkFlags[c] != 0ULL)
         {
-            for (csmUint32 i = 0; i < _eyeBlinkParameterIds.GetSize() && i < MaxTargetSize; ++i)
-            {
-                if (_eyeBlinkParameterIds[i] == curves[c].Id)
-                {
-                    value *= eyeBlinkValue;
-                    eyeBlinkFlags |= 1ULL << i;
-                    break;
-                }
-            }
+            value *= eyeBlinkValue;
+            eyeBlinkFlags |= binding->CurveEyeBlinkFlags[c];
         }
 
-        if (lipSyncValue != FLT_MAX)
+        if (lipSyncValue != FLT_MAX && binding->CurveLipSyncFlags[c] != 0ULL)
         {
-            for (csmUint32 i = 0; i < _lipSyncParameterIds.GetSize() && i < MaxTargetSize; ++i)
-            {
-                if (_lipSyncParameterIds[i] == curves[c].Id)
-                {
-                    value += lipSyncValue;
-                    lipSyncFlags |= 1ULL << i;
-                    break;
-                }
-            }
+            value += lipSyncValue;
+            lipSyncFlags |= binding->CurveLipSyncFlags[c];
         }
 
         csmFloat32 v;
@@ -447,9 +808,9 @@ void CubismMotion::DoUpdateParameters(CubismModel* model, csmFloat32 userTimeSec
     {
         if (eyeBlinkValue != FLT_MAX)
         {
-            for (csmUint32 i = 0; i < _eyeBlinkParameterIds.GetSize() && i < MaxTargetSize; ++i)
+            for (csmUint32 i = 0; i < binding->EyeBlinkParameterIndices.GetSize(); ++i)
             {
-                const csmFloat32 sourceValue = model->GetParameterValue(_eyeBlinkParameterIds[i]);
+                const csmFloat32 sourceValue = model->GetParameterValue(binding->EyeBlinkParameterIndices[i]);
                 //モーションでの上書きがあった時にはまばたきは適用しない
                 if ((eyeBlinkFlags >> i) & 0x01)
                 {
@@ -458,15 +819,15 @@ void CubismMotion::DoUpdateParameters(CubismModel* model, csmFloat32 userTimeSec
 
                 const csmFloat32 v = sourceValue + (eyeBlinkValue - sourceValue) * fadeWeight;
 
-                model->SetParameterValue(_eyeBlinkParameterIds[i], v);
+                model->SetParameterValue(binding->EyeBlinkParameterIndices[i], v);
             }
         }
 
         if (lipSyncValue != FLT_MAX)
         {
-            for (csmUint32 i = 0; i < _lipSyncParameterIds.GetSize() && i < MaxTargetSize; ++i)
+            for (csmUint32 i = 0; i < binding->LipSyncParameterIndices.GetSize(); ++i)
             {
-                const csmFloat32 sourceValue = model->GetParameterValue(_lipSyncParameterIds[i]);
+                const csmFloat32 sourceValue = model->GetParameterValue(binding->LipSyncParameterIndices[i]);
                 //モーションでの上書きがあった時にはリップシンクは適用しない
                 if ((lipSyncFlags >> i) & 0x01)
                 {
@@ -475,7 +836,7 @@ void CubismMotion::DoUpdateParameters(CubismModel* model, csmFloat32 userTimeSec
 
                 const csmFloat32 v = sourceValue + (lipSyncValue - sourceValue) * fadeWeight;
 
-                model->SetParameterValue(_lipSyncParameterIds[i], v);
+                model->SetParameterValue(binding->LipSyncParameterIndices[i], v);
             }
         }
     }
@@ -483,7 +844,7 @@ void CubismMotion::DoUpdateParameters(CubismModel* model, csmFloat32 userTimeSec
     for (; c < _motionData->CurveCount && curves[c].Type == CubismMotionCurveTarget_PartOpacity; ++c)
     {
         // Find parameter index.
-        parameterIndex = model->GetParameterIndex(curves[c].Id);
+        parameterIndex = binding->CurveParameterIndices[c];
 
         // Skip curve evaluation if no value in sink.
         if (parameterIndex == -1)
@@ -492,7 +853,9 @@ void CubismMotion::DoUpdateParameters(CubismModel* model, csmFloat32 userTimeSec
         }
 
         // Evaluate curve and apply value.
-        value = EvaluateCurve(_motionData, c, time);
+        value = (bakedValues != NULL && _bakedData->CurveBaked[c])
+                    ? bakedValues[c]
+                    : EvaluateCurve(_motionData, c, time, binding->CurveSegmentCursors[c]);
 
         model->SetParameterValue(parameterIndex, value);
     }
@@ -522,6 +885,196 @@ void CubismMotion::DoUpdateParameters(CubismModel* model, csmFloat32 userTimeSec
     _lastWeight = fadeWeight;
 }
 
+CubismMotionBinding* CubismMotion::BindModel(CubismModel* model, CubismMotionQueueEntry* motionQueueEntry)
+{
+    CubismMotionBinding* binding = motionQueueEntry->_motionBinding;
+
+    if (binding != NULL && binding->Model == model)
+    {
+        return binding;
+    }
+
+    if (binding == NULL)
+    {
+        binding = CSM_NEW CubismMotionBinding();
+        motionQueueEntry->_motionBinding = binding;
+    }
+
+    //まばたき、リップシンクのうちモーションの適用を検出するためのビット（maxFlagCount個まで
+    const csmUint32 MaxTargetSize = 64;
+    const csmUint32 eyeBlinkCount = _eyeBlinkParameterIds.GetSize() < MaxTargetSize ? _eyeBlinkParameterIds.GetSize() : MaxTargetSize;
+    const csmUint32 lipSyncCount = _lipSyncParameterIds.GetSize() < MaxTargetSize ? _lipSyncParameterIds.GetSize() : MaxTargetSize;
+    const csmVector<CubismMotionCurve>& curves = _motionData->Curves;
+
+    binding->Model = model;
+    binding->CurveParameterIndices.Resize(_motionData->CurveCount, -1);
+    binding->CurveEyeBlinkFlags.Resize(_motionData->CurveCount, 0ULL);
+    binding->CurveLipSyncFlags.Resize(_motionData->CurveCount, 0ULL);
+    binding->CurveSegmentCursors.Resize(_motionData->CurveCount, -1);
+    binding->EyeBlinkParameterIndices.Resize(eyeBlinkCount, -1);
+    binding->LipSyncParameterIndices.Resize(lipSyncCount, -1);
+
+    for (csmInt32 c = 0; c < _motionData->CurveCount; ++c)
+    {
+        binding->CurveParameterIndices[c] = -1;
+        binding->CurveEyeBlinkFlags[c] = 0ULL;
+        binding->CurveLipSyncFlags[c] = 0ULL;
+        binding->CurveSegmentCursors[c] = -1;
+
+        if (curves[c].Type == CubismMotionCurveTarget_Model)
+        {
+            continue;
+        }
+
+        binding->CurveParameterIndices[c] = model->GetParameterIndex(curves[c].Id);
+
+        if (curves[c].Type != CubismMotionCurveTarget_Parameter)
+        {
+            continue;
+        }
+
+        for (csmUint32 i = 0; i < eyeBlinkCount; ++i)
+        {
+            if (_eyeBlinkParameterIds[i] == curves[c].Id)
+            {
+                binding->CurveEyeBlinkFlags[c] = 1ULL << i;
+                break;
+            }
+        }
+
+        for (csmUint32 i = 0; i < lipSyncCount; ++i)
+        {
+            if (_lipSyncParameterIds[i] == curves[c].Id)
+            {
+                binding->CurveLipSyncFlags[c] = 1ULL << i;
+                break;
+            }
+        }
+    }
+
+    for (csmUint32 i = 0; i < eyeBlinkCount; ++i)
+    {
+        binding->EyeBlinkParameterIndices[i] = model->GetParameterIndex(_eyeBlinkParameterIds[i]);
+    }
+
+    for (csmUint32 i = 0; i < lipSyncCount; ++i)
+    {
+        binding->LipSyncParameterIndices[i] = model->GetParameterIndex(_lipSyncParameterIds[i]);
+    }
+
+    return binding;
+}
+
+csmBool CubismMotion::ParseBinary(const csmByte* buffer, const csmSizeInt size, csmBool copyPoints)
+{
+    _motionData = CSM_NEW CubismMotionData;
+
+    // テーブルは 4 バイト境界に置かれているため、そのまま参照するにはバッファも揃っている必要がある
+    if (!IsBinary(buffer, size) || (reinterpret_cast<csmSizeType>(buffer) & 3) != 0)
+    {
+        return false;
+    }
+
+    const CubismMotionBinaryHeader* header = reinterpret_cast<const CubismMotionBinaryHeader*>(buffer);
+
+    if (header->Version != CubismMotionBinaryVersion
+        || header->CurveCount > 0x7FFF
+        || !IsBinaryTableInBuffer(header->CurveOffset, header->CurveCount, sizeof(CubismMotionBinaryCurve), size)
+        || !IsBinaryTableInBuffer(header->SegmentOffset, header->SegmentCount, sizeof(CubismMotionBinarySegment), size)
+        || !IsBinaryTableInBuffer(header->PointOffset, header->PointCount, sizeof(CubismMotionPoint), size)
+        || !IsBinaryTableInBuffer(header->EventOffset, header->EventCount, sizeof(CubismMotionBinaryEvent), size)
+        || static_cast<csmUint64>(header->StringOffset) + header->StringSize > size
+        || (header->StringSize > 0 && buffer[header->StringOffset + header->StringSize - 1] != '\0'))
+    {
+        return false;
+    }
+
+    const CubismMotionBinaryCurve* binaryCurves = reinterpret_cast<const CubismMotionBinaryCurve*>(buffer + header->CurveOffset);
+    const CubismMotionBinarySegment* binarySegments = reinterpret_cast<const CubismMotionBinarySegment*>(buffer + header->SegmentOffset);
+    const CubismMotionPoint* points = reinterpret_cast<const CubismMotionPoint*>(buffer + header->PointOffset);
+    const CubismMotionBinaryEvent* binaryEvents = reinterpret_cast<const CubismMotionBinaryEvent*>(buffer + header->EventOffset);
+    const csmChar* strings = reinterpret_cast<const csmChar*>(buffer + header->StringOffset);
+
+    _motionData->Duration = header->Duration;
+    _motionData->Loop = static_cast<csmInt16>(header->Loop);
+    _motionData->CurveCount = static_cast<csmInt16>(header->CurveCount);
+    _motionData->Fps = header->Fps;
+    _motionData->EventCount = header->EventCount;
+
+    _fadeInSeconds = header->FadeInTime;
+    _fadeOutSeconds = header->FadeOutTime;
+
+    _motionData->Curves.UpdateSize(header->CurveCount, CubismMotionCurve(), true);
+    _motionData->Segments.UpdateSize(header->SegmentCount, CubismMotionSegment(), true);
+    _motionData->Events.UpdateSize(header->EventCount, CubismMotionEvent(), true);
+
+    for (csmInt32 i = 0; i < header->CurveCount; ++i)
+    {
+        const CubismMotionBinaryCurve& binaryCurve = binaryCurves[i];
+
+        if (binaryCurve.Type < CubismMotionCurveTarget_Model || binaryCurve.Type > CubismMotionCurveTarget_PartOpacity
+            || binaryCurve.IdOffset >= header->StringSize
+            || binaryCurve.BaseSegmentIndex < 0 || binaryCurve.SegmentCount < 0
+            || binaryCurve.BaseSegmentIndex > header->SegmentCount - binaryCurve.SegmentCount)
+        {
+            return false;
+        }
+
+        CubismMotionCurve& curve = _motionData->Curves[i];
+        curve.Type = static_cast<CubismMotionCurveTarget>(binaryCurve.Type);
+        curve.Id = CubismFramework::GetIdManager()->GetId(strings + binaryCurve.IdOffset);
+        curve.BaseSegmentIndex = binaryCurve.BaseSegmentIndex;
+        curve.SegmentCount = binaryCurve.SegmentCount;
+        curve.FadeInTime = binaryCurve.FadeInTime;
+        curve.FadeOutTime = binaryCurve.FadeOutTime;
+    }
+
+    for (csmInt32 i = 0; i < header->SegmentCount; ++i)
+    {
+        const CubismMotionBinarySegment& binarySegment = binarySegments[i];
+        const csmInt32 lastPointOffset = (binarySegment.SegmentType == CubismMotionSegmentType_Bezier) ? 3 : 1;
+
+        if (binarySegment.Evaluator < 0 || binarySegment.Evaluator >= BinaryEvaluatorCount
+            || binarySegment.SegmentType != BinaryEvaluatorSegmentTypes[binarySegment.Evaluator]
+            || binarySegment.BasePointIndex < 0 || binarySegment.BasePointIndex >= header->PointCount - lastPointOffset)
+        {
+            return false;
+        }
+
+        CubismMotionSegment& segment = _motionData->Segments[i];
+        segment.Evaluate = BinaryEvaluators[binarySegment.Evaluator];
+        segment.BasePointIndex = binarySegment.BasePointIndex;
+        segment.SegmentType = binarySegment.SegmentType;
+    }
+
+    for (csmInt32 i = 0; i < header->EventCount; ++i)
+    {
+        if (binaryEvents[i].ValueOffset >= header->StringSize)
+        {
+            return false;
+        }
+
+        _motionData->Events[i].FireTime = binaryEvents[i].FireTime;
+        _motionData->Events[i].Value = strings + binaryEvents[i].ValueOffset;
+    }
+
+    if (copyPoints)
+    {
+        _motionData->Points.UpdateSize(header->PointCount, CubismMotionPoint(), true);
+        if (header->PointCount > 0)
+        {
+            memcpy(_motionData->Points.GetPtr(), points, sizeof(CubismMotionPoint) * header->PointCount);
+        }
+        _motionData->PointData = _motionData->Points.GetPtr();
+    }
+    else
+    {
+        _motionData->PointData = points;
+    }
+
+    return true;
+}
+
 void CubismMotion::Parse(const csmByte* motionJson, const csmSizeInt size)
 {
     _motionData = CSM_NEW CubismMotionData;
@@ -709,6 +1262,8 @@ void CubismMotion::Parse(const csmByte* motionJson, const csmSizeInt size)
         _motionData->Events[userdatacount].Value = json->GetEventValue(userdatacount);
     }
 
+    _motionData->PointData = _motionData->Points.GetPtr();
+
     CSM_DELETE(json);
 }
 
@@ -883,4 +1438,149 @@ csmFloat32 CubismMotion::GetModelOpacityValue() const
     return _modelOpacity;
 }
 
+csmInt32 CubismMotion::Bake(csmFloat32 sampleRate, csmFloat32 maxError)
+{
+    ReleaseBakedData();
+
+    if (sampleRate <= 0.0f || _motionData->Duration <= 0.0f || _motionData->CurveCount <= 0)
+    {
+        return 0;
+    }
+
+    // サンプル間の誤差を測る分割数。粗いとベジェの山を見落として再生時に maxError を超える
+    const csmInt32 ErrorCheckDivision = 32;
+
+    const csmInt32 curveCount = _motionData->CurveCount;
+    csmInt32 intervalCount = static_cast<csmInt32>(_motionData->Duration * sampleRate);
+
+    if (static_cast<csmFloat32>(intervalCount) < _motionData->Duration * sampleRate || intervalCount < 1)
+    {
+        ++intervalCount;
+    }
+
+    const csmInt32 sampleCount = intervalCount + 1;
+
+    CubismMotionBakedData* bakedData = CSM_NEW CubismMotionBakedData();
+    bakedData->SampleCount = sampleCount;
+    bakedData->Stride = (curveCount + 3) & ~3;
+    bakedData->Interval = _motionData->Duration / static_cast<csmFloat32>(sampleCount - 1);
+    bakedData->Samples.Resize(sampleCount * bakedData->Stride, 0.0f);
+    bakedData->CurveBaked.Resize(curveCount, true);
+
+    csmVector<csmInt32> cursors;
+    cursors.Resize(curveCount, -1);
+
+    for (csmInt32 k = 0; k < sampleCount; ++k)
+    {
+        const csmFloat32 time = (k == sampleCount - 1) ? _motionData->Duration : bakedData->Interval * static_cast<csmFloat32>(k);
+        csmFloat32* row = bakedData->Samples.GetPtr() + k * bakedData->Stride;
+
+        for (csmInt32 c = 0; c < curveCount; ++c)
+        {
+            row[c] = EvaluateCurve(_motionData, c, time, cursors[c]);
+        }
+    }
+
+    csmInt32 bakedCount = 0;
+
+    for (csmInt32 c = 0; c < curveCount; ++c)
+    {
+        csmFloat32 curveError = 0.0f;
+        csmInt32 cursor = -1;
+
+        for (csmInt32 k = 0; k < sampleCount - 1 && curveError <= maxError; ++k)
+        {
+            const csmFloat32 from = bakedData->Samples[k * bakedData->Stride + c];
+            const csmFloat32 to = bakedData->Samples[(k + 1) * bakedData->Stride + c];
+
+            for (csmInt32 d = 1; d < ErrorCheckDivision; ++d)
+            {
+                const csmFloat32 t = static_cast<csmFloat32>(d) / static_cast<csmFloat32>(ErrorCheckDivision);
+                const csmFloat32 time = bakedData->Interval * (static_cast<csmFloat32>(k) + t);
+                const csmFloat32 error = CubismMath::AbsF(from + (to - from) * t - EvaluateCurve(_motionData, c, time, cursor));
+
+                if (error > curveError)
+                {
+                    curveError = error;
+                }
+            }
+        }
+
+        if (curveError > maxError)
+        {
+            bakedData->CurveBaked[c] = false;
+            continue;
+        }
+
+        if (curveError > bakedData->MaxError)
+        {
+            bakedData->MaxError = curveError;
+        }
+
+        ++bakedCount;
+    }
+
+    if (bakedCount == 0)
+    {
+        CSM_DELETE(bakedData);
+        return 0;
+    }
+
+    _bakedData = bakedData;
+
+    return bakedCount;
+}
+
+void CubismMotion::ReleaseBakedData()
+{
+    if (_bakedData != NULL)
+    {
+        CSM_DELETE(_bakedData);
+        _bakedData = NULL;
+    }
+}
+
+csmBool CubismMotion::IsBaked() const
+{
+    return _bakedData != NULL;
+}
+
+csmSizeInt CubismMotion::GetBakedDataSize() const
+{
+    if (_bakedData == NULL)
+    {
+        return 0;
+    }
+
+    return sizeof(CubismMotionBakedData)
+        + sizeof(csmFloat32) * _bakedData->Samples.GetSize()
+        + sizeof(csmBool) * _bakedData->CurveBaked.GetSize();
+}
+
+csmFloat32 CubismMotion::GetBakedMaxError() const
+{
+    return (_bakedData != NULL) ? _bakedData->MaxError : 0.0f;
+}
+
+csmSizeInt CubismMotion::GetDataSize() const
+{
+    csmSizeInt size = sizeof(CubismMotion) + GetBakedDataSize() + _binaryBufferSize;
+
+    if (_motionData != NULL)
+    {
+        size += sizeof(CubismMotionData)
+            + sizeof(CubismMotionCurve) * _motionData->Curves.GetSize()
+            + sizeof(CubismMotionSegment) * _motionData->Segments.GetSize()
+            + sizeof(CubismMotionPoint) * _motionData->Points.GetSize()
+            + sizeof(CubismMotionEvent) * _motionData->Events.GetSize();
+
+        for (csmUint32 i = 0; i < _motionData->Events.GetSize(); ++i)
+        {
+            size += _motionData->Events[i].Value.GetLength();
+        }
+    }
+
+    return size;
+}
+
 }}}
@@ -16,6 +16,8 @@ namespace Live2D { namespace Cubism { namespace Framework {
 
 class CubismMotionQueueEntry;
 struct CubismMotionData;
+struct CubismMotionBinding;
+struct CubismMotionBakedData;
 
 /**
  * Handles motions.
@@ -23,6 +25,14 @@ struct CubismMotionData;
 class CubismMotion : public ACubismMotion
 {
 public:
+    /**
+     * Function that releases the buffer of a compiled motion.
+     *
+     * @param buffer buffer passed to CreateFromBinary()
+     * @param size size of the buffer in bytes
+     */
+    typedef void (*BinaryBufferReleaseFunction)(csmByte* buffer, csmSizeInt size);
+
     /**
      * Makes an instance.
      *
@@ -34,6 +44,56 @@ public:
      */
     static CubismMotion* Create(const csmByte* buffer, csmSizeInt size, FinishedMotionCallback onFinishedMotionHandler = NULL, BeganMotionCallback onBeganMotionHandler = NULL);
 
+    /**
+     * Makes an instance from a compiled motion.
+     *
+     * With a release function the instance takes ownership of the buffer and evaluates the control
+     * points in place, so the buffer can be a memory-mapped file. The function is called when the
+     * instance is deleted. Without one, the control points are copied and the caller keeps the buffer.
+     *
+     * @param buffer buffer containing the compiled motion
+     * @param size size of the buffer in bytes
+     * @param releaseBuffer function that releases the buffer; NULL to copy the control points
+     * @param onFinishedMotionHandler callback function for when motion playback ends
+     * @param onBeganMotionHandler callback function for when motion playback starts
+     *
+     * @return created instance; NULL if the buffer is not a valid compiled motion. The buffer is not released in that case.
+     */
+    static CubismMotion* CreateFromBinary(const csmByte* buffer, csmSizeInt size, BinaryBufferReleaseFunction releaseBuffer = NULL, FinishedMotionCallback onFinishedMotionHandler = NULL, BeganMotionCallback onBeganMotionHandler = NULL);
+
+    /**
+     * Checks whether a buffer holds a compiled motion.
+     *
+     * @param buffer buffer containing a motion file
+     * @param size size of the buffer in bytes
+     *
+     * @return true if the buffer starts with the header of a compiled motion; otherwise false.
+     */
+    static csmBool IsBinary(const csmByte* buffer, csmSizeInt size);
+
+    /**
+     * Checks whether a compiled motion was compiled from the given .motion3.json.
+     *
+     * @param buffer buffer containing the compiled motion
+     * @param size size of the compiled motion in bytes
+     * @param motionJson buffer containing the .motion3.json
+     * @param jsonSize size of the .motion3.json in bytes
+     *
+     * @return true if the compiled motion records the size and hash of this .motion3.json; false if it is stale or not a compiled motion.
+     */
+    static csmBool IsBinaryCompiledFrom(const csmByte* buffer, csmSizeInt size, const csmByte* motionJson, csmSizeInt jsonSize);
+
+    /**
+     * Compiles a .motion3.json into the binary motion format.
+     *
+     * @param motionJson buffer containing the .motion3.json
+     * @param size size of the buffer in bytes
+     * @param outBinary buffer that receives the compiled motion
+     *
+     * @return true if the motion was compiled; false if the JSON is invalid.
+     */
+    static csmBool ConvertToBinary(const csmByte* motionJson, csmSizeInt size, csmVector<csmByte>& outBinary);
+
     /**
      * Updates the model parameters.
      *
@@ -166,6 +226,53 @@ public:
      */
     CubismIdHandle GetModelOpacityId(csmInt32 index);
 
+    /**
+     * Samples the curves at a fixed rate so that playback only interpolates linearly between samples.
+     *
+     * The deviation from the analytic curves is measured between the samples.
+     * Curves that deviate by more than maxError keep being evaluated analytically.
+     * Calling this again replaces the previous samples.
+     *
+     * @param sampleRate number of samples per second
+     * @param maxError allowed deviation from the analytic curves
+     *
+     * @return number of curves that were baked
+     */
+    csmInt32 Bake(csmFloat32 sampleRate, csmFloat32 maxError);
+
+    /**
+     * Releases the baked samples and returns to analytic evaluation.
+     */
+    void ReleaseBakedData();
+
+    /**
+     * Checks whether the motion has baked samples.
+     *
+     * @return true if baked; otherwise false.
+     */
+    csmBool IsBaked() const;
+
+    /**
+     * Returns the size of the baked samples.
+     *
+     * @return size in bytes; 0 if not baked.
+     */
+    csmSizeInt GetBakedDataSize() const;
+
+    /**
+     * Returns the largest measured deviation of the baked curves from the analytic curves.
+     *
+     * @return largest deviation; 0 if not baked.
+     */
+    csmFloat32 GetBakedMaxError() const;
+
+    /**
+     * Returns the memory held by the motion data.
+     *
+     * @return size in bytes, including baked samples and the buffer of a compiled motion
+     */
+    csmSizeInt GetDataSize() const;
+
 protected:
     csmFloat32 GetModelOpacityValue() const;
 
@@ -179,6 +286,20 @@ private:
 
     void Parse(const csmByte* motionJson, const csmSizeInt size);
 
+    csmBool ParseBinary(const csmByte* buffer, const csmSizeInt size, csmBool copyPoints);
+
+    /**
+     * Returns the indices of the curve targets resolved against the model.
+     *
+     * The lookup runs only once per queue entry; later frames reuse the cached result.
+     *
+     * @param model model the motion is applied to
+     * @param motionQueueEntry motion being played
+     *
+     * @return resolved indices
+     */
+    CubismMotionBinding* BindModel(CubismModel* model, CubismMotionQueueEntry* motionQueueEntry);
+
     csmFloat32      _sourceFrameRate;
     csmFloat32      _loopDurationSeconds;
     csmBool         _isLoop;
@@ -186,6 +307,11 @@ private:
     csmFloat32      _lastWeight;
 
     CubismMotionData*    _motionData;
+    CubismMotionBakedData*  _bakedData;
+
+    csmByte*                    _binaryBuffer;          ///< Compiled motion the control points refer to
+    csmSizeInt                  _binaryBufferSize;
+    BinaryBufferReleaseFunction _releaseBinaryBuffer;
 
     csmVector<CubismIdHandle>  _eyeBlinkParameterIds;
     csmVector<CubismIdHandle>  _lipSyncParameterIds;
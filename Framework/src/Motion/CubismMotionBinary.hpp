@@ -0,0 +1,98 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#pragma once
+
+#include "CubismFramework.hpp"
+
+namespace Live2D { namespace Cubism { namespace Framework {
+
+/**
+ * Layout of compiled (binary) motion files
+ *
+ * A compiled motion starts with CubismMotionBinaryHeader, followed by the curve, segment,
+ * point and event tables and a string table. Every table starts on a 4-byte boundary and
+ * all values are stored in the byte order of the machine that compiled the file.
+ * The point table has the same layout as CubismMotionPoint, so it is used in place.
+ * The header records the size and hash of the .motion3.json it was compiled from, so a
+ * compiled motion that is older than its source can be detected.
+ */
+
+const csmUint32 CubismMotionBinaryMagic = 0x42334D43;     ///< "CM3B"
+const csmUint32 CubismMotionBinaryVersion = 2;            ///< Format version
+
+/**
+ * Evaluation functions of segments in compiled motions
+ */
+enum CubismMotionBinaryEvaluator
+{
+    CubismMotionBinaryEvaluator_Linear = 0,                 ///< Linear
+    CubismMotionBinaryEvaluator_Bezier = 1,                 ///< Bezier curve with restricted control points
+    CubismMotionBinaryEvaluator_BezierCardano = 2,          ///< Bezier curve solved with the Cardano algorithm
+    CubismMotionBinaryEvaluator_Stepped = 3,                ///< Step
+    CubismMotionBinaryEvaluator_InverseStepped = 4          ///< Inverse step
+};
+
+/**
+ * Header of a compiled motion
+ */
+struct CubismMotionBinaryHeader
+{
+    csmUint32 Magic;            ///< CubismMotionBinaryMagic
+    csmUint32 Version;          ///< CubismMotionBinaryVersion
+    csmFloat32 Duration;        ///< Motion length [seconds]
+    csmFloat32 Fps;             ///< Motion frame rate
+    csmFloat32 FadeInTime;      ///< Fade-in time of the whole motion [seconds]
+    csmFloat32 FadeOutTime;     ///< Fade-out time of the whole motion [seconds]
+    csmInt32 Loop;              ///< Whether to loop
+    csmInt32 CurveCount;        ///< Number of curves
+    csmInt32 SegmentCount;      ///< Number of segments
+    csmInt32 PointCount;        ///< Number of control points
+    csmInt32 EventCount;        ///< Number of user data events
+    csmUint32 CurveOffset;      ///< Offset of the curve table [bytes]
+    csmUint32 SegmentOffset;    ///< Offset of the segment table [bytes]
+    csmUint32 PointOffset;      ///< Offset of the point table [bytes]
+    csmUint32 EventOffset;      ///< Offset of the event table [bytes]
+    csmUint32 StringOffset;     ///< Offset of the string table [bytes]
+    csmUint32 StringSize;       ///< Size of the string table [bytes]
+    csmUint32 SourceSize;       ///< Size of the source .motion3.json [bytes]
+    csmUint32 SourceHash;       ///< FNV-1a hash of the source .motion3.json
+};
+
+/**
+ * Curve in a compiled motion
+ */
+struct CubismMotionBinaryCurve
+{
+    csmInt32 Type;                  ///< CubismMotionCurveTarget
+    csmUint32 IdOffset;             ///< Offset of the ID in the string table
+    csmInt32 BaseSegmentIndex;      ///< Index of the first segment
+    csmInt32 SegmentCount;          ///< Number of segments
+    csmFloat32 FadeInTime;          ///< Fade-in time [seconds]; negative if not set
+    csmFloat32 FadeOutTime;         ///< Fade-out time [seconds]; negative if not set
+};
+
+/**
+ * Segment in a compiled motion
+ */
+struct CubismMotionBinarySegment
+{
+    csmInt32 BasePointIndex;        ///< Index of the first control point
+    csmInt32 SegmentType;           ///< CubismMotionSegmentType
+    csmInt32 Evaluator;             ///< CubismMotionBinaryEvaluator
+};
+
+/**
+ * User data event in a compiled motion
+ */
+struct CubismMotionBinaryEvent
+{
+    csmFloat32 FireTime;            ///< Seconds in motion when the event fires [seconds]
+    csmUint32 ValueOffset;          ///< Offset of the value in the string table
+};
+
+}}}
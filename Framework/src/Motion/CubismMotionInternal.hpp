@@ -11,6 +11,8 @@
 
 namespace Live2D { namespace Cubism { namespace Framework {
 
+class CubismModel;
+
 /**
  * Types of motion curve application targets
  */
@@ -130,6 +132,7 @@ struct CubismMotionData
         , CurveCount(0)
         , EventCount(0)
         , Fps(0.0f)
+        , PointData(NULL)
     { }
 
     csmFloat32 Duration;                            ///< Motion length [seconds]
@@ -140,7 +143,79 @@ struct CubismMotionData
     csmVector<CubismMotionCurve> Curves;            ///< Curve collection
     csmVector<CubismMotionSegment> Segments;        ///< Segment collection
     csmVector<CubismMotionPoint> Points;            ///< Control point collection
+    const CubismMotionPoint* PointData;             ///< Control points used for evaluation; Points, or the point table of a compiled motion
     csmVector<CubismMotionEvent> Events;            ///< User data event collection
 };
 
+/**
+ * Curves of a motion sampled at a fixed rate
+ *
+ * Row k holds the value of every curve at k * Interval seconds, so playback interpolates
+ * all curves at once between two adjacent rows.
+ */
+struct CubismMotionBakedData
+{
+    /**
+     * Constructor
+     */
+    CubismMotionBakedData()
+        : SampleCount(0)
+        , Stride(0)
+        , Interval(0.0f)
+        , MaxError(0.0f)
+    { }
+
+    csmInt32 SampleCount;                   ///< Number of rows
+    csmInt32 Stride;                        ///< Floats per row; the curve count rounded up to a multiple of 4
+    csmFloat32 Interval;                    ///< Time between rows [seconds]
+    csmFloat32 MaxError;                    ///< Largest measured deviation from the analytic curves among baked curves
+    csmVector<csmFloat32> Samples;          ///< Rows of curve values
+    csmVector<csmBool> CurveBaked;          ///< Whether each curve stayed within the error bound; others are evaluated analytically
+};
+
+/**
+ * Model-specific lookup results of a motion
+ *
+ * Resolved once when a motion starts playing on a model so that per-frame evaluation
+ * only reads flat index arrays.
+ */
+struct CubismMotionBinding
+{
+    /**
+     * Constructor
+     */
+    CubismMotionBinding()
+        : Model(NULL)
+    { }
+
+    const CubismModel* Model;                       ///< Model the indices were resolved against
+    csmVector<csmInt32> CurveParameterIndices;      ///< Parameter index per curve; -1 for model curves
+    csmVector<csmUint64> CurveEyeBlinkFlags;        ///< Bit of the eye blink target each curve overrides; 0 if none
+    csmVector<csmUint64> CurveLipSyncFlags;         ///< Bit of the lip sync target each curve overrides; 0 if none
+    csmVector<csmInt32> CurveSegmentCursors;        ///< Segment evaluated last per curve; -1 if not evaluated yet
+    csmVector<csmFloat32> CurveValues;              ///< Curve values interpolated from the baked samples for the current frame
+    csmVector<csmInt32> EyeBlinkParameterIndices;   ///< Parameter index per eye blink target
+    csmVector<csmInt32> LipSyncParameterIndices;    ///< Parameter index per lip sync target
+};
+
+/**
+ * Model-specific lookup results of a facial expression motion
+ *
+ * Resolved by CubismExpressionMotionManager when an expression starts playing so that
+ * blending works on the manager's value list by index.
+ */
+struct CubismExpressionBinding
+{
+    /**
+     * Constructor
+     */
+    CubismExpressionBinding()
+        : Model(NULL)
+    { }
+
+    const CubismModel* Model;                       ///< Model the indices were resolved against
+    csmVector<csmInt32> ValueIndices;               ///< Index into the manager's value list per expression parameter; -1 if the parameter is skipped
+    csmVector<csmFloat32> BlendedValues;            ///< Additive, multiply and overwrite value per expression parameter for the current frame
+};
+
 }}}
@@ -7,6 +7,7 @@
 
 #include "CubismMotionQueueEntry.hpp"
 #include "CubismFramework.hpp"
+#include "CubismMotionInternal.hpp"
 
 namespace Live2D { namespace Cubism { namespace Framework {
 
@@ -25,6 +26,8 @@ CubismMotionQueueEntry::CubismMotionQueueEntry()
     , _motionQueueEntryHandle(NULL)
     , _fadeOutSeconds(0.0f)
     , _IsTriggeredFadeOut(false)
+    , _motionBinding(NULL)
+    , _expressionBinding(NULL)
 {
     this->_motionQueueEntryHandle = this;
 }
@@ -35,6 +38,16 @@ CubismMotionQueueEntry::~CubismMotionQueueEntry()
     {
         ACubismMotion::Delete(_motion); //
     }
+
+    if (_motionBinding)
+    {
+        CSM_DELETE(_motionBinding);
+    }
+
+    if (_expressionBinding)
+    {
+        CSM_DELETE(_expressionBinding);
+    }
 }
 
 void CubismMotionQueueEntry::SetFadeout(csmFloat32 fadeOutSeconds)
@@ -14,6 +14,8 @@
 namespace Live2D { namespace Cubism { namespace Framework {
 
 class CubismMotion;
+struct CubismMotionBinding;
+struct CubismExpressionBinding;
 
 /**
  * Handles adding information to the motion data for use by the CubismMotionQueueManager.
@@ -23,6 +25,8 @@ class CubismMotionQueueEntry
     friend class CubismMotionQueueManager;
     friend class ACubismMotion;
     friend class CubismMotion;
+    friend class CubismExpressionMotion;
+    friend class CubismExpressionMotionManager;
 
 public:
     /**
@@ -203,6 +207,9 @@ private:
     csmBool         _IsTriggeredFadeOut;
 
     CubismMotionQueueEntryHandle  _motionQueueEntryHandle;
+
+    CubismMotionBinding*    _motionBinding;     ///< Indices resolved by CubismMotion for the model playing this entry
+    CubismExpressionBinding* _expressionBinding; ///< Indices resolved by CubismExpressionMotionManager for the model playing this entry
 };
 
 }}}
@@ -225,6 +225,19 @@ csmBool CubismMotionQueueManager::IsFinished()
     return true;
 }
 
+csmBool CubismMotionQueueManager::IsMotionQueued(const ACubismMotion* motion) const
+{
+    for (csmUint32 i = 0; i < _motions.GetSize(); ++i)
+    {
+        if (_motions[i] != NULL && _motions[i]->_motion == motion)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
 csmBool CubismMotionQueueManager::IsFinished(CubismMotionQueueEntryHandle motionQueueEntryNumber)
 {
     // 既にモーションがあれば終了フラグを立てる
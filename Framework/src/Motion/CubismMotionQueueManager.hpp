@@ -93,6 +93,17 @@ public:
      */
     csmBool     IsFinished(CubismMotionQueueEntryHandle motionQueueEntryNumber);
 
+    /**
+     * Checks whether the queue still refers to the motion.
+     *
+     * A motion must not be deleted while this returns true.
+     *
+     * @param motion motion to check
+     *
+     * @return true if a queue entry refers to the motion; otherwise false.
+     */
+    csmBool     IsMotionQueued(const ACubismMotion* motion) const;
+
     /**
      * Ends the playback of all motions.
      */
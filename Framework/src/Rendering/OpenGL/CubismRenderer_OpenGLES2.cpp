@@ -10,11 +10,25 @@
 #include "Type/csmVector.hpp"
 #include "Model/CubismModel.hpp"
 #include <float.h>
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
 
 #ifdef CSM_TARGET_WIN_GL
 #include <Windows.h>
 #endif
 
+#ifdef CSM_TARGET_MAC_GL
+#include <OpenGL/OpenGL.h>
+#endif
+
+#ifdef CSM_TARGET_LINUX_GL
+#include <dlfcn.h>
+#endif
+
 #define CSM_FRAGMENT_SHADER_FP_PRECISION_HIGH "highp"
 #define CSM_FRAGMENT_SHADER_FP_PRECISION_MID "mediump"
 #define CSM_FRAGMENT_SHADER_FP_PRECISION_LOW "lowp"
@@ -46,22 +60,13 @@ void CubismClippingManager_OpenGLES2::SetupClippingContext(CubismModel& model, C
         }
     }
 
+    renderer->_drawStatistics.ClippingMaskCount = usingClipCount;
+
     if (usingClipCount <= 0)
     {
         return;
     }
 
-    // マスク作成処理
-    // 生成したOffscreenSurfaceと同じサイズでビューポートを設定
-    glViewport(0, 0, _clippingMaskBufferSize.X, _clippingMaskBufferSize.Y);
-
-    // 後の計算のためにインデックスの最初をセット
-    _currentMaskBuffer = renderer->GetMaskBuffer(0);
-    // ----- マスク描画処理 -----
-    _currentMaskBuffer->BeginDraw(lastFBO);
-
-    renderer->PreDraw(); // バッファをクリアする
-
     // 各マスクのレイアウトを決定していく
     SetupLayoutBounds(usingClipCount);
 
@@ -84,31 +89,35 @@ void CubismClippingManager_OpenGLES2::SetupClippingContext(CubismModel& model, C
         }
     }
 
-    // 実際にマスクを生成する
-    // 全てのマスクをどの様にレイアウトして描くかを決定し、ClipContext , ClippedDrawContext に記憶する
+    // マスクの描画は割り当てられたチャンネルにしか書き込まないため、チャンネル単位でクリアして描き直せば
+    // 他のチャンネルのマスクは前回描いたものをそのまま使える
+    const csmInt32 channelFlagCount = _renderTextureCount * ColorChannelCount;
+    if (_dirtyChannelFlags.GetSize() != static_cast<csmUint32>(channelFlagCount))
+    {
+        _dirtyChannelFlags.Clear();
+
+        for (csmInt32 i = 0; i < channelFlagCount; ++i)
+        {
+            _dirtyChannelFlags.PushBack(false);
+        }
+    }
+    else
+    {
+        for (csmInt32 i = 0; i < channelFlagCount; ++i)
+        {
+            _dirtyChannelFlags[i] = false;
+        }
+    }
+
+    // 全てのマスクの行列を求め、前回から変わったマスクのチャンネルを描き直す対象にする
+    csmBool isDirty = false;
     for (csmUint32 clipIndex = 0; clipIndex < _clippingContextListForMask.GetSize(); clipIndex++)
     {
-        // --- 実際に１つのマスクを描く ---
         CubismClippingContext_OpenGLES2* clipContext = _clippingContextListForMask[clipIndex];
         csmRectF* allClippedDrawRect = clipContext->_allClippedDrawRect; //このマスクを使う、全ての描画オブジェクトの論理座標上の囲み矩形
         csmRectF* layoutBoundsOnTex01 = clipContext->_layoutBounds; //この中にマスクを収める
         const csmFloat32 MARGIN = 0.05f;
 
-        // clipContextに設定したオフスクリーンサーフェイスをインデックスで取得
-        CubismOffscreenSurface_OpenGLES2* clipContextOffscreenSurface = renderer->GetMaskBuffer(clipContext->_bufferIndex);
-
-        // 現在のオフスクリーンサーフェイスがclipContextのものと異なる場合
-        if (_currentMaskBuffer != clipContextOffscreenSurface)
-        {
-            _currentMaskBuffer->EndDraw();
-            _currentMaskBuffer = clipContextOffscreenSurface;
-            // マスク用RenderTextureをactiveにセット
-            _currentMaskBuffer->BeginDraw(lastFBO);
-
-            // バッファをクリアする。
-            renderer->PreDraw();
-        }
-
         // モデル座標上の矩形を、適宜マージンを付けて使う
         _tmpBoundsOnModel.SetRect(allClippedDrawRect);
         _tmpBoundsOnModel.Expand(allClippedDrawRect->Width * MARGIN, allClippedDrawRect->Height * MARGIN);
@@ -124,6 +133,65 @@ void CubismClippingManager_OpenGLES2::SetupClippingContext(CubismModel& model, C
         clipContext->_matrixForMask.SetMatrix(_tmpMatrixForMask.GetArray());
         clipContext->_matrixForDraw.SetMatrix(_tmpMatrixForDraw.GetArray());
 
+        const csmBool wasMaskDrawn = clipContext->_isMaskDrawn;
+        const csmInt32 drawnChannelFlagIndex = clipContext->_drawnBufferIndex * ColorChannelCount + clipContext->_drawnLayoutChannelIndex;
+
+        if (!renderer->IsUsingClippingMaskReuse() || clipContext->UpdateMaskState(model, renderer))
+        {
+            _dirtyChannelFlags[clipContext->_bufferIndex * ColorChannelCount + clipContext->_layoutChannelIndex] = true;
+
+            // 配置が変わった場合は前回描いたチャンネルからも消す
+            if (wasMaskDrawn && drawnChannelFlagIndex < channelFlagCount)
+            {
+                _dirtyChannelFlags[drawnChannelFlagIndex] = true;
+            }
+
+            isDirty = true;
+        }
+    }
+
+    if (!isDirty)
+    {
+        return;
+    }
+
+    // マスク作成処理
+    // 生成したOffscreenSurfaceと同じサイズでビューポートを設定
+    glViewport(0, 0, _clippingMaskBufferSize.X, _clippingMaskBufferSize.Y);
+
+    _currentMaskBuffer = NULL;
+
+    // 実際にマスクを生成する
+    for (csmUint32 clipIndex = 0; clipIndex < _clippingContextListForMask.GetSize(); clipIndex++)
+    {
+        // --- 実際に１つのマスクを描く ---
+        CubismClippingContext_OpenGLES2* clipContext = _clippingContextListForMask[clipIndex];
+
+        if (!_dirtyChannelFlags[clipContext->_bufferIndex * ColorChannelCount + clipContext->_layoutChannelIndex])
+        {
+            continue;
+        }
+
+        // clipContextに設定したオフスクリーンサーフェイスをインデックスで取得
+        CubismOffscreenSurface_OpenGLES2* clipContextOffscreenSurface = renderer->GetMaskBuffer(clipContext->_bufferIndex);
+
+        // 現在のオフスクリーンサーフェイスがclipContextのものと異なる場合
+        if (_currentMaskBuffer != clipContextOffscreenSurface)
+        {
+            if (_currentMaskBuffer != NULL)
+            {
+                _currentMaskBuffer->EndDraw();
+            }
+            _currentMaskBuffer = clipContextOffscreenSurface;
+            // マスク用RenderTextureをactiveにセット
+            _currentMaskBuffer->BeginDraw(lastFBO);
+
+            // バッファをクリアする。
+            renderer->PreDraw();
+        }
+
+        renderer->_drawStatistics.RedrawnClippingMaskCount++;
+
         // 実際の描画を行う
         const csmInt32 clipDrawCount = clipContext->_clippingIdCount;
         for (csmInt32 i = 0; i < clipDrawCount; i++)
@@ -143,8 +211,24 @@ void CubismClippingManager_OpenGLES2::SetupClippingContext(CubismModel& model, C
             {
                 // マスクをクリアする
                 // 1が無効（描かれない）領域、0が有効（描かれる）領域。（シェーダーCd*Csで0に近い値をかけてマスクを作る。1をかけると何も起こらない）
+                // 描き直さないチャンネルは書き込みを禁止して残す
+                CubismRendererStateCache_OpenGLES2* stateCache = CubismRendererStateCache_OpenGLES2::GetInstance();
+                csmFloat32 clearMask[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+                for (csmInt32 channel = 0; channel < ColorChannelCount; ++channel)
+                {
+                    if (_dirtyChannelFlags[clipContext->_bufferIndex * ColorChannelCount + channel])
+                    {
+                        const CubismRenderer::CubismTextureColor* channelFlag = GetChannelFlagAsColor(channel);
+                        clearMask[0] += channelFlag->R;
+                        clearMask[1] += channelFlag->G;
+                        clearMask[2] += channelFlag->B;
+                        clearMask[3] += channelFlag->A;
+                    }
+                }
+                stateCache->ColorMask(clearMask[0] > 0.0f, clearMask[1] > 0.0f, clearMask[2] > 0.0f, clearMask[3] > 0.0f);
                 glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
                 glClear(GL_COLOR_BUFFER_BIT);
+                stateCache->ColorMask(1, 1, 1, 1);
                 _clearedMaskBufferFlags[clipContext->_bufferIndex] = true;
             }
 
@@ -162,13 +246,25 @@ void CubismClippingManager_OpenGLES2::SetupClippingContext(CubismModel& model, C
     glViewport(lastViewport[0], lastViewport[1], lastViewport[2], lastViewport[3]);
 }
 
+void CubismClippingManager_OpenGLES2::InvalidateMasks()
+{
+    for (csmUint32 clipIndex = 0; clipIndex < _clippingContextListForMask.GetSize(); clipIndex++)
+    {
+        _clippingContextListForMask[clipIndex]->_isMaskDrawn = false;
+    }
+}
+
 /*********************************************************************************************************************
 *                                      CubismClippingContext_OpenGLES2
 ********************************************************************************************************************/
 CubismClippingContext_OpenGLES2::CubismClippingContext_OpenGLES2(CubismClippingManager<CubismClippingContext_OpenGLES2, CubismOffscreenSurface_OpenGLES2>* manager, CubismModel& model, const csmInt32* clippingDrawableIndices, csmInt32 clipCount)
     : CubismClippingContext(clippingDrawableIndices, clipCount)
+    , _isMaskDrawn(false)
+    , _drawnBufferIndex(0)
+    , _drawnLayoutChannelIndex(0)
 {
     _owner = manager;
+    memset(_drawnMatrixForMask, 0, sizeof(_drawnMatrixForMask));
 }
 
 CubismClippingContext_OpenGLES2::~CubismClippingContext_OpenGLES2()
@@ -180,6 +276,294 @@ CubismClippingManager<CubismClippingContext_OpenGLES2, CubismOffscreenSurface_Op
     return _owner;
 }
 
+csmBool CubismClippingContext_OpenGLES2::UpdateMaskState(const CubismModel& model, CubismRenderer_OpenGLES2* renderer)
+{
+    csmBool isChanged = !_isMaskDrawn ||
+        _drawnBufferIndex != _bufferIndex ||
+        _drawnLayoutChannelIndex != _layoutChannelIndex ||
+        _drawnLayoutBounds.X != _layoutBounds->X || _drawnLayoutBounds.Y != _layoutBounds->Y ||
+        _drawnLayoutBounds.Width != _layoutBounds->Width || _drawnLayoutBounds.Height != _layoutBounds->Height ||
+        memcmp(_drawnMatrixForMask, _matrixForMask.GetArray(), sizeof(_drawnMatrixForMask)) != 0;
+
+    _isMaskDrawn = true;
+    _drawnBufferIndex = _bufferIndex;
+    _drawnLayoutChannelIndex = _layoutChannelIndex;
+    _drawnLayoutBounds.SetRect(_layoutBounds);
+    memcpy(_drawnMatrixForMask, _matrixForMask.GetArray(), sizeof(_drawnMatrixForMask));
+
+    csmInt32 vertexTotal = 0;
+    for (csmInt32 i = 0; i < _clippingIdCount; ++i)
+    {
+        vertexTotal += model.GetDrawableVertexCount(_clippingIdList[i]);
+    }
+
+    if (static_cast<csmInt32>(_drawnVertexPositions.GetSize()) != vertexTotal || static_cast<csmInt32>(_drawnTextures.GetSize()) != _clippingIdCount)
+    {
+        _drawnVertexPositions.Resize(vertexTotal);
+        _drawnTextures.Resize(_clippingIdCount, 0);
+        isChanged = true;
+    }
+
+    csmInt32 vertexOffset = 0;
+    for (csmInt32 i = 0; i < _clippingIdCount; ++i)
+    {
+        const csmInt32 clipDrawIndex = _clippingIdList[i];
+
+        // 頂点情報が更新されていないDrawableはマスクに描かれない
+        const GLuint texture = model.GetDrawableDynamicFlagVertexPositionsDidChange(clipDrawIndex)
+            ? renderer->GetBindedTextureId(model.GetDrawableTextureIndex(clipDrawIndex))
+            : 0;
+        if (_drawnTextures[i] != texture)
+        {
+            _drawnTextures[i] = texture;
+            isChanged = true;
+        }
+
+        const csmInt32 vertexCount = model.GetDrawableVertexCount(clipDrawIndex);
+        const csmSizeType size = sizeof(Core::csmVector2) * vertexCount;
+        Core::csmVector2* drawnPositions = _drawnVertexPositions.GetPtr() + vertexOffset;
+        if (memcmp(drawnPositions, model.GetDrawableVertexPositions(clipDrawIndex), size) != 0)
+        {
+            memcpy(drawnPositions, model.GetDrawableVertexPositions(clipDrawIndex), size);
+            isChanged = true;
+        }
+        vertexOffset += vertexCount;
+    }
+
+    return isChanged;
+}
+
+/*********************************************************************************************************************
+*                                      CubismRendererStateCache_OpenGLES2
+********************************************************************************************************************/
+namespace {
+csmBool s_isTrustedHost = false;        ///< ホストが描画の間にステートを変更しないと宣言しているか
+std::atomic<csmUint32> s_stateCacheGeneration(0);   ///< InvalidateAll() の回数
+std::mutex s_stateCachesMutex;          ///< コンテキストごとの写しの表を守る
+}
+
+CubismRendererStateCache_OpenGLES2* CubismRendererStateCache_OpenGLES2::GetInstance()
+{
+    // 写しは取得したスレッドで使うので、前回と同じコンテキストなら表を引かない
+    // 表の写しは解放しない。破棄されたコンテキストのアドレスが再利用されても、写しは不明に戻されてから使われる
+    static std::map<void*, std::unique_ptr<CubismRendererStateCache_OpenGLES2> > instances;
+    static thread_local void* lastContext = NULL;
+    static thread_local CubismRendererStateCache_OpenGLES2* lastInstance = NULL;
+    static thread_local CubismRendererStateCache_OpenGLES2 unknownContextInstance(false);
+
+    void* context = CubismRenderer_OpenGLES2::GetCurrentContext();
+    CubismRendererStateCache_OpenGLES2* instance;
+    if (context == NULL)
+    {
+        instance = &unknownContextInstance;
+    }
+    else if (context == lastContext)
+    {
+        instance = lastInstance;
+    }
+    else
+    {
+        std::lock_guard<std::mutex> lock(s_stateCachesMutex);
+        std::unique_ptr<CubismRendererStateCache_OpenGLES2>& entry = instances[context];
+        if (!entry)
+        {
+            entry.reset(new CubismRendererStateCache_OpenGLES2(true));
+        }
+        instance = entry.get();
+        lastContext = context;
+        lastInstance = instance;
+    }
+
+    const csmUint32 generation = s_stateCacheGeneration.load(std::memory_order_relaxed);
+    if (instance->_generation != generation)
+    {
+        instance->Invalidate();
+        instance->_generation = generation;
+    }
+    return instance;
+}
+
+void CubismRendererStateCache_OpenGLES2::InvalidateAll()
+{
+    // 他のスレッドが使っている写しには触れず、次に取得したスレッドが不明にする
+    s_stateCacheGeneration.fetch_add(1, std::memory_order_relaxed);
+}
+
+CubismRendererStateCache_OpenGLES2::CubismRendererStateCache_OpenGLES2(csmBool contextKnown)
+    : _skippedCallCount(0)
+    , _contextKnown(contextKnown)
+    , _generation(s_stateCacheGeneration.load(std::memory_order_relaxed))
+{
+    Invalidate();
+}
+
+void CubismRendererStateCache_OpenGLES2::Invalidate()
+{
+    _program = -1;
+    _activeTexture = -1;
+    _texture2D[0] = -1;
+    _texture2D[1] = -1;
+    for (csmInt32 i = 0; i < CapabilityCount; ++i)
+    {
+        _enabled[i] = -1;
+    }
+    _frontFace = -1;
+    for (csmInt32 i = 0; i < 4; ++i)
+    {
+        _colorMask[i] = -1;
+        _blending[i] = -1;
+    }
+    _vertexArray = -1;
+}
+
+void CubismRendererStateCache_OpenGLES2::Load(const CubismRendererProfile_OpenGLES2& profile)
+{
+    _program = profile._lastProgram;
+    // Save() はユニット1、0の順に切り替えて問い合わせるため、ユニット0がアクティブになっている
+    _activeTexture = GL_TEXTURE0;
+    _texture2D[0] = profile._lastTexture0Binding2D;
+    _texture2D[1] = profile._lastTexture1Binding2D;
+    _enabled[GetCapabilityIndex(GL_SCISSOR_TEST)] = profile._lastScissorTest;
+    _enabled[GetCapabilityIndex(GL_STENCIL_TEST)] = profile._lastStencilTest;
+    _enabled[GetCapabilityIndex(GL_DEPTH_TEST)] = profile._lastDepthTest;
+    _enabled[GetCapabilityIndex(GL_CULL_FACE)] = profile._lastCullFace;
+    _enabled[GetCapabilityIndex(GL_BLEND)] = profile._lastBlend;
+    _frontFace = profile._lastFrontFace;
+    for (csmInt32 i = 0; i < 4; ++i)
+    {
+        _colorMask[i] = profile._lastColorMask[i];
+        _blending[i] = profile._lastBlending[i];
+    }
+    _vertexArray = profile._vertexArrayEnabled ? profile._lastVertexArrayBinding : -1;
+}
+
+void CubismRendererStateCache_OpenGLES2::UseProgram(GLuint program)
+{
+    if (_program == static_cast<GLint>(program))
+    {
+        _skippedCallCount++;
+        return;
+    }
+
+    glUseProgram(program);
+    _program = program;
+}
+
+void CubismRendererStateCache_OpenGLES2::ActiveTexture(GLenum unit)
+{
+    if (_activeTexture == static_cast<GLint>(unit))
+    {
+        _skippedCallCount++;
+        return;
+    }
+
+    glActiveTexture(unit);
+    _activeTexture = unit;
+}
+
+void CubismRendererStateCache_OpenGLES2::BindTexture(GLenum unit, GLuint texture)
+{
+    const csmInt32 index = unit - GL_TEXTURE0;
+    if (_texture2D[index] == static_cast<GLint>(texture))
+    {
+        _skippedCallCount++;
+        return;
+    }
+
+    ActiveTexture(unit);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    _texture2D[index] = texture;
+}
+
+void CubismRendererStateCache_OpenGLES2::SetEnable(GLenum capability, GLboolean enabled)
+{
+    const csmInt32 index = GetCapabilityIndex(capability);
+    if (_enabled[index] == enabled)
+    {
+        _skippedCallCount++;
+        return;
+    }
+
+    if (enabled == GL_TRUE) glEnable(capability);
+    else glDisable(capability);
+    _enabled[index] = enabled;
+}
+
+void CubismRendererStateCache_OpenGLES2::FrontFace(GLenum mode)
+{
+    if (_frontFace == static_cast<GLint>(mode))
+    {
+        _skippedCallCount++;
+        return;
+    }
+
+    glFrontFace(mode);
+    _frontFace = mode;
+}
+
+void CubismRendererStateCache_OpenGLES2::ColorMask(GLboolean red, GLboolean green, GLboolean blue, GLboolean alpha)
+{
+    if (_colorMask[0] == red && _colorMask[1] == green && _colorMask[2] == blue && _colorMask[3] == alpha)
+    {
+        _skippedCallCount++;
+        return;
+    }
+
+    glColorMask(red, green, blue, alpha);
+    _colorMask[0] = red;
+    _colorMask[1] = green;
+    _colorMask[2] = blue;
+    _colorMask[3] = alpha;
+}
+
+void CubismRendererStateCache_OpenGLES2::BlendFuncSeparate(GLenum srcColor, GLenum dstColor, GLenum srcAlpha, GLenum dstAlpha)
+{
+    if (_blending[0] == static_cast<GLint>(srcColor) && _blending[1] == static_cast<GLint>(dstColor) &&
+        _blending[2] == static_cast<GLint>(srcAlpha) && _blending[3] == static_cast<GLint>(dstAlpha))
+    {
+        _skippedCallCount++;
+        return;
+    }
+
+    glBlendFuncSeparate(srcColor, dstColor, srcAlpha, dstAlpha);
+    _blending[0] = srcColor;
+    _blending[1] = dstColor;
+    _blending[2] = srcAlpha;
+    _blending[3] = dstAlpha;
+}
+
+void CubismRendererStateCache_OpenGLES2::BindVertexArray(GLuint vertexArray)
+{
+#ifdef CSM_OPENGL_VERTEX_BUFFER_OBJECT
+    if (_vertexArray == static_cast<GLint>(vertexArray))
+    {
+        _skippedCallCount++;
+        return;
+    }
+
+    glBindVertexArray(vertexArray);
+    _vertexArray = vertexArray;
+#endif
+}
+
+csmInt32 CubismRendererStateCache_OpenGLES2::GetCapabilityIndex(GLenum capability)
+{
+    switch (capability)
+    {
+    case GL_SCISSOR_TEST:
+        return 0;
+    case GL_STENCIL_TEST:
+        return 1;
+    case GL_DEPTH_TEST:
+        return 2;
+    case GL_CULL_FACE:
+        return 3;
+    case GL_BLEND:
+    default:
+        return 4;
+    }
+}
+
 /*********************************************************************************************************************
 *                                      CubismDrawProfile_OpenGL
 ********************************************************************************************************************/
@@ -234,40 +618,53 @@ void CubismRendererProfile_OpenGLES2::Save()
     glGetIntegerv(GL_FRAMEBUFFER_BINDING, &_lastFBO);
     glGetIntegerv(GL_VIEWPORT, _lastViewport);
 
+#ifdef CSM_OPENGL_VERTEX_BUFFER_OBJECT
+    if (_vertexArrayEnabled)
+    {
+        glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &_lastVertexArrayBinding);
+    }
+#endif
 }
 
 void CubismRendererProfile_OpenGLES2::Restore()
 {
-    glUseProgram(_lastProgram);
+    // 写しと同じ値のステートは設定を省略する
+    CubismRendererStateCache_OpenGLES2* stateCache = CubismRendererStateCache_OpenGLES2::GetInstance();
+
+    stateCache->UseProgram(_lastProgram);
+
+#ifdef CSM_OPENGL_VERTEX_BUFFER_OBJECT
+    // 頂点属性の有効・無効とElementバッファはVAOごとの状態なので、先にVAOを戻す
+    if (_vertexArrayEnabled)
+    {
+        stateCache->BindVertexArray(_lastVertexArrayBinding);
+    }
+#endif
 
     SetGlEnableVertexAttribArray(0, _lastVertexAttribArrayEnabled[0]);
     SetGlEnableVertexAttribArray(1, _lastVertexAttribArrayEnabled[1]);
     SetGlEnableVertexAttribArray(2, _lastVertexAttribArrayEnabled[2]);
     SetGlEnableVertexAttribArray(3, _lastVertexAttribArrayEnabled[3]);
 
-    SetGlEnable(GL_SCISSOR_TEST, _lastScissorTest);
-    SetGlEnable(GL_STENCIL_TEST, _lastStencilTest);
-    SetGlEnable(GL_DEPTH_TEST, _lastDepthTest);
-    SetGlEnable(GL_CULL_FACE, _lastCullFace);
-    SetGlEnable(GL_BLEND, _lastBlend);
+    stateCache->SetEnable(GL_SCISSOR_TEST, _lastScissorTest);
+    stateCache->SetEnable(GL_STENCIL_TEST, _lastStencilTest);
+    stateCache->SetEnable(GL_DEPTH_TEST, _lastDepthTest);
+    stateCache->SetEnable(GL_CULL_FACE, _lastCullFace);
+    stateCache->SetEnable(GL_BLEND, _lastBlend);
 
-    glFrontFace(_lastFrontFace);
+    stateCache->FrontFace(_lastFrontFace);
 
-    glColorMask(_lastColorMask[0], _lastColorMask[1], _lastColorMask[2], _lastColorMask[3]);
+    stateCache->ColorMask(_lastColorMask[0], _lastColorMask[1], _lastColorMask[2], _lastColorMask[3]);
 
     glBindBuffer(GL_ARRAY_BUFFER, _lastArrayBufferBinding); //前にバッファがバインドされていたら破棄する必要がある
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _lastElementArrayBufferBinding);
 
-    glActiveTexture(GL_TEXTURE1); //テクスチャユニット1を復元
-    glBindTexture(GL_TEXTURE_2D, _lastTexture1Binding2D);
-
-    glActiveTexture(GL_TEXTURE0); //テクスチャユニット0を復元
-    glBindTexture(GL_TEXTURE_2D, _lastTexture0Binding2D);
-
-    glActiveTexture(_lastActiveTexture);
+    stateCache->BindTexture(GL_TEXTURE1, _lastTexture1Binding2D); //テクスチャユニット1を復元
+    stateCache->BindTexture(GL_TEXTURE0, _lastTexture0Binding2D); //テクスチャユニット0を復元
+    stateCache->ActiveTexture(_lastActiveTexture);
 
     // restore blending
-    glBlendFuncSeparate(_lastBlending[0], _lastBlending[1], _lastBlending[2], _lastBlending[3]);
+    stateCache->BlendFuncSeparate(_lastBlending[0], _lastBlending[1], _lastBlending[2], _lastBlending[3]);
 }
 
 /*********************************************************************************************************************
@@ -432,7 +829,36 @@ void CubismRenderer::StaticRelease()
 CubismRenderer_OpenGLES2::CubismRenderer_OpenGLES2() : _clippingManager(NULL)
                                                      , _clippingContextBufferForMask(NULL)
                                                      , _clippingContextBufferForDraw(NULL)
+                                                     , _useVertexBufferObject(true)
+                                                     , _vertexBufferObjectSupport(-1)
+                                                     , _vertexArray(0)
+                                                     , _positionBuffer(0)
+                                                     , _uvBuffer(0)
+                                                     , _indexBuffer(0)
+                                                     , _vertexTotal(0)
+                                                     , _positionSlot(0)
+                                                     , _useSyncObjects(false)
+                                                     , _useDrawCallBatching(true)
+                                                     , _useClippingMaskReuse(true)
+                                                     , _skippedCallCountAtSave(0)
+                                                     , _isProfileSaved(false)
 {
+    _drawStatistics.UploadedDrawableCount = 0;
+    _drawStatistics.UploadedVertexBytes = 0;
+    _drawStatistics.DrawCallCount = 0;
+    _drawStatistics.BatchedDrawableCount = 0;
+    _drawStatistics.StateChangeCount = 0;
+    _drawStatistics.SkippedStateCallCount = 0;
+    _drawStatistics.ClippingMaskCount = 0;
+    _drawStatistics.RedrawnClippingMaskCount = 0;
+
+#ifdef CSM_OPENGL_VERTEX_BUFFER_OBJECT
+    for (csmInt32 i = 0; i < PositionSlotCount; ++i)
+    {
+        _positionFences[i] = NULL;
+    }
+#endif
+
     // テクスチャ対応マップの容量を確保しておく.
     _textures.PrepareCapacity(32, true);
 }
@@ -441,6 +867,8 @@ CubismRenderer_OpenGLES2::~CubismRenderer_OpenGLES2()
 {
     CSM_DELETE_SELF(CubismClippingManager_OpenGLES2, _clippingManager);
 
+    ReleaseVertexBuffers();
+
     for (csmInt32 i = 0; i < _offscreenSurfaces.GetSize(); ++i)
     {
         if (_offscreenSurfaces[i].IsValid())
@@ -449,6 +877,9 @@ CubismRenderer_OpenGLES2::~CubismRenderer_OpenGLES2()
         }
     }
     _offscreenSurfaces.Clear();
+
+    // 削除したオブジェクトの名前は再利用されるため、写しに残さない
+    InvalidateStateCache();
 }
 
 void CubismRenderer_OpenGLES2::DoStaticRelease()
@@ -490,6 +921,9 @@ void CubismRenderer_OpenGLES2::Initialize(CubismModel* model, csmInt32 maskBuffe
             _offscreenSurfaces.PushBack(offscreenSurface);
         }
 
+        // 作成時にテクスチャのバインドが変わる
+        InvalidateStateCache();
+
     }
 
     _sortedDrawableIndexList.Resize(model->GetDrawableCount(), 0);
@@ -504,26 +938,41 @@ void CubismRenderer_OpenGLES2::PreDraw()
     if (!s_isInitializeGlFunctionsSuccess) return;
 #endif
 
-    glDisable(GL_SCISSOR_TEST);
-    glDisable(GL_STENCIL_TEST);
-    glDisable(GL_DEPTH_TEST);
+    CubismRendererStateCache_OpenGLES2* stateCache = CubismRendererStateCache_OpenGLES2::GetInstance();
 
-    glEnable(GL_BLEND);
-    glColorMask(1, 1, 1, 1);
+    stateCache->SetEnable(GL_SCISSOR_TEST, GL_FALSE);
+    stateCache->SetEnable(GL_STENCIL_TEST, GL_FALSE);
+    stateCache->SetEnable(GL_DEPTH_TEST, GL_FALSE);
+
+    stateCache->SetEnable(GL_BLEND, GL_TRUE);
+    stateCache->ColorMask(1, 1, 1, 1);
 
 #ifdef CSM_TARGET_IPHONE_ES2
     glBindVertexArrayOES(0);
 #endif
 
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-    glBindBuffer(GL_ARRAY_BUFFER, 0); //前にバッファがバインドされていたら破棄する必要がある
+#ifdef CSM_OPENGL_VERTEX_BUFFER_OBJECT
+    if (_vertexArray != 0 && IsUsingVertexBufferObject())
+    {
+        // ElementバッファはVAOに記録されているので外さない
+        stateCache->BindVertexArray(_vertexArray);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+    else
+#endif
+    {
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+        glBindBuffer(GL_ARRAY_BUFFER, 0); //前にバッファがバインドされていたら破棄する必要がある
+    }
 
     //異方性フィルタリング。プラットフォームのOpenGLによっては未対応の場合があるので、未設定のときは設定しない
     if (GetAnisotropy() >= 1.0f)
     {
+        // glTexParameterf はアクティブなユニットのテクスチャに作用する
+        stateCache->ActiveTexture(GL_TEXTURE0);
         for (csmInt32 i = 0; i < _textures.GetSize(); i++)
         {
-            glBindTexture(GL_TEXTURE_2D, _textures[i]);
+            stateCache->BindTexture(GL_TEXTURE0, _textures[i]);
             glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAX_ANISOTROPY_EXT, GetAnisotropy());
         }
     }
@@ -532,6 +981,40 @@ void CubismRenderer_OpenGLES2::PreDraw()
 
 void CubismRenderer_OpenGLES2::DoDrawModel()
 {
+    _drawStatistics.UploadedDrawableCount = 0;
+    _drawStatistics.UploadedVertexBytes = 0;
+    _drawStatistics.DrawCallCount = 0;
+    _drawStatistics.BatchedDrawableCount = 0;
+    _drawStatistics.StateChangeCount = 0;
+    _drawStatistics.ClippingMaskCount = 0;
+    _drawStatistics.RedrawnClippingMaskCount = 0;
+    _lastStatisticsState[0] = 0;
+    _lastStatisticsState[1] = 0;
+    _lastStatisticsState[2] = 0;
+
+    const csmInt32 drawableCount = GetModel()->GetDrawableCount();
+    const csmInt32* renderOrder = GetModel()->GetDrawableRenderOrders();
+
+    // インデックスを描画順でソート
+    for (csmInt32 i = 0; i < drawableCount; ++i)
+    {
+        const csmInt32 order = renderOrder[i];
+        _sortedDrawableIndexList[order] = i;
+    }
+
+    //------------ 頂点バッファオブジェクトを使う場合 ------------
+    if (IsUsingVertexBufferObject())
+    {
+        if (_vertexArray == 0)
+        {
+            CreateVertexBuffers();
+        }
+
+        // マスクの描画でも使うため、最初に変化した頂点座標を転送しておく
+        UploadVertexPositions();
+        UpdateIndexBuffer();
+    }
+
     //------------ クリッピングマスク・バッファ前処理方式の場合 ------------
     if (_clippingManager != NULL)
     {
@@ -545,12 +1028,17 @@ void CubismRenderer_OpenGLES2::DoDrawModel()
             {
                 _offscreenSurfaces[i].CreateOffscreenSurface(
                     static_cast<csmUint32>(_clippingManager->GetClippingMaskBufferSize().X), static_cast<csmUint32>(_clippingManager->GetClippingMaskBufferSize().Y));
+                InvalidateStateCache();
+                _clippingManager->InvalidateMasks();
             }
         }
 
         if (IsUsingHighPrecisionMask())
         {
            _clippingManager->SetupMatrixForHighPrecision(*GetModel(), false);
+
+           // 高精細マスクはバッファを上書きするため、通常のマスクは次回描き直す
+           _clippingManager->InvalidateMasks();
         }
         else
         {
@@ -561,15 +1049,13 @@ void CubismRenderer_OpenGLES2::DoDrawModel()
     // 上記クリッピング処理内でも一度PreDrawを呼ぶので注意!!
     PreDraw();
 
-    const csmInt32 drawableCount = GetModel()->GetDrawableCount();
-    const csmInt32* renderOrder = GetModel()->GetDrawableRenderOrders();
-
-    // インデックスを描画順でソート
-    for (csmInt32 i = 0; i < drawableCount; ++i)
-    {
-        const csmInt32 order = renderOrder[i];
-        _sortedDrawableIndexList[order] = i;
-    }
+    // 描画順で連続し、ステートが同じDrawableは1回の描画命令にまとめる
+    // インデックスのバッファは描画順に並んでいるため、まとめたDrawableのインデックスは連続している
+    const csmBool isBatching = IsUsingDrawCallBatching() && _vertexArray != 0 && IsUsingVertexBufferObject();
+    csmInt32 batchIndex = -1;       // まとめている先頭のDrawable。-1ならまとめていない
+    csmInt32 batchLastIndex = -1;   // まとめている最後のDrawable
+    csmInt32 batchIndexCount = 0;
+    CubismClippingContext_OpenGLES2* batchClipContext = NULL;
 
     // 描画
     for (csmInt32 i = 0; i < drawableCount; ++i)
@@ -587,10 +1073,42 @@ void CubismRenderer_OpenGLES2::DoDrawModel()
             ? (*_clippingManager->GetClippingContextListForDraw())[drawableIndex]
             : NULL;
 
+        // 間に非表示のDrawableがあるとインデックスが連続しないため、そこで区切られる
+        if (batchIndex >= 0 &&
+            _indexOffsets[batchIndex] + batchIndexCount == _indexOffsets[drawableIndex] &&
+            CanBatchDrawables(batchLastIndex, batchClipContext, drawableIndex, clipContext))
+        {
+            batchLastIndex = drawableIndex;
+            batchIndexCount += GetModel()->GetDrawableVertexIndexCount(drawableIndex);
+            _drawStatistics.BatchedDrawableCount++;
+            continue;
+        }
+
+        if (batchIndex >= 0)
+        {
+            SetClippingContextBufferForDraw(batchClipContext);
+            IsCulling(GetModel()->GetDrawableCulling(batchIndex) != 0);
+            DrawMeshOpenGL(*GetModel(), batchIndex, batchIndexCount);
+            batchIndex = -1;
+        }
+
+        // 高精細マスクはDrawableごとにマスクを書き直すため、まとめない
+        if (isBatching && (clipContext == NULL || !IsUsingHighPrecisionMask()))
+        {
+            batchIndex = drawableIndex;
+            batchLastIndex = drawableIndex;
+            batchIndexCount = GetModel()->GetDrawableVertexIndexCount(drawableIndex);
+            batchClipContext = clipContext;
+            continue;
+        }
+
         if (clipContext != NULL && IsUsingHighPrecisionMask()) // マスクを書く必要がある
         {
             if(clipContext->_isUsing) // 書くことになっていた
             {
+                _drawStatistics.ClippingMaskCount++;
+                _drawStatistics.RedrawnClippingMaskCount++;
+
                 // 生成したOffscreenSurfaceと同じサイズでビューポートを設定
                 glViewport(0, 0, _clippingManager->GetClippingMaskBufferSize().X, _clippingManager->GetClippingMaskBufferSize().Y);
 
@@ -646,11 +1164,31 @@ void CubismRenderer_OpenGLES2::DoDrawModel()
         DrawMeshOpenGL(*GetModel(), drawableIndex);
     }
 
+    if (batchIndex >= 0)
+    {
+        SetClippingContextBufferForDraw(batchClipContext);
+        IsCulling(GetModel()->GetDrawableCulling(batchIndex) != 0);
+        DrawMeshOpenGL(*GetModel(), batchIndex, batchIndexCount);
+    }
+
+#ifdef CSM_OPENGL_VERTEX_BUFFER_OBJECT
+    if (_vertexArray != 0 && IsUsingVertexBufferObject() && _useSyncObjects)
+    {
+        // 今回の区画を次に書き換える前に、この描画の完了を確認する
+        _positionFences[_positionSlot] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    }
+#endif
+
     PostDraw();
 
 }
 
 void CubismRenderer_OpenGLES2::DrawMeshOpenGL(const CubismModel& model, const csmInt32 index)
+{
+    DrawMeshOpenGL(model, index, model.GetDrawableVertexIndexCount(index));
+}
+
+void CubismRenderer_OpenGLES2::DrawMeshOpenGL(const CubismModel& model, const csmInt32 index, const csmInt32 indexCount)
 {
 
 #ifdef CSM_TARGET_WIN_GL
@@ -661,17 +1199,12 @@ void CubismRenderer_OpenGLES2::DrawMeshOpenGL(const CubismModel& model, const cs
     if (_textures[model.GetDrawableTextureIndex(index)] == 0) return;    // モデルが参照するテクスチャがバインドされていない場合は描画をスキップする
 #endif
 
+    CubismRendererStateCache_OpenGLES2* stateCache = CubismRendererStateCache_OpenGLES2::GetInstance();
+
     // 裏面描画の有効・無効
-    if (IsCulling())
-    {
-        glEnable(GL_CULL_FACE);
-    }
-    else
-    {
-        glDisable(GL_CULL_FACE);
-    }
+    stateCache->SetEnable(GL_CULL_FACE, IsCulling() ? GL_TRUE : GL_FALSE);
 
-    glFrontFace(GL_CCW);    // Cubism SDK OpenGLはマスク・アートメッシュ共にCCWが表面
+    stateCache->FrontFace(GL_CCW);    // Cubism SDK OpenGLはマスク・アートメッシュ共にCCWが表面
 
     if (IsGeneratingMask())  // マスク生成時
     {
@@ -682,26 +1215,124 @@ void CubismRenderer_OpenGLES2::DrawMeshOpenGL(const CubismModel& model, const cs
     }
 
     // ポリゴンメッシュを描画する
+#ifdef CSM_OPENGL_VERTEX_BUFFER_OBJECT
+    if (_vertexArray != 0 && IsUsingVertexBufferObject())
+    {
+        // VAOに記録したElementバッファのオフセットを指定する
+        const csmSizeType indexOffset = sizeof(GLuint) * static_cast<csmSizeType>(_indexOffsets[index]);
+        glDrawElements(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, reinterpret_cast<const void*>(indexOffset));
+    }
+    else
+#endif
     {
-        csmInt32 indexCount = model.GetDrawableVertexIndexCount(index);
         csmUint16* indexArray = const_cast<csmUint16*>(model.GetDrawableVertexIndices(index));
         glDrawElements(GL_TRIANGLES, indexCount, GL_UNSIGNED_SHORT, indexArray);
+
+        // クライアント側の配列は描画のたびにドライバへ渡される
+        _drawStatistics.UploadedDrawableCount++;
+        _drawStatistics.UploadedVertexBytes += sizeof(Core::csmVector2) * model.GetDrawableVertexCount(index);
     }
 
     // 後処理
-    glUseProgram(0);
+    // シェーダプログラムは次の描画でも使われることが多いため外さない。描画後に RestoreProfile() で戻る
     SetClippingContextBufferForDraw(NULL);
     SetClippingContextBufferForMask(NULL);
 }
 
 void CubismRenderer_OpenGLES2::SaveProfile()
 {
+    CubismRendererStateCache_OpenGLES2* stateCache = CubismRendererStateCache_OpenGLES2::GetInstance();
+    _skippedCallCountAtSave = stateCache->_skippedCallCount;
+
+    // どのコンテキストの写しか分からない場合は、信頼モードでも写しを使わずに問い合わせる
+    if (s_isTrustedHost && stateCache->_contextKnown)
+    {
+        // ステートは前回の描画で設定したままなので写しをそのまま使う。描画先だけは変わりうる
+        glGetIntegerv(GL_FRAMEBUFFER_BINDING, &_rendererProfile._lastFBO);
+        glGetIntegerv(GL_VIEWPORT, _rendererProfile._lastViewport);
+        _isProfileSaved = false;
+        return;
+    }
+
+    // 頂点バッファオブジェクトを使う場合はVAOも保存・復帰する
+    _rendererProfile._vertexArrayEnabled = IsUsingVertexBufferObject();
     _rendererProfile.Save();
+    _isProfileSaved = true;
+
+    // 問い合わせた値をそのまま写しにする
+    stateCache->Load(_rendererProfile);
 }
 
 void CubismRenderer_OpenGLES2::RestoreProfile()
 {
-    _rendererProfile.Restore();
+    if (_isProfileSaved)
+    {
+        _rendererProfile.Restore();
+    }
+
+    _drawStatistics.SkippedStateCallCount = static_cast<csmInt32>(CubismRendererStateCache_OpenGLES2::GetInstance()->_skippedCallCount - _skippedCallCountAtSave);
+}
+
+void CubismRenderer_OpenGLES2::SetTrustedHost(csmBool trusted)
+{
+    if (s_isTrustedHost != trusted)
+    {
+        // 最後の描画の後にホストが設定したステートは写しに無い
+        CubismRendererStateCache_OpenGLES2::InvalidateAll();
+    }
+
+    s_isTrustedHost = trusted;
+}
+
+csmBool CubismRenderer_OpenGLES2::IsTrustedHost()
+{
+    return s_isTrustedHost;
+}
+
+void CubismRenderer_OpenGLES2::InvalidateStateCache()
+{
+    CubismRendererStateCache_OpenGLES2::GetInstance()->Invalidate();
+}
+
+void* CubismRenderer_OpenGLES2::GetCurrentContext()
+{
+#if defined(CSM_TARGET_WIN_GL)
+    return wglGetCurrentContext();
+#elif defined(CSM_TARGET_MAC_GL)
+    return CGLGetCurrentContext();
+#elif defined(CSM_TARGET_LINUX_GL)
+    // GLXとEGL（ヘッドレスやWayland）のどちらのコンテキストもありうる
+    typedef void* (*GetCurrentContextFunction)();
+    struct ContextFunctions
+    {
+        GetCurrentContextFunction glx;
+        GetCurrentContextFunction egl;
+
+        ContextFunctions() : glx(NULL), egl(NULL)
+        {
+            void* library = dlopen("libGL.so.1", RTLD_LAZY | RTLD_LOCAL);
+            if (library != NULL)
+            {
+                glx = reinterpret_cast<GetCurrentContextFunction>(dlsym(library, "glXGetCurrentContext"));
+            }
+            library = dlopen("libEGL.so.1", RTLD_LAZY | RTLD_LOCAL);
+            if (library != NULL)
+            {
+                egl = reinterpret_cast<GetCurrentContextFunction>(dlsym(library, "eglGetCurrentContext"));
+            }
+        }
+    };
+    static const ContextFunctions functions;
+
+    void* context = functions.glx != NULL ? functions.glx() : NULL;
+    if (context == NULL && functions.egl != NULL)
+    {
+        context = functions.egl();
+    }
+    return context;
+#else
+    return NULL;
+#endif
 }
 
 void CubismRenderer_OpenGLES2::BindTexture(csmUint32 modelTextureIndex, GLuint glTextureIndex)
@@ -782,6 +1413,427 @@ GLuint CubismRenderer_OpenGLES2::GetBindedTextureId(csmInt32 textureId)
     return (_textures[textureId] != 0) ? _textures[textureId] : -1;
 }
 
+void CubismRenderer_OpenGLES2::UseVertexBufferObject(csmBool enable)
+{
+    _useVertexBufferObject = enable;
+}
+
+csmBool CubismRenderer_OpenGLES2::IsUsingVertexBufferObject()
+{
+    if (!_useVertexBufferObject)
+    {
+        return false;
+    }
+
+    if (_vertexBufferObjectSupport < 0)
+    {
+        _vertexBufferObjectSupport = CheckVertexBufferObjectSupport() ? 1 : 0;
+    }
+
+    return _vertexBufferObjectSupport != 0;
+}
+
+void CubismRenderer_OpenGLES2::UseDrawCallBatching(csmBool enable)
+{
+    _useDrawCallBatching = enable;
+}
+
+csmBool CubismRenderer_OpenGLES2::IsUsingDrawCallBatching() const
+{
+    return _useDrawCallBatching;
+}
+
+void CubismRenderer_OpenGLES2::UseClippingMaskReuse(csmBool enable)
+{
+    _useClippingMaskReuse = enable;
+}
+
+csmBool CubismRenderer_OpenGLES2::IsUsingClippingMaskReuse() const
+{
+    return _useClippingMaskReuse;
+}
+
+csmBool CubismRenderer_OpenGLES2::CheckVertexBufferObjectSupport()
+{
+#ifdef CSM_OPENGL_VERTEX_BUFFER_OBJECT
+    const csmChar* version = reinterpret_cast<const csmChar*>(glGetString(GL_VERSION));
+    if (version == NULL)
+    {
+        return false;
+    }
+
+    // "OpenGL ES 3.0 ..." のような接頭辞を読み飛ばしてメジャーバージョンを取り出す
+    while (*version != '\0' && (*version < '0' || *version > '9'))
+    {
+        ++version;
+    }
+
+    if (atoi(version) < 3)
+    {
+        return false;
+    }
+
+#ifdef __glew_h__
+    // glewInit() の前や拡張の読み込みに失敗した場合は関数ポインタが空になっている
+    if (glGenVertexArrays == NULL || glBindVertexArray == NULL || glDeleteVertexArrays == NULL ||
+        glMapBufferRange == NULL || glFlushMappedBufferRange == NULL)
+    {
+        return false;
+    }
+#endif
+
+    return true;
+#else
+    return false;
+#endif
+}
+
+void CubismRenderer_OpenGLES2::CreateVertexBuffers()
+{
+#ifdef CSM_OPENGL_VERTEX_BUFFER_OBJECT
+    const CubismModel* model = GetModel();
+    const csmInt32 drawableCount = model->GetDrawableCount();
+
+    // 全Drawableの頂点とインデックスを1本ずつのバッファにまとめる
+    _vertexTotal = 0;
+    _vertexOffsets.Resize(drawableCount, 0);
+    _indexOffsets.Resize(drawableCount, 0);
+    for (csmInt32 i = 0; i < drawableCount; ++i)
+    {
+        _vertexOffsets[i] = _vertexTotal;
+        _vertexTotal += model->GetDrawableVertexCount(i);
+    }
+
+    glGenVertexArrays(1, &_vertexArray);
+    CubismRendererStateCache_OpenGLES2::GetInstance()->BindVertexArray(_vertexArray);
+
+    // UVは変化しないので一度だけ転送する
+    glGenBuffers(1, &_uvBuffer);
+    glBindBuffer(GL_ARRAY_BUFFER, _uvBuffer);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(Core::csmVector2) * _vertexTotal, NULL, GL_STATIC_DRAW);
+    for (csmInt32 i = 0; i < drawableCount; ++i)
+    {
+        const csmInt32 vertexCount = model->GetDrawableVertexCount(i);
+        if (vertexCount > 0)
+        {
+            glBufferSubData(GL_ARRAY_BUFFER, sizeof(Core::csmVector2) * _vertexOffsets[i], sizeof(Core::csmVector2) * vertexCount, model->GetDrawableVertexUvs(i));
+        }
+    }
+    glEnableVertexAttribArray(CubismShader_OpenGLES2::AttributeTexCoordIndex);
+    glVertexAttribPointer(CubismShader_OpenGLES2::AttributeTexCoordIndex, 2, GL_FLOAT, GL_FALSE, sizeof(csmFloat32) * 2, NULL);
+
+    // 頂点座標は UploadVertexPositions() で変化した範囲だけ転送する
+    // 前の描画がGPUで参照している範囲を書き換えないよう、区画を描画ごとに順に使う
+    glGenBuffers(1, &_positionBuffer);
+    glBindBuffer(GL_ARRAY_BUFFER, _positionBuffer);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(Core::csmVector2) * _vertexTotal * PositionSlotCount, NULL, GL_DYNAMIC_DRAW);
+    _uploadedPositions.Resize(_vertexTotal);
+    _positionGenerations.Resize(drawableCount, 0);
+    _slotGenerations.Resize(drawableCount * PositionSlotCount, 0);
+    for (csmInt32 i = 0; i < drawableCount; ++i)
+    {
+        _positionGenerations[i] = 0;
+    }
+    for (csmInt32 i = 0; i < drawableCount * PositionSlotCount; ++i)
+    {
+        _slotGenerations[i] = 0;
+    }
+    _positionSlot = 0;
+
+    // フェンスが無い環境では区画の書き込みをドライバに同期させる
+#ifdef __glew_h__
+    _useSyncObjects = (GLEW_VERSION_3_2 || GLEW_ARB_sync) && glFenceSync != NULL && glClientWaitSync != NULL && glDeleteSync != NULL;
+#else
+    _useSyncObjects = true;
+#endif
+
+    // マスクに使われるDrawableは非表示でも描かれるため、常に最新の座標を転送する
+    _clippingSources.Resize(drawableCount, false);
+    if (_clippingManager != NULL)
+    {
+        csmVector<CubismClippingContext_OpenGLES2*>* contexts = _clippingManager->GetClippingContextListForDraw();
+        for (csmUint32 i = 0; i < contexts->GetSize(); ++i)
+        {
+            const CubismClippingContext_OpenGLES2* context = (*contexts)[i];
+            if (context == NULL)
+            {
+                continue;
+            }
+
+            for (csmInt32 j = 0; j < context->_clippingIdCount; ++j)
+            {
+                _clippingSources[context->_clippingIdList[j]] = true;
+            }
+        }
+    }
+    glEnableVertexAttribArray(CubismShader_OpenGLES2::AttributePositionIndex);
+    glVertexAttribPointer(CubismShader_OpenGLES2::AttributePositionIndex, 2, GL_FLOAT, GL_FALSE, sizeof(csmFloat32) * 2, NULL);
+
+    // インデックスは UpdateIndexBuffer() で描画順に並べて転送する
+    glGenBuffers(1, &_indexBuffer);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _indexBuffer);
+    _indexOrder.Clear();
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+#endif
+}
+
+void CubismRenderer_OpenGLES2::UpdateIndexBuffer()
+{
+#ifdef CSM_OPENGL_VERTEX_BUFFER_OBJECT
+    const CubismModel* model = GetModel();
+    const csmInt32 drawableCount = model->GetDrawableCount();
+
+    // 描画順は描画順グループを持つモデルではパラメータによって変わるが、変わらないフレームでは何もしない
+    if (_indexOrder.GetSize() == static_cast<csmUint32>(drawableCount) &&
+        memcmp(_indexOrder.GetPtr(), _sortedDrawableIndexList.GetPtr(), sizeof(csmInt32) * drawableCount) == 0)
+    {
+        return;
+    }
+
+    _indexOrder.Resize(drawableCount, 0);
+    csmInt32 indexTotal = 0;
+    for (csmInt32 i = 0; i < drawableCount; ++i)
+    {
+        const csmInt32 drawableIndex = _sortedDrawableIndexList[i];
+        _indexOrder[i] = drawableIndex;
+        _indexOffsets[drawableIndex] = indexTotal;
+        indexTotal += model->GetDrawableVertexIndexCount(drawableIndex);
+    }
+
+    // Drawableごとのインデックスは頂点の先頭位置を加算して1本のバッファから引けるようにする
+    // 頂点の総数は16bitに収まらない場合があるので32bitで持つ
+    csmVector<GLuint> indices;
+    indices.Resize(indexTotal, 0);
+    for (csmInt32 i = 0; i < drawableCount; ++i)
+    {
+        const csmInt32 indexCount = model->GetDrawableVertexIndexCount(i);
+        const csmUint16* vertexIndices = model->GetDrawableVertexIndices(i);
+        for (csmInt32 j = 0; j < indexCount; ++j)
+        {
+            indices[_indexOffsets[i] + j] = static_cast<GLuint>(_vertexOffsets[i] + vertexIndices[j]);
+        }
+    }
+
+    // Elementバッファの割り当てはVAOに記録されている
+    CubismRendererStateCache_OpenGLES2::GetInstance()->BindVertexArray(_vertexArray);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _indexBuffer);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(GLuint) * indexTotal, indices.GetPtr(), GL_DYNAMIC_DRAW);
+#endif
+}
+
+csmBool CubismRenderer_OpenGLES2::CanBatchDrawables(csmInt32 index, const CubismClippingContext_OpenGLES2* clip, csmInt32 nextIndex, const CubismClippingContext_OpenGLES2* nextClip)
+{
+    const CubismModel* model = GetModel();
+
+    if (clip != nextClip ||
+        GetBindedTextureId(model->GetDrawableTextureIndex(index)) != GetBindedTextureId(model->GetDrawableTextureIndex(nextIndex)) ||
+        model->GetDrawableBlendMode(index) != model->GetDrawableBlendMode(nextIndex) ||
+        model->GetDrawableInvertedMask(index) != model->GetDrawableInvertedMask(nextIndex) ||
+        model->GetDrawableCulling(index) != model->GetDrawableCulling(nextIndex) ||
+        model->GetDrawableOpacity(index) != model->GetDrawableOpacity(nextIndex))
+    {
+        return false;
+    }
+
+    const CubismTextureColor multiplyColor = model->GetMultiplyColor(index);
+    const CubismTextureColor nextMultiplyColor = model->GetMultiplyColor(nextIndex);
+    if (multiplyColor.R != nextMultiplyColor.R || multiplyColor.G != nextMultiplyColor.G ||
+        multiplyColor.B != nextMultiplyColor.B || multiplyColor.A != nextMultiplyColor.A)
+    {
+        return false;
+    }
+
+    const CubismTextureColor screenColor = model->GetScreenColor(index);
+    const CubismTextureColor nextScreenColor = model->GetScreenColor(nextIndex);
+    if (screenColor.R != nextScreenColor.R || screenColor.G != nextScreenColor.G ||
+        screenColor.B != nextScreenColor.B || screenColor.A != nextScreenColor.A)
+    {
+        return false;
+    }
+
+    return true;
+}
+
+void CubismRenderer_OpenGLES2::CountDrawCall(GLuint program, GLuint texture, GLuint maskTexture)
+{
+    _drawStatistics.DrawCallCount++;
+
+    if (_lastStatisticsState[0] != program || _lastStatisticsState[1] != texture || _lastStatisticsState[2] != maskTexture)
+    {
+        _drawStatistics.StateChangeCount++;
+        _lastStatisticsState[0] = program;
+        _lastStatisticsState[1] = texture;
+        _lastStatisticsState[2] = maskTexture;
+    }
+}
+
+void CubismRenderer_OpenGLES2::ReleaseVertexBuffers()
+{
+#ifdef CSM_OPENGL_VERTEX_BUFFER_OBJECT
+    if (_vertexArray != 0)
+    {
+        glDeleteVertexArrays(1, &_vertexArray);
+        _vertexArray = 0;
+    }
+
+    for (csmInt32 i = 0; i < PositionSlotCount; ++i)
+    {
+        if (_positionFences[i] != NULL)
+        {
+            glDeleteSync(_positionFences[i]);
+            _positionFences[i] = NULL;
+        }
+    }
+
+    GLuint buffers[] = {_positionBuffer, _uvBuffer, _indexBuffer};
+    glDeleteBuffers(3, buffers);
+    _positionBuffer = 0;
+    _uvBuffer = 0;
+    _indexBuffer = 0;
+#endif
+}
+
+void CubismRenderer_OpenGLES2::UploadVertexPositions()
+{
+#ifdef CSM_OPENGL_VERTEX_BUFFER_OBJECT
+    const CubismModel* model = GetModel();
+    const csmInt32 drawableCount = model->GetDrawableCount();
+
+    // 前回までの描画が参照している区画は書き換えず、次の区画へ進む
+    _positionSlot = (_positionSlot + 1) % PositionSlotCount;
+    if (_positionFences[_positionSlot] != NULL)
+    {
+        // この区画を使った描画は PositionSlotCount 回前なので、通常は待たずに完了している
+        GLenum result;
+        do
+        {
+            result = glClientWaitSync(_positionFences[_positionSlot], GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000);
+        } while (result == GL_TIMEOUT_EXPIRED);
+
+        glDeleteSync(_positionFences[_positionSlot]);
+        _positionFences[_positionSlot] = NULL;
+    }
+
+    csmUint32* slotGenerations = _slotGenerations.GetPtr() + _positionSlot * drawableCount;
+    _dirtyVertexRanges.Clear();
+
+    for (csmInt32 i = 0; i < drawableCount; ++i)
+    {
+        const csmInt32 vertexCount = model->GetDrawableVertexCount(i);
+        if (vertexCount <= 0)
+        {
+            continue;
+        }
+
+        // 非表示のDrawableは表示されたときに転送する。マスクとしては非表示でも描かれる
+        if (!model->GetDrawableDynamicFlagIsVisible(i) && !_clippingSources[i])
+        {
+            continue;
+        }
+
+        // コアの VertexPositionsDidChange は直前の csmUpdateModel との比較で、描画の間に複数回更新すると取りこぼす。
+        // また座標が同じでも計算されたDrawableには立つため、転送済みの内容と比較して判定する
+        const Core::csmVector2* positions = model->GetDrawableVertexPositions(i);
+        Core::csmVector2* uploaded = _uploadedPositions.GetPtr() + _vertexOffsets[i];
+        const csmSizeType size = sizeof(Core::csmVector2) * vertexCount;
+        if (_positionGenerations[i] == 0 || memcmp(uploaded, positions, size) != 0)
+        {
+            memcpy(uploaded, positions, size);
+            _positionGenerations[i]++;
+        }
+
+        // 区画ごとに最後に書き込んだ時点から変化したDrawableだけ転送する
+        if (slotGenerations[i] == _positionGenerations[i])
+        {
+            continue;
+        }
+        slotGenerations[i] = _positionGenerations[i];
+
+        // 隣り合うDrawableの転送はまとめて1回にする
+        const csmUint32 rangeCount = _dirtyVertexRanges.GetSize();
+        if (rangeCount > 0 && _dirtyVertexRanges[rangeCount - 1] == _vertexOffsets[i])
+        {
+            _dirtyVertexRanges[rangeCount - 1] = _vertexOffsets[i] + vertexCount;
+        }
+        else
+        {
+            _dirtyVertexRanges.PushBack(_vertexOffsets[i]);
+            _dirtyVertexRanges.PushBack(_vertexOffsets[i] + vertexCount);
+        }
+
+        _drawStatistics.UploadedDrawableCount++;
+        _drawStatistics.UploadedVertexBytes += size;
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, _positionBuffer);
+
+    FlushVertexPositions();
+
+    // VAOの頂点座標を今回の区画に向ける
+    CubismRendererStateCache_OpenGLES2::GetInstance()->BindVertexArray(_vertexArray);
+    const csmSizeType slotOffset = sizeof(Core::csmVector2) * static_cast<csmSizeType>(_positionSlot) * _vertexTotal;
+    glVertexAttribPointer(CubismShader_OpenGLES2::AttributePositionIndex, 2, GL_FLOAT, GL_FALSE, sizeof(csmFloat32) * 2, reinterpret_cast<const void*>(slotOffset));
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+#endif
+}
+
+void CubismRenderer_OpenGLES2::FlushVertexPositions()
+{
+#ifdef CSM_OPENGL_VERTEX_BUFFER_OBJECT
+    const csmUint32 rangeCount = _dirtyVertexRanges.GetSize();
+    if (rangeCount == 0)
+    {
+        return;
+    }
+
+    // 転送する範囲をまとめてマップする。間の転送しない範囲は内容を残すため INVALIDATE は指定しない
+    // フェンスで区画の描画の完了を確認しているので、ドライバの同期は省く
+    const csmInt32 slotBegin = _positionSlot * _vertexTotal;
+    const csmInt32 mapBegin = _dirtyVertexRanges[0];
+    const csmInt32 mapEnd = _dirtyVertexRanges[rangeCount - 1];
+    GLbitfield access = GL_MAP_WRITE_BIT | GL_MAP_FLUSH_EXPLICIT_BIT;
+    if (_useSyncObjects)
+    {
+        access |= GL_MAP_UNSYNCHRONIZED_BIT;
+    }
+    Core::csmVector2* mapped = reinterpret_cast<Core::csmVector2*>(glMapBufferRange(GL_ARRAY_BUFFER,
+        sizeof(Core::csmVector2) * (slotBegin + mapBegin), sizeof(Core::csmVector2) * (mapEnd - mapBegin), access));
+
+    for (csmUint32 i = 0; i < rangeCount; i += 2)
+    {
+        const csmInt32 vertexBegin = _dirtyVertexRanges[i];
+        const csmSizeType size = sizeof(Core::csmVector2) * (_dirtyVertexRanges[i + 1] - vertexBegin);
+        if (mapped != NULL)
+        {
+            memcpy(mapped + (vertexBegin - mapBegin), _uploadedPositions.GetPtr() + vertexBegin, size);
+            glFlushMappedBufferRange(GL_ARRAY_BUFFER, sizeof(Core::csmVector2) * (vertexBegin - mapBegin), size);
+        }
+        else
+        {
+            glBufferSubData(GL_ARRAY_BUFFER, sizeof(Core::csmVector2) * (slotBegin + vertexBegin), size, _uploadedPositions.GetPtr() + vertexBegin);
+        }
+    }
+
+    if (mapped != NULL && glUnmapBuffer(GL_ARRAY_BUFFER) == GL_FALSE)
+    {
+        // 区画の内容が失われたので、写しから区画全体を転送し直す
+        const csmInt32 drawableCount = GetModel()->GetDrawableCount();
+        glBufferSubData(GL_ARRAY_BUFFER, sizeof(Core::csmVector2) * slotBegin, sizeof(Core::csmVector2) * _vertexTotal, _uploadedPositions.GetPtr());
+        for (csmInt32 i = 0; i < drawableCount; ++i)
+        {
+            _slotGenerations[_positionSlot * drawableCount + i] = _positionGenerations[i];
+        }
+    }
+#endif
+}
+
+const CubismRenderer_OpenGLES2::DrawStatistics& CubismRenderer_OpenGLES2::GetDrawStatistics() const
+{
+    return _drawStatistics;
+}
+
 }}}}
 
 //------------ LIVE2D NAMESPACE ------------
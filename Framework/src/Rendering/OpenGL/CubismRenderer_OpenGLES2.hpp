@@ -46,6 +46,12 @@
 #include <GLES2/gl2ext.h>
 #endif
 
+// 頂点バッファオブジェクト(VAO/VBO)による描画を利用できるヘッダか
+// 実際に使うかどうかは実行時のOpenGLのバージョンで判定する
+#if defined(CSM_TARGET_WIN_GL) || defined(CSM_TARGET_LINUX_GL) || defined(CSM_TARGET_HARMONYOS_ES3) || (defined(CSM_TARGET_MAC_GL) && !defined(CSM_TARGET_COCOS))
+#define CSM_OPENGL_VERTEX_BUFFER_OBJECT
+#endif
+
 //------------ LIVE2D NAMESPACE ------------
 namespace Live2D { namespace Cubism { namespace Framework { namespace Rendering {
 
@@ -53,6 +59,7 @@ namespace Live2D { namespace Cubism { namespace Framework { namespace Rendering
 class CubismRenderer_OpenGLES2;
 class CubismClippingContext_OpenGLES2;
 class CubismShader_OpenGLES2;
+class CubismRendererProfile_OpenGLES2;
 
 /**
  * @brief  クリッピングマスクの処理を実行するクラス
@@ -71,6 +78,15 @@ public:
      * @param[in]   lastViewport ->  ビューポート
      */
     void SetupClippingContext(CubismModel& model, CubismRenderer_OpenGLES2* renderer, GLint lastFBO, GLint lastViewport[4]);
+
+    /**
+     * @brief   バッファに残っているマスクを全て無効にし、次の SetupClippingContext() で描き直させる。<br>
+     *          マスク用のバッファを作り直したときや、高精細マスクでバッファを上書きしたときに呼ぶ。
+     */
+    void InvalidateMasks();
+
+private:
+    csmVector<csmBool> _dirtyChannelFlags;      ///< レンダーテクスチャ・チャンネルごとの、マスクを描き直すかのフラグ
 };
 
 /**
@@ -100,7 +116,136 @@ public:
      */
     CubismClippingManager<CubismClippingContext_OpenGLES2, CubismOffscreenSurface_OpenGLES2>* GetClippingManager();
 
+    /**
+     * @brief   マスクの描画に使う値を前回描いたときの値と比べ、今回の値を記録する。
+     *
+     * @param[in]   model       ->  モデルのインスタンス
+     * @param[in]   renderer    ->  レンダラのインスタンス
+     *
+     * @return  前回から変わっていればtrue。前回描いたマスクが残っていない場合もtrue
+     */
+    csmBool UpdateMaskState(const CubismModel& model, CubismRenderer_OpenGLES2* renderer);
+
     CubismClippingManager<CubismClippingContext_OpenGLES2, CubismOffscreenSurface_OpenGLES2>* _owner;        ///< このマスクを管理しているマネージャのインスタンス
+
+    csmBool _isMaskDrawn;                           ///< 前回描いたマスクがバッファに残っているか
+    csmInt32 _drawnBufferIndex;                     ///< 前回描いたレンダーテクスチャ
+    csmInt32 _drawnLayoutChannelIndex;              ///< 前回描いたチャンネル
+    csmRectF _drawnLayoutBounds;                    ///< 前回描いた範囲
+    csmFloat32 _drawnMatrixForMask[16];             ///< 前回描いたときのマスク用の行列
+    csmVector<Core::csmVector2> _drawnVertexPositions;  ///< 前回描いたときのマスク用Drawableの頂点座標
+    csmVector<GLuint> _drawnTextures;               ///< 前回描いたときのマスク用Drawableのテクスチャ。描かなかったDrawableは0
+};
+
+/**
+ * @brief   レンダラが設定したOpenGLES2のステートの写しを持ち、写しと同じ値の設定を省略するクラス<br>
+ *           写しはOpenGLのコンテキストごとに1つ持ち、そのコンテキストに描画する全てのレンダラで共有する。
+ *           コンテキストは同時に1つのスレッドでしか現在のコンテキストにならないため、写しは排他せずに使う。
+ *
+ */
+class CubismRendererStateCache_OpenGLES2
+{
+    friend class CubismClippingManager_OpenGLES2;
+    friend class CubismRenderer_OpenGLES2;
+    friend class CubismRendererProfile_OpenGLES2;
+    friend class CubismShader_OpenGLES2;
+
+private:
+    /**
+     * @brief   呼び出したスレッドで現在のコンテキストの写しを取得する<br>
+     *           現在のコンテキストを特定できない場合はスレッドごとの写しを返す。
+     */
+    static CubismRendererStateCache_OpenGLES2* GetInstance();
+
+    /**
+     * @brief   全てのコンテキストの写しを、次に取得したときに不明にする
+     */
+    static void InvalidateAll();
+
+    /**
+     * @brief   privateなコンストラクタ
+     *
+     * @param[in]   contextKnown    ->  写しのコンテキストを特定できているか
+     */
+    CubismRendererStateCache_OpenGLES2(csmBool contextKnown);
+
+    /**
+     * @brief   写しを全て不明にする。次の設定は必ず実行される。
+     */
+    void Invalidate();
+
+    /**
+     * @brief   保存したステートを写しにする
+     *
+     * @param[in]   profile ->  Save() 直後のプロファイル
+     */
+    void Load(const CubismRendererProfile_OpenGLES2& profile);
+
+    /**
+     * @brief   glUseProgram の写し付きの呼び出し
+     */
+    void UseProgram(GLuint program);
+
+    /**
+     * @brief   glActiveTexture の写し付きの呼び出し
+     */
+    void ActiveTexture(GLenum unit);
+
+    /**
+     * @brief   テクスチャユニットにテクスチャをバインドする
+     *
+     * @param[in]   unit    ->  GL_TEXTURE0 か GL_TEXTURE1
+     * @param[in]   texture ->  バインドするテクスチャ
+     */
+    void BindTexture(GLenum unit, GLuint texture);
+
+    /**
+     * @brief   機能の有効・無効をセットする
+     *
+     * @param[in]   capability  ->  GL_SCISSOR_TEST, GL_STENCIL_TEST, GL_DEPTH_TEST, GL_CULL_FACE, GL_BLEND のいずれか
+     * @param[in]   enabled     ->  trueなら有効にする
+     */
+    void SetEnable(GLenum capability, GLboolean enabled);
+
+    /**
+     * @brief   glFrontFace の写し付きの呼び出し
+     */
+    void FrontFace(GLenum mode);
+
+    /**
+     * @brief   glColorMask の写し付きの呼び出し
+     */
+    void ColorMask(GLboolean red, GLboolean green, GLboolean blue, GLboolean alpha);
+
+    /**
+     * @brief   glBlendFuncSeparate の写し付きの呼び出し
+     */
+    void BlendFuncSeparate(GLenum srcColor, GLenum dstColor, GLenum srcAlpha, GLenum dstAlpha);
+
+    /**
+     * @brief   glBindVertexArray の写し付きの呼び出し。VAOに対応していない環境では何もしない
+     */
+    void BindVertexArray(GLuint vertexArray);
+
+    static const csmInt32 CapabilityCount = 5;
+
+    /**
+     * @brief   機能に対応する _enabled の位置を取得する
+     */
+    static csmInt32 GetCapabilityIndex(GLenum capability);
+
+    // -1は不明
+    GLint _program;                         ///< シェーダプログラム
+    GLint _activeTexture;                   ///< アクティブなテクスチャユニット
+    GLint _texture2D[2];                    ///< テクスチャユニット0,1にバインドされたテクスチャ
+    GLint _enabled[CapabilityCount];        ///< 機能の有効・無効
+    GLint _frontFace;                       ///< 表面の向き
+    GLint _colorMask[4];                    ///< カラーマスク
+    GLint _blending[4];                     ///< カラーブレンディングパラメータ
+    GLint _vertexArray;                     ///< VAO
+    csmUint64 _skippedCallCount;            ///< 省略した設定の累計
+    csmBool _contextKnown;                  ///< 写しのコンテキストを特定できているか。できていなければ信頼モードでもステートを問い合わせる
+    csmUint32 _generation;                  ///< InvalidateAll() の回数。全体の回数と違えば不明にする
 };
 
 /**
@@ -110,6 +255,7 @@ public:
 class CubismRendererProfile_OpenGLES2
 {
     friend class CubismRenderer_OpenGLES2;
+    friend class CubismRendererStateCache_OpenGLES2;
 
 private:
     /**
@@ -166,6 +312,8 @@ private:
     GLint _lastBlending[4];                 ///< モデル描画直前のカラーブレンディングパラメータ
     GLint _lastFBO;                         ///< モデル描画直前のフレームバッファ
     GLint _lastViewport[4];                 ///< モデル描画直前のビューポート
+    GLint _lastVertexArrayBinding;          ///< モデル描画直前のVAO
+    csmBool _vertexArrayEnabled;            ///< VAOを保存・復帰の対象にするか。VAOに対応していない環境ではfalse
 };
 
 /**
@@ -176,9 +324,25 @@ class CubismRenderer_OpenGLES2 : public CubismRenderer
 {
     friend class CubismRenderer;
     friend class CubismClippingManager_OpenGLES2;
+    friend class CubismClippingContext_OpenGLES2;
     friend class CubismShader_OpenGLES2;
 
 public:
+    /**
+     * @brief   直近の DrawModel() 1回分の統計
+     */
+    struct DrawStatistics
+    {
+        csmInt32 UploadedDrawableCount;     ///< 頂点座標を転送したDrawableの数
+        csmSizeType UploadedVertexBytes;    ///< 転送した頂点座標のバイト数
+        csmInt32 DrawCallCount;             ///< 描画命令の数。マスクの描画を含む
+        csmInt32 BatchedDrawableCount;      ///< 直前のDrawableと1回の描画命令にまとめたDrawableの数
+        csmInt32 StateChangeCount;          ///< シェーダプログラムかテクスチャが直前の描画命令から切り替わった回数
+        csmInt32 SkippedStateCallCount;     ///< 現在のステートと同じ値だったため省略したステート設定の数
+        csmInt32 ClippingMaskCount;         ///< クリッピングマスクの数
+        csmInt32 RedrawnClippingMaskCount;  ///< 描き直したクリッピングマスクの数。高精細マスクでは描いた回数
+    };
+
     /**
      * @brief    レンダラの初期化処理を実行する<br>
      *           引数に渡したモデルからレンダラの初期化処理に必要な情報を取り出すことができる
@@ -239,6 +403,98 @@ public:
      */
     CubismOffscreenSurface_OpenGLES2* GetMaskBuffer(csmInt32 index);
 
+    /**
+     * @brief  頂点バッファオブジェクトを使って描画するかを設定する<br>
+     *         OpenGL 3.0 / OpenGL ES 3.0 以上の環境では、UVとインデックスを静的なバッファに一度だけ転送し、
+     *         頂点座標を毎フレームストリーミング用のバッファに転送してVAOから描画する。
+     *         それ以外の環境ではこの設定に関わらずクライアント側の配列から描画する。初期値はtrue。
+     *
+     * @param[in]  enable -> trueなら頂点バッファオブジェクトを使う
+     */
+    void UseVertexBufferObject(csmBool enable);
+
+    /**
+     * @brief  頂点バッファオブジェクトを使って描画しているかを取得する<br>
+     *         初回はOpenGLのバージョンを確認するため、コンテキストがカレントの状態で呼ぶこと。
+     *
+     * @return 頂点バッファオブジェクトを使っていればtrue
+     */
+    csmBool IsUsingVertexBufferObject();
+
+    /**
+     * @brief  描画順で連続するDrawableをまとめて描画するかを設定する<br>
+     *         テクスチャ・ブレンドモード・クリッピングマスク・カリング・不透明度・乗算色・スクリーン色が
+     *         すべて一致するDrawableを1回の描画命令にまとめる。頂点バッファオブジェクトを使う場合だけ有効。初期値はtrue。
+     *
+     * @param[in]  enable -> trueならまとめて描画する
+     */
+    void UseDrawCallBatching(csmBool enable);
+
+    /**
+     * @brief  描画順で連続するDrawableをまとめて描画する設定かを取得する
+     *
+     * @return まとめて描画する設定ならtrue
+     */
+    csmBool IsUsingDrawCallBatching() const;
+
+    /**
+     * @brief  前回描いたクリッピングマスクを再利用するかを設定する<br>
+     *         マスク用Drawableの頂点座標・テクスチャとマスクの配置が前回と同じマスクは描き直さない。
+     *         マスク用のバッファはチャンネルごとにクリアし、変化したマスクを含むチャンネルだけ描き直す。初期値はtrue。
+     *
+     * @param[in]  enable -> trueなら再利用する
+     */
+    void UseClippingMaskReuse(csmBool enable);
+
+    /**
+     * @brief  前回描いたクリッピングマスクを再利用する設定かを取得する
+     *
+     * @return 再利用する設定ならtrue
+     */
+    csmBool IsUsingClippingMaskReuse() const;
+
+    /**
+     * @brief  直近の DrawModel() の統計を取得する<br>
+     *         頂点バッファオブジェクトを使う場合は座標が変化したDrawableだけを転送した量、
+     *         クライアント側の配列から描画する場合は描画命令ごとにドライバへ渡した量になる。
+     *
+     * @return 統計
+     */
+    const DrawStatistics& GetDrawStatistics() const;
+
+    /**
+     * @brief  ホストがモデルの描画の間にOpenGLのステートを変更しないことを宣言する<br>
+     *         trueにすると DrawModel() の前後でのステートの保存と復帰を行わず、描画後はレンダラが設定したステートのまま残る。
+     *         描画先のフレームバッファとビューポートだけは毎回取得する。
+     *         ホストがステートを変更した場合は、そのコンテキストを現在にして InvalidateStateCache() を呼ぶこと。
+     *         写しはコンテキストごとに持つ。現在のコンテキストを特定できない場合は宣言していても保存と復帰を行う。初期値はfalse。
+     *
+     * @param[in]  trusted -> trueならステートを保存・復帰しない
+     */
+    static void SetTrustedHost(csmBool trusted);
+
+    /**
+     * @brief  ホストがステートを変更しないと宣言されているかを取得する
+     *
+     * @return 宣言されていればtrue
+     */
+    static csmBool IsTrustedHost();
+
+    /**
+     * @brief  現在のコンテキストについてレンダラが持つOpenGLのステートの写しを破棄する<br>
+     *         レンダラの外でテクスチャのバインドなどステートを変更した後に呼ぶ。
+     *         コンテキストを作り直した場合も、古いコンテキストと同じアドレスになりうるため呼ぶ。
+     */
+    static void InvalidateStateCache();
+
+    /**
+     * @brief  呼び出したスレッドで現在のOpenGLコンテキストを取得する<br>
+     *         ステートの写しなど、コンテキストごとに持つ情報の区別に使う。
+     *
+     * @return コンテキスト。現在のコンテキストが無いか、特定できない環境ではNULL
+     */
+    static void* GetCurrentContext();
+
 protected:
     /**
      * @brief   コンストラクタ
@@ -265,6 +521,17 @@ protected:
      */
     void DrawMeshOpenGL(const CubismModel& model, const csmInt32 index);
 
+    /**
+     * @brief    描画順で連続する複数の描画オブジェクトを1回で描画する。<br>
+     *           ステートは先頭の描画オブジェクトのものを使う。
+     *
+     * @param[in]   model       ->  描画対象のモデル
+     * @param[in]   index       ->  先頭のメッシュのインデックス
+     * @param[in]   indexCount  ->  まとめたメッシュのインデックスの総数
+     *
+     */
+    void DrawMeshOpenGL(const CubismModel& model, const csmInt32 index, const csmInt32 indexCount);
+
 #ifdef CSM_TARGET_ANDROID_ES2
 public:
     /**
@@ -353,6 +620,59 @@ private:
      */
     GLuint GetBindedTextureId(csmInt32 textureId);
 
+    /**
+     * @brief   現在のOpenGLコンテキストが頂点バッファオブジェクトによる描画に対応しているかを判定する。
+     */
+    static csmBool CheckVertexBufferObjectSupport();
+
+    /**
+     * @brief   VAOと静的なUV・インデックスのバッファを作成する。
+     */
+    void CreateVertexBuffers();
+
+    /**
+     * @brief   VAOと頂点バッファを破棄する。
+     */
+    void ReleaseVertexBuffers();
+
+    /**
+     * @brief   頂点座標のバッファの次の区画へ、その区画に転送した時点から座標が変化したDrawableの頂点座標を転送する。<br>
+     *          非表示でマスクにも使われないDrawableは表示されるまで転送しない。
+     */
+    void UploadVertexPositions();
+
+    /**
+     * @brief   _dirtyVertexRanges の範囲を転送済みの写しから今回の区画へ書き込む。
+     */
+    void FlushVertexPositions();
+
+    /**
+     * @brief   描画順が変わっていればインデックスのバッファを描画順に並べ直す。<br>
+     *          描画順で連続するDrawableのインデックスがバッファ上でも連続するため、まとめて1回で描画できる。
+     */
+    void UpdateIndexBuffer();
+
+    /**
+     * @brief   2つのDrawableを1回の描画命令にまとめられるかを判定する。
+     *
+     * @param[in]   index       ->  先に描くDrawableのインデックス
+     * @param[in]   clip        ->  先に描くDrawableのクリッピングコンテキスト
+     * @param[in]   nextIndex   ->  続けて描くDrawableのインデックス
+     * @param[in]   nextClip    ->  続けて描くDrawableのクリッピングコンテキスト
+     *
+     * @return  シェーダ・テクスチャ・ユニフォーム変数がすべて一致すればtrue
+     */
+    csmBool CanBatchDrawables(csmInt32 index, const CubismClippingContext_OpenGLES2* clip, csmInt32 nextIndex, const CubismClippingContext_OpenGLES2* nextClip);
+
+    /**
+     * @brief   描画命令の統計を記録する。シェーダから描画命令ごとに呼ばれる。
+     *
+     * @param[in]   program     ->  使用するシェーダプログラム
+     * @param[in]   texture     ->  モデルのテクスチャ
+     * @param[in]   maskTexture ->  クリッピングマスクのテクスチャ。使わない場合は0
+     */
+    void CountDrawCall(GLuint program, GLuint texture, GLuint maskTexture);
+
 #ifdef CSM_TARGET_WIN_GL
     /**
      * @brief   Windows対応。OpenGL命令のバインドを行う。
@@ -378,6 +698,35 @@ private:
     CubismClippingContext_OpenGLES2* _clippingContextBufferForDraw;  ///< 画面上描画するためのクリッピングコンテキスト
 
     csmVector<CubismOffscreenSurface_OpenGLES2>   _offscreenSurfaces;          ///< マスク描画用のフレームバッファ
+
+    csmBool _useVertexBufferObject;             ///< 頂点バッファオブジェクトを使う設定か
+    csmInt32 _vertexBufferObjectSupport;        ///< 環境が頂点バッファオブジェクトに対応しているか。-1なら未確認
+    GLuint _vertexArray;                        ///< モデル全体で共有するVAO
+    static const csmInt32 PositionSlotCount = 3;    ///< 頂点座標のバッファの区画数
+
+    GLuint _positionBuffer;                     ///< 頂点座標。PositionSlotCount 個の区画を描画ごとに順に使い、変化したDrawableの範囲だけ更新する
+    GLuint _uvBuffer;                           ///< UV。作成時に一度だけ転送する
+    GLuint _indexBuffer;                        ///< インデックス。Drawableごとの頂点の先頭位置を加算済み
+    csmVector<csmInt32> _vertexOffsets;         ///< Drawableごとの頂点の先頭位置
+    csmVector<csmInt32> _indexOffsets;          ///< Drawableごとのインデックスの先頭位置
+    csmInt32 _vertexTotal;                      ///< 全Drawableの頂点数
+    csmVector<Core::csmVector2> _uploadedPositions;  ///< _positionBuffer に転送済みの頂点座標の写し
+    csmVector<csmUint32> _positionGenerations;  ///< Drawableごとに _uploadedPositions を更新した回数。0なら未転送
+    csmVector<csmUint32> _slotGenerations;      ///< 区画・Drawableごとに書き込んだ時点の _positionGenerations
+    csmVector<csmInt32> _dirtyVertexRanges;     ///< 今回の区画へ書き込む頂点の範囲。先頭と終端の組
+    csmInt32 _positionSlot;                     ///< 今回の描画で使う頂点座標の区画
+    csmBool _useSyncObjects;                    ///< フェンスで区画の描画の完了を確認できるか
+#ifdef CSM_OPENGL_VERTEX_BUFFER_OBJECT
+    GLsync _positionFences[PositionSlotCount];  ///< 区画を最後に使った描画の完了を示すフェンス
+#endif
+    csmVector<csmBool> _clippingSources;        ///< Drawableがクリッピングマスクとして描かれるか
+    DrawStatistics _drawStatistics;             ///< 直近の描画の統計
+    csmBool _useDrawCallBatching;               ///< 連続するDrawableをまとめて描画する設定か
+    csmBool _useClippingMaskReuse;              ///< 前回描いたクリッピングマスクを再利用する設定か
+    csmUint64 _skippedCallCountAtSave;          ///< 統計用。SaveProfile() 時点の省略したステート設定の累計
+    csmBool _isProfileSaved;                    ///< SaveProfile() でステートを保存したか。RestoreProfile() で戻す
+    csmVector<csmInt32> _indexOrder;            ///< _indexBuffer を並べた時点の描画順
+    GLuint _lastStatisticsState[3];             ///< 統計用。直前の描画命令のシェーダプログラムとテクスチャ
 };
 
 }}}}
@@ -471,6 +471,9 @@ void CubismShader_OpenGLES2::ReleaseShaderProgram()
             CSM_DELETE(_shaderSets[i]);
         }
     }
+
+    // 削除したプログラムの名前は再利用されるため、写しに残さない
+    CubismRendererStateCache_OpenGLES2::GetInstance()->Invalidate();
 }
 
 void CubismShader_OpenGLES2::ReleaseInvalidShaderProgram()
@@ -851,22 +854,25 @@ void CubismShader_OpenGLES2::SetupShaderProgramForDraw(CubismRenderer_OpenGLES2*
         break;
     }
 
-    glUseProgram(shaderSet->ShaderProgram);
+    CubismRendererStateCache_OpenGLES2::GetInstance()->UseProgram(shaderSet->ShaderProgram);
 
     //テクスチャ設定
     SetupTexture(renderer, model, index, shaderSet);
 
-    // 頂点属性設定
-    SetVertexAttributes(model, index, shaderSet);
+    // 頂点属性設定。頂点バッファオブジェクトを使う場合はVAOに記録済み
+    if (!renderer->IsUsingVertexBufferObject())
+    {
+        SetVertexAttributes(model, index, shaderSet);
+    }
 
+    GLuint maskTexture = 0;
     if (masked)
     {
-        glActiveTexture(GL_TEXTURE1);
-
         // frameBufferに書かれたテクスチャ
         GLuint tex = renderer->GetMaskBuffer(renderer->GetClippingContextBufferForDraw()->_bufferIndex)->GetColorBuffer();
+        maskTexture = tex;
 
-        glBindTexture(GL_TEXTURE_2D, tex);
+        CubismRendererStateCache_OpenGLES2::GetInstance()->BindTexture(GL_TEXTURE1, tex);
         glUniform1i(shaderSet->SamplerTexture1Location, 1);
 
         // View座標をClippingContextの座標に変換するための行列を設定
@@ -885,7 +891,9 @@ void CubismShader_OpenGLES2::SetupShaderProgramForDraw(CubismRenderer_OpenGLES2*
     CubismRenderer::CubismTextureColor screenColor = model.GetScreenColor(index);
     SetColorUniformVariables(renderer, model, index, shaderSet, baseColor, multiplyColor, screenColor);
 
-    glBlendFuncSeparate(SRC_COLOR, DST_COLOR, SRC_ALPHA, DST_ALPHA);
+    CubismRendererStateCache_OpenGLES2::GetInstance()->BlendFuncSeparate(SRC_COLOR, DST_COLOR, SRC_ALPHA, DST_ALPHA);
+
+    renderer->CountDrawCall(shaderSet->ShaderProgram, renderer->GetBindedTextureId(model.GetDrawableTextureIndex(index)), maskTexture);
 }
 
 void CubismShader_OpenGLES2::SetupShaderProgramForMask(CubismRenderer_OpenGLES2* renderer, const CubismModel& model, const csmInt32 index)
@@ -902,13 +910,16 @@ void CubismShader_OpenGLES2::SetupShaderProgramForMask(CubismRenderer_OpenGLES2*
     csmInt32 DST_ALPHA = GL_ONE_MINUS_SRC_ALPHA;
 
     CubismShaderSet* shaderSet = _shaderSets[ShaderNames_SetupMask];
-    glUseProgram(shaderSet->ShaderProgram);
+    CubismRendererStateCache_OpenGLES2::GetInstance()->UseProgram(shaderSet->ShaderProgram);
 
     //テクスチャ設定
     SetupTexture(renderer, model, index, shaderSet);
 
-    // 頂点属性設定
-    SetVertexAttributes(model, index, shaderSet);
+    // 頂点属性設定。頂点バッファオブジェクトを使う場合はVAOに記録済み
+    if (!renderer->IsUsingVertexBufferObject())
+    {
+        SetVertexAttributes(model, index, shaderSet);
+    }
 
     // 使用するカラーチャンネルを設定
     SetColorChannelUniformVariables(shaderSet, renderer->GetClippingContextBufferForMask());
@@ -922,7 +933,9 @@ void CubismShader_OpenGLES2::SetupShaderProgramForMask(CubismRenderer_OpenGLES2*
     CubismRenderer::CubismTextureColor screenColor = model.GetScreenColor(index);
     SetColorUniformVariables(renderer, model, index, shaderSet, baseColor, multiplyColor, screenColor);
 
-    glBlendFuncSeparate(SRC_COLOR, DST_COLOR, SRC_ALPHA, DST_ALPHA);
+    CubismRendererStateCache_OpenGLES2::GetInstance()->BlendFuncSeparate(SRC_COLOR, DST_COLOR, SRC_ALPHA, DST_ALPHA);
+
+    renderer->CountDrawCall(shaderSet->ShaderProgram, renderer->GetBindedTextureId(model.GetDrawableTextureIndex(index)), 0);
 }
 
 csmBool CubismShader_OpenGLES2::CompileShaderSource(GLuint* outShader, GLenum shaderType, const csmChar* shaderSource)
@@ -1027,6 +1040,10 @@ GLuint CubismShader_OpenGLES2::LoadShaderProgram(const csmChar* vertShaderSrc, c
     // Attach fragment shader to program.
     glAttachShader(shaderProgram, fragShader);
 
+    // VAOを全てのシェーダで共有できるよう頂点属性の番号を揃える
+    glBindAttribLocation(shaderProgram, AttributePositionIndex, "a_position");
+    glBindAttribLocation(shaderProgram, AttributeTexCoordIndex, "a_texCoord");
+
     // Link program.
     if (!LinkProgram(shaderProgram))
     {
@@ -1084,8 +1101,7 @@ void CubismShader_OpenGLES2::SetupTexture(CubismRenderer_OpenGLES2* renderer, co
 {
     const csmInt32 textureIndex = model.GetDrawableTextureIndex(index);
     const GLuint textureId = renderer->GetBindedTextureId(textureIndex);
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, textureId);
+    CubismRendererStateCache_OpenGLES2::GetInstance()->BindTexture(GL_TEXTURE0, textureId);
     glUniform1i(shaderSet->SamplerTexture0Location, 0);
 }
 
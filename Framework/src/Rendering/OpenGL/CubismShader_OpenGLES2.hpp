@@ -53,6 +53,15 @@ class CubismClippingContext_OpenGLES2;
 class CubismShader_OpenGLES2
 {
 public:
+    /**
+     * @brief   全てのシェーダで共通の頂点属性の番号。VAOに頂点属性を記録するために固定している
+     */
+    enum
+    {
+        AttributePositionIndex = 0,     ///< a_position
+        AttributeTexCoordIndex = 1,     ///< a_texCoord
+    };
+
     /**
      * @brief   インスタンスを取得する（シングルトン）。
      *
@@ -0,0 +1,1475 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#include "CubismRenderer_Software.hpp"
+#include "Math/CubismMatrix44.hpp"
+#include "Model/CubismModel.hpp"
+#include <float.h>
+#include <math.h>
+#include <string.h>
+#include <atomic>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CSM_SOFTWARE_RENDERER_SSE2
+#include <emmintrin.h>
+#endif
+
+//------------ LIVE2D NAMESPACE ------------
+namespace Live2D { namespace Cubism { namespace Framework { namespace Rendering {
+
+namespace {
+
+const csmInt32 TileHeight = 32;        ///< 複数のスレッドで描くときの帯の行数
+const csmInt32 MaxThreadCount = 16;
+const csmFloat32 ColorScale = 1.0f / 255.0f;
+
+/*********************************************************************************************************************
+*                                      RGBAの4要素をまとめて計算する型
+********************************************************************************************************************/
+#ifdef CSM_SOFTWARE_RENDERER_SSE2
+
+struct Color4
+{
+    __m128 V;
+};
+
+inline Color4 MakeColor(csmFloat32 r, csmFloat32 g, csmFloat32 b, csmFloat32 a)
+{
+    Color4 c = { _mm_setr_ps(r, g, b, a) };
+    return c;
+}
+
+inline Color4 SplatColor(csmFloat32 value)
+{
+    Color4 c = { _mm_set1_ps(value) };
+    return c;
+}
+
+inline Color4 operator+(const Color4& a, const Color4& b)
+{
+    Color4 c = { _mm_add_ps(a.V, b.V) };
+    return c;
+}
+
+inline Color4 operator-(const Color4& a, const Color4& b)
+{
+    Color4 c = { _mm_sub_ps(a.V, b.V) };
+    return c;
+}
+
+inline Color4 operator*(const Color4& a, const Color4& b)
+{
+    Color4 c = { _mm_mul_ps(a.V, b.V) };
+    return c;
+}
+
+/**
+ * @brief   アルファを全ての要素に広げる
+ */
+inline Color4 BroadcastAlpha(const Color4& a)
+{
+    Color4 c = { _mm_shuffle_ps(a.V, a.V, _MM_SHUFFLE(3, 3, 3, 3)) };
+    return c;
+}
+
+/**
+ * @brief   RGBA8のピクセルを 0..255 の値で読む
+ */
+inline Color4 LoadPixel(const csmUint8* pixel)
+{
+    csmInt32 packed;
+    memcpy(&packed, pixel, sizeof(packed));
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i words = _mm_unpacklo_epi8(_mm_cvtsi32_si128(packed), zero);
+    Color4 c = { _mm_cvtepi32_ps(_mm_unpacklo_epi16(words, zero)) };
+    return c;
+}
+
+/**
+ * @brief   0..1 の値を丸めてRGBA8のピクセルに書く
+ */
+inline void StorePixel(csmUint8* pixel, const Color4& color)
+{
+    const __m128 clamped = _mm_min_ps(_mm_max_ps(color.V, _mm_setzero_ps()), _mm_set1_ps(1.0f));
+    const __m128i values = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(clamped, _mm_set1_ps(255.0f)), _mm_set1_ps(0.5f)));
+    const __m128i words = _mm_packs_epi32(values, values);
+    const csmInt32 packed = _mm_cvtsi128_si32(_mm_packus_epi16(words, words));
+    memcpy(pixel, &packed, sizeof(packed));
+}
+
+inline csmFloat32 GetAlpha(const Color4& color)
+{
+    return _mm_cvtss_f32(_mm_shuffle_ps(color.V, color.V, _MM_SHUFFLE(3, 3, 3, 3)));
+}
+
+#else
+
+struct Color4
+{
+    csmFloat32 V[4];
+};
+
+inline Color4 MakeColor(csmFloat32 r, csmFloat32 g, csmFloat32 b, csmFloat32 a)
+{
+    Color4 c = { { r, g, b, a } };
+    return c;
+}
+
+inline Color4 SplatColor(csmFloat32 value)
+{
+    return MakeColor(value, value, value, value);
+}
+
+inline Color4 operator+(const Color4& a, const Color4& b)
+{
+    return MakeColor(a.V[0] + b.V[0], a.V[1] + b.V[1], a.V[2] + b.V[2], a.V[3] + b.V[3]);
+}
+
+inline Color4 operator-(const Color4& a, const Color4& b)
+{
+    return MakeColor(a.V[0] - b.V[0], a.V[1] - b.V[1], a.V[2] - b.V[2], a.V[3] - b.V[3]);
+}
+
+inline Color4 operator*(const Color4& a, const Color4& b)
+{
+    return MakeColor(a.V[0] * b.V[0], a.V[1] * b.V[1], a.V[2] * b.V[2], a.V[3] * b.V[3]);
+}
+
+inline Color4 BroadcastAlpha(const Color4& a)
+{
+    return SplatColor(a.V[3]);
+}
+
+inline Color4 LoadPixel(const csmUint8* pixel)
+{
+    return MakeColor(pixel[0], pixel[1], pixel[2], pixel[3]);
+}
+
+inline void StorePixel(csmUint8* pixel, const Color4& color)
+{
+    for (csmInt32 i = 0; i < 4; i++)
+    {
+        const csmFloat32 value = color.V[i] < 0.0f ? 0.0f : (color.V[i] > 1.0f ? 1.0f : color.V[i]);
+        pixel[i] = static_cast<csmUint8>(value * 255.0f + 0.5f);
+    }
+}
+
+inline csmFloat32 GetAlpha(const Color4& color)
+{
+    return color.V[3];
+}
+
+#endif
+
+inline Color4 Lerp(const Color4& a, const Color4& b, csmFloat32 t)
+{
+    return a + (b - a) * SplatColor(t);
+}
+
+inline csmInt32 FloorToInt(csmFloat32 value)
+{
+    const csmInt32 truncated = static_cast<csmInt32>(value);
+    return (value < static_cast<csmFloat32>(truncated)) ? truncated - 1 : truncated;
+}
+
+/**
+ * @brief   GL_REPEAT と同じくテクスチャの範囲に折り返す
+ */
+inline csmInt32 Repeat(csmInt32 value, csmInt32 size)
+{
+    if ((size & (size - 1)) == 0)
+    {
+        return value & (size - 1);
+    }
+    value %= size;
+    return value < 0 ? value + size : value;
+}
+
+inline csmInt32 Clamp(csmInt32 value, csmInt32 minValue, csmInt32 maxValue)
+{
+    return value < minValue ? minValue : (value > maxValue ? maxValue : value);
+}
+
+inline csmFloat32 Min3(csmFloat32 a, csmFloat32 b, csmFloat32 c)
+{
+    return a < b ? (a < c ? a : c) : (b < c ? b : c);
+}
+
+inline csmFloat32 Max3(csmFloat32 a, csmFloat32 b, csmFloat32 c)
+{
+    return a > b ? (a > c ? a : c) : (b > c ? b : c);
+}
+
+/**
+ * @brief   三角形の辺の内外判定
+ *
+ * 2つの三角形が共有する辺で同じ値になるよう、頂点を座標の小さい順に並べた向きで計算し、
+ * 三角形の向きと逆であれば符号を反転して扱う。値が0の画素はどちらか一方の三角形だけが描く。
+ */
+struct Edge
+{
+    csmFloat32 Ax;
+    csmFloat32 Ay;
+    csmFloat32 Dx;
+    csmFloat32 Dy;
+    csmBool IsForward;  ///< 三角形の向きと同じ順か。同じなら値が0の画素を含む
+
+    void Setup(csmFloat32 x0, csmFloat32 y0, csmFloat32 x1, csmFloat32 y1)
+    {
+        IsForward = (x0 < x1) || (x0 == x1 && y0 < y1);
+        if (IsForward)
+        {
+            Ax = x0;
+            Ay = y0;
+            Dx = x1 - x0;
+            Dy = y1 - y0;
+        }
+        else
+        {
+            Ax = x1;
+            Ay = y1;
+            Dx = x0 - x1;
+            Dy = y0 - y1;
+        }
+    }
+
+    /**
+     * @brief   行 py で内側になりうる x の範囲を狭める。実際の判定は画素ごとに行う
+     */
+    void ClipSpan(csmFloat32 py, csmInt32& left, csmInt32& right) const
+    {
+        // 三角形の向きでの値 s * (Dx * (py - Ay) - Dy * (px - Ax)) が 0 以上になる px の範囲
+        const csmFloat32 dy = IsForward ? Dy : -Dy;
+        if (dy == 0.0f)
+        {
+            return;
+        }
+
+        csmFloat32 bound = Ax + Dx * (py - Ay) / Dy - 0.5f;
+
+        // 辺がほぼ水平な場合に整数へ変換できる範囲を超えないようにする
+        bound = bound < -16777216.0f ? -16777216.0f : (bound > 16777216.0f ? 16777216.0f : bound);
+        if (dy > 0.0f)
+        {
+            const csmInt32 limit = FloorToInt(bound) + 1;
+            right = right < limit ? right : limit;
+        }
+        else
+        {
+            const csmInt32 limit = FloorToInt(bound);
+            left = left > limit ? left : limit;
+        }
+    }
+};
+
+/**
+ * @brief   横に並んだ4画素 x .. x + 3 のうち三角形の内側にあるものをビットで返す
+ */
+inline csmInt32 QuadCoverage(const Edge* edges, csmInt32 x, csmFloat32 py)
+{
+#ifdef CSM_SOFTWARE_RENDERER_SSE2
+    const __m128 px = _mm_add_ps(_mm_set1_ps(static_cast<csmFloat32>(x) + 0.5f), _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f));
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 allOnes = _mm_castsi128_ps(_mm_set1_epi32(-1));
+    __m128 inside = allOnes;
+
+    for (csmInt32 i = 0; i < 3; i++)
+    {
+        const Edge& e = edges[i];
+        const __m128 value = _mm_sub_ps(_mm_set1_ps(e.Dx * (py - e.Ay)), _mm_mul_ps(_mm_set1_ps(e.Dy), _mm_sub_ps(px, _mm_set1_ps(e.Ax))));
+        const __m128 negative = _mm_cmplt_ps(value, zero);
+        inside = _mm_and_ps(inside, e.IsForward ? _mm_xor_ps(negative, allOnes) : negative);
+    }
+
+    return _mm_movemask_ps(inside);
+#else
+    csmInt32 mask = 0;
+    for (csmInt32 lane = 0; lane < 4; lane++)
+    {
+        const csmFloat32 px = static_cast<csmFloat32>(x + lane) + 0.5f;
+        csmBool inside = true;
+        for (csmInt32 i = 0; i < 3; i++)
+        {
+            const Edge& e = edges[i];
+            const csmFloat32 value = e.Dx * (py - e.Ay) - e.Dy * (px - e.Ax);
+            inside = inside && (e.IsForward ? !(value < 0.0f) : (value < 0.0f));
+        }
+        mask |= inside ? (1 << lane) : 0;
+    }
+    return mask;
+#endif
+}
+
+/**
+ * @brief   三角形の中で1次関数として変化する値。a0 + Dx * (px - x0) + Dy * (py - y0)
+ */
+struct Plane
+{
+    csmFloat32 A0;
+    csmFloat32 X0;
+    csmFloat32 Y0;
+    csmFloat32 Dx;
+    csmFloat32 Dy;
+
+    /**
+     * @param[in]   v           ->  3頂点の座標 x0, y0, x1, y1, x2, y2
+     * @param[in]   inverseArea ->  3頂点が作る平行四辺形の面積の逆数
+     */
+    void Setup(csmFloat32 a0, csmFloat32 a1, csmFloat32 a2, const csmFloat32* v, csmFloat32 inverseArea)
+    {
+        A0 = a0;
+        X0 = v[0];
+        Y0 = v[1];
+        Dx = ((a1 - a0) * (v[5] - v[1]) - (a2 - a0) * (v[3] - v[1])) * inverseArea;
+        Dy = ((a2 - a0) * (v[2] - v[0]) - (a1 - a0) * (v[4] - v[0])) * inverseArea;
+    }
+
+    csmFloat32 At(csmFloat32 px, csmFloat32 py) const
+    {
+        return A0 + Dx * (px - X0) + Dy * (py - Y0);
+    }
+};
+
+}
+
+/*********************************************************************************************************************
+*                                      CubismRenderThreadPool_Software
+********************************************************************************************************************/
+/**
+ * @brief   帯を並列に描くためのスレッドプール。呼び出し元のスレッドも作業に参加する
+ *
+ * スレッド数が同じレンダラの間で1つを共有する。Acquire() で参照を得て Release() で返す。
+ */
+class CubismRenderThreadPool_Software
+{
+public:
+    typedef void (*TaskFunction)(void* context, csmInt32 index);
+
+    /**
+     * @brief   指定したスレッド数の共有のプールを得る。なければ作成する
+     */
+    static CubismRenderThreadPool_Software* Acquire(csmInt32 threadCount)
+    {
+        std::lock_guard<std::mutex> lock(s_poolsMutex);
+        CubismRenderThreadPool_Software*& pool = s_pools[threadCount];
+        if (pool == NULL)
+        {
+            pool = CSM_NEW CubismRenderThreadPool_Software(threadCount);
+        }
+        pool->_refCount++;
+        return pool;
+    }
+
+    /**
+     * @brief   Acquire() で得たプールを返す。最後の参照ならスレッドを終了して破棄する
+     */
+    static void Release(CubismRenderThreadPool_Software* pool)
+    {
+        {
+            std::lock_guard<std::mutex> lock(s_poolsMutex);
+            if (--pool->_refCount > 0)
+            {
+                return;
+            }
+            s_pools.erase(pool->_threadCount);
+        }
+
+        CSM_DELETE(pool);
+    }
+
+    explicit CubismRenderThreadPool_Software(csmInt32 threadCount)
+        : _threadCount(threadCount)
+        , _refCount(0)
+        , _task(NULL)
+        , _context(NULL)
+        , _count(0)
+        , _next(0)
+        , _remaining(0)
+        , _activeWorkerCount(0)
+        , _generation(0)
+        , _stop(false)
+    {
+        for (csmInt32 i = 1; i < threadCount; i++)
+        {
+            _threads.push_back(std::thread(&CubismRenderThreadPool_Software::WorkerMain, this));
+        }
+    }
+
+    ~CubismRenderThreadPool_Software()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stop = true;
+        }
+        _wake.notify_all();
+
+        for (size_t i = 0; i < _threads.size(); i++)
+        {
+            _threads[i].join();
+        }
+    }
+
+    /**
+     * @brief   0 から count - 1 までの番号について task を並列に実行し、すべて終わるまで待つ
+     */
+    void Run(csmInt32 count, TaskFunction task, void* context)
+    {
+        // 他のレンダラが使用中なら、スレッドを増やさずに呼び出し元のスレッドだけで実行する
+        std::unique_lock<std::mutex> runLock(_runMutex, std::try_to_lock);
+        if (!runLock.owns_lock() || count <= 1 || _threads.empty())
+        {
+            for (csmInt32 i = 0; i < count; i++)
+            {
+                task(context, i);
+            }
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _task = task;
+            _context = context;
+            _count = count;
+            _next.store(0);
+            _remaining.store(count);
+            _generation++;
+        }
+        _wake.notify_all();
+
+        RunTasks();
+
+        // 次の Run() で値を書き換える前に、全てのワーカーが作業を抜けるのを待つ
+        std::unique_lock<std::mutex> lock(_mutex);
+        _done.wait(lock, [this] { return _remaining.load() == 0 && _activeWorkerCount == 0; });
+    }
+
+private:
+    void WorkerMain()
+    {
+        unsigned long long generation = 0;
+
+        for (;;)
+        {
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                _wake.wait(lock, [this, generation] { return _stop || _generation != generation; });
+                if (_stop)
+                {
+                    return;
+                }
+                generation = _generation;
+                _activeWorkerCount++;
+            }
+
+            RunTasks();
+
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _activeWorkerCount--;
+            }
+            _done.notify_all();
+        }
+    }
+
+    void RunTasks()
+    {
+        for (;;)
+        {
+            const csmInt32 index = _next.fetch_add(1);
+            if (index >= _count)
+            {
+                return;
+            }
+
+            _task(_context, index);
+
+            if (_remaining.fetch_sub(1) == 1)
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _done.notify_all();
+            }
+        }
+    }
+
+    static std::mutex s_poolsMutex;
+    static std::map<csmInt32, CubismRenderThreadPool_Software*> s_pools;   ///< スレッド数ごとの共有のプール
+
+    csmInt32 _threadCount;
+    csmInt32 _refCount;                 ///< プールを使っているレンダラの数。s_poolsMutex で保護する
+    std::vector<std::thread> _threads;
+    std::mutex _runMutex;               ///< Run() を同時に1つに限る
+    std::mutex _mutex;
+    std::condition_variable _wake;  ///< 新しい作業の通知
+    std::condition_variable _done;  ///< 作業の完了とワーカーが作業を抜けたことの通知
+    TaskFunction _task;
+    void* _context;
+    csmInt32 _count;
+    std::atomic<csmInt32> _next;        ///< 次に実行する番号
+    std::atomic<csmInt32> _remaining;   ///< 未完了の作業数
+    csmInt32 _activeWorkerCount;        ///< 作業中のワーカーの数
+    unsigned long long _generation;     ///< Run() の呼び出しごとに増える
+    csmBool _stop;
+};
+
+std::mutex CubismRenderThreadPool_Software::s_poolsMutex;
+std::map<csmInt32, CubismRenderThreadPool_Software*> CubismRenderThreadPool_Software::s_pools;
+
+/*********************************************************************************************************************
+*                                      CubismOffscreenSurface_Software
+********************************************************************************************************************/
+CubismOffscreenSurface_Software::CubismOffscreenSurface_Software()
+    : _pixels(NULL)
+    , _bufferWidth(0)
+    , _bufferHeight(0)
+{
+}
+
+csmBool CubismOffscreenSurface_Software::CreateOffscreenSurface(csmUint32 displayBufferWidth, csmUint32 displayBufferHeight)
+{
+    DestroyOffscreenSurface();
+
+    if (displayBufferWidth == 0 || displayBufferHeight == 0)
+    {
+        return false;
+    }
+
+    _pixels = static_cast<csmUint8*>(CSM_MALLOC(displayBufferWidth * displayBufferHeight * 4));
+    if (_pixels == NULL)
+    {
+        return false;
+    }
+
+    // 1が無効（描かれない）領域
+    memset(_pixels, 0xFF, displayBufferWidth * displayBufferHeight * 4);
+    _bufferWidth = displayBufferWidth;
+    _bufferHeight = displayBufferHeight;
+    return true;
+}
+
+void CubismOffscreenSurface_Software::DestroyOffscreenSurface()
+{
+    if (_pixels != NULL)
+    {
+        CSM_FREE(_pixels);
+        _pixels = NULL;
+    }
+    _bufferWidth = 0;
+    _bufferHeight = 0;
+}
+
+csmUint8* CubismOffscreenSurface_Software::GetPixels() const
+{
+    return _pixels;
+}
+
+csmUint32 CubismOffscreenSurface_Software::GetBufferWidth() const
+{
+    return _bufferWidth;
+}
+
+csmUint32 CubismOffscreenSurface_Software::GetBufferHeight() const
+{
+    return _bufferHeight;
+}
+
+csmBool CubismOffscreenSurface_Software::IsValid() const
+{
+    return _pixels != NULL;
+}
+
+/*********************************************************************************************************************
+*                                      CubismClippingManager_Software
+********************************************************************************************************************/
+csmBool CubismClippingManager_Software::SetupClippingContext(CubismModel& model, CubismRenderer_Software* renderer)
+{
+    // 全てのクリッピングを用意する
+    // 同じクリップ（複数の場合はまとめて１つのクリップ）を使う場合は１度だけ設定する
+    csmInt32 usingClipCount = 0;
+    for (csmUint32 clipIndex = 0; clipIndex < _clippingContextListForMask.GetSize(); clipIndex++)
+    {
+        // １つのクリッピングマスクに関して
+        CubismClippingContext_Software* cc = _clippingContextListForMask[clipIndex];
+
+        // このクリップを利用する描画オブジェクト群全体を囲む矩形を計算
+        CalcClippedDrawTotalBounds(model, cc);
+
+        if (cc->_isUsing)
+        {
+            usingClipCount++; //使用中としてカウント
+        }
+    }
+
+    renderer->_drawStatistics.ClippingMaskCount = usingClipCount;
+
+    if (usingClipCount <= 0)
+    {
+        return false;
+    }
+
+    // 各マスクのレイアウトを決定していく
+    SetupLayoutBounds(usingClipCount);
+
+    // 全てのマスクの行列を求め、マスクを描く命令を積む
+    for (csmUint32 clipIndex = 0; clipIndex < _clippingContextListForMask.GetSize(); clipIndex++)
+    {
+        CubismClippingContext_Software* clipContext = _clippingContextListForMask[clipIndex];
+        csmRectF* allClippedDrawRect = clipContext->_allClippedDrawRect; //このマスクを使う、全ての描画オブジェクトの論理座標上の囲み矩形
+        csmRectF* layoutBoundsOnTex01 = clipContext->_layoutBounds; //この中にマスクを収める
+        const csmFloat32 MARGIN = 0.05f;
+
+        // モデル座標上の矩形を、適宜マージンを付けて使う
+        _tmpBoundsOnModel.SetRect(allClippedDrawRect);
+        _tmpBoundsOnModel.Expand(allClippedDrawRect->Width * MARGIN, allClippedDrawRect->Height * MARGIN);
+        csmFloat32 scaleX = layoutBoundsOnTex01->Width / _tmpBoundsOnModel.Width;
+        csmFloat32 scaleY = layoutBoundsOnTex01->Height / _tmpBoundsOnModel.Height;
+
+        // マスク生成時に使う行列を求める
+        createMatrixForMask(false, layoutBoundsOnTex01, scaleX, scaleY);
+
+        clipContext->_matrixForMask.SetMatrix(_tmpMatrixForMask.GetArray());
+        clipContext->_matrixForDraw.SetMatrix(_tmpMatrixForDraw.GetArray());
+
+        const csmInt32 clipDrawCount = clipContext->_clippingIdCount;
+        for (csmInt32 i = 0; i < clipDrawCount; i++)
+        {
+            const csmInt32 clipDrawIndex = clipContext->_clippingIdList[i];
+
+            // 頂点情報が更新されておらず、信頼性がない場合は描画をパスする
+            if (!model.GetDrawableDynamicFlagVertexPositionsDidChange(clipDrawIndex))
+            {
+                continue;
+            }
+
+            renderer->AddMaskCommand(clipDrawIndex, clipContext);
+        }
+    }
+
+    return true;
+}
+
+/*********************************************************************************************************************
+*                                      CubismClippingContext_Software
+********************************************************************************************************************/
+CubismClippingContext_Software::CubismClippingContext_Software(CubismClippingManager<CubismClippingContext_Software, CubismOffscreenSurface_Software>* manager, CubismModel& /*model*/, const csmInt32* clippingDrawableIndices, csmInt32 clipCount)
+    : CubismClippingContext(clippingDrawableIndices, clipCount)
+{
+    _owner = manager;
+}
+
+CubismClippingContext_Software::~CubismClippingContext_Software()
+{
+}
+
+CubismClippingManager<CubismClippingContext_Software, CubismOffscreenSurface_Software>* CubismClippingContext_Software::GetClippingManager()
+{
+    return _owner;
+}
+
+/*********************************************************************************************************************
+ *                                      CubismRenderer_Software
+ ********************************************************************************************************************/
+CubismRenderer_Software::CubismRenderer_Software()
+    : _clippingManager(NULL)
+    , _renderTarget(NULL)
+    , _renderTargetWidth(0)
+    , _renderTargetHeight(0)
+    , _renderTargetStride(0)
+    , _tileHeight(TileHeight)
+    , _threadPool(NULL)
+    , _threadCount(1)
+{
+    memset(&_drawStatistics, 0, sizeof(_drawStatistics));
+
+    SetThreadCount(0);
+}
+
+CubismRenderer_Software::~CubismRenderer_Software()
+{
+    CSM_DELETE_SELF(CubismClippingManager_Software, _clippingManager);
+
+    for (csmUint32 i = 0; i < _offscreenSurfaces.GetSize(); ++i)
+    {
+        _offscreenSurfaces[i].DestroyOffscreenSurface();
+    }
+
+    for (csmUint32 i = 0; i < _textures.GetSize(); ++i)
+    {
+        Texture* texture = _textures[i];
+        if (texture == NULL)
+        {
+            continue;
+        }
+        for (csmInt32 level = 0; level < texture->LevelCount; ++level)
+        {
+            CSM_FREE(texture->Levels[level].Pixels);
+        }
+        CSM_DELETE(texture);
+    }
+
+    if (_threadPool != NULL)
+    {
+        CubismRenderThreadPool_Software::Release(_threadPool);
+    }
+}
+
+void CubismRenderer_Software::Initialize(CubismModel* model)
+{
+    Initialize(model, 1);
+}
+
+void CubismRenderer_Software::Initialize(CubismModel* model, csmInt32 maskBufferCount)
+{
+    // 1未満は1に補正する
+    if (maskBufferCount < 1)
+    {
+        maskBufferCount = 1;
+        CubismLogWarning("The number of render textures must be an integer greater than or equal to 1. Set the number of render textures to 1.");
+    }
+
+    if (model->IsUsingMasking())
+    {
+        _clippingManager = CSM_NEW CubismClippingManager_Software();  //クリッピングマスク・バッファ前処理方式を初期化
+        _clippingManager->Initialize(*model, maskBufferCount);
+
+        _offscreenSurfaces.Clear();
+        for (csmInt32 i = 0; i < maskBufferCount; ++i)
+        {
+            CubismOffscreenSurface_Software offscreenSurface;
+            offscreenSurface.CreateOffscreenSurface(static_cast<csmUint32>(_clippingManager->GetClippingMaskBufferSize().X), static_cast<csmUint32>(_clippingManager->GetClippingMaskBufferSize().Y));
+            _offscreenSurfaces.PushBack(offscreenSurface);
+        }
+    }
+
+    _sortedDrawableIndexList.Resize(model->GetDrawableCount(), 0);
+
+    CubismRenderer::Initialize(model, maskBufferCount);  //親クラスの処理を呼ぶ
+}
+
+void CubismRenderer_Software::BindTexture(csmUint32 modelTextureIndex, const csmUint8* pixels, csmInt32 width, csmInt32 height)
+{
+    if (pixels == NULL || width <= 0 || height <= 0)
+    {
+        return;
+    }
+
+    while (_textures.GetSize() <= modelTextureIndex)
+    {
+        _textures.PushBack(NULL);
+    }
+
+    Texture* texture = _textures[modelTextureIndex];
+    if (texture == NULL)
+    {
+        texture = CSM_NEW Texture();
+        texture->LevelCount = 0;
+        _textures[modelTextureIndex] = texture;
+    }
+    for (csmInt32 level = 0; level < texture->LevelCount; ++level)
+    {
+        CSM_FREE(texture->Levels[level].Pixels);
+    }
+    texture->LevelCount = 0;
+
+    // glGenerateMipmap と同じく、1x1 になるまで 2x2 の平均で縮小していく
+    csmInt32 levelWidth = width;
+    csmInt32 levelHeight = height;
+    const csmUint8* source = pixels;
+    csmInt32 sourceWidth = width;
+    csmInt32 sourceHeight = height;
+
+    while (texture->LevelCount < Texture::MaxLevelCount)
+    {
+        TextureLevel& level = texture->Levels[texture->LevelCount];
+        level.Width = levelWidth;
+        level.Height = levelHeight;
+        level.Pixels = static_cast<csmUint8*>(CSM_MALLOC(levelWidth * levelHeight * 4));
+
+        if (texture->LevelCount == 0)
+        {
+            memcpy(level.Pixels, source, levelWidth * levelHeight * 4);
+        }
+        else
+        {
+            for (csmInt32 y = 0; y < levelHeight; ++y)
+            {
+                const csmUint8* row0 = source + Clamp(y * 2, 0, sourceHeight - 1) * sourceWidth * 4;
+                const csmUint8* row1 = source + Clamp(y * 2 + 1, 0, sourceHeight - 1) * sourceWidth * 4;
+                csmUint8* destination = level.Pixels + y * levelWidth * 4;
+
+                for (csmInt32 x = 0; x < levelWidth; ++x)
+                {
+                    const csmInt32 x0 = Clamp(x * 2, 0, sourceWidth - 1) * 4;
+                    const csmInt32 x1 = Clamp(x * 2 + 1, 0, sourceWidth - 1) * 4;
+                    for (csmInt32 c = 0; c < 4; ++c)
+                    {
+                        destination[x * 4 + c] = static_cast<csmUint8>((row0[x0 + c] + row0[x1 + c] + row1[x0 + c] + row1[x1 + c] + 2) >> 2);
+                    }
+                }
+            }
+        }
+
+        source = level.Pixels;
+        sourceWidth = levelWidth;
+        sourceHeight = levelHeight;
+        texture->LevelCount++;
+
+        if (levelWidth == 1 && levelHeight == 1)
+        {
+            break;
+        }
+        levelWidth = levelWidth > 1 ? levelWidth / 2 : 1;
+        levelHeight = levelHeight > 1 ? levelHeight / 2 : 1;
+    }
+}
+
+void CubismRenderer_Software::SetRenderTarget(csmUint8* pixels, csmInt32 width, csmInt32 height, csmInt32 stride)
+{
+    _renderTarget = pixels;
+    _renderTargetWidth = width;
+    _renderTargetHeight = height;
+    _renderTargetStride = (stride > 0) ? stride : width * 4;
+}
+
+void CubismRenderer_Software::SetClippingMaskBufferSize(csmFloat32 width, csmFloat32 height)
+{
+    if (_clippingManager == NULL)
+    {
+        return;
+    }
+
+    // インスタンス破棄前にレンダーテクスチャの数を保存
+    const csmInt32 renderTextureCount = _clippingManager->GetRenderTextureCount();
+
+    // OffscreenSurfaceのサイズを変更するためにインスタンスを破棄・再作成する
+    CSM_DELETE_SELF(CubismClippingManager_Software, _clippingManager);
+
+    _clippingManager = CSM_NEW CubismClippingManager_Software();
+
+    _clippingManager->SetClippingMaskBufferSize(width, height);
+
+    _clippingManager->Initialize(*GetModel(), renderTextureCount);
+}
+
+CubismVector2 CubismRenderer_Software::GetClippingMaskBufferSize() const
+{
+    return _clippingManager->GetClippingMaskBufferSize();
+}
+
+const CubismOffscreenSurface_Software* CubismRenderer_Software::GetMaskBuffer(csmInt32 index) const
+{
+    if (index < 0 || index >= static_cast<csmInt32>(_offscreenSurfaces.GetSize()))
+    {
+        return NULL;
+    }
+    return &_offscreenSurfaces[index];
+}
+
+void CubismRenderer_Software::SetThreadCount(csmInt32 threadCount)
+{
+    if (threadCount <= 0)
+    {
+        threadCount = static_cast<csmInt32>(std::thread::hardware_concurrency());
+    }
+    threadCount = Clamp(threadCount, 1, MaxThreadCount);
+
+    if (_threadPool != NULL && threadCount == _threadCount)
+    {
+        return;
+    }
+
+    if (_threadPool != NULL)
+    {
+        CubismRenderThreadPool_Software::Release(_threadPool);
+        _threadPool = NULL;
+    }
+
+    _threadCount = threadCount;
+    if (threadCount > 1)
+    {
+        _threadPool = CubismRenderThreadPool_Software::Acquire(threadCount);
+    }
+}
+
+csmInt32 CubismRenderer_Software::GetThreadCount() const
+{
+    return _threadCount;
+}
+
+const CubismRenderer_Software::DrawStatistics& CubismRenderer_Software::GetDrawStatistics() const
+{
+    return _drawStatistics;
+}
+
+void CubismRenderer_Software::SaveProfile()
+{
+}
+
+void CubismRenderer_Software::RestoreProfile()
+{
+}
+
+csmInt32 CubismRenderer_Software::TransformVertices(csmInt32 drawableIndex, CubismMatrix44& matrix, csmFloat32 scaleX, csmFloat32 offsetX, csmFloat32 scaleY, csmFloat32 offsetY, csmFloat32* bounds)
+{
+    const csmInt32 vertexCount = GetModel()->GetDrawableVertexCount(drawableIndex);
+    const Core::csmVector2* positions = GetModel()->GetDrawableVertexPositions(drawableIndex);
+    const csmFloat32* m = matrix.GetArray();
+
+    const csmInt32 offset = _transformedVertices.GetSize();
+    _transformedVertices.Resize(offset + vertexCount * 2, 0.0f);
+    csmFloat32* destination = _transformedVertices.GetPtr() + offset;
+
+    csmFloat32 left = FLT_MAX;
+    csmFloat32 top = FLT_MAX;
+    csmFloat32 right = -FLT_MAX;
+    csmFloat32 bottom = -FLT_MAX;
+
+    for (csmInt32 i = 0; i < vertexCount; ++i)
+    {
+        // 列優先の行列に (x, y, 0, 1) を掛ける
+        const csmFloat32 x = positions[i].X;
+        const csmFloat32 y = positions[i].Y;
+        const csmFloat32 w = m[3] * x + m[7] * y + m[15];
+        const csmFloat32 inverseW = (w != 0.0f) ? 1.0f / w : 1.0f;
+        const csmFloat32 tx = ((m[0] * x + m[4] * y + m[12]) * inverseW) * scaleX + offsetX;
+        const csmFloat32 ty = ((m[1] * x + m[5] * y + m[13]) * inverseW) * scaleY + offsetY;
+
+        destination[i * 2] = tx;
+        destination[i * 2 + 1] = ty;
+
+        left = tx < left ? tx : left;
+        right = tx > right ? tx : right;
+        top = ty < top ? ty : top;
+        bottom = ty > bottom ? ty : bottom;
+    }
+
+    if (bounds != NULL)
+    {
+        bounds[0] = left;
+        bounds[1] = top;
+        bounds[2] = right;
+        bounds[3] = bottom;
+    }
+
+    return offset;
+}
+
+void CubismRenderer_Software::AddMaskCommand(csmInt32 drawableIndex, CubismClippingContext_Software* clipContext)
+{
+    CubismModel* model = GetModel();
+    const csmInt32 textureIndex = model->GetDrawableTextureIndex(drawableIndex);
+    if (textureIndex < 0 || textureIndex >= static_cast<csmInt32>(_textures.GetSize()) || _textures[textureIndex] == NULL)
+    {
+        return;
+    }
+
+    const csmFloat32 maskWidth = static_cast<csmFloat32>(_offscreenSurfaces[clipContext->_bufferIndex].GetBufferWidth());
+    const csmFloat32 maskHeight = static_cast<csmFloat32>(_offscreenSurfaces[clipContext->_bufferIndex].GetBufferHeight());
+    const csmRectF* rect = clipContext->_layoutBounds;
+
+    DrawCommand command;
+    command.DrawableIndex = drawableIndex;
+    // マスクのバッファは下から上の順のため、正規化デバイス座標の上下をそのまま行にする
+    command.VertexOffset = TransformVertices(drawableIndex, clipContext->_matrixForMask, maskWidth * 0.5f, maskWidth * 0.5f, maskHeight * 0.5f, maskHeight * 0.5f, command.Bounds);
+    command.ClipVertexOffset = -1;
+    command.SourceTexture = _textures[textureIndex];
+    command.IsCulling = model->GetDrawableCulling(drawableIndex) != 0;
+    command.IsFlipped = false;
+    command.BlendMode = CubismBlendMode_Normal;
+    command.BaseColor[0] = rect->X * 2.0f - 1.0f;
+    command.BaseColor[1] = rect->Y * 2.0f - 1.0f;
+    command.BaseColor[2] = rect->GetRight() * 2.0f - 1.0f;
+    command.BaseColor[3] = rect->GetBottom() * 2.0f - 1.0f;
+    command.MaskBufferIndex = clipContext->_bufferIndex;
+    command.MaskChannel = clipContext->_layoutChannelIndex;
+    command.IsInvertedMask = false;
+
+    _maskCommands.PushBack(command);
+    _drawStatistics.TriangleCount += model->GetDrawableVertexIndexCount(drawableIndex) / 3;
+}
+
+void CubismRenderer_Software::DoDrawModel()
+{
+    _drawStatistics.DrawnDrawableCount = 0;
+    _drawStatistics.TriangleCount = 0;
+    _drawStatistics.ClippingMaskCount = 0;
+    _drawStatistics.TileCount = 0;
+    _drawStatistics.ThreadCount = _threadCount;
+
+    if (_renderTarget == NULL || _renderTargetWidth <= 0 || _renderTargetHeight <= 0)
+    {
+        return;
+    }
+
+    CubismModel* model = GetModel();
+    const csmInt32 drawableCount = model->GetDrawableCount();
+    const csmInt32* renderOrder = model->GetDrawableRenderOrders();
+
+    // インデックスを描画順でソート
+    for (csmInt32 i = 0; i < drawableCount; ++i)
+    {
+        const csmInt32 order = renderOrder[i];
+        _sortedDrawableIndexList[order] = i;
+    }
+
+    _transformedVertices.Clear();
+    _maskCommands.Clear();
+    _drawCommands.Clear();
+
+    //------------ クリッピングマスク・バッファ前処理方式の場合 ------------
+    // 高精細マスクには対応せず、常にまとめて描いたマスクを使う
+    if (_clippingManager != NULL)
+    {
+        // サイズが違う場合はここで作成しなおし
+        const csmUint32 maskWidth = static_cast<csmUint32>(_clippingManager->GetClippingMaskBufferSize().X);
+        const csmUint32 maskHeight = static_cast<csmUint32>(_clippingManager->GetClippingMaskBufferSize().Y);
+        for (csmInt32 i = 0; i < _clippingManager->GetRenderTextureCount(); ++i)
+        {
+            if (_offscreenSurfaces[i].GetBufferWidth() != maskWidth || _offscreenSurfaces[i].GetBufferHeight() != maskHeight)
+            {
+                _offscreenSurfaces[i].CreateOffscreenSurface(maskWidth, maskHeight);
+            }
+        }
+
+        if (_clippingManager->SetupClippingContext(*model, this))
+        {
+            _tileHeight = (_threadPool != NULL) ? TileHeight : static_cast<csmInt32>(maskHeight);
+            const csmInt32 tileCount = (static_cast<csmInt32>(maskHeight) + _tileHeight - 1) / _tileHeight;
+            if (_threadPool != NULL)
+            {
+                _threadPool->Run(tileCount, DrawMaskTile, this);
+            }
+            else
+            {
+                DrawMaskTile(this, 0);
+            }
+        }
+    }
+
+    CubismMatrix44 mvp = GetMvpMatrix();
+    const csmFloat32 width = static_cast<csmFloat32>(_renderTargetWidth);
+    const csmFloat32 height = static_cast<csmFloat32>(_renderTargetHeight);
+
+    for (csmInt32 i = 0; i < drawableCount; ++i)
+    {
+        const csmInt32 drawableIndex = _sortedDrawableIndexList[i];
+
+        // Drawableが表示状態でなければ処理をパスする
+        if (!model->GetDrawableDynamicFlagIsVisible(drawableIndex))
+        {
+            continue;
+        }
+
+        const csmInt32 textureIndex = model->GetDrawableTextureIndex(drawableIndex);
+        if (textureIndex < 0 || textureIndex >= static_cast<csmInt32>(_textures.GetSize()) || _textures[textureIndex] == NULL)
+        {
+            continue;
+        }
+
+        // 不透明度が0ならどのブレンドモードでも描画先は変わらない
+        const CubismTextureColor baseColor = GetModelColorWithOpacity(model->GetDrawableOpacity(drawableIndex));
+        if (baseColor.A <= 0.0f)
+        {
+            continue;
+        }
+
+        const CubismTextureColor multiplyColor = model->GetMultiplyColor(drawableIndex);
+        const CubismTextureColor screenColor = model->GetScreenColor(drawableIndex);
+
+        DrawCommand command;
+        command.DrawableIndex = drawableIndex;
+        // 描画先は上から下の順のため、正規化デバイス座標の上下を反転する
+        command.VertexOffset = TransformVertices(drawableIndex, mvp, width * 0.5f, width * 0.5f, -height * 0.5f, height * 0.5f, command.Bounds);
+
+        if (command.Bounds[2] < 0.0f || command.Bounds[0] > width || command.Bounds[3] < 0.0f || command.Bounds[1] > height)
+        {
+            continue;
+        }
+
+        command.SourceTexture = _textures[textureIndex];
+        command.IsCulling = model->GetDrawableCulling(drawableIndex) != 0;
+        command.IsFlipped = true;
+        command.BlendMode = model->GetDrawableBlendMode(drawableIndex);
+        command.BaseColor[0] = baseColor.R;
+        command.BaseColor[1] = baseColor.G;
+        command.BaseColor[2] = baseColor.B;
+        command.BaseColor[3] = baseColor.A;
+        command.MultiplyColor[0] = multiplyColor.R;
+        command.MultiplyColor[1] = multiplyColor.G;
+        command.MultiplyColor[2] = multiplyColor.B;
+        command.MultiplyColor[3] = 1.0f;
+        command.ScreenColor[0] = screenColor.R;
+        command.ScreenColor[1] = screenColor.G;
+        command.ScreenColor[2] = screenColor.B;
+        command.ScreenColor[3] = 0.0f;
+        command.ClipVertexOffset = -1;
+        command.MaskBufferIndex = -1;
+        command.MaskChannel = 0;
+        command.IsInvertedMask = false;
+
+        // クリッピングマスク
+        CubismClippingContext_Software* clipContext = (_clippingManager != NULL)
+            ? (*_clippingManager->GetClippingContextListForDraw())[drawableIndex]
+            : NULL;
+
+        if (clipContext != NULL)
+        {
+            // マスクの座標はテクスチャ座標 0..1 で求まるため、バッファのピクセル座標にする
+            const CubismOffscreenSurface_Software& maskBuffer = _offscreenSurfaces[clipContext->_bufferIndex];
+            command.ClipVertexOffset = TransformVertices(drawableIndex, clipContext->_matrixForDraw,
+                static_cast<csmFloat32>(maskBuffer.GetBufferWidth()), 0.0f, static_cast<csmFloat32>(maskBuffer.GetBufferHeight()), 0.0f, NULL);
+            command.MaskBufferIndex = clipContext->_bufferIndex;
+            command.MaskChannel = clipContext->_layoutChannelIndex;
+            command.IsInvertedMask = model->GetDrawableInvertedMask(drawableIndex);
+        }
+
+        _drawCommands.PushBack(command);
+        _drawStatistics.DrawnDrawableCount++;
+        _drawStatistics.TriangleCount += model->GetDrawableVertexIndexCount(drawableIndex) / 3;
+    }
+
+    _tileHeight = (_threadPool != NULL) ? TileHeight : _renderTargetHeight;
+    const csmInt32 tileCount = (_renderTargetHeight + _tileHeight - 1) / _tileHeight;
+    _drawStatistics.TileCount = tileCount;
+
+    if (_threadPool != NULL)
+    {
+        _threadPool->Run(tileCount, DrawTile, this);
+    }
+    else
+    {
+        DrawTile(this, 0);
+    }
+}
+
+void CubismRenderer_Software::DrawMaskTile(void* context, csmInt32 tileIndex)
+{
+    CubismRenderer_Software* renderer = static_cast<CubismRenderer_Software*>(context);
+
+    for (csmUint32 i = 0; i < renderer->_offscreenSurfaces.GetSize(); ++i)
+    {
+        CubismOffscreenSurface_Software& surface = renderer->_offscreenSurfaces[i];
+        const csmInt32 width = static_cast<csmInt32>(surface.GetBufferWidth());
+        const csmInt32 height = static_cast<csmInt32>(surface.GetBufferHeight());
+        const csmInt32 top = tileIndex * renderer->_tileHeight;
+        const csmInt32 bottom = (top + renderer->_tileHeight < height) ? top + renderer->_tileHeight : height;
+        if (top >= bottom)
+        {
+            continue;
+        }
+
+        // マスクをクリアする
+        // 1が無効（描かれない）領域、0が有効（描かれる）領域
+        memset(surface.GetPixels() + top * width * 4, 0xFF, (bottom - top) * width * 4);
+
+        for (csmUint32 j = 0; j < renderer->_maskCommands.GetSize(); ++j)
+        {
+            const DrawCommand& command = renderer->_maskCommands[j];
+            if (command.MaskBufferIndex == static_cast<csmInt32>(i))
+            {
+                renderer->RasterizeCommand(command, surface.GetPixels(), width, height, width * 4, top, bottom, true);
+            }
+        }
+    }
+}
+
+void CubismRenderer_Software::DrawTile(void* context, csmInt32 tileIndex)
+{
+    CubismRenderer_Software* renderer = static_cast<CubismRenderer_Software*>(context);
+    const csmInt32 top = tileIndex * renderer->_tileHeight;
+    const csmInt32 bottom = (top + renderer->_tileHeight < renderer->_renderTargetHeight) ? top + renderer->_tileHeight : renderer->_renderTargetHeight;
+
+    for (csmUint32 i = 0; i < renderer->_drawCommands.GetSize(); ++i)
+    {
+        renderer->RasterizeCommand(renderer->_drawCommands[i], renderer->_renderTarget,
+            renderer->_renderTargetWidth, renderer->_renderTargetHeight, renderer->_renderTargetStride, top, bottom, false);
+    }
+}
+
+void CubismRenderer_Software::RasterizeCommand(const DrawCommand& command, csmUint8* pixels, csmInt32 width, csmInt32 height, csmInt32 stride, csmInt32 tileTop, csmInt32 tileBottom, csmBool isMask)
+{
+    // 画素の中心 (y + 0.5) が範囲に入る行だけを描く
+    if (command.Bounds[3] < static_cast<csmFloat32>(tileTop) || command.Bounds[1] > static_cast<csmFloat32>(tileBottom))
+    {
+        return;
+    }
+
+    const CubismModel* model = GetModel();
+    const csmInt32 indexCount = model->GetDrawableVertexIndexCount(command.DrawableIndex);
+    const csmUint16* indices = model->GetDrawableVertexIndices(command.DrawableIndex);
+    const Core::csmVector2* uvs = model->GetDrawableVertexUvs(command.DrawableIndex);
+    const csmFloat32* positions = _transformedVertices.GetPtr() + command.VertexOffset;
+    const csmFloat32* clipPositions = (command.ClipVertexOffset >= 0) ? _transformedVertices.GetPtr() + command.ClipVertexOffset : NULL;
+    const Texture* texture = command.SourceTexture;
+
+    const CubismOffscreenSurface_Software* maskBuffer = (!isMask && command.MaskBufferIndex >= 0) ? &_offscreenSurfaces[command.MaskBufferIndex] : NULL;
+    const csmUint8* maskPixels = (maskBuffer != NULL) ? maskBuffer->GetPixels() : NULL;
+    const csmInt32 maskWidth = (maskBuffer != NULL) ? static_cast<csmInt32>(maskBuffer->GetBufferWidth()) : 0;
+    const csmInt32 maskHeight = (maskBuffer != NULL) ? static_cast<csmInt32>(maskBuffer->GetBufferHeight()) : 0;
+
+    const Color4 baseColor = MakeColor(command.BaseColor[0], command.BaseColor[1], command.BaseColor[2], command.BaseColor[3]);
+    const Color4 multiplyColor = MakeColor(command.MultiplyColor[0], command.MultiplyColor[1], command.MultiplyColor[2], command.MultiplyColor[3]);
+    const Color4 screenColor = MakeColor(command.ScreenColor[0], command.ScreenColor[1], command.ScreenColor[2], command.ScreenColor[3]);
+    const Color4 rgbMask = MakeColor(1.0f, 1.0f, 1.0f, 0.0f);
+    const Color4 alphaOne = MakeColor(0.0f, 0.0f, 0.0f, 1.0f);
+    const Color4 one = SplatColor(1.0f);
+    const Color4 colorScale = SplatColor(ColorScale);
+    const csmBool isPremultipliedAlpha = IsPremultipliedAlpha();
+
+    for (csmInt32 t = 0; t + 2 < indexCount; t += 3)
+    {
+        csmInt32 i0 = indices[t];
+        csmInt32 i1 = indices[t + 1];
+        csmInt32 i2 = indices[t + 2];
+
+        const csmFloat32 minY = Min3(positions[i0 * 2 + 1], positions[i1 * 2 + 1], positions[i2 * 2 + 1]);
+        const csmFloat32 maxY = Max3(positions[i0 * 2 + 1], positions[i1 * 2 + 1], positions[i2 * 2 + 1]);
+        const csmInt32 rowBegin = Clamp(FloorToInt(minY + 0.5f), tileTop, tileBottom);
+        const csmInt32 rowEnd = Clamp(FloorToInt(maxY + 0.5f) + 1, tileTop, tileBottom);
+        if (rowBegin >= rowEnd)
+        {
+            continue;
+        }
+
+        const csmFloat32 minX = Min3(positions[i0 * 2], positions[i1 * 2], positions[i2 * 2]);
+        const csmFloat32 maxX = Max3(positions[i0 * 2], positions[i1 * 2], positions[i2 * 2]);
+        const csmInt32 columnBegin = Clamp(FloorToInt(minX - 0.5f), 0, width - 1);
+        const csmInt32 columnEnd = Clamp(FloorToInt(maxX + 0.5f), 0, width - 1);
+        if (maxX < 0.0f || minX > static_cast<csmFloat32>(width))
+        {
+            continue;
+        }
+
+        csmFloat32 area = (positions[i1 * 2] - positions[i0 * 2]) * (positions[i2 * 2 + 1] - positions[i0 * 2 + 1])
+                        - (positions[i2 * 2] - positions[i0 * 2]) * (positions[i1 * 2 + 1] - positions[i0 * 2 + 1]);
+        if (area == 0.0f)
+        {
+            continue;
+        }
+
+        // OpenGLと同じく、正規化デバイス座標で反時計回りの面を表とする
+        const csmBool isFrontFace = command.IsFlipped ? (area < 0.0f) : (area > 0.0f);
+        if (command.IsCulling && !isFrontFace)
+        {
+            continue;
+        }
+
+        // 面積が正になる順に並べ替える
+        if (area < 0.0f)
+        {
+            const csmInt32 swap = i1;
+            i1 = i2;
+            i2 = swap;
+            area = -area;
+        }
+
+        const csmFloat32 v[6] = {
+            positions[i0 * 2], positions[i0 * 2 + 1],
+            positions[i1 * 2], positions[i1 * 2 + 1],
+            positions[i2 * 2], positions[i2 * 2 + 1],
+        };
+
+        Edge edges[3];
+        edges[0].Setup(v[0], v[1], v[2], v[3]);
+        edges[1].Setup(v[2], v[3], v[4], v[5]);
+        edges[2].Setup(v[4], v[5], v[0], v[1]);
+
+        // テクスチャ座標。OpenGLのシェーダと同じく上下を反転し、行が上から下の順のテクスチャで引く
+        const csmFloat32 inverseArea = 1.0f / area;
+        Plane planeS;
+        Plane planeT;
+        planeS.Setup(uvs[i0].X, uvs[i1].X, uvs[i2].X, v, inverseArea);
+        planeT.Setup(1.0f - uvs[i0].Y, 1.0f - uvs[i1].Y, 1.0f - uvs[i2].Y, v, inverseArea);
+
+        Plane planeMaskX;
+        Plane planeMaskY;
+        if (maskPixels != NULL)
+        {
+            planeMaskX.Setup(clipPositions[i0 * 2], clipPositions[i1 * 2], clipPositions[i2 * 2], v, inverseArea);
+            planeMaskY.Setup(clipPositions[i0 * 2 + 1], clipPositions[i1 * 2 + 1], clipPositions[i2 * 2 + 1], v, inverseArea);
+        }
+
+        // アフィン変換のためミップマップの詳細度は三角形の中で一定になる
+        const TextureLevel* level0 = &texture->Levels[0];
+        const TextureLevel* level1 = NULL;
+        csmFloat32 levelBlend = 0.0f;
+        {
+            const csmFloat32 baseWidth = static_cast<csmFloat32>(level0->Width);
+            const csmFloat32 baseHeight = static_cast<csmFloat32>(level0->Height);
+            const csmFloat32 dudx = planeS.Dx * baseWidth;
+            const csmFloat32 dvdx = planeT.Dx * baseHeight;
+            const csmFloat32 dudy = planeS.Dy * baseWidth;
+            const csmFloat32 dvdy = planeT.Dy * baseHeight;
+            const csmFloat32 lengthX = dudx * dudx + dvdx * dvdx;
+            const csmFloat32 lengthY = dudy * dudy + dvdy * dvdy;
+            const csmFloat32 rho = lengthX > lengthY ? lengthX : lengthY;
+
+            // 拡大では GL_LINEAR、縮小では GL_LINEAR_MIPMAP_LINEAR と同じく隣り合う2つのレベルを混ぜる
+            if (rho > 1.0f && texture->LevelCount > 1)
+            {
+                const csmFloat32 lambda = 0.5f * log2f(rho);
+                const csmInt32 maxLevel = texture->LevelCount - 1;
+                if (lambda >= static_cast<csmFloat32>(maxLevel))
+                {
+                    level0 = &texture->Levels[maxLevel];
+                }
+                else
+                {
+                    const csmInt32 level = static_cast<csmInt32>(lambda);
+                    level0 = &texture->Levels[level];
+                    level1 = &texture->Levels[level + 1];
+                    levelBlend = lambda - static_cast<csmFloat32>(level);
+                }
+            }
+        }
+
+        for (csmInt32 y = rowBegin; y < rowEnd; ++y)
+        {
+            const csmFloat32 py = static_cast<csmFloat32>(y) + 0.5f;
+            csmInt32 left = columnBegin;
+            csmInt32 right = columnEnd;
+            edges[0].ClipSpan(py, left, right);
+            edges[1].ClipSpan(py, left, right);
+            edges[2].ClipSpan(py, left, right);
+            left = left > columnBegin ? left : columnBegin;
+            right = right < columnEnd ? right : columnEnd;
+
+            csmUint8* row = pixels + static_cast<csmSizeType>(y) * stride;
+
+            for (csmInt32 x = left; x <= right; x += 4)
+            {
+                csmInt32 coverage = QuadCoverage(edges, x, py);
+                if (x + 3 > right)
+                {
+                    coverage &= (1 << (right - x + 1)) - 1;
+                }
+
+                while (coverage != 0)
+                {
+                    csmInt32 lane = 0;
+                    while ((coverage & (1 << lane)) == 0)
+                    {
+                        lane++;
+                    }
+                    coverage &= ~(1 << lane);
+
+                    const csmInt32 px = x + lane;
+                    const csmFloat32 centerX = static_cast<csmFloat32>(px) + 0.5f;
+                    csmUint8* pixel = row + px * 4;
+
+                    // テクスチャをバイリニアでサンプリングする
+                    const csmFloat32 s = planeS.At(centerX, py);
+                    const csmFloat32 tt = planeT.At(centerX, py);
+                    Color4 texColor;
+                    {
+                        const TextureLevel* level = level0;
+                        Color4 sampled[2];
+                        for (csmInt32 l = 0; l < (level1 != NULL ? 2 : 1); ++l)
+                        {
+                            const csmFloat32 tx = s * static_cast<csmFloat32>(level->Width) - 0.5f;
+                            const csmFloat32 ty = tt * static_cast<csmFloat32>(level->Height) - 0.5f;
+                            const csmInt32 ix = FloorToInt(tx);
+                            const csmInt32 iy = FloorToInt(ty);
+                            const csmFloat32 fx = tx - static_cast<csmFloat32>(ix);
+                            const csmFloat32 fy = ty - static_cast<csmFloat32>(iy);
+                            const csmInt32 x0 = Repeat(ix, level->Width) * 4;
+                            const csmInt32 x1 = Repeat(ix + 1, level->Width) * 4;
+                            const csmUint8* row0 = level->Pixels + Repeat(iy, level->Height) * level->Width * 4;
+                            const csmUint8* row1 = level->Pixels + Repeat(iy + 1, level->Height) * level->Width * 4;
+                            const Color4 top = Lerp(LoadPixel(row0 + x0), LoadPixel(row0 + x1), fx);
+                            const Color4 bottom = Lerp(LoadPixel(row1 + x0), LoadPixel(row1 + x1), fx);
+                            sampled[l] = Lerp(top, bottom, fy);
+                            level = level1;
+                        }
+                        texColor = ((level1 != NULL) ? Lerp(sampled[0], sampled[1], levelBlend) : sampled[0]) * colorScale;
+                    }
+
+                    if (isMask)
+                    {
+                        // 割り当てられたチャンネルに (1 - テクスチャのアルファ) を掛ける。マスクを収める範囲の外は変えない
+                        const csmFloat32 ndcX = centerX / static_cast<csmFloat32>(width) * 2.0f - 1.0f;
+                        const csmFloat32 ndcY = py / static_cast<csmFloat32>(height) * 2.0f - 1.0f;
+                        if (ndcX < command.BaseColor[0] || ndcY < command.BaseColor[1] || ndcX > command.BaseColor[2] || ndcY > command.BaseColor[3])
+                        {
+                            continue;
+                        }
+
+                        const csmFloat32 value = GetAlpha(texColor);
+                        csmUint8& destination = pixel[command.MaskChannel];
+                        destination = static_cast<csmUint8>(static_cast<csmFloat32>(destination) * (1.0f - value) + 0.5f);
+                        continue;
+                    }
+
+                    // 乗算色・スクリーン色とモデルの色
+                    Color4 source;
+                    texColor = texColor * multiplyColor;
+                    if (isPremultipliedAlpha)
+                    {
+                        texColor = texColor + screenColor * BroadcastAlpha(texColor) - texColor * screenColor;
+                        source = texColor * baseColor;
+                    }
+                    else
+                    {
+                        texColor = texColor + screenColor - texColor * screenColor;
+                        const Color4 color = texColor * baseColor;
+                        source = color * (BroadcastAlpha(color) * rgbMask + alphaOne);
+                    }
+
+                    // クリッピングマスク。割り当てられたチャンネルをバイリニアでサンプリングする
+                    if (maskPixels != NULL)
+                    {
+                        const csmFloat32 mx = planeMaskX.At(centerX, py) - 0.5f;
+                        const csmFloat32 my = planeMaskY.At(centerX, py) - 0.5f;
+                        const csmInt32 ix = FloorToInt(mx);
+                        const csmInt32 iy = FloorToInt(my);
+                        const csmFloat32 fx = mx - static_cast<csmFloat32>(ix);
+                        const csmFloat32 fy = my - static_cast<csmFloat32>(iy);
+                        const csmInt32 x0 = Clamp(ix, 0, maskWidth - 1) * 4 + command.MaskChannel;
+                        const csmInt32 x1 = Clamp(ix + 1, 0, maskWidth - 1) * 4 + command.MaskChannel;
+                        const csmUint8* row0 = maskPixels + Clamp(iy, 0, maskHeight - 1) * maskWidth * 4;
+                        const csmUint8* row1 = maskPixels + Clamp(iy + 1, 0, maskHeight - 1) * maskWidth * 4;
+                        const csmFloat32 top = row0[x0] + (row0[x1] - row0[x0]) * fx;
+                        const csmFloat32 bottom = row1[x0] + (row1[x1] - row1[x0]) * fx;
+                        const csmFloat32 maskValue = (top + (bottom - top) * fy) * ColorScale;
+
+                        source = source * SplatColor(command.IsInvertedMask ? maskValue : 1.0f - maskValue);
+                    }
+
+                    // ブレンド
+                    const Color4 destination = LoadPixel(pixel) * colorScale;
+                    const Color4 inverseSourceAlpha = one - BroadcastAlpha(source);
+                    Color4 result;
+                    switch (command.BlendMode)
+                    {
+                    case CubismBlendMode_Additive:
+                        // RGB: ONE, ONE  A: ZERO, ONE
+                        result = destination + source * rgbMask;
+                        break;
+                    case CubismBlendMode_Multiplicative:
+                        // RGB: DST_COLOR, ONE_MINUS_SRC_ALPHA  A: ZERO, ONE
+                        result = destination * (source * rgbMask + inverseSourceAlpha * rgbMask + alphaOne);
+                        break;
+                    case CubismBlendMode_Normal:
+                    default:
+                        // ONE, ONE_MINUS_SRC_ALPHA
+                        result = source + destination * inverseSourceAlpha;
+                        break;
+                    }
+
+                    StorePixel(pixel, result);
+                }
+            }
+        }
+    }
+}
+
+}}}}
+//------------ LIVE2D NAMESPACE ------------
@@ -0,0 +1,343 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#pragma once
+
+#include "../CubismRenderer.hpp"
+#include "../CubismClippingManager.hpp"
+#include "CubismFramework.hpp"
+#include "Type/csmVector.hpp"
+#include "Type/csmRectF.hpp"
+#include "Math/CubismVector2.hpp"
+
+//------------ LIVE2D NAMESPACE ------------
+namespace Live2D { namespace Cubism { namespace Framework { namespace Rendering {
+
+//  前方宣言
+class CubismRenderer_Software;
+class CubismClippingContext_Software;
+class CubismRenderThreadPool_Software;
+
+/**
+ * @brief   CPUで描画する際のマスク用のバッファ<br>
+ *           RGBA各8bitで、OpenGLのテクスチャと同じく行は下から上の順に並ぶ。
+ *           コピーしてもピクセルは共有されるため、破棄は DestroyOffscreenSurface() で明示的に行う。
+ */
+class CubismOffscreenSurface_Software
+{
+public:
+    CubismOffscreenSurface_Software();
+
+    /**
+     * @brief   バッファを作成する
+     *
+     * @param[in]   displayBufferWidth     ->  作成するバッファの幅
+     * @param[in]   displayBufferHeight    ->  作成するバッファの高さ
+     *
+     * @return  成功した場合はtrue
+     */
+    csmBool CreateOffscreenSurface(csmUint32 displayBufferWidth, csmUint32 displayBufferHeight);
+
+    /**
+     * @brief   バッファを破棄する
+     */
+    void DestroyOffscreenSurface();
+
+    /**
+     * @brief   ピクセルの先頭アドレスを取得する
+     */
+    csmUint8* GetPixels() const;
+
+    csmUint32 GetBufferWidth() const;
+
+    csmUint32 GetBufferHeight() const;
+
+    /**
+     * @brief   現在有効かどうか
+     */
+    csmBool IsValid() const;
+
+private:
+    csmUint8* _pixels;          ///< RGBAのピクセル
+    csmUint32 _bufferWidth;     ///< 幅
+    csmUint32 _bufferHeight;    ///< 高さ
+};
+
+/**
+ * @brief  クリッピングマスクの処理を実行するクラス
+ *
+ */
+class CubismClippingManager_Software : public CubismClippingManager<CubismClippingContext_Software, CubismOffscreenSurface_Software>
+{
+public:
+
+    /**
+     * @brief   クリッピングコンテキストを作成する。モデル描画時に実行する。<br>
+     *           マスクのレイアウトと行列を決め、マスク用のバッファに描く内容をレンダラに積む。
+     *
+     * @param[in]   model        ->  モデルのインスタンス
+     * @param[in]   renderer     ->  レンダラのインスタンス
+     *
+     * @return  描くマスクがあればtrue
+     */
+    csmBool SetupClippingContext(CubismModel& model, CubismRenderer_Software* renderer);
+};
+
+/**
+ * @brief   クリッピングマスクのコンテキスト
+ */
+class CubismClippingContext_Software : public CubismClippingContext
+{
+    friend class CubismClippingManager_Software;
+    friend class CubismRenderer_Software;
+
+public:
+    /**
+     * @brief   引数付きコンストラクタ
+     *
+     */
+    CubismClippingContext_Software(CubismClippingManager<CubismClippingContext_Software, CubismOffscreenSurface_Software>* manager, CubismModel& model, const csmInt32* clippingDrawableIndices, csmInt32 clipCount);
+
+    /**
+     * @brief   デストラクタ
+     */
+    virtual ~CubismClippingContext_Software();
+
+    /**
+     * @brief   このマスクを管理するマネージャのインスタンスを取得する。
+     *
+     * @return  クリッピングマネージャのインスタンス
+     */
+    CubismClippingManager<CubismClippingContext_Software, CubismOffscreenSurface_Software>* GetClippingManager();
+
+    CubismClippingManager<CubismClippingContext_Software, CubismOffscreenSurface_Software>* _owner;        ///< このマスクを管理しているマネージャのインスタンス
+};
+
+/**
+ * @brief   CPUで描画するレンダラ<br>
+ *           OpenGLを使わず、呼び出し側が用意したRGBA8のメモリにモデルを描く。
+ *           三角形のラスタライズ、テクスチャのサンプリング(ミップマップ付きのバイリニア)、3種類のブレンドモード、
+ *           乗算色・スクリーン色とクリッピングマスクは OpenGL のシェーダと同じ式で計算する。
+ *           描画先は横長の帯に分けて、帯ごとに複数のスレッドで並列に描く。<br>
+ *           CubismRenderer::Create() は OpenGL のレンダラを返すため、このクラスは CSM_NEW で直接作成し、
+ *           CubismRenderer::Delete() で破棄する。
+ */
+class CubismRenderer_Software : public CubismRenderer
+{
+    friend class CubismClippingManager_Software;
+
+public:
+    /**
+     * @brief   直近の DrawModel() 1回分の統計
+     */
+    struct DrawStatistics
+    {
+        csmInt32 DrawnDrawableCount;    ///< 描いたDrawableの数。マスクは含まない
+        csmInt32 TriangleCount;         ///< 描いた三角形の数。マスクと、カリングで捨てたものを含む
+        csmInt32 ClippingMaskCount;     ///< クリッピングマスクの数
+        csmInt32 TileCount;             ///< 描画先を分けた帯の数
+        csmInt32 ThreadCount;           ///< 描画に使ったスレッドの数
+    };
+
+    /**
+     * @brief   コンストラクタ
+     */
+    CubismRenderer_Software();
+
+    /**
+     * @brief   デストラクタ
+     */
+    virtual ~CubismRenderer_Software();
+
+    /**
+     * @brief    レンダラの初期化処理を実行する<br>
+     *           引数に渡したモデルからレンダラの初期化処理に必要な情報を取り出すことができる
+     *
+     * @param[in]  model -> モデルのインスタンス
+     */
+    void Initialize(Framework::CubismModel* model);
+
+    void Initialize(Framework::CubismModel* model, csmInt32 maskBufferCount);
+
+    /**
+     * @brief   テクスチャを設定する<br>
+     *           ピクセルはコピーし、ミップマップを作成する。乗算済みアルファかどうかは IsPremultipliedAlpha() に合わせること。
+     *
+     * @param[in]   modelTextureIndex  ->  セットするモデルテクスチャの番号
+     * @param[in]   pixels             ->  RGBA各8bitのピクセル。行は上から下の順
+     * @param[in]   width              ->  幅
+     * @param[in]   height             ->  高さ
+     */
+    void BindTexture(csmUint32 modelTextureIndex, const csmUint8* pixels, csmInt32 width, csmInt32 height);
+
+    /**
+     * @brief   描画先を設定する<br>
+     *           描画先の内容に重ねて描くため、必要なら事前にクリアしておく。メモリは描画中も呼び出し側が保持する。
+     *
+     * @param[in]   pixels  ->  RGBA各8bitのピクセル。行は上から下の順
+     * @param[in]   width   ->  幅
+     * @param[in]   height  ->  高さ
+     * @param[in]   stride  ->  1行のバイト数。0なら width * 4
+     */
+    void SetRenderTarget(csmUint8* pixels, csmInt32 width, csmInt32 height, csmInt32 stride = 0);
+
+    /**
+     * @brief  クリッピングマスクバッファのサイズを設定する
+     *
+     * @param[in]  width  -> クリッピングマスクバッファの幅
+     * @param[in]  height -> クリッピングマスクバッファの高さ
+     */
+    void SetClippingMaskBufferSize(csmFloat32 width, csmFloat32 height);
+
+    /**
+     * @brief  クリッピングマスクバッファのサイズを取得する
+     *
+     * @return クリッピングマスクバッファのサイズ
+     */
+    CubismVector2 GetClippingMaskBufferSize() const;
+
+    /**
+     * @brief  マスク用のバッファを取得する
+     *
+     * @param[in]  index -> バッファの番号
+     */
+    const CubismOffscreenSurface_Software* GetMaskBuffer(csmInt32 index) const;
+
+    /**
+     * @brief  描画に使うスレッドの数を設定する
+     *
+     * スレッドはスレッド数が同じレンダラの間で共有する。他のレンダラが同時に描画している間は呼び出し元のスレッドだけで描く。
+     *
+     * @param[in]  threadCount -> 呼び出し元を含めたスレッドの数。0以下ならハードウェアのスレッド数
+     */
+    void SetThreadCount(csmInt32 threadCount);
+
+    /**
+     * @brief  描画に使うスレッドの数を取得する
+     */
+    csmInt32 GetThreadCount() const;
+
+    /**
+     * @brief   直近の DrawModel() の統計を取得する
+     */
+    const DrawStatistics& GetDrawStatistics() const;
+
+protected:
+    /**
+     * @brief   モデルを描画する実際の処理
+     *
+     */
+    void DoDrawModel();
+
+    /**
+     * @brief   CPUで描くため保存するステートはない
+     */
+    void SaveProfile();
+
+    /**
+     * @brief   CPUで描くため復帰するステートはない
+     */
+    void RestoreProfile();
+
+private:
+    // Prevention of copy Constructor
+    CubismRenderer_Software(const CubismRenderer_Software&);
+    CubismRenderer_Software& operator=(const CubismRenderer_Software&);
+
+    struct TextureLevel
+    {
+        csmUint8* Pixels;       ///< RGBAのピクセル。行は上から下の順
+        csmInt32 Width;
+        csmInt32 Height;
+    };
+
+    /**
+     * @brief   ミップマップ付きのテクスチャ
+     */
+    struct Texture
+    {
+        static const csmInt32 MaxLevelCount = 16;
+
+        TextureLevel Levels[MaxLevelCount];
+        csmInt32 LevelCount;
+    };
+
+    /**
+     * @brief   1つのDrawableを描くための値。フレームの最初に全てまとめて求め、帯ごとに同じものを使う
+     */
+    struct DrawCommand
+    {
+        csmInt32 DrawableIndex;
+        csmInt32 VertexOffset;          ///< 変換した頂点座標の、_transformedVertices 内の位置
+        csmInt32 ClipVertexOffset;      ///< マスクの座標の、_transformedVertices 内の位置。マスクを使わなければ -1
+        csmFloat32 Bounds[4];           ///< 描画先のピクセル座標での範囲。左、上、右、下
+        const Texture* SourceTexture;
+        csmBool IsCulling;
+        csmBool IsFlipped;              ///< 描画先の上下が正規化デバイス座標と逆か。表裏の判定に使う
+        CubismBlendMode BlendMode;
+        csmFloat32 BaseColor[4];        ///< マスクの生成ではマスクを収める範囲(正規化デバイス座標)
+        csmFloat32 MultiplyColor[4];
+        csmFloat32 ScreenColor[4];
+        csmInt32 MaskBufferIndex;       ///< 読み書きするマスク用のバッファ。使わなければ -1
+        csmInt32 MaskChannel;           ///< 読み書きするマスクのチャンネル
+        csmBool IsInvertedMask;
+    };
+
+    /**
+     * @brief   モデルの頂点座標を行列で変換し、さらに x * scale + offset でピクセル座標にして _transformedVertices に追加する
+     *
+     * @param[in]   drawableIndex   ->  Drawableの番号
+     * @param[in]   matrix          ->  変換行列
+     * @param[in]   scaleX          ->  変換後のxに掛ける値
+     * @param[in]   offsetX         ->  変換後のxに足す値
+     * @param[in]   scaleY          ->  変換後のyに掛ける値
+     * @param[in]   offsetY         ->  変換後のyに足す値
+     * @param[out]  bounds          ->  変換した頂点を囲む矩形。NULLなら求めない
+     *
+     * @return  追加した位置
+     */
+    csmInt32 TransformVertices(csmInt32 drawableIndex, CubismMatrix44& matrix, csmFloat32 scaleX, csmFloat32 offsetX, csmFloat32 scaleY, csmFloat32 offsetY, csmFloat32* bounds);
+
+    /**
+     * @brief   マスクの描画命令を積む。CubismClippingManager_Software から呼ぶ
+     */
+    void AddMaskCommand(csmInt32 drawableIndex, CubismClippingContext_Software* clipContext);
+
+    /**
+     * @brief   帯ごとの描画処理。スレッドプールから呼ばれる
+     */
+    static void DrawMaskTile(void* renderer, csmInt32 tileIndex);
+    static void DrawTile(void* renderer, csmInt32 tileIndex);
+
+    /**
+     * @brief   1つの描画命令の三角形のうち、指定した行の範囲にあるものを描く
+     */
+    void RasterizeCommand(const DrawCommand& command, csmUint8* pixels, csmInt32 width, csmInt32 height, csmInt32 stride, csmInt32 tileTop, csmInt32 tileBottom, csmBool isMask);
+
+    CubismClippingManager_Software* _clippingManager;  ///< クリッピングマスク管理オブジェクト
+    csmVector<CubismOffscreenSurface_Software> _offscreenSurfaces; ///< マスク描画用のバッファ
+    csmVector<csmInt32> _sortedDrawableIndexList;       ///< 描画オブジェクトのインデックスを描画順に並べたリスト
+    csmVector<Texture*> _textures;                      ///< モデルテクスチャの番号ごとのテクスチャ
+
+    csmUint8* _renderTarget;                            ///< 描画先
+    csmInt32 _renderTargetWidth;
+    csmInt32 _renderTargetHeight;
+    csmInt32 _renderTargetStride;
+
+    csmVector<csmFloat32> _transformedVertices;         ///< 変換した頂点座標。フレームごとに作り直す
+    csmVector<DrawCommand> _maskCommands;               ///< マスクの描画命令
+    csmVector<DrawCommand> _drawCommands;               ///< Drawableの描画命令。描画順に並ぶ
+    csmInt32 _tileHeight;                               ///< 1つの帯の行数
+
+    CubismRenderThreadPool_Software* _threadPool;       ///< 帯を並列に描くスレッド。1スレッドの場合はNULL
+    csmInt32 _threadCount;
+
+    DrawStatistics _drawStatistics;
+};
+
+}}}}
+//------------ LIVE2D NAMESPACE ------------
@@ -58,6 +58,15 @@ public:
         return _ptr;
     }
 
+    /**
+     * @brief   コンテナの先頭アドレスを返す（const版）
+     *
+     */
+    const T* GetPtr() const
+    {
+        return _ptr;
+    }
+
     /**
      * @brief   []演算子のオーバーロード
      *
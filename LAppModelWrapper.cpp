@@ -1,6 +1,9 @@
 #include <GL/glew.h>
 
 #include <LAppModel.hpp>
+#include <LAppScene.hpp>
+#include <LAppFrameCapture.hpp>
+#include <LAppHeadlessContext.hpp>
 #include <CubismFramework.hpp>
 #include <LAppPal.hpp>
 #include <LAppAllocator.hpp>
@@ -31,6 +34,117 @@ struct PyLAppModelObject
     time_t fadeout;
 };
 
+// 在方法执行期间持有锁
+// 其他线程可能在释放 GIL 的状态下持有该锁并等待 GIL（例如动作回调），
+// 所以不能持有 GIL 等待，否则会死锁
+template <typename Mutex>
+class GilSafeLock
+{
+public:
+    explicit GilSafeLock(Mutex& mutex)
+        : _mutex(&mutex)
+    {
+        Lock();
+    }
+
+    ~GilSafeLock()
+    {
+        Unlock();
+    }
+
+protected:
+    void Lock()
+    {
+        if (!_mutex->try_lock())
+        {
+            Py_BEGIN_ALLOW_THREADS
+            _mutex->lock();
+            Py_END_ALLOW_THREADS
+        }
+    }
+
+    void Unlock()
+    {
+        _mutex->unlock();
+    }
+
+private:
+    Mutex* _mutex;
+};
+
+// 使用模型自身的递归锁，以便回调中可以再次调用同一模型的方法，Scene 的工作线程也使用同一把锁
+// 流水线模式下还要等待后台更新结束（waitPendingUpdate），Draw 只读取快照所以不需要等待
+class ModelLock : public GilSafeLock<std::recursive_mutex>
+{
+public:
+    explicit ModelLock(PyLAppModelObject* self, bool waitPendingUpdate = true)
+        : GilSafeLock<std::recursive_mutex>(self->model->GetMutex())
+    {
+        // 后台更新中的动作回调也会获取这把锁，等待时要先释放锁，否则会死锁
+        while (waitPendingUpdate && self->model->IsUpdatePending())
+        {
+            Unlock();
+            Py_BEGIN_ALLOW_THREADS
+            self->model->WaitPendingUpdate();
+            Py_END_ALLOW_THREADS
+            Lock();
+        }
+    }
+};
+
+// 异步加载时加载线程不持有模型的锁，一边填充模型、动作和表情一边运行，加载完成前不能访问这些数据
+// 访问模型的方法要求加载完成；只修改设置的方法（allowUnloaded）在开始加载前或加载失败后也可以调用
+static bool CheckLoadState(PyLAppModelObject* self, bool allowUnloaded = false)
+{
+    const LAppModel::LoadState state = self->model->GetLoadState();
+    if (state == LAppModel::LoadState_Finished)
+    {
+        return true;
+    }
+
+    if (allowUnloaded && (state == LAppModel::LoadState_None || state == LAppModel::LoadState_Failed))
+    {
+        return true;
+    }
+
+    PyErr_SetString(PyExc_RuntimeError, "model is not loaded");
+    return false;
+}
+
+// 解析 Update / Frame 的 deltaTime 参数。省略或为 None 时返回 -1，表示按模型时钟测得的实际经过时间更新
+static bool ParseDeltaTime(PyObject* args, PyObject* kwargs, float* deltaTime)
+{
+    PyObject* value = NULL;
+
+    static char* kwlist[] = {(char*)"deltaTime", NULL};
+
+    if (!(PyArg_ParseTupleAndKeywords(args, kwargs, "|O", kwlist, &value)))
+    {
+        return false;
+    }
+
+    if (value == NULL || value == Py_None)
+    {
+        *deltaTime = -1.0f;
+        return true;
+    }
+
+    const double seconds = PyFloat_AsDouble(value);
+    if (seconds == -1.0 && PyErr_Occurred())
+    {
+        return false;
+    }
+
+    if (!(seconds >= 0.0))
+    {
+        PyErr_SetString(PyExc_ValueError, "deltaTime must be non-negative");
+        return false;
+    }
+
+    *deltaTime = static_cast<float>(seconds);
+    return true;
+}
+
 // LAppModel()
 static int PyLAppModel_init(PyLAppModelObject* self, PyObject* args, PyObject* kwds)
 {
@@ -51,19 +165,109 @@ static void PyLAppModel_dealloc(PyLAppModelObject* self)
 // LAppModel->LoadAssets
 static PyObject* PyLAppModel_LoadModelJson(PyLAppModelObject* self, PyObject* args)
 {
+    ModelLock lock(self);
+
     const char* fileName;
     if (!PyArg_ParseTuple(args, "s", &fileName))
     {
         return NULL;
     }
 
+    // 加载期间释放 GIL
+    Py_BEGIN_ALLOW_THREADS
     self->model->LoadAssets(fileName);
+    Py_END_ALLOW_THREADS
+
+    Py_RETURN_NONE;
+}
+
+// LAppModel->LoadAssetsAsync
+static PyObject* PyLAppModel_LoadModelJsonAsync(PyLAppModelObject* self, PyObject* args)
+{
+    ModelLock lock(self);
+
+    const char* fileName;
+    int workerCount = 0;
+    if (!PyArg_ParseTuple(args, "s|i", &fileName, &workerCount))
+    {
+        return NULL;
+    }
+
+    self->model->LoadAssetsAsync(fileName, workerCount);
 
     Py_RETURN_NONE;
 }
 
+static PyObject* PyLAppModel_FinishLoad(PyLAppModelObject* self, PyObject* args)
+{
+    ModelLock lock(self);
+
+    bool wait = false;
+    if (!PyArg_ParseTuple(args, "|b", &wait))
+    {
+        return NULL;
+    }
+
+    bool finished;
+
+    // wait 为 True 时会阻塞到加载完成，期间释放 GIL
+    Py_BEGIN_ALLOW_THREADS
+    finished = self->model->FinishLoad(wait);
+    Py_END_ALLOW_THREADS
+
+    if (!finished)
+    {
+        Py_RETURN_FALSE;
+    }
+
+    if (self->model->GetLoadState() == LAppModel::LoadState_Failed)
+    {
+        PyErr_SetString(PyExc_RuntimeError, "failed to load model");
+        return NULL;
+    }
+
+    Py_RETURN_TRUE;
+}
+
+static PyObject* PyLAppModel_GetLoadProgress(PyLAppModelObject* self, PyObject* args)
+{
+    ModelLock lock(self);
+
+    return PyFloat_FromDouble(self->model->GetLoadProgress());
+}
+
+static PyObject* PyLAppModel_GetLoadTimings(PyLAppModelObject* self, PyObject* args)
+{
+    ModelLock lock(self);
+
+    static const char* names[LAppModel::LoadCategory_Count] = {
+        "setting", "moc", "expression", "physics", "pose", "userData", "motion", "textureDecode", "textureUpload",
+        "renderer"
+    };
+
+    double timings[LAppModel::LoadCategory_Count];
+    self->model->GetLoadTimings(timings);
+
+    PyObject* dict = PyDict_New();
+    for (int i = 0; i < LAppModel::LoadCategory_Count; i++)
+    {
+        PyObject* value = PyFloat_FromDouble(timings[i]);
+        PyDict_SetItemString(dict, names[i], value);
+        Py_DECREF(value);
+    }
+
+    return dict;
+}
+
 static PyObject* PyLAppModel_Resize(PyLAppModelObject* self, PyObject* args)
 {
+    ModelLock lock(self);
+
+    if (!CheckLoadState(self, true))
+    {
+        return NULL;
+    }
+
     int ww, wh;
     if (!PyArg_ParseTuple(args, "ii", &ww, &wh))
     {
@@ -78,10 +282,66 @@ static PyObject* PyLAppModel_Resize(PyLAppModelObject* self, PyObject* args)
 
 static PyObject* PyLAppModel_Draw(PyLAppModelObject* self, PyObject* args)
 {
+    ModelLock lock(self, false);
+
+    if (!CheckLoadState(self))
+    {
+        return NULL;
+    }
+
+    // 绘制期间释放 GIL。OpenGL 上下文需要在调用线程中为当前上下文
+    Py_BEGIN_ALLOW_THREADS
     self->model->Draw();
+    Py_END_ALLOW_THREADS
+
     Py_RETURN_NONE;
 }
 
+// 不使用 OpenGL，用 CPU 绘制到新的 bytearray（RGBA，行从上到下，背景透明）
+static PyObject* PyLAppModel_DrawSoftware(PyLAppModelObject* self, PyObject* args)
+{
+    int width, height;
+    if (!PyArg_ParseTuple(args, "ii", &width, &height) || width <= 0 || height <= 0)
+    {
+        PyErr_SetString(PyExc_TypeError, "Invalid param");
+        return NULL;
+    }
+
+    const size_t size = static_cast<size_t>(width) * height * 4;
+    PyObject* pixels = PyByteArray_FromStringAndSize(NULL, static_cast<Py_ssize_t>(size));
+    if (pixels == NULL)
+    {
+        return NULL;
+    }
+
+    unsigned char* data = reinterpret_cast<unsigned char*>(PyByteArray_AsString(pixels));
+    bool drawn;
+
+    {
+        ModelLock lock(self, false);
+
+        if (!CheckLoadState(self))
+        {
+            Py_DECREF(pixels);
+            return NULL;
+        }
+
+        Py_BEGIN_ALLOW_THREADS
+        memset(data, 0, size);
+        drawn = self->model->DrawSoftware(data, width, height);
+        Py_END_ALLOW_THREADS
+    }
+
+    if (!drawn)
+    {
+        Py_DECREF(pixels);
+        PyErr_SetString(PyExc_RuntimeError, "model is not loaded");
+        return NULL;
+    }
+
+    return pixels;
+}
+
 typedef Live2D::Cubism::Framework::ACubismMotion ACubismMotion;
 
 void OnMotionStartedCallback(ACubismMotion* motion)
@@ -137,6 +397,13 @@ static PyObject* MakeCallee(PyObject* callback)
 
 static PyObject* PyLAppModel_StartMotion(PyLAppModelObject* self, PyObject* args, PyObject* kwargs)
 {
+    ModelLock lock(self);
+
+    if (!CheckLoadState(self))
+    {
+        return NULL;
+    }
+
     const char* group;
     int no, priority;
     PyObject* onStartHandler = nullptr;
@@ -164,6 +431,13 @@ static PyObject* PyLAppModel_StartMotion(PyLAppModelObject* self, PyObject* args
 
 static PyObject* PyLAppModel_StartRandomMotion(PyLAppModelObject* self, PyObject* args, PyObject* kwargs)
 {
+    ModelLock lock(self);
+
+    if (!CheckLoadState(self))
+    {
+        return NULL;
+    }
+
     const char* group = nullptr;
     int priority = 3;
 
@@ -190,18 +464,39 @@ static PyObject* PyLAppModel_StartRandomMotion(PyLAppModelObject* self, PyObject
 
 static PyObject* PyLAppModel_StopAllMotions(PyLAppModelObject* self, PyObject* args, PyObject* kwargs)
 {
+    ModelLock lock(self);
+
+    if (!CheckLoadState(self))
+    {
+        return NULL;
+    }
+
     self->model->StopAllMotions();
     Py_RETURN_NONE;
 }
 
 static PyObject* PyLAppModel_ResetPose(PyLAppModelObject* self, PyObject* args, PyObject* kwargs)
 {
+    ModelLock lock(self);
+
+    if (!CheckLoadState(self))
+    {
+        return NULL;
+    }
+
     self->model->ResetPose();
     Py_RETURN_NONE;
 }
 
 static PyObject* PyLAppModel_SetExpression(PyLAppModelObject* self, PyObject* args, PyObject* kwargs)
 {
+    ModelLock lock(self);
+
+    if (!CheckLoadState(self))
+    {
+        return NULL;
+    }
+
     const char* expressionID;
     int fadeout = -1;
 
@@ -215,8 +510,8 @@ static PyObject* PyLAppModel_SetExpression(PyLAppModelObject* self, PyObject* ar
 
     if (fadeout >= 0)
     {
-        auto now = std::chrono::system_clock::now();
-        self->expStartedAt = std::chrono::time_point_cast<std::chrono::milliseconds>(now).time_since_epoch().count();
+        // 使用模型自身的时钟计时，使 Update(deltaTime) 时同样生效
+        self->expStartedAt = static_cast<time_t>(self->model->GetUserTimeSeconds() * 1000.0f);
     }
     else
     {
@@ -239,6 +534,13 @@ static PyObject* PyLAppModel_SetExpression(PyLAppModelObject* self, PyObject* ar
 
 static PyObject* PyLAppModel_ResetExpression(PyLAppModelObject* self, PyObject* args)
 {
+    ModelLock lock(self);
+
+    if (!CheckLoadState(self))
+    {
+        return NULL;
+    }
+
     self->fadeout = -1;
     self->expStartedAt = -1;
     if (self->lastExpression != nullptr)
@@ -253,6 +555,13 @@ static PyObject* PyLAppModel_ResetExpression(PyLAppModelObject* self, PyObject*
 
 static PyObject* PyLAppModel_SetRandomExpression(PyLAppModelObject* self, PyObject* args)
 {
+    ModelLock lock(self);
+
+    if (!CheckLoadState(self))
+    {
+        return NULL;
+    }
+
     self->model->SetRandomExpression();
     Py_RETURN_NONE;
 }
@@ -261,6 +570,13 @@ typedef Live2D::Cubism::Framework::csmString csmString;
 
 static PyObject* PyLAppModel_HitTest(PyLAppModelObject* self, PyObject* args)
 {
+    ModelLock lock(self);
+
+    if (!CheckLoadState(self))
+    {
+        return NULL;
+    }
+
     float x, y;
     if (!(PyArg_ParseTuple(args, "ff", &x, &y)))
     {
@@ -274,6 +590,13 @@ static PyObject* PyLAppModel_HitTest(PyLAppModelObject* self, PyObject* args)
 
 static PyObject* PyLAppModel_HasMocConsistencyFromFile(PyLAppModelObject* self, PyObject* args)
 {
+    ModelLock lock(self);
+
+    if (!CheckLoadState(self, true))
+    {
+        return NULL;
+    }
+
     const char* mocFileName;
     if (!(PyArg_ParseTuple(args, "s", &mocFileName)))
     {
@@ -290,6 +613,13 @@ static PyObject* PyLAppModel_HasMocConsistencyFromFile(PyLAppModelObject* self,
 
 static PyObject* PyLAppModel_Touch(PyLAppModelObject* self, PyObject* args, PyObject* kwargs)
 {
+    ModelLock lock(self);
+
+    if (!CheckLoadState(self))
+    {
+        return NULL;
+    }
+
     float mx, my;
     PyObject* onStartHandler = nullptr;
     PyObject* onFinishHandler = nullptr;
@@ -313,6 +643,13 @@ static PyObject* PyLAppModel_Touch(PyLAppModelObject* self, PyObject* args, PyOb
 
 static PyObject* PyLAppModel_Drag(PyLAppModelObject* self, PyObject* args)
 {
+    ModelLock lock(self);
+
+    if (!CheckLoadState(self))
+    {
+        return NULL;
+    }
+
     float mx, my;
     if (!(PyArg_ParseTuple(args, "ff", &mx, &my)))
     {
@@ -326,6 +663,13 @@ static PyObject* PyLAppModel_Drag(PyLAppModelObject* self, PyObject* args)
 
 static PyObject* PyLAppModel_IsMotionFinished(PyLAppModelObject* self, PyObject* args)
 {
+    ModelLock lock(self);
+
+    if (!CheckLoadState(self))
+    {
+        return NULL;
+    }
+
     if (self->model->IsMotionFinished())
     {
         Py_RETURN_TRUE;
@@ -336,6 +680,13 @@ static PyObject* PyLAppModel_IsMotionFinished(PyLAppModelObject* self, PyObject*
 
 static PyObject* PyLAppModel_SetOffset(PyLAppModelObject* self, PyObject* args)
 {
+    ModelLock lock(self);
+
+    if (!CheckLoadState(self, true))
+    {
+        return NULL;
+    }
+
     float dx, dy;
 
     if (PyArg_ParseTuple(args, "ff", &dx, &dy) < 0)
@@ -351,6 +702,13 @@ static PyObject* PyLAppModel_SetOffset(PyLAppModelObject* self, PyObject* args)
 
 static PyObject* PyLAppModel_SetScale(PyLAppModelObject* self, PyObject* args)
 {
+    ModelLock lock(self);
+
+    if (!CheckLoadState(self, true))
+    {
+        return NULL;
+    }
+
     float scale;
 
     if (PyArg_ParseTuple(args, "f", &scale) < 0)
@@ -366,6 +724,13 @@ static PyObject* PyLAppModel_SetScale(PyLAppModelObject* self, PyObject* args)
 
 static PyObject* PyLAppModel_SetParameterValue(PyLAppModelObject* self, PyObject* args)
 {
+    ModelLock lock(self);
+
+    if (!CheckLoadState(self))
+    {
+        return NULL;
+    }
+
     const char* paramId;
     float value, weight;
 
@@ -382,6 +747,13 @@ static PyObject* PyLAppModel_SetParameterValue(PyLAppModelObject* self, PyObject
 
 static PyObject* PyLAppModel_AddParameterValue(PyLAppModelObject* self, PyObject* args)
 {
+    ModelLock lock(self);
+
+    if (!CheckLoadState(self))
+    {
+        return NULL;
+    }
+
     const char* paramId;
     float value;
 
@@ -396,36 +768,67 @@ static PyObject* PyLAppModel_AddParameterValue(PyLAppModelObject* self, PyObject
     Py_RETURN_NONE;
 }
 
-static PyObject* PyLAppModel_Update(PyLAppModelObject* self, PyObject* args)
+static PyObject* PyLAppModel_Update(PyLAppModelObject* self, PyObject* args, PyObject* kwargs)
 {
-    if (self->fadeout >= 0)
+    ModelLock lock(self);
+
+    if (!CheckLoadState(self))
+    {
+        return NULL;
+    }
+
+    float deltaTime;
+    if (!ParseDeltaTime(args, kwargs, &deltaTime))
     {
-        auto now = std::chrono::system_clock::now();
-        auto value = std::chrono::time_point_cast<std::chrono::milliseconds>(now).time_since_epoch().count();
-        time_t elapsed = value - self->expStartedAt;
-        if (elapsed >= self->fadeout)
+        return NULL;
+    }
+
+    // 更新期间释放 GIL，其他线程可以同时更新其他模型
+    // 动作回调会通过 PyGILState_Ensure 重新获取 GIL
+    Py_BEGIN_ALLOW_THREADS
+        if (self->fadeout >= 0)
         {
-            if (self->lastExpression != nullptr)
+            time_t value = static_cast<time_t>(self->model->GetUserTimeSeconds() * 1000.0f);
+            time_t elapsed = value - self->expStartedAt;
+            if (elapsed >= self->fadeout)
             {
-                self->model->SetExpression(self->lastExpression);
-                Info("reset expression %s", self->lastExpression);
+                if (self->lastExpression != nullptr)
+                {
+                    self->model->SetExpression(self->lastExpression);
+                    Info("reset expression %s", self->lastExpression);
+                }
+                else
+                {
+                    self->model->ResetExpression();
+                    Info("clear expression");
+                }
+                self->fadeout = -1;
             }
-            else
-            {
-                self->model->ResetExpression();
-                Info("clear expression");
-            }
-            self->fadeout = -1;
         }
-    }
 
-    self->model->Update();
+        // 省略 deltaTime 时按模型时钟测得的实际经过时间更新
+        if (deltaTime < 0.0f)
+        {
+            self->model->Update();
+        }
+        else
+        {
+            self->model->Update(deltaTime);
+        }
+    Py_END_ALLOW_THREADS
 
     Py_RETURN_NONE;
 }
 
 static PyObject* PyLAppModel_SetAutoBreathEnable(PyLAppModelObject* self, PyObject* args)
 {
+    ModelLock lock(self);
+
+    if (!CheckLoadState(self, true))
+    {
+        return NULL;
+    }
+
     bool enable;
 
     if (PyArg_ParseTuple(args, "b", &enable) < 0)
@@ -441,6 +844,13 @@ static PyObject* PyLAppModel_SetAutoBreathEnable(PyLAppModelObject* self, PyObje
 
 static PyObject* PyLAppModel_SetAutoBlinkEnable(PyLAppModelObject* self, PyObject* args)
 {
+    ModelLock lock(self);
+
+    if (!CheckLoadState(self, true))
+    {
+        return NULL;
+    }
+
     bool enable;
 
     if (PyArg_ParseTuple(args, "b", &enable) < 0)
@@ -454,39 +864,236 @@ static PyObject* PyLAppModel_SetAutoBlinkEnable(PyLAppModelObject* self, PyObjec
     Py_RETURN_NONE;
 }
 
-static PyObject* PyLAppModel_GetParameterCount(PyLAppModelObject* self, PyObject* args)
+static PyObject* PyLAppModel_SetMotionBaking(PyLAppModelObject* self, PyObject* args)
 {
-    return PyLong_FromLong(self->model->GetParameterCount());
-}
+    ModelLock lock(self);
 
-static PyObject* module_live2d_v3_params = nullptr;
-static PyObject* typeobject_live2d_v3_parameter = nullptr;
-
-static PyObject* PyLAppModel_GetParameter(PyLAppModelObject* self, PyObject* args)
-{
-    int index;
-    if (PyArg_ParseTuple(args, "i", &index) < 0)
+    if (!CheckLoadState(self, true))
     {
-        PyErr_SetString(PyExc_TypeError, "Invalid param");
         return NULL;
     }
 
-    const char* id;
-    int type;
-    float value, maxValue, minValue, defaultValue;
-    self->model->GetParameter(index, id, type, value, maxValue, minValue, defaultValue);
+    float sampleRate;
+    float maxError = 0.01f;
 
-    PyObject* instance = PyObject_CallObject(typeobject_live2d_v3_parameter, NULL);
-    if (instance == NULL)
+    if (!PyArg_ParseTuple(args, "f|f", &sampleRate, &maxError))
     {
-        PyErr_Print();
+        PyErr_SetString(PyExc_TypeError, "Invalid param");
         return NULL;
     }
 
-    PyObject_SetAttrString(instance, "id", PyUnicode_FromString(id));
-    PyObject_SetAttrString(instance, "type", PyLong_FromLong(type));
-    PyObject_SetAttrString(instance, "value", PyFloat_FromDouble(value));
-    PyObject_SetAttrString(instance, "max", PyFloat_FromDouble(maxValue));
+    self->model->SetMotionBaking(sampleRate, maxError);
+
+    Py_RETURN_NONE;
+}
+
+static PyObject* PyLAppModel_SetMotionCachePolicy(PyLAppModelObject* self, PyObject* args)
+{
+    ModelLock lock(self);
+
+    if (!CheckLoadState(self, true))
+    {
+        return NULL;
+    }
+
+    bool lazy;
+    Py_ssize_t budgetBytes = 0;
+
+    if (!PyArg_ParseTuple(args, "b|n", &lazy, &budgetBytes))
+    {
+        PyErr_SetString(PyExc_TypeError, "Invalid param");
+        return NULL;
+    }
+
+    self->model->SetMotionCachePolicy(lazy, budgetBytes > 0 ? static_cast<size_t>(budgetBytes) : 0);
+
+    Py_RETURN_NONE;
+}
+
+static PyObject* PyLAppModel_PrefetchMotionGroup(PyLAppModelObject* self, PyObject* args)
+{
+    ModelLock lock(self);
+
+    if (!CheckLoadState(self))
+    {
+        return NULL;
+    }
+
+    const char* group;
+
+    if (!PyArg_ParseTuple(args, "s", &group))
+    {
+        PyErr_SetString(PyExc_TypeError, "Invalid param");
+        return NULL;
+    }
+
+    self->model->PrefetchMotionGroup(group);
+
+    Py_RETURN_NONE;
+}
+
+static PyObject* PyLAppModel_GetMotionCacheStats(PyLAppModelObject* self, PyObject* args)
+{
+    ModelLock lock(self);
+
+    if (!CheckLoadState(self))
+    {
+        return NULL;
+    }
+
+    unsigned long long hits, misses, evictions;
+    size_t residentBytes;
+    int residentCount;
+
+    self->model->GetMotionCacheStats(hits, misses, evictions, residentBytes, residentCount);
+
+    return Py_BuildValue("{s:K,s:K,s:K,s:n,s:i}", "hits", hits, "misses", misses, "evictions", evictions,
+                         "residentBytes", static_cast<Py_ssize_t>(residentBytes), "residentCount", residentCount);
+}
+
+static PyObject* PyLAppModel_SetRenderCacheEnable(PyLAppModelObject* self, PyObject* args)
+{
+    ModelLock lock(self);
+
+    if (!CheckLoadState(self, true))
+    {
+        return NULL;
+    }
+
+    bool enable;
+
+    if (!PyArg_ParseTuple(args, "b", &enable))
+    {
+        PyErr_SetString(PyExc_TypeError, "Invalid param");
+        return NULL;
+    }
+
+    self->model->SetRenderCacheEnable(enable);
+
+    Py_RETURN_NONE;
+}
+
+static PyObject* PyLAppModel_InvalidateRenderCache(PyLAppModelObject* self, PyObject* args)
+{
+    ModelLock lock(self);
+
+    if (!CheckLoadState(self))
+    {
+        return NULL;
+    }
+
+    self->model->InvalidateRenderCache();
+
+    Py_RETURN_NONE;
+}
+
+// 绘制结果缓存的命中次数、未命中次数和命中率
+static PyObject* PyLAppModel_GetRenderCacheStats(PyLAppModelObject* self, PyObject* args)
+{
+    ModelLock lock(self, false);
+
+    if (!CheckLoadState(self))
+    {
+        return NULL;
+    }
+
+    unsigned long long hits, misses;
+
+    self->model->GetRenderCacheStats(hits, misses);
+
+    const double total = static_cast<double>(hits + misses);
+
+    // 含正片叠底混合部件的模型不使用缓存，enabled 为 False
+    return Py_BuildValue("{s:O,s:K,s:K,s:d}", "enabled", self->model->IsRenderCacheEnabled() ? Py_True : Py_False,
+                         "hits", hits, "misses", misses, "hitRate", total > 0 ? hits / total : 0.0);
+}
+
+// 顶点计算的统计：实际计算的次数和因参数、部件透明度未变化而跳过的次数
+static PyObject* PyLAppModel_GetCoreUpdateStats(PyLAppModelObject* self, PyObject* args)
+{
+    ModelLock lock(self);
+
+    if (!CheckLoadState(self))
+    {
+        return NULL;
+    }
+
+    unsigned long long performed, skipped;
+
+    self->model->GetCoreUpdateStats(performed, skipped);
+
+    return Py_BuildValue("{s:K,s:K}", "performed", performed, "skipped", skipped);
+}
+
+// 最近一次 Draw 的统计：上传了顶点坐标的 Drawable 数和字节数
+static PyObject* PyLAppModel_GetRenderStats(PyLAppModelObject* self, PyObject* args)
+{
+    ModelLock lock(self, false);
+
+    if (!CheckLoadState(self))
+    {
+        return NULL;
+    }
+
+    const Csm::Rendering::CubismRenderer_OpenGLES2::DrawStatistics stats = self->model->GetDrawStatistics();
+
+    return Py_BuildValue("{s:i,s:n,s:i,s:i,s:i,s:i,s:i,s:i}", "uploadedDrawables", stats.UploadedDrawableCount,
+                         "uploadedVertexBytes", static_cast<Py_ssize_t>(stats.UploadedVertexBytes),
+                         "drawCalls", stats.DrawCallCount,
+                         "batchedDrawables", stats.BatchedDrawableCount,
+                         "stateChanges", stats.StateChangeCount,
+                         "skippedStateCalls", stats.SkippedStateCallCount,
+                         "clippingMasks", stats.ClippingMaskCount,
+                         "redrawnClippingMasks", stats.RedrawnClippingMaskCount);
+}
+
+static PyObject* PyLAppModel_GetParameterCount(PyLAppModelObject* self, PyObject* args)
+{
+    ModelLock lock(self);
+
+    if (!CheckLoadState(self))
+    {
+        return NULL;
+    }
+
+    return PyLong_FromLong(self->model->GetParameterCount());
+}
+
+static PyObject* module_live2d_v3_params = nullptr;
+static PyObject* typeobject_live2d_v3_parameter = nullptr;
+
+static PyObject* PyLAppModel_GetParameter(PyLAppModelObject* self, PyObject* args)
+{
+    ModelLock lock(self);
+
+    if (!CheckLoadState(self))
+    {
+        return NULL;
+    }
+
+    int index;
+    if (PyArg_ParseTuple(args, "i", &index) < 0)
+    {
+        PyErr_SetString(PyExc_TypeError, "Invalid param");
+        return NULL;
+    }
+
+    const char* id;
+    int type;
+    float value, maxValue, minValue, defaultValue;
+    self->model->GetParameter(index, id, type, value, maxValue, minValue, defaultValue);
+
+    PyObject* instance = PyObject_CallObject(typeobject_live2d_v3_parameter, NULL);
+    if (instance == NULL)
+    {
+        PyErr_Print();
+        return NULL;
+    }
+
+    PyObject_SetAttrString(instance, "id", PyUnicode_FromString(id));
+    PyObject_SetAttrString(instance, "type", PyLong_FromLong(type));
+    PyObject_SetAttrString(instance, "value", PyFloat_FromDouble(value));
+    PyObject_SetAttrString(instance, "max", PyFloat_FromDouble(maxValue));
     PyObject_SetAttrString(instance, "min", PyFloat_FromDouble(minValue));
     PyObject_SetAttrString(instance, "default", PyFloat_FromDouble(defaultValue));
 
@@ -496,12 +1103,26 @@ static PyObject* PyLAppModel_GetParameter(PyLAppModelObject* self, PyObject* arg
 // GetPartCount() -> int
 static PyObject* PyLAppModel_GetPartCount(PyLAppModelObject* self, PyObject* args)
 {
+    ModelLock lock(self);
+
+    if (!CheckLoadState(self))
+    {
+        return NULL;
+    }
+
     return PyLong_FromLong(self->model->GetPartCount());
 }
 
 // GetPartId(index: int) -> str
 static PyObject* PyLAppModel_GetPartId(PyLAppModelObject* self, PyObject* args)
 {
+    ModelLock lock(self);
+
+    if (!CheckLoadState(self))
+    {
+        return NULL;
+    }
+
     int index;
     if (PyArg_ParseTuple(args, "i", &index) < 0)
     {
@@ -515,6 +1136,13 @@ static PyObject* PyLAppModel_GetPartId(PyLAppModelObject* self, PyObject* args)
 // GetPartIds() -> tuple[str]
 static PyObject* PyLAppModel_GetPartIds(PyLAppModelObject* self, PyObject* args)
 {
+    ModelLock lock(self);
+
+    if (!CheckLoadState(self))
+    {
+        return NULL;
+    }
+
     const int size = self->model->GetPartCount();
 
     PyObject* list = PyList_New(size);
@@ -530,6 +1158,13 @@ static PyObject* PyLAppModel_GetPartIds(PyLAppModelObject* self, PyObject* args)
 // SetPartOpacity(id: str, opacity: float) -> None
 static PyObject* PyLAppModel_SetPartOpacity(PyLAppModelObject* self, PyObject* args)
 {
+    ModelLock lock(self);
+
+    if (!CheckLoadState(self))
+    {
+        return NULL;
+    }
+
     int index;
     float opacity;
     if (PyArg_ParseTuple(args, "if", &index, &opacity) < 0)
@@ -549,6 +1184,13 @@ void hitPartCallback(void* collector, const char* paramId) {
 
 static PyObject* PyLAppModel_HitPart(PyLAppModelObject* self, PyObject* args)
 {
+    ModelLock lock(self);
+
+    if (!CheckLoadState(self))
+    {
+        return NULL;
+    }
+
     float x, y;
     bool topOnly = false;
     if (!PyArg_ParseTuple(args, "ff|b", &x, &y, &topOnly))
@@ -567,6 +1209,13 @@ static PyObject* PyLAppModel_HitPart(PyLAppModelObject* self, PyObject* args)
 
 static PyObject* PyLAppModel_SetPartMultiplyColor(PyLAppModelObject* self, PyObject* args)
 {
+    ModelLock lock(self);
+
+    if (!CheckLoadState(self))
+    {
+        return NULL;
+    }
+
     int index;
     float r, g, b, a;
     if (PyArg_ParseTuple(args, "iffff", &index, &r, &g, &b, &a) < 0)
@@ -580,6 +1229,13 @@ static PyObject* PyLAppModel_SetPartMultiplyColor(PyLAppModelObject* self, PyObj
 
 static PyObject* PyLAppModel_GetPartMultiplyColor(PyLAppModelObject* self, PyObject* args)
 {
+    ModelLock lock(self);
+
+    if (!CheckLoadState(self))
+    {
+        return NULL;
+    }
+
     int index;
     if (PyArg_ParseTuple(args, "i", &index) < 0)
     {
@@ -594,6 +1250,13 @@ static PyObject* PyLAppModel_GetPartMultiplyColor(PyLAppModelObject* self, PyObj
 
 static PyObject* PyLAppModel_SetPartScreenColor(PyLAppModelObject* self, PyObject* args)
 {
+    ModelLock lock(self);
+
+    if (!CheckLoadState(self))
+    {
+        return NULL;
+    }
+
     int index;
     float r, g, b, a;
     if (PyArg_ParseTuple(args, "iffff", &index, &r, &g, &b, &a) < 0)
@@ -606,8 +1269,48 @@ static PyObject* PyLAppModel_SetPartScreenColor(PyLAppModelObject* self, PyObjec
     Py_RETURN_NONE;
 }
 
+// 流水线模式：Update 在模型的工作线程中计算下一帧，Draw 绘制上一帧的快照，显示延迟一帧
+static PyObject* PyLAppModel_SetPipelined(PyLAppModelObject* self, PyObject* args)
+{
+    ModelLock lock(self);
+
+    if (!CheckLoadState(self, true))
+    {
+        return NULL;
+    }
+
+    bool enable;
+
+    if (!PyArg_ParseTuple(args, "b", &enable))
+    {
+        PyErr_SetString(PyExc_TypeError, "Invalid param");
+        return NULL;
+    }
+
+    bool result;
+    Py_BEGIN_ALLOW_THREADS
+    result = self->model->SetPipelined(enable);
+    Py_END_ALLOW_THREADS
+
+    // 流水线工作线程中的动作回调不能等待工作线程自己结束
+    if (!result)
+    {
+        PyErr_SetString(PyExc_RuntimeError, "SetPipelined(False) cannot be called from a callback running on the pipeline worker");
+        return NULL;
+    }
+
+    Py_RETURN_NONE;
+}
+
 static PyObject* PyLAppModel_GetPartScreenColor(PyLAppModelObject* self, PyObject* args)
 {
+    ModelLock lock(self);
+
+    if (!CheckLoadState(self))
+    {
+        return NULL;
+    }
+
     int index;
 
     if (PyArg_ParseTuple(args, "i", &index) < 0)
@@ -625,8 +1328,13 @@ static PyObject* PyLAppModel_GetPartScreenColor(PyLAppModelObject* self, PyObjec
 // 包装模块方法的方法列表
 static PyMethodDef PyLAppModel_methods[] = {
     {"LoadModelJson", (PyCFunction)PyLAppModel_LoadModelJson, METH_VARARGS, ""},
+    {"LoadModelJsonAsync", (PyCFunction)PyLAppModel_LoadModelJsonAsync, METH_VARARGS, ""},
+    {"FinishLoad", (PyCFunction)PyLAppModel_FinishLoad, METH_VARARGS, ""},
+    {"GetLoadProgress", (PyCFunction)PyLAppModel_GetLoadProgress, METH_VARARGS, ""},
+    {"GetLoadTimings", (PyCFunction)PyLAppModel_GetLoadTimings, METH_VARARGS, ""},
     {"Resize", (PyCFunction)PyLAppModel_Resize, METH_VARARGS, ""},
     {"Draw", (PyCFunction)PyLAppModel_Draw, METH_VARARGS, ""},
+    {"DrawSoftware", (PyCFunction)PyLAppModel_DrawSoftware, METH_VARARGS, ""},
     {"StartMotion", (PyCFunction)PyLAppModel_StartMotion, METH_VARARGS | METH_KEYWORDS, ""},
     {"StartRandomMotion", (PyCFunction)PyLAppModel_StartRandomMotion, METH_VARARGS | METH_KEYWORDS, ""},
     {"StopAllMotions", (PyCFunction)PyLAppModel_StopAllMotions, METH_VARARGS | METH_KEYWORDS, ""},
@@ -643,10 +1351,20 @@ static PyMethodDef PyLAppModel_methods[] = {
     {"IsMotionFinished", (PyCFunction)PyLAppModel_IsMotionFinished, METH_VARARGS, ""},
     {"SetOffset", (PyCFunction)PyLAppModel_SetOffset, METH_VARARGS, ""},
     {"SetScale", (PyCFunction)PyLAppModel_SetScale, METH_VARARGS, ""},
-    {"Update", (PyCFunction)PyLAppModel_Update, METH_VARARGS, ""},
+    {"Update", (PyCFunction)PyLAppModel_Update, METH_VARARGS | METH_KEYWORDS, ""},
+    {"SetPipelined", (PyCFunction)PyLAppModel_SetPipelined, METH_VARARGS, ""},
 
     {"SetAutoBreathEnable", (PyCFunction)PyLAppModel_SetAutoBreathEnable, METH_VARARGS, ""},
     {"SetAutoBlinkEnable", (PyCFunction)PyLAppModel_SetAutoBlinkEnable, METH_VARARGS, ""},
+    {"SetMotionBaking", (PyCFunction)PyLAppModel_SetMotionBaking, METH_VARARGS, ""},
+    {"SetMotionCachePolicy", (PyCFunction)PyLAppModel_SetMotionCachePolicy, METH_VARARGS, ""},
+    {"PrefetchMotionGroup", (PyCFunction)PyLAppModel_PrefetchMotionGroup, METH_VARARGS, ""},
+    {"GetMotionCacheStats", (PyCFunction)PyLAppModel_GetMotionCacheStats, METH_VARARGS, ""},
+    {"GetRenderStats", (PyCFunction)PyLAppModel_GetRenderStats, METH_VARARGS, ""},
+    {"SetRenderCacheEnable", (PyCFunction)PyLAppModel_SetRenderCacheEnable, METH_VARARGS, ""},
+    {"InvalidateRenderCache", (PyCFunction)PyLAppModel_InvalidateRenderCache, METH_VARARGS, ""},
+    {"GetRenderCacheStats", (PyCFunction)PyLAppModel_GetRenderCacheStats, METH_VARARGS, ""},
+    {"GetCoreUpdateStats", (PyCFunction)PyLAppModel_GetCoreUpdateStats, METH_VARARGS, ""},
 
     {"SetParameterValue", (PyCFunction)PyLAppModel_SetParameterValue, METH_VARARGS, ""},
     {"AddParameterValue", (PyCFunction)PyLAppModel_AddParameterValue, METH_VARARGS, ""},
@@ -690,52 +1408,594 @@ static PyType_Spec PyLAppModel_spec = {
     PyLAppModel_slots,
 };
 
-static PyObject* live2d_init()
+static PyObject* typeobject_live2d_lappmodel = nullptr;
+
+struct PySceneObject
 {
-    _cubismOption.LogFunction = LAppPal::PrintLn;
-    _cubismOption.LoggingLevel = Csm::CubismFramework::Option::LogLevel_Verbose;
+    PyObject_HEAD
+    LAppScene* scene;
+    PyObject* models; // 持有加入场景的模型的引用
+    std::mutex* mutex;
+};
 
-    Csm::CubismFramework::StartUp(&_cubismAllocator, &_cubismOption);
-    Csm::CubismFramework::Initialize();
-    Py_RETURN_NONE;
+// Scene(threads=0)
+static int PyScene_init(PySceneObject* self, PyObject* args, PyObject* kwds)
+{
+    int threads = 0;
+
+    static char* kwlist[] = {(char*)"threads", NULL};
+
+    if (!(PyArg_ParseTupleAndKeywords(args, kwds, "|i", kwlist, &threads)))
+    {
+        return -1;
+    }
+
+    self->scene = new LAppScene(threads);
+    self->models = PyList_New(0);
+    self->mutex = new std::mutex();
+    return 0;
 }
 
-static PyObject* live2d_dispose()
+static void PyScene_dealloc(PySceneObject* self)
 {
-    Csm::CubismFramework::Dispose();
-    Py_RETURN_NONE;
+    delete self->scene;
+    delete self->mutex;
+    Py_XDECREF(self->models);
+    PyObject_Free(self);
 }
 
-static PyObject* live2d_glew_init()
+// 场景的 Update / Draw 期间，模型回调（可能在工作线程中）再调用场景的方法会等待场景自己持有的锁
+static bool CheckSceneReentry(PySceneObject* self)
 {
-    if (glewInit() != GLEW_OK)
+    if (self->scene->IsProcessingOnCurrentThread())
     {
-        Info("Can't initilize glew.");
+        PyErr_SetString(PyExc_RuntimeError, "Scene methods cannot be called from a model callback during Scene.Update/Draw/Frame");
+        return false;
     }
-    LAppPal::UpdateTime();
-    Py_RETURN_NONE;
+    return true;
 }
 
-static PyObject* live2d_clear_buffer(PyObject* self, PyObject* args)
+static PyObject* PyScene_AddModel(PySceneObject* self, PyObject* args)
 {
-    // 默认为黑色
-    float r = 0.0, g = 0.0, b = 0.0, a = 0.0;
-
-    // 解析传入的参数，允许指定颜色
-    if (!PyArg_ParseTuple(args, "|ffff", &r, &g, &b, &a))
+    if (!CheckSceneReentry(self))
     {
         return NULL;
     }
 
-    // 设置清屏颜色
-    glClearColor(r, g, b, a);
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-    glClearDepth(1.0);
+    GilSafeLock<std::mutex> lock(*self->mutex);
 
-    Py_RETURN_NONE;
-}
+    PyObject* model;
+    if (!PyArg_ParseTuple(args, "O", &model))
+    {
+        return NULL;
+    }
 
-static PyObject* live2d_set_log_enable(PyObject* self, PyObject* args)
+    if (PyObject_IsInstance(model, typeobject_live2d_lappmodel) != 1)
+    {
+        PyErr_SetString(PyExc_TypeError, "model must be LAppModel");
+        return NULL;
+    }
+
+    PyList_Append(self->models, model);
+    self->scene->AddModel(((PyLAppModelObject*)model)->model);
+
+    Py_RETURN_NONE;
+}
+
+static PyObject* PyScene_RemoveModel(PySceneObject* self, PyObject* args)
+{
+    if (!CheckSceneReentry(self))
+    {
+        return NULL;
+    }
+
+    GilSafeLock<std::mutex> lock(*self->mutex);
+
+    PyObject* model;
+    if (!PyArg_ParseTuple(args, "O", &model))
+    {
+        return NULL;
+    }
+
+    for (Py_ssize_t i = 0; i < PyList_Size(self->models); i++)
+    {
+        if (PyList_GetItem(self->models, i) == model)
+        {
+            self->scene->RemoveModel(((PyLAppModelObject*)model)->model);
+            PyList_SetSlice(self->models, i, i + 1, NULL);
+            Py_RETURN_TRUE;
+        }
+    }
+
+    Py_RETURN_FALSE;
+}
+
+static PyObject* PyScene_GetModelCount(PySceneObject* self, PyObject* args)
+{
+    if (!CheckSceneReentry(self))
+    {
+        return NULL;
+    }
+
+    GilSafeLock<std::mutex> lock(*self->mutex);
+
+    return PyLong_FromLong(self->scene->GetModelCount());
+}
+
+static PyObject* PyScene_Update(PySceneObject* self, PyObject* args, PyObject* kwargs)
+{
+    if (!CheckSceneReentry(self))
+    {
+        return NULL;
+    }
+
+    GilSafeLock<std::mutex> lock(*self->mutex);
+
+    float deltaTime;
+    if (!ParseDeltaTime(args, kwargs, &deltaTime))
+    {
+        return NULL;
+    }
+
+    // 工作线程中的动作回调需要获取 GIL
+    Py_BEGIN_ALLOW_THREADS
+    self->scene->Update(deltaTime);
+    Py_END_ALLOW_THREADS
+
+    Py_RETURN_NONE;
+}
+
+static PyObject* PyScene_Draw(PySceneObject* self, PyObject* args)
+{
+    if (!CheckSceneReentry(self))
+    {
+        return NULL;
+    }
+
+    GilSafeLock<std::mutex> lock(*self->mutex);
+
+    Py_BEGIN_ALLOW_THREADS
+    self->scene->Draw();
+    Py_END_ALLOW_THREADS
+
+    Py_RETURN_NONE;
+}
+
+// 每帧调用一次：并行更新所有模型后在当前线程依次绘制
+static PyObject* PyScene_Frame(PySceneObject* self, PyObject* args, PyObject* kwargs)
+{
+    if (!CheckSceneReentry(self))
+    {
+        return NULL;
+    }
+
+    GilSafeLock<std::mutex> lock(*self->mutex);
+
+    float deltaTime;
+    if (!ParseDeltaTime(args, kwargs, &deltaTime))
+    {
+        return NULL;
+    }
+
+    Py_BEGIN_ALLOW_THREADS
+    self->scene->Update(deltaTime);
+    self->scene->Draw();
+    Py_END_ALLOW_THREADS
+
+    Py_RETURN_NONE;
+}
+
+static PyObject* PyScene_GetTimings(PySceneObject* self, PyObject* args)
+{
+    if (!CheckSceneReentry(self))
+    {
+        return NULL;
+    }
+
+    GilSafeLock<std::mutex> lock(*self->mutex);
+
+    const LAppScene::Timings& timings = self->scene->GetTimings();
+
+    PyObject* models = PyList_New(self->scene->GetModelCount());
+    for (int i = 0; i < self->scene->GetModelCount(); i++)
+    {
+        PyList_SetItem(models, i, PyFloat_FromDouble(self->scene->GetModelUpdateTime(i)));
+    }
+
+    return Py_BuildValue("{s:d,s:d,s:d,s:i,s:N}", "update", timings.update, "updateTotal", timings.updateTotal,
+                         "draw", timings.draw, "threads", self->scene->GetThreadCount(), "models", models);
+}
+
+static PyMethodDef PyScene_methods[] = {
+    {"AddModel", (PyCFunction)PyScene_AddModel, METH_VARARGS, ""},
+    {"RemoveModel", (PyCFunction)PyScene_RemoveModel, METH_VARARGS, ""},
+    {"GetModelCount", (PyCFunction)PyScene_GetModelCount, METH_VARARGS, ""},
+    {"Update", (PyCFunction)PyScene_Update, METH_VARARGS | METH_KEYWORDS, ""},
+    {"Draw", (PyCFunction)PyScene_Draw, METH_VARARGS, ""},
+    {"Frame", (PyCFunction)PyScene_Frame, METH_VARARGS | METH_KEYWORDS, ""},
+    {"GetTimings", (PyCFunction)PyScene_GetTimings, METH_VARARGS, ""},
+    {NULL} // 方法列表结束的标志
+};
+
+static PyObject* PyScene_new(PyTypeObject* type, PyObject* args, PyObject* kwds)
+{
+    PyObject* self = (PyObject*)PyObject_Malloc(sizeof(PySceneObject));
+    PyObject_Init(self, type);
+    return self;
+}
+
+static PyType_Slot PyScene_slots[] = {
+    {Py_tp_new, (void*)PyScene_new},
+    {Py_tp_init, (void*)PyScene_init},
+    {Py_tp_dealloc, (void*)PyScene_dealloc},
+    {Py_tp_methods, (void*)PyScene_methods},
+    {0, NULL}
+};
+
+static PyType_Spec PyScene_spec = {
+    "live2d.Scene",
+    sizeof(PySceneObject),
+    0,
+    Py_TPFLAGS_DEFAULT,
+    PyScene_slots,
+};
+
+struct PyFrameCaptureObject
+{
+    PyObject_HEAD
+    LAppFrameCapture* capture;
+    PyObject* frames; // 返回给 Python 的帧缓冲（bytearray），没有其他引用时复用
+    std::mutex* mutex;
+};
+
+// FrameCapture(buffers=3)
+static int PyFrameCapture_init(PyFrameCaptureObject* self, PyObject* args, PyObject* kwds)
+{
+    int buffers = 3;
+
+    static char* kwlist[] = {(char*)"buffers", NULL};
+
+    if (!(PyArg_ParseTupleAndKeywords(args, kwds, "|i", kwlist, &buffers)))
+    {
+        return -1;
+    }
+
+    self->capture = new LAppFrameCapture(buffers);
+    self->frames = PyList_New(0);
+    self->mutex = new std::mutex();
+    return 0;
+}
+
+static void PyFrameCapture_dealloc(PyFrameCaptureObject* self)
+{
+    // 第一次 Capture 时的上下文不是当前上下文时，只丢弃 PBO 和同步对象的名字，不删除
+    delete self->capture;
+    delete self->mutex;
+    Py_XDECREF(self->frames);
+    PyObject_Free(self);
+}
+
+// 读取当前绑定的帧缓冲中的矩形，不等待 GPU 完成
+static PyObject* PyFrameCapture_Capture(PyFrameCaptureObject* self, PyObject* args)
+{
+    GilSafeLock<std::mutex> lock(*self->mutex);
+
+    int x, y, width, height;
+    if (!PyArg_ParseTuple(args, "iiii", &x, &y, &width, &height))
+    {
+        return NULL;
+    }
+
+    Py_BEGIN_ALLOW_THREADS
+    self->capture->Capture(x, y, width, height);
+    Py_END_ALLOW_THREADS
+
+    Py_RETURN_NONE;
+}
+
+// 取出最早的一帧，返回 (width, height, bytearray)，行从下到上
+// wait=False 时若 GPU 尚未完成则返回 None
+static PyObject* PyFrameCapture_Read(PyFrameCaptureObject* self, PyObject* args, PyObject* kwargs)
+{
+    GilSafeLock<std::mutex> lock(*self->mutex);
+
+    char wait = 0;
+
+    static char* kwlist[] = {(char*)"wait", NULL};
+
+    if (!(PyArg_ParseTupleAndKeywords(args, kwargs, "|b", kwlist, &wait)))
+    {
+        return NULL;
+    }
+
+    int width, height;
+    if (!self->capture->GetFrameSize(width, height) || (!wait && !self->capture->IsFrameReady()))
+    {
+        Py_RETURN_NONE;
+    }
+
+    const Py_ssize_t size = static_cast<Py_ssize_t>(width) * height * 4;
+
+    // 只被列表引用的 bytearray 已不再使用，直接写入
+    PyObject* frame = NULL;
+    for (Py_ssize_t i = 0; i < PyList_Size(self->frames); i++)
+    {
+        PyObject* item = PyList_GetItem(self->frames, i);
+        if (Py_REFCNT(item) == 1)
+        {
+            if (PyByteArray_Size(item) != size && PyByteArray_Resize(item, size) < 0)
+            {
+                return NULL;
+            }
+            frame = item;
+            break;
+        }
+    }
+
+    if (frame == NULL)
+    {
+        frame = PyByteArray_FromStringAndSize(NULL, size);
+        if (frame == NULL)
+        {
+            return NULL;
+        }
+        PyList_Append(self->frames, frame);
+        Py_DECREF(frame);
+    }
+
+    unsigned char* pixels = reinterpret_cast<unsigned char*>(PyByteArray_AsString(frame));
+
+    Py_BEGIN_ALLOW_THREADS
+    self->capture->ReadFrame(pixels);
+    Py_END_ALLOW_THREADS
+
+    return Py_BuildValue("(iiO)", width, height, frame);
+}
+
+static PyObject* PyFrameCapture_GetPendingCount(PyFrameCaptureObject* self, PyObject* args)
+{
+    GilSafeLock<std::mutex> lock(*self->mutex);
+
+    return PyLong_FromLong(self->capture->GetPendingFrameCount());
+}
+
+static PyObject* PyFrameCapture_GetStats(PyFrameCaptureObject* self, PyObject* args)
+{
+    GilSafeLock<std::mutex> lock(*self->mutex);
+
+    const LAppFrameCapture::Statistics& stats = self->capture->GetStatistics();
+
+    return Py_BuildValue("{s:i,s:i,s:i,s:i,s:i,s:N}", "captured", stats.captured, "read", stats.read,
+                         "dropped", stats.dropped, "stalls", stats.stalls,
+                         "pending", self->capture->GetPendingFrameCount(),
+                         "async", PyBool_FromLong(self->capture->GetMode() != LAppFrameCapture::Mode_Sync));
+}
+
+static PyMethodDef PyFrameCapture_methods[] = {
+    {"Capture", (PyCFunction)PyFrameCapture_Capture, METH_VARARGS, ""},
+    {"Read", (PyCFunction)PyFrameCapture_Read, METH_VARARGS | METH_KEYWORDS, ""},
+    {"GetPendingCount", (PyCFunction)PyFrameCapture_GetPendingCount, METH_VARARGS, ""},
+    {"GetStats", (PyCFunction)PyFrameCapture_GetStats, METH_VARARGS, ""},
+    {NULL} // 方法列表结束的标志
+};
+
+static PyObject* PyFrameCapture_new(PyTypeObject* type, PyObject* args, PyObject* kwds)
+{
+    PyObject* self = (PyObject*)PyObject_Malloc(sizeof(PyFrameCaptureObject));
+    PyObject_Init(self, type);
+    return self;
+}
+
+static PyType_Slot PyFrameCapture_slots[] = {
+    {Py_tp_new, (void*)PyFrameCapture_new},
+    {Py_tp_init, (void*)PyFrameCapture_init},
+    {Py_tp_dealloc, (void*)PyFrameCapture_dealloc},
+    {Py_tp_methods, (void*)PyFrameCapture_methods},
+    {0, NULL}
+};
+
+static PyType_Spec PyFrameCapture_spec = {
+    "live2d.FrameCapture",
+    sizeof(PyFrameCaptureObject),
+    0,
+    Py_TPFLAGS_DEFAULT,
+    PyFrameCapture_slots,
+};
+
+struct PyHeadlessContextObject
+{
+    PyObject_HEAD
+    LAppHeadlessContext* context;
+};
+
+// HeadlessContext(width, height)
+static int PyHeadlessContext_init(PyHeadlessContextObject* self, PyObject* args, PyObject* kwds)
+{
+    int width, height;
+
+    static char* kwlist[] = {(char*)"width", (char*)"height", NULL};
+
+    if (!(PyArg_ParseTupleAndKeywords(args, kwds, "ii", kwlist, &width, &height)))
+    {
+        return -1;
+    }
+
+    self->context = new LAppHeadlessContext();
+    if (!self->context->Initialize(width, height))
+    {
+        PyErr_SetString(PyExc_RuntimeError, "failed to create headless OpenGL context");
+        return -1;
+    }
+    return 0;
+}
+
+static void PyHeadlessContext_dealloc(PyHeadlessContextObject* self)
+{
+    delete self->context;
+    PyObject_Free(self);
+}
+
+// 在当前线程激活上下文，并绑定离屏帧缓冲
+static PyObject* PyHeadlessContext_MakeCurrent(PyHeadlessContextObject* self, PyObject* args)
+{
+    if (!self->context->MakeCurrent())
+    {
+        PyErr_SetString(PyExc_RuntimeError, "failed to make headless context current");
+        return NULL;
+    }
+
+    Py_RETURN_NONE;
+}
+
+static PyObject* PyHeadlessContext_Resize(PyHeadlessContextObject* self, PyObject* args)
+{
+    int width, height;
+    if (!PyArg_ParseTuple(args, "ii", &width, &height))
+    {
+        return NULL;
+    }
+
+    if (!self->context->Resize(width, height))
+    {
+        PyErr_SetString(PyExc_RuntimeError, "failed to resize headless framebuffer");
+        return NULL;
+    }
+
+    Py_RETURN_NONE;
+}
+
+static PyObject* PyHeadlessContext_GetSize(PyHeadlessContextObject* self, PyObject* args)
+{
+    return Py_BuildValue("(ii)", self->context->GetWidth(), self->context->GetHeight());
+}
+
+static PyObject* PyHeadlessContext_GetFramebuffer(PyHeadlessContextObject* self, PyObject* args)
+{
+    return PyLong_FromUnsignedLong(self->context->GetFramebuffer());
+}
+
+static PyObject* PyHeadlessContext_GetColorTexture(PyHeadlessContextObject* self, PyObject* args)
+{
+    return PyLong_FromUnsignedLong(self->context->GetColorTexture());
+}
+
+// 读取离屏帧缓冲，返回 (width, height, bytearray)，RGBA，行从下到上
+static PyObject* PyHeadlessContext_ReadPixels(PyHeadlessContextObject* self, PyObject* args)
+{
+    const int width = self->context->GetWidth();
+    const int height = self->context->GetHeight();
+
+    PyObject* pixels = PyByteArray_FromStringAndSize(NULL, static_cast<Py_ssize_t>(width) * height * 4);
+    if (pixels == NULL)
+    {
+        return NULL;
+    }
+
+    unsigned char* data = reinterpret_cast<unsigned char*>(PyByteArray_AsString(pixels));
+
+    Py_BEGIN_ALLOW_THREADS
+    self->context->ReadPixels(data);
+    Py_END_ALLOW_THREADS
+
+    return Py_BuildValue("(iiN)", width, height, pixels);
+}
+
+static PyObject* PyHeadlessContext_Release(PyHeadlessContextObject* self, PyObject* args)
+{
+    self->context->Release();
+    Py_RETURN_NONE;
+}
+
+static PyMethodDef PyHeadlessContext_methods[] = {
+    {"MakeCurrent", (PyCFunction)PyHeadlessContext_MakeCurrent, METH_VARARGS, ""},
+    {"Resize", (PyCFunction)PyHeadlessContext_Resize, METH_VARARGS, ""},
+    {"GetSize", (PyCFunction)PyHeadlessContext_GetSize, METH_VARARGS, ""},
+    {"GetFramebuffer", (PyCFunction)PyHeadlessContext_GetFramebuffer, METH_VARARGS, ""},
+    {"GetColorTexture", (PyCFunction)PyHeadlessContext_GetColorTexture, METH_VARARGS, ""},
+    {"ReadPixels", (PyCFunction)PyHeadlessContext_ReadPixels, METH_VARARGS, ""},
+    {"Release", (PyCFunction)PyHeadlessContext_Release, METH_VARARGS, ""},
+    {NULL} // 方法列表结束的标志
+};
+
+static PyObject* PyHeadlessContext_new(PyTypeObject* type, PyObject* args, PyObject* kwds)
+{
+    PyObject* self = (PyObject*)PyObject_Malloc(sizeof(PyHeadlessContextObject));
+    PyObject_Init(self, type);
+    ((PyHeadlessContextObject*)self)->context = NULL;
+    return self;
+}
+
+static PyType_Slot PyHeadlessContext_slots[] = {
+    {Py_tp_new, (void*)PyHeadlessContext_new},
+    {Py_tp_init, (void*)PyHeadlessContext_init},
+    {Py_tp_dealloc, (void*)PyHeadlessContext_dealloc},
+    {Py_tp_methods, (void*)PyHeadlessContext_methods},
+    {0, NULL}
+};
+
+static PyType_Spec PyHeadlessContext_spec = {
+    "live2d.HeadlessContext",
+    sizeof(PyHeadlessContextObject),
+    0,
+    Py_TPFLAGS_DEFAULT,
+    PyHeadlessContext_slots,
+};
+
+static PyObject* live2d_headless_supported(PyObject* self, PyObject* args)
+{
+    if (LAppHeadlessContext::IsSupported())
+    {
+        Py_RETURN_TRUE;
+    }
+    Py_RETURN_FALSE;
+}
+
+static PyObject* live2d_init()
+{
+    _cubismOption.LogFunction = LAppPal::PrintLn;
+    _cubismOption.LoggingLevel = Csm::CubismFramework::Option::LogLevel_Verbose;
+
+    Csm::CubismFramework::StartUp(&_cubismAllocator, &_cubismOption);
+    Csm::CubismFramework::Initialize();
+    Py_RETURN_NONE;
+}
+
+static PyObject* live2d_dispose()
+{
+    Csm::CubismFramework::Dispose();
+    Py_RETURN_NONE;
+}
+
+static PyObject* live2d_glew_init()
+{
+    if (glewInit() != GLEW_OK)
+    {
+        Info("Can't initilize glew.");
+    }
+    LAppPal::UpdateTime();
+    Py_RETURN_NONE;
+}
+
+static PyObject* live2d_clear_buffer(PyObject* self, PyObject* args)
+{
+    // 默认为黑色
+    float r = 0.0, g = 0.0, b = 0.0, a = 0.0;
+
+    // 解析传入的参数，允许指定颜色
+    if (!PyArg_ParseTuple(args, "|ffff", &r, &g, &b, &a))
+    {
+        return NULL;
+    }
+
+    // 设置清屏颜色
+    glClearColor(r, g, b, a);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    glClearDepth(1.0);
+
+    Py_RETURN_NONE;
+}
+
+static PyObject* live2d_set_log_enable(PyObject* self, PyObject* args)
 {
     bool enable;
     if (!PyArg_ParseTuple(args, "b", &enable))
@@ -756,6 +2016,43 @@ static PyObject* live2d_log_enable(PyObject* self, PyObject* args)
     Py_RETURN_FALSE;
 }
 
+// 宿主承诺在两次 Draw 之间不修改 OpenGL 状态时，跳过绘制前后的状态保存与恢复
+static PyObject* live2d_set_trusted_host(PyObject* self, PyObject* args)
+{
+    bool trusted;
+    if (!PyArg_ParseTuple(args, "b", &trusted))
+    {
+        PyErr_SetString(PyExc_TypeError, "invalid param");
+        return NULL;
+    }
+
+    Csm::Rendering::CubismRenderer_OpenGLES2::SetTrustedHost(trusted);
+
+    Py_RETURN_NONE;
+}
+
+static PyObject* live2d_trusted_host(PyObject* self, PyObject* args)
+{
+    if (Csm::Rendering::CubismRenderer_OpenGLES2::IsTrustedHost())
+        Py_RETURN_TRUE;
+    Py_RETURN_FALSE;
+}
+
+// 在渲染器之外修改了 OpenGL 状态后调用
+static PyObject* live2d_invalidate_state_cache(PyObject* self, PyObject* args)
+{
+    Csm::Rendering::CubismRenderer_OpenGLES2::InvalidateStateCache();
+
+    Py_RETURN_NONE;
+}
+
+// 模型共享的纹理缓存。纹理按 OpenGL 上下文分别共享，统计包括所有上下文
+static PyObject* live2d_get_texture_cache_stats(PyObject* self, PyObject* args)
+{
+    return Py_BuildValue("{s:i,s:n}", "count", LAppTextureManager::GetResidentTextureCount(),
+                         "residentBytes", static_cast<Py_ssize_t>(LAppTextureManager::GetResidentTextureBytes()));
+}
+
 // 定义live2d模块的方法
 static PyMethodDef live2d_methods[] = {
     {"init", (PyCFunction)live2d_init, METH_VARARGS, ""},
@@ -764,6 +2061,11 @@ static PyMethodDef live2d_methods[] = {
     {"clearBuffer", (PyCFunction)live2d_clear_buffer, METH_VARARGS, ""},
     {"setLogEnable", (PyCFunction)live2d_set_log_enable, METH_VARARGS, ""},
     {"logEnable", (PyCFunction)live2d_log_enable, METH_VARARGS, ""},
+    {"getTextureCacheStats", (PyCFunction)live2d_get_texture_cache_stats, METH_VARARGS, ""},
+    {"setTrustedHost", (PyCFunction)live2d_set_trusted_host, METH_VARARGS, ""},
+    {"trustedHost", (PyCFunction)live2d_trusted_host, METH_VARARGS, ""},
+    {"invalidateStateCache", (PyCFunction)live2d_invalidate_state_cache, METH_VARARGS, ""},
+    {"headlessSupported", (PyCFunction)live2d_headless_supported, METH_VARARGS, ""},
     {NULL, NULL, 0, NULL}
 };
 
@@ -799,6 +2101,46 @@ PyMODINIT_FUNC PyInit_live2d(void)
         Py_DECREF(m);
         return NULL;
     }
+    typeobject_live2d_lappmodel = lappmodel_type;
+
+    PyObject* scene_type = PyType_FromSpec(&PyScene_spec);
+    if (!scene_type)
+    {
+        return NULL;
+    }
+
+    if (PyModule_AddObject(m, "Scene", scene_type) < 0)
+    {
+        Py_DECREF(scene_type);
+        Py_DECREF(m);
+        return NULL;
+    }
+
+    PyObject* frame_capture_type = PyType_FromSpec(&PyFrameCapture_spec);
+    if (!frame_capture_type)
+    {
+        return NULL;
+    }
+
+    if (PyModule_AddObject(m, "FrameCapture", frame_capture_type) < 0)
+    {
+        Py_DECREF(frame_capture_type);
+        Py_DECREF(m);
+        return NULL;
+    }
+
+    PyObject* headless_context_type = PyType_FromSpec(&PyHeadlessContext_spec);
+    if (!headless_context_type)
+    {
+        return NULL;
+    }
+
+    if (PyModule_AddObject(m, "HeadlessContext", headless_context_type) < 0)
+    {
+        Py_DECREF(headless_context_type);
+        Py_DECREF(m);
+        return NULL;
+    }
 
     // assume that module `params` is already imported in `live2d/v3/__init__.py`
     module_live2d_v3_params = PyImport_AddModule("live2d.v3.params");
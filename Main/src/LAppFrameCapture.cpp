@@ -0,0 +1,247 @@
+#include "LAppFrameCapture.hpp"
+
+#include <cstring>
+
+#include "LAppTextureManager.hpp"
+
+LAppFrameCapture::LAppFrameCapture(int bufferCount)
+    : _slots(bufferCount > 1 ? bufferCount : 1)
+    , _head(0)
+    , _pendingCount(0)
+    , _mode(Mode_Unknown)
+    , _context(NULL)
+{
+    for (size_t i = 0; i < _slots.size(); i++)
+    {
+        _slots[i].buffer = 0;
+        _slots[i].fence = NULL;
+        _slots[i].width = 0;
+        _slots[i].height = 0;
+        _slots[i].bufferSize = 0;
+    }
+
+    _statistics.captured = 0;
+    _statistics.read = 0;
+    _statistics.dropped = 0;
+    _statistics.stalls = 0;
+}
+
+LAppFrameCapture::~LAppFrameCapture()
+{
+    // 別のコンテキストやコンテキストがない状態で削除すると、無関係のオブジェクトを消すかエラーになる
+    if (_context == NULL || LAppTextureManager::GetCurrentContext() != _context)
+    {
+        return;
+    }
+
+    for (size_t i = 0; i < _slots.size(); i++)
+    {
+        if (_slots[i].fence != NULL)
+        {
+            glDeleteSync(_slots[i].fence);
+        }
+        if (_slots[i].buffer != 0)
+        {
+            glDeleteBuffers(1, &_slots[i].buffer);
+        }
+    }
+}
+
+LAppFrameCapture::Mode LAppFrameCapture::CheckMode()
+{
+    if (!(GLEW_VERSION_2_1 || GLEW_ARB_pixel_buffer_object))
+    {
+        return Mode_Sync;
+    }
+
+    if (!(GLEW_VERSION_3_2 || GLEW_ARB_sync))
+    {
+        return Mode_PixelBuffer;
+    }
+
+    return Mode_PixelBufferFence;
+}
+
+void LAppFrameCapture::Capture(int x, int y, int width, int height)
+{
+    if (_mode == Mode_Unknown)
+    {
+        _mode = CheckMode();
+        _context = LAppTextureManager::GetCurrentContext();
+    }
+
+    if (width <= 0 || height <= 0)
+    {
+        return;
+    }
+
+    // 取り出されていないフレームで一杯なら最も古いものを捨てる
+    if (_pendingCount == static_cast<int>(_slots.size()))
+    {
+        PopFrame();
+        _statistics.dropped++;
+    }
+
+    Slot& slot = _slots[_head];
+    slot.width = width;
+    slot.height = height;
+
+    const int size = width * height * 4;
+
+    GLint lastPackAlignment;
+    glGetIntegerv(GL_PACK_ALIGNMENT, &lastPackAlignment);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+
+    if (_mode == Mode_Sync)
+    {
+        slot.pixels.resize(size);
+        glReadPixels(x, y, width, height, GL_RGBA, GL_UNSIGNED_BYTE, slot.pixels.data());
+    }
+    else
+    {
+        GLint lastPixelPackBuffer;
+        glGetIntegerv(GL_PIXEL_PACK_BUFFER_BINDING, &lastPixelPackBuffer);
+
+        if (slot.buffer == 0)
+        {
+            glGenBuffers(1, &slot.buffer);
+        }
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+        if (slot.bufferSize != size)
+        {
+            glBufferData(GL_PIXEL_PACK_BUFFER, size, NULL, GL_STREAM_READ);
+            slot.bufferSize = size;
+        }
+
+        // PBO が束縛されているため、最後の引数はバッファ内のオフセットになり、ここでは待たない
+        glReadPixels(x, y, width, height, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+
+        if (_mode == Mode_PixelBufferFence)
+        {
+            slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        }
+
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, lastPixelPackBuffer);
+    }
+
+    glPixelStorei(GL_PACK_ALIGNMENT, lastPackAlignment);
+
+    _head = (_head + 1) % static_cast<int>(_slots.size());
+    _pendingCount++;
+    _statistics.captured++;
+}
+
+int LAppFrameCapture::GetPendingFrameCount() const
+{
+    return _pendingCount;
+}
+
+bool LAppFrameCapture::IsFrameReady()
+{
+    if (_pendingCount == 0)
+    {
+        return false;
+    }
+
+    const Slot& slot = _slots[GetOldestSlot()];
+
+    switch (_mode)
+    {
+    case Mode_PixelBufferFence:
+    {
+        // 発行済みでないフェンスは完了しないため、確認のついでにフラッシュする
+        const GLenum status = glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+        return status == GL_ALREADY_SIGNALED || status == GL_CONDITION_SATISFIED || status == GL_WAIT_FAILED;
+    }
+    case Mode_PixelBuffer:
+        // 完了を確認できないため、後のフレームを発行していれば完了しているとみなす
+        return _pendingCount > 1;
+    default:
+        return true;
+    }
+}
+
+bool LAppFrameCapture::GetFrameSize(int& width, int& height) const
+{
+    if (_pendingCount == 0)
+    {
+        return false;
+    }
+
+    const Slot& slot = _slots[GetOldestSlot()];
+    width = slot.width;
+    height = slot.height;
+    return true;
+}
+
+bool LAppFrameCapture::ReadFrame(unsigned char* pixels)
+{
+    if (_pendingCount == 0)
+    {
+        return false;
+    }
+
+    if (!IsFrameReady())
+    {
+        _statistics.stalls++;
+    }
+
+    Slot& slot = _slots[GetOldestSlot()];
+    const int size = slot.width * slot.height * 4;
+
+    if (_mode == Mode_Sync)
+    {
+        memcpy(pixels, slot.pixels.data(), size);
+    }
+    else
+    {
+        // 完了していなければ glMapBuffer が待つ
+        GLint lastPixelPackBuffer;
+        glGetIntegerv(GL_PIXEL_PACK_BUFFER_BINDING, &lastPixelPackBuffer);
+
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+        const void* mapped = glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY);
+        if (mapped != NULL)
+        {
+            memcpy(pixels, mapped, size);
+            glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+        }
+        else
+        {
+            memset(pixels, 0, size);
+        }
+
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, lastPixelPackBuffer);
+    }
+
+    PopFrame();
+    _statistics.read++;
+    return true;
+}
+
+int LAppFrameCapture::GetOldestSlot() const
+{
+    const int slotCount = static_cast<int>(_slots.size());
+    return (_head - _pendingCount + slotCount) % slotCount;
+}
+
+void LAppFrameCapture::PopFrame()
+{
+    Slot& slot = _slots[GetOldestSlot()];
+    if (slot.fence != NULL)
+    {
+        glDeleteSync(slot.fence);
+        slot.fence = NULL;
+    }
+    _pendingCount--;
+}
+
+LAppFrameCapture::Mode LAppFrameCapture::GetMode() const
+{
+    return _mode;
+}
+
+const LAppFrameCapture::Statistics& LAppFrameCapture::GetStatistics() const
+{
+    return _statistics;
+}
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <GL/glew.h>
+#include <vector>
+
+/**
+ * @brief フレームバッファの内容を非同期に読み出すクラス
+ *
+ * Capture() はピクセルパックバッファ（PBO）への glReadPixels を発行するだけで、GPU の完了を待たない。
+ * 読み出したフレームは ReadFrame() で古い順に取り出す。通常は 1〜2 フレーム遅れで取り出せる。
+ * 完了は glFenceSync で確認する（OpenGL 3.2 / ARB_sync）。
+ * フェンスがない場合は後のフレームを発行した時点で完了したものとみなし、PBO がない場合は同期読み出しになる。
+ * すべての関数は最初の Capture() と同じ OpenGL のコンテキストがカレントのスレッドで呼ぶこと。
+ */
+class LAppFrameCapture
+{
+public:
+    /**
+     * @brief 読み出しの方式
+     */
+    enum Mode
+    {
+        Mode_Unknown = -1, ///< 最初の Capture() まで未定
+        Mode_Sync = 0, ///< glReadPixels で同期読み出し
+        Mode_PixelBuffer = 1, ///< PBO に読み出し、後のフレームを発行した後に取り出す
+        Mode_PixelBufferFence = 2, ///< PBO に読み出し、フェンスで完了を確認する
+    };
+
+    /**
+     * @brief 統計
+     */
+    struct Statistics
+    {
+        int captured; ///< Capture() の回数
+        int read; ///< ReadFrame() で取り出したフレーム数
+        int dropped; ///< 取り出す前にリングが一杯になり、捨てたフレーム数
+        int stalls; ///< 取り出しで GPU の完了を待った回数
+    };
+
+    /**
+     * @brief コンストラクタ
+     *
+     * @param[in]   bufferCount     リングのバッファ数。未取り出しのフレームはこの数まで保持する
+     */
+    explicit LAppFrameCapture(int bufferCount = 3);
+
+    /**
+     * @brief デストラクタ。OpenGL のオブジェクトを削除する
+     *
+     * 最初の Capture() のコンテキストがカレントでなければ削除せずに手放す（コンテキストの破棄と共に解放される）。
+     */
+    ~LAppFrameCapture();
+
+    /**
+     * @brief 現在の読み出し用フレームバッファの矩形を RGBA で読み出す処理を発行する
+     *
+     * リングが一杯の場合は最も古いフレームを捨てる。
+     */
+    void Capture(int x, int y, int width, int height);
+
+    /**
+     * @brief 未取り出しのフレーム数
+     */
+    int GetPendingFrameCount() const;
+
+    /**
+     * @brief 最も古いフレームが待たずに取り出せるか
+     */
+    bool IsFrameReady();
+
+    /**
+     * @brief 最も古いフレームのサイズを取得する
+     *
+     * @return  未取り出しのフレームがない場合 false
+     */
+    bool GetFrameSize(int& width, int& height) const;
+
+    /**
+     * @brief 最も古いフレームを取り出す。完了していなければ待つ
+     *
+     * @param[out]  pixels  width * height * 4 バイトの書き込み先。行は下から上の順
+     * @return  未取り出しのフレームがない場合 false
+     */
+    bool ReadFrame(unsigned char* pixels);
+
+    Mode GetMode() const;
+
+    const Statistics& GetStatistics() const;
+
+private:
+    struct Slot
+    {
+        GLuint buffer; ///< PBO
+        GLsync fence;
+        int width;
+        int height;
+        int bufferSize; ///< PBO の確保済みサイズ
+        std::vector<unsigned char> pixels; ///< 同期読み出しの場合の読み出し先
+    };
+
+    LAppFrameCapture(const LAppFrameCapture&);
+    LAppFrameCapture& operator=(const LAppFrameCapture&);
+
+    static Mode CheckMode();
+
+    /**
+     * @brief 最も古い未取り出しのフレームのスロット
+     */
+    int GetOldestSlot() const;
+
+    /**
+     * @brief 最も古いフレームを未取り出しから外す
+     */
+    void PopFrame();
+
+    std::vector<Slot> _slots;
+    int _head; ///< 次に書き込むスロット
+    int _pendingCount;
+    Mode _mode;
+    void* _context; ///< 最初の Capture() でカレントだったコンテキスト。PBO とフェンスはこのコンテキストに属する
+    Statistics _statistics;
+};
@@ -0,0 +1,403 @@
+#include "LAppHeadlessContext.hpp"
+
+#include <Rendering/OpenGL/CubismRenderer_OpenGLES2.hpp>
+#include "LAppPal.hpp"
+#include "LAppTextureManager.hpp"
+#include "Log.hpp"
+#include <cstring>
+
+#if defined(CSM_TARGET_LINUX_GL) && __has_include(<EGL/egl.h>)
+#define LAPP_HEADLESS_EGL
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <dlfcn.h>
+#endif
+
+using namespace Live2D::Cubism::Framework;
+
+#ifdef LAPP_HEADLESS_EGL
+namespace {
+
+/**
+ * @brief 実行時に読み込んだ EGL の関数
+ */
+struct EglFunctions
+{
+    bool loaded;
+    PFNEGLGETPROCADDRESSPROC getProcAddress;
+    PFNEGLGETDISPLAYPROC getDisplay;
+    PFNEGLINITIALIZEPROC initialize;
+    PFNEGLTERMINATEPROC terminate;
+    PFNEGLQUERYSTRINGPROC queryString;
+    PFNEGLBINDAPIPROC bindApi;
+    PFNEGLCHOOSECONFIGPROC chooseConfig;
+    PFNEGLCREATECONTEXTPROC createContext;
+    PFNEGLDESTROYCONTEXTPROC destroyContext;
+    PFNEGLCREATEPBUFFERSURFACEPROC createPbufferSurface;
+    PFNEGLDESTROYSURFACEPROC destroySurface;
+    PFNEGLMAKECURRENTPROC makeCurrent;
+    PFNEGLGETCURRENTCONTEXTPROC getCurrentContext;
+    PFNEGLGETCURRENTDISPLAYPROC getCurrentDisplay;
+    PFNEGLGETCURRENTSURFACEPROC getCurrentSurface;
+    PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay;
+    PFNEGLQUERYDEVICESEXTPROC queryDevices;
+};
+
+EglFunctions s_egl;
+
+bool LoadEgl()
+{
+    if (s_egl.loaded)
+    {
+        return true;
+    }
+
+    void* library = dlopen("libEGL.so.1", RTLD_NOW | RTLD_LOCAL);
+    if (library == NULL)
+    {
+        library = dlopen("libEGL.so", RTLD_NOW | RTLD_LOCAL);
+    }
+    if (library == NULL)
+    {
+        Warn("[Headless] libEGL not found");
+        return false;
+    }
+
+    s_egl.getProcAddress = reinterpret_cast<PFNEGLGETPROCADDRESSPROC>(dlsym(library, "eglGetProcAddress"));
+    s_egl.getDisplay = reinterpret_cast<PFNEGLGETDISPLAYPROC>(dlsym(library, "eglGetDisplay"));
+    s_egl.initialize = reinterpret_cast<PFNEGLINITIALIZEPROC>(dlsym(library, "eglInitialize"));
+    s_egl.terminate = reinterpret_cast<PFNEGLTERMINATEPROC>(dlsym(library, "eglTerminate"));
+    s_egl.queryString = reinterpret_cast<PFNEGLQUERYSTRINGPROC>(dlsym(library, "eglQueryString"));
+    s_egl.bindApi = reinterpret_cast<PFNEGLBINDAPIPROC>(dlsym(library, "eglBindAPI"));
+    s_egl.chooseConfig = reinterpret_cast<PFNEGLCHOOSECONFIGPROC>(dlsym(library, "eglChooseConfig"));
+    s_egl.createContext = reinterpret_cast<PFNEGLCREATECONTEXTPROC>(dlsym(library, "eglCreateContext"));
+    s_egl.destroyContext = reinterpret_cast<PFNEGLDESTROYCONTEXTPROC>(dlsym(library, "eglDestroyContext"));
+    s_egl.createPbufferSurface = reinterpret_cast<PFNEGLCREATEPBUFFERSURFACEPROC>(dlsym(library, "eglCreatePbufferSurface"));
+    s_egl.destroySurface = reinterpret_cast<PFNEGLDESTROYSURFACEPROC>(dlsym(library, "eglDestroySurface"));
+    s_egl.makeCurrent = reinterpret_cast<PFNEGLMAKECURRENTPROC>(dlsym(library, "eglMakeCurrent"));
+    s_egl.getCurrentContext = reinterpret_cast<PFNEGLGETCURRENTCONTEXTPROC>(dlsym(library, "eglGetCurrentContext"));
+    s_egl.getCurrentDisplay = reinterpret_cast<PFNEGLGETCURRENTDISPLAYPROC>(dlsym(library, "eglGetCurrentDisplay"));
+    s_egl.getCurrentSurface = reinterpret_cast<PFNEGLGETCURRENTSURFACEPROC>(dlsym(library, "eglGetCurrentSurface"));
+
+    if (s_egl.getProcAddress == NULL || s_egl.getDisplay == NULL || s_egl.initialize == NULL || s_egl.terminate == NULL ||
+        s_egl.queryString == NULL || s_egl.bindApi == NULL || s_egl.chooseConfig == NULL || s_egl.createContext == NULL ||
+        s_egl.destroyContext == NULL || s_egl.createPbufferSurface == NULL || s_egl.destroySurface == NULL ||
+        s_egl.makeCurrent == NULL || s_egl.getCurrentContext == NULL || s_egl.getCurrentDisplay == NULL ||
+        s_egl.getCurrentSurface == NULL)
+    {
+        Warn("[Headless] libEGL is missing required functions");
+        dlclose(library);
+        return false;
+    }
+
+    // 拡張の関数。なければ既定のディスプレイだけを使う
+    s_egl.getPlatformDisplay = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(s_egl.getProcAddress("eglGetPlatformDisplayEXT"));
+    s_egl.queryDevices = reinterpret_cast<PFNEGLQUERYDEVICESEXTPROC>(s_egl.getProcAddress("eglQueryDevicesEXT"));
+
+    // ライブラリは閉じずにプロセスの終了まで使う
+    s_egl.loaded = true;
+    return true;
+}
+
+bool HasExtension(const char* extensions, const char* name)
+{
+    if (extensions == NULL)
+    {
+        return false;
+    }
+
+    const size_t length = strlen(name);
+    for (const char* p = strstr(extensions, name); p != NULL; p = strstr(p + length, name))
+    {
+        if ((p == extensions || p[-1] == ' ') && (p[length] == ' ' || p[length] == '\0'))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief 初期化できるディスプレイを探す
+ *
+ * surfaceless（Mesa）、EGL デバイス（GPU ドライバ）、既定のディスプレイの順に試す。
+ */
+EGLDisplay OpenDisplay()
+{
+    const char* clientExtensions = s_egl.queryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+
+    EGLDisplay candidates[3];
+    int candidateCount = 0;
+
+    if (s_egl.getPlatformDisplay != NULL && HasExtension(clientExtensions, "EGL_MESA_platform_surfaceless"))
+    {
+        candidates[candidateCount++] = s_egl.getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL);
+    }
+
+    if (s_egl.getPlatformDisplay != NULL && s_egl.queryDevices != NULL && HasExtension(clientExtensions, "EGL_EXT_platform_device"))
+    {
+        EGLDeviceEXT device;
+        EGLint deviceCount = 0;
+        if (s_egl.queryDevices(1, &device, &deviceCount) && deviceCount > 0)
+        {
+            candidates[candidateCount++] = s_egl.getPlatformDisplay(EGL_PLATFORM_DEVICE_EXT, device, NULL);
+        }
+    }
+
+    candidates[candidateCount++] = s_egl.getDisplay(EGL_DEFAULT_DISPLAY);
+
+    for (int i = 0; i < candidateCount; i++)
+    {
+        EGLint major, minor;
+        if (candidates[i] != EGL_NO_DISPLAY && s_egl.initialize(candidates[i], &major, &minor))
+        {
+            return candidates[i];
+        }
+    }
+
+    return EGL_NO_DISPLAY;
+}
+
+}
+#endif
+
+LAppHeadlessContext::LAppHeadlessContext()
+    : _display(NULL)
+    , _context(NULL)
+    , _surface(NULL)
+{
+}
+
+LAppHeadlessContext::~LAppHeadlessContext()
+{
+    Release();
+}
+
+bool LAppHeadlessContext::IsSupported()
+{
+#ifdef LAPP_HEADLESS_EGL
+    return LoadEgl();
+#else
+    return false;
+#endif
+}
+
+bool LAppHeadlessContext::Initialize(int width, int height)
+{
+    Release();
+
+#ifdef LAPP_HEADLESS_EGL
+    if (!LoadEgl())
+    {
+        return false;
+    }
+
+    EGLDisplay display = OpenDisplay();
+    if (display == EGL_NO_DISPLAY)
+    {
+        Warn("[Headless] no EGL display can be initialized");
+        return false;
+    }
+    _display = display;
+
+    if (!s_egl.bindApi(EGL_OPENGL_API))
+    {
+        Warn("[Headless] EGL display does not support desktop OpenGL");
+        Release();
+        return false;
+    }
+
+    const EGLint configAttributes[] = {
+        EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+        EGL_RED_SIZE, 8,
+        EGL_GREEN_SIZE, 8,
+        EGL_BLUE_SIZE, 8,
+        EGL_ALPHA_SIZE, 8,
+        EGL_NONE
+    };
+    EGLConfig config;
+    EGLint configCount = 0;
+    if (!s_egl.chooseConfig(display, configAttributes, &config, 1, &configCount) || configCount == 0)
+    {
+        Warn("[Headless] no EGL config for OpenGL");
+        Release();
+        return false;
+    }
+
+    EGLContext context = s_egl.createContext(display, config, EGL_NO_CONTEXT, NULL);
+    if (context == EGL_NO_CONTEXT)
+    {
+        Warn("[Headless] failed to create EGL context");
+        Release();
+        return false;
+    }
+    _context = context;
+
+    // 描画はオフスクリーンサーフェイスに行うため、コンテキストをカレントにするためだけの 1x1 の pbuffer で足りる
+    if (!HasExtension(s_egl.queryString(display, EGL_EXTENSIONS), "EGL_KHR_surfaceless_context"))
+    {
+        const EGLint surfaceAttributes[] = {EGL_WIDTH, 1, EGL_HEIGHT, 1, EGL_NONE};
+        EGLSurface surface = s_egl.createPbufferSurface(display, config, surfaceAttributes);
+        if (surface == EGL_NO_SURFACE)
+        {
+            Warn("[Headless] failed to create EGL pbuffer");
+            Release();
+            return false;
+        }
+        _surface = surface;
+    }
+
+    if (!s_egl.makeCurrent(display, _surface, _surface, context))
+    {
+        Warn("[Headless] failed to make EGL context current");
+        Release();
+        return false;
+    }
+
+    // GLX のディスプレイがないため glxewInit は失敗するが、OpenGL の関数はその前に読み込まれている
+    const GLenum glewResult = glewInit();
+    if (glewResult != GLEW_OK && glewResult != GLEW_ERROR_NO_GLX_DISPLAY)
+    {
+        Warn("[Headless] failed to initialize glew: %s", reinterpret_cast<const char*>(glewGetErrorString(glewResult)));
+        Release();
+        return false;
+    }
+    LAppPal::UpdateTime();
+
+    Info("[Headless] %s", reinterpret_cast<const char*>(glGetString(GL_RENDERER)));
+
+    return Resize(width, height);
+#else
+    Warn("[Headless] headless context is not supported on this platform");
+    (void)width;
+    (void)height;
+    return false;
+#endif
+}
+
+void LAppHeadlessContext::Release()
+{
+#ifdef LAPP_HEADLESS_EGL
+    if (_display == NULL)
+    {
+        return;
+    }
+
+    EGLDisplay display = static_cast<EGLDisplay>(_display);
+
+    if (_context != NULL)
+    {
+        // 描画先の削除のために一時的にカレントにするので、呼び出し元でカレントだったコンテキストを覚えておく
+        const EGLDisplay lastDisplay = s_egl.getCurrentDisplay();
+        const EGLContext lastContext = s_egl.getCurrentContext();
+        const EGLSurface lastDrawSurface = s_egl.getCurrentSurface(EGL_DRAW);
+        const EGLSurface lastReadSurface = s_egl.getCurrentSurface(EGL_READ);
+
+        s_egl.makeCurrent(display, static_cast<EGLSurface>(_surface), static_cast<EGLSurface>(_surface), static_cast<EGLContext>(_context));
+        _renderTarget.DestroyOffscreenSurface();
+        LAppTextureManager::DeletePendingTextures();
+        Rendering::CubismRenderer_OpenGLES2::InvalidateStateCache();
+
+        // 破棄するコンテキスト自身がカレントだった場合だけカレントを外す
+        if (lastContext == EGL_NO_CONTEXT || lastContext == _context)
+        {
+            s_egl.makeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        }
+        else if (!s_egl.makeCurrent(lastDisplay, lastDrawSurface, lastReadSurface, lastContext))
+        {
+            Warn("[Headless] failed to restore the current context");
+            s_egl.makeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        }
+
+        s_egl.destroyContext(display, static_cast<EGLContext>(_context));
+        _context = NULL;
+    }
+
+    if (_surface != NULL)
+    {
+        s_egl.destroySurface(display, static_cast<EGLSurface>(_surface));
+        _surface = NULL;
+    }
+
+    // ディスプレイは同じプロセスの他のコンテキストと共有されるため終了しない
+    _display = NULL;
+#endif
+}
+
+bool LAppHeadlessContext::MakeCurrent()
+{
+#ifdef LAPP_HEADLESS_EGL
+    if (_context == NULL)
+    {
+        return false;
+    }
+
+    if (s_egl.getCurrentContext() != _context)
+    {
+        if (!s_egl.makeCurrent(static_cast<EGLDisplay>(_display), static_cast<EGLSurface>(_surface), static_cast<EGLSurface>(_surface), static_cast<EGLContext>(_context)))
+        {
+            return false;
+        }
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, _renderTarget.GetRenderTexture());
+    glViewport(0, 0, GetWidth(), GetHeight());
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool LAppHeadlessContext::Resize(int width, int height)
+{
+    if (_context == NULL || width <= 0 || height <= 0)
+    {
+        return false;
+    }
+
+    if (!_renderTarget.CreateOffscreenSurface(static_cast<csmUint32>(width), static_cast<csmUint32>(height)))
+    {
+        return false;
+    }
+
+    // 作成時にテクスチャのバインドが変わる
+    Rendering::CubismRenderer_OpenGLES2::InvalidateStateCache();
+
+    return MakeCurrent();
+}
+
+int LAppHeadlessContext::GetWidth() const
+{
+    return static_cast<int>(_renderTarget.GetBufferWidth());
+}
+
+int LAppHeadlessContext::GetHeight() const
+{
+    return static_cast<int>(_renderTarget.GetBufferHeight());
+}
+
+GLuint LAppHeadlessContext::GetFramebuffer() const
+{
+    return _renderTarget.GetRenderTexture();
+}
+
+GLuint LAppHeadlessContext::GetColorTexture() const
+{
+    return _renderTarget.GetColorBuffer();
+}
+
+void LAppHeadlessContext::ReadPixels(unsigned char* pixels)
+{
+    GLint lastFramebuffer;
+    GLint lastPackAlignment;
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &lastFramebuffer);
+    glGetIntegerv(GL_PACK_ALIGNMENT, &lastPackAlignment);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, _renderTarget.GetRenderTexture());
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, GetWidth(), GetHeight(), GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+
+    glPixelStorei(GL_PACK_ALIGNMENT, lastPackAlignment);
+    glBindFramebuffer(GL_FRAMEBUFFER, lastFramebuffer);
+}
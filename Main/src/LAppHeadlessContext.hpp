@@ -0,0 +1,83 @@
+#pragma once
+
+#include <Rendering/OpenGL/CubismOffscreenSurface_OpenGLES2.hpp>
+
+/**
+ * @brief ウィンドウを使わずに描画するための OpenGL コンテキスト
+ *
+ * EGL でディスプレイサーバーなしのコンテキストを作成する。
+ * Mesa の surfaceless プラットフォーム、EGL デバイス、既定のディスプレイの順に試すため、GPU のない環境でも llvmpipe で動く。
+ * 描画先はコンテキストが持つオフスクリーンサーフェイスで、MakeCurrent() でフレームバッファとして束縛する。
+ * EGL は実行時に読み込むため、使わない場合は libEGL がなくても動く。現在は Linux のみ対応。
+ */
+class LAppHeadlessContext
+{
+public:
+    LAppHeadlessContext();
+
+    /**
+     * @brief デストラクタ。Release() を呼ぶ
+     */
+    ~LAppHeadlessContext();
+
+    /**
+     * @brief このビルドでヘッドレスのコンテキストを作成できるか
+     */
+    static bool IsSupported();
+
+    /**
+     * @brief コンテキストと描画先を作成してカレントにする
+     *
+     * @param[in]   width   描画先の幅
+     * @param[in]   height  描画先の高さ
+     * @return  成功した場合 true
+     */
+    bool Initialize(int width, int height);
+
+    /**
+     * @brief 描画先とコンテキストを破棄する
+     *
+     * 他の EGL コンテキストがカレントだった場合は、破棄した後にそのコンテキストをカレントに戻す。
+     */
+    void Release();
+
+    /**
+     * @brief コンテキストを呼び出し元のスレッドでカレントにし、描画先を束縛してビューポートを合わせる
+     */
+    bool MakeCurrent();
+
+    /**
+     * @brief 描画先を作り直す。内容は消える
+     */
+    bool Resize(int width, int height);
+
+    int GetWidth() const;
+
+    int GetHeight() const;
+
+    /**
+     * @brief 描画先のフレームバッファ
+     */
+    GLuint GetFramebuffer() const;
+
+    /**
+     * @brief 描画先のカラーバッファのテクスチャ
+     */
+    GLuint GetColorTexture() const;
+
+    /**
+     * @brief 描画先の内容を RGBA で読み出す
+     *
+     * @param[out]  pixels  幅 * 高さ * 4 バイトの書き込み先。行は下から上の順
+     */
+    void ReadPixels(unsigned char* pixels);
+
+private:
+    LAppHeadlessContext(const LAppHeadlessContext&);
+    LAppHeadlessContext& operator=(const LAppHeadlessContext&);
+
+    void* _display; ///< EGLDisplay
+    void* _context; ///< EGLContext
+    void* _surface; ///< EGLSurface。surfaceless に対応していない場合だけ作る 1x1 の pbuffer
+    Csm::Rendering::CubismOffscreenSurface_OpenGLES2 _renderTarget;
+};
@@ -22,6 +22,7 @@
 #include "LAppTextureManager.hpp"
 
 #include <Log.hpp>
+#include <chrono>
 #include <filesystem>
 #include <unordered_set>
 
@@ -42,6 +43,172 @@ namespace
         Info("delete buffer: %s", path);
         LAppPal::ReleaseBytes(buffer);
     }
+
+    double GetMilliseconds()
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // 描画結果のキャッシュを合成するシェーダ。レンダラと同じく GLSL 1.20 / ES 1.00 で書く
+    const char *RenderCacheVertexShader =
+#if defined(CSM_TARGET_IPHONE_ES2) || defined(CSM_TARGET_ANDROID_ES2) || defined(CSM_TARGET_HARMONYOS_ES3)
+        "#version 100\n"
+#else
+        "#version 120\n"
+#endif
+        "attribute vec2 a_position;"
+        "attribute vec2 a_texCoord;"
+        "varying vec2 v_texCoord;"
+        "void main()"
+        "{"
+        "gl_Position = vec4(a_position, 0.0, 1.0);"
+        "v_texCoord = a_texCoord;"
+        "}";
+
+    const char *RenderCacheFragmentShader =
+#if defined(CSM_TARGET_IPHONE_ES2) || defined(CSM_TARGET_ANDROID_ES2) || defined(CSM_TARGET_HARMONYOS_ES3)
+        "#version 100\n"
+        "precision mediump float;"
+#else
+        "#version 120\n"
+#endif
+        "varying vec2 v_texCoord;"
+        "uniform sampler2D s_texture0;"
+        "void main()"
+        "{"
+        "gl_FragColor = texture2D(s_texture0, v_texCoord);"
+        "}";
+
+    GLuint CompileRenderCacheShader(GLenum type, const char *source)
+    {
+        GLuint shader = glCreateShader(type);
+        glShaderSource(shader, 1, &source, NULL);
+        glCompileShader(shader);
+
+        GLint status = GL_FALSE;
+        glGetShaderiv(shader, GL_COMPILE_STATUS, &status);
+        if (status == GL_FALSE)
+        {
+            char log[512] = {};
+            glGetShaderInfoLog(shader, sizeof(log), NULL, log);
+            Warn("[RenderCache] failed to compile shader: %s", log);
+            glDeleteShader(shader);
+            return 0;
+        }
+        return shader;
+    }
+
+    /**
+     * @brief キャッシュへの描画と合成で変更するOpenGLのステートを保存し、スコープを抜けるときに戻す
+     */
+    class RenderCacheStateGuard
+    {
+    public:
+        explicit RenderCacheStateGuard(bool vertexArray)
+            : _vertexArray(vertexArray), _lastVertexArray(0)
+        {
+            glGetIntegerv(GL_FRAMEBUFFER_BINDING, &_lastFramebuffer);
+            glGetIntegerv(GL_VIEWPORT, _lastViewport);
+            glGetIntegerv(GL_CURRENT_PROGRAM, &_lastProgram);
+            glGetIntegerv(GL_ACTIVE_TEXTURE, &_lastActiveTexture);
+            glActiveTexture(GL_TEXTURE0);
+            glGetIntegerv(GL_TEXTURE_BINDING_2D, &_lastTexture);
+            glGetIntegerv(GL_ARRAY_BUFFER_BINDING, &_lastArrayBuffer);
+            if (_vertexArray)
+            {
+                glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &_lastVertexArray);
+                glBindVertexArray(0);
+            }
+            glGetVertexAttribiv(0, GL_VERTEX_ATTRIB_ARRAY_ENABLED, &_lastAttribEnabled[0]);
+            glGetVertexAttribiv(1, GL_VERTEX_ATTRIB_ARRAY_ENABLED, &_lastAttribEnabled[1]);
+            _lastBlend = glIsEnabled(GL_BLEND);
+            _lastScissorTest = glIsEnabled(GL_SCISSOR_TEST);
+            _lastStencilTest = glIsEnabled(GL_STENCIL_TEST);
+            _lastDepthTest = glIsEnabled(GL_DEPTH_TEST);
+            _lastCullFace = glIsEnabled(GL_CULL_FACE);
+            glGetIntegerv(GL_BLEND_SRC_RGB, &_lastBlending[0]);
+            glGetIntegerv(GL_BLEND_DST_RGB, &_lastBlending[1]);
+            glGetIntegerv(GL_BLEND_SRC_ALPHA, &_lastBlending[2]);
+            glGetIntegerv(GL_BLEND_DST_ALPHA, &_lastBlending[3]);
+            glGetBooleanv(GL_COLOR_WRITEMASK, _lastColorMask);
+            glGetFloatv(GL_COLOR_CLEAR_VALUE, _lastClearColor);
+        }
+
+        ~RenderCacheStateGuard()
+        {
+            glBindFramebuffer(GL_FRAMEBUFFER, _lastFramebuffer);
+            glViewport(_lastViewport[0], _lastViewport[1], _lastViewport[2], _lastViewport[3]);
+            glUseProgram(_lastProgram);
+            glBindTexture(GL_TEXTURE_2D, _lastTexture);
+            glActiveTexture(_lastActiveTexture);
+            glBindBuffer(GL_ARRAY_BUFFER, _lastArrayBuffer);
+            SetAttribEnabled(0, _lastAttribEnabled[0]);
+            SetAttribEnabled(1, _lastAttribEnabled[1]);
+            if (_vertexArray)
+            {
+                glBindVertexArray(_lastVertexArray);
+            }
+            SetEnabled(GL_BLEND, _lastBlend);
+            SetEnabled(GL_SCISSOR_TEST, _lastScissorTest);
+            SetEnabled(GL_STENCIL_TEST, _lastStencilTest);
+            SetEnabled(GL_DEPTH_TEST, _lastDepthTest);
+            SetEnabled(GL_CULL_FACE, _lastCullFace);
+            glBlendFuncSeparate(_lastBlending[0], _lastBlending[1], _lastBlending[2], _lastBlending[3]);
+            glColorMask(_lastColorMask[0], _lastColorMask[1], _lastColorMask[2], _lastColorMask[3]);
+            glClearColor(_lastClearColor[0], _lastClearColor[1], _lastClearColor[2], _lastClearColor[3]);
+
+            // レンダラの外でステートを変更したので、レンダラが持つ写しは使えない
+            Rendering::CubismRenderer_OpenGLES2::InvalidateStateCache();
+        }
+
+        GLint GetFramebuffer() const
+        {
+            return _lastFramebuffer;
+        }
+
+    private:
+        static void SetEnabled(GLenum capability, GLboolean enabled)
+        {
+            if (enabled)
+            {
+                glEnable(capability);
+            }
+            else
+            {
+                glDisable(capability);
+            }
+        }
+
+        static void SetAttribEnabled(GLuint index, GLint enabled)
+        {
+            if (enabled)
+            {
+                glEnableVertexAttribArray(index);
+            }
+            else
+            {
+                glDisableVertexAttribArray(index);
+            }
+        }
+
+        bool _vertexArray;
+        GLint _lastFramebuffer;
+        GLint _lastViewport[4];
+        GLint _lastProgram;
+        GLint _lastActiveTexture;
+        GLint _lastTexture;
+        GLint _lastArrayBuffer;
+        GLint _lastVertexArray;
+        GLint _lastAttribEnabled[2];
+        GLboolean _lastBlend;
+        GLboolean _lastScissorTest;
+        GLboolean _lastStencilTest;
+        GLboolean _lastDepthTest;
+        GLboolean _lastCullFace;
+        GLint _lastBlending[4];
+        GLboolean _lastColorMask[4];
+        GLfloat _lastClearColor[4];
+    };
 }
 
 class FakeMotion : public ACubismMotion
@@ -59,9 +226,22 @@ public:
 };
 
 LAppModel::LAppModel()
-    : CubismUserModel(), _modelSetting(NULL), _userTimeSeconds(0.0f), _autoBlink(true), _autoBreath(true),
-      _matrixManager(), _tmpOrderedDrawIndices(NULL)
+    : CubismUserModel(), _modelSetting(NULL), _userTimeSeconds(0.0f), _lastUpdateTime(-1.0), _autoBlink(true), _autoBreath(true),
+      _matrixManager(), _motionBakeRate(0.0f), _motionBakeMaxError(0.0f),
+      _lazyMotionLoading(false), _motionCacheBudget(0), _motionCacheBytes(0), _motionCacheClock(0),
+      _motionCacheHits(0), _motionCacheMisses(0), _motionCacheEvictions(0),
+      _loadState(LoadState_None), _loadStepsDone(0), _loadStepsTotal(0), _nextDecodeTexture(0), _loadContext(NULL),
+      _drawablesUpdated(false), _pipelineUpdatePending(false), _pipelineStop(false), _pipelineDeltaTime(0.0f),
+      _renderCacheEnabled(false), _renderCacheValid(false), _renderCacheHits(0), _renderCacheMisses(0), _renderCacheProgram(0),
+      _renderCacheBounds(), _renderCacheBypassed(false),
+      _softwareRenderer(NULL),
+      _tmpOrderedDrawIndices(NULL)
 {
+    for (int i = 0; i < LoadCategory_Count; i++)
+    {
+        _loadTimings[i] = 0.0;
+    }
+
     _mocConsistency = MocConsistencyValidationEnable;
 
     _debugMode = DebugLogEnable;
@@ -76,8 +256,29 @@ LAppModel::LAppModel()
 
 LAppModel::~LAppModel()
 {
+    StopPipeline();
+
+    if (_softwareRenderer != NULL)
+    {
+        Rendering::CubismRenderer::Delete(_softwareRenderer);
+    }
+
     _renderBuffer.DestroyOffscreenSurface();
+    if (_renderCacheProgram != 0)
+    {
+        glDeleteProgram(_renderCacheProgram);
+    }
+
+    if (_loadThread.joinable())
+    {
+        _loadThread.join();
+    }
+    for (size_t i = 0; i < _decodedTextures.size(); i++)
+    {
+        _textureManager.ReleaseDecodedImage(_decodedTextures[i]);
+    }
 
+    JoinPrefetch();
     ReleaseMotions();
     ReleaseExpressions();
 
@@ -96,7 +297,139 @@ LAppModel::~LAppModel()
 
 void LAppModel::LoadAssets(const csmChar *fileName)
 {
-    char *dir = strdup(fileName);
+    if (_loadState == LoadState_Loading || _loadState == LoadState_Ready)
+    {
+        Info("model is already loading: %s", _modelHomeDir.GetRawString());
+        return;
+    }
+
+    _loadContext = LAppTextureManager::GetCurrentContext();
+    LoadCpuAssets(fileName, 1);
+    FinishLoad(true);
+}
+
+void LAppModel::LoadAssetsAsync(const csmChar *fileName, int workerCount)
+{
+    if (_loadState == LoadState_Loading || _loadState == LoadState_Ready)
+    {
+        Info("model is already loading: %s", _modelHomeDir.GetRawString());
+        return;
+    }
+
+    if (workerCount <= 0)
+    {
+        workerCount = static_cast<int>(std::thread::hardware_concurrency());
+        workerCount = workerCount > 0 ? workerCount : 1;
+    }
+
+    _loadState = LoadState_Loading;
+    _loadContext = LAppTextureManager::GetCurrentContext();
+    _loadThread = std::thread(&LAppModel::LoadCpuAssets, this, std::string(fileName), workerCount);
+}
+
+bool LAppModel::FinishLoad(bool wait)
+{
+    const int state = _loadState;
+    if (state == LoadState_Finished || state == LoadState_Failed)
+    {
+        return true;
+    }
+    if (state == LoadState_None || (state == LoadState_Loading && !wait))
+    {
+        return false;
+    }
+
+    if (_loadThread.joinable())
+    {
+        _loadThread.join();
+    }
+
+    if (_model == NULL)
+    {
+        for (size_t i = 0; i < _decodedTextures.size(); i++)
+        {
+            _textureManager.ReleaseDecodedImage(_decodedTextures[i]);
+        }
+        _decodedTextures.clear();
+
+        Info("Failed to LoadAssets().");
+        _loadState = LoadState_Failed;
+        return true;
+    }
+
+    // ここから先は GL を使うため呼び出しスレッドで行う
+    double start = GetMilliseconds();
+    CreateRenderer();
+    AddLoadTiming(LoadCategory_Renderer, GetMilliseconds() - start);
+    AdvanceLoadProgress();
+
+    start = GetMilliseconds();
+    SetupTextures();
+    AddLoadTiming(LoadCategory_TextureUpload, GetMilliseconds() - start);
+
+    UpdateRenderCacheBypass();
+
+    _loadState = LoadState_Finished;
+    return true;
+}
+
+LAppModel::LoadState LAppModel::GetLoadState() const
+{
+    return static_cast<LoadState>(_loadState.load());
+}
+
+float LAppModel::GetLoadProgress() const
+{
+    const int state = _loadState;
+    if (state == LoadState_Finished || state == LoadState_Failed)
+    {
+        return 1.0f;
+    }
+
+    const int total = _loadStepsTotal;
+    if (total <= 0)
+    {
+        return 0.0f;
+    }
+
+    const float progress = static_cast<float>(_loadStepsDone) / static_cast<float>(total);
+    return progress < 1.0f ? progress : 1.0f;
+}
+
+void LAppModel::GetLoadTimings(double *timings) const
+{
+    std::lock_guard<std::mutex> lock(_loadMutex);
+    for (int i = 0; i < LoadCategory_Count; i++)
+    {
+        timings[i] = _loadTimings[i];
+    }
+}
+
+void LAppModel::AddLoadTiming(LoadCategory category, double milliseconds)
+{
+    std::lock_guard<std::mutex> lock(_loadMutex);
+    _loadTimings[category] += milliseconds;
+}
+
+void LAppModel::AdvanceLoadProgress()
+{
+    ++_loadStepsDone;
+}
+
+void LAppModel::LoadCpuAssets(const std::string &fileName, int workerCount)
+{
+    _loadState = LoadState_Loading;
+    _loadStepsDone = 0;
+    _loadStepsTotal = 0;
+    {
+        std::lock_guard<std::mutex> lock(_loadMutex);
+        for (int i = 0; i < LoadCategory_Count; i++)
+        {
+            _loadTimings[i] = 0.0;
+        }
+    }
+
+    char *dir = strdup(fileName.c_str());
     char *last_slash = strrchr(dir, '/');
     if (last_slash) {
         *last_slash = '\0';
@@ -107,26 +440,76 @@ void LAppModel::LoadAssets(const csmChar *fileName)
     }
     free(dir);
 
-    Info("load model setting: %s", fileName);
+    Info("load model setting: %s", fileName.c_str());
+
+    double start = GetMilliseconds();
 
     csmSizeInt size;
-    const csmString path = fileName;
+    const csmString path = fileName.c_str();
 
     csmByte *buffer = CreateBuffer(path.GetRawString(), &size);
     ICubismModelSetting *setting = new CubismModelSettingJson(buffer, size);
     DeleteBuffer(buffer, path.GetRawString());
 
+    AddLoadTiming(LoadCategory_Setting, GetMilliseconds() - start);
+
+    // 進捗の段階数: model3.json, moc, 各資産, モーション, テクスチャのデコードと転送, レンダラ
+    const csmInt32 textureCount = setting->GetTextureCount();
+    csmInt32 steps = 3 + setting->GetExpressionCount() + textureCount * 2;
+    steps += strcmp(setting->GetPhysicsFileName(), "") != 0 ? 1 : 0;
+    steps += strcmp(setting->GetPoseFileName(), "") != 0 ? 1 : 0;
+    steps += strcmp(setting->GetUserDataFile(), "") != 0 ? 1 : 0;
+    for (csmInt32 i = 0; i < setting->GetMotionGroupCount() && !_lazyMotionLoading; i++)
+    {
+        steps += setting->GetMotionCount(setting->GetMotionGroupName(i));
+    }
+    _loadStepsTotal = steps;
+    AdvanceLoadProgress();
+
+    // テクスチャのデコードはモデルの構築と並行してワーカーで行う
+    _texturePaths.assign(textureCount, std::string());
+    _decodedTextures.assign(textureCount, LAppTextureManager::DecodedImage());
+    for (csmInt32 i = 0; i < textureCount; i++)
+    {
+        _decodedTextures[i].pixels = NULL;
+        if (strcmp(setting->GetTextureFileName(i), "") != 0)
+        {
+            _texturePaths[i] = (_modelHomeDir + setting->GetTextureFileName(i)).GetRawString();
+        }
+    }
+    _nextDecodeTexture = 0;
+
+    std::vector<std::thread> workers;
+    for (csmInt32 i = 1; i < workerCount && i < textureCount; i++)
+    {
+        workers.push_back(std::thread(&LAppModel::DecodePendingTextures, this));
+    }
+
     SetupModel(setting);
 
-    if (_model == NULL)
+    DecodePendingTextures();
+    for (size_t i = 0; i < workers.size(); i++)
     {
-        Info("Failed to LoadAssets().");
-        return;
+        workers[i].join();
     }
 
-    CreateRenderer();
+    _loadState = LoadState_Ready;
+}
 
-    SetupTextures();
+void LAppModel::DecodePendingTextures()
+{
+    const int count = static_cast<int>(_texturePaths.size());
+    for (int i = _nextDecodeTexture++; i < count; i = _nextDecodeTexture++)
+    {
+        // 他のモデルが転送済みのテクスチャはデコードせず共有キャッシュから使う
+        if (!_texturePaths[i].empty() && !LAppTextureManager::IsTextureCached(_texturePaths[i], _loadContext))
+        {
+            const double start = GetMilliseconds();
+            _textureManager.DecodePngFile(_texturePaths[i], _decodedTextures[i]);
+            AddLoadTiming(LoadCategory_TextureDecode, GetMilliseconds() - start);
+        }
+        AdvanceLoadProgress();
+    }
 }
 
 void LAppModel::SetupModel(ICubismModelSetting *setting)
@@ -138,8 +521,10 @@ void LAppModel::SetupModel(ICubismModelSetting *setting)
 
     csmByte *buffer;
     csmSizeInt size;
+    double start;
 
     // Cubism Model
+    start = GetMilliseconds();
     if (strcmp(_modelSetting->GetModelFileName(), "") != 0)
     {
         csmString path = _modelSetting->GetModelFileName();
@@ -150,12 +535,25 @@ void LAppModel::SetupModel(ICubismModelSetting *setting)
             Info("create model: %s", setting->GetModelFileName());
         }
 
-        buffer = CreateBuffer(path.GetRawString(), &size);
-        LoadModel(buffer, size, _mocConsistency);
-        DeleteBuffer(buffer, path.GetRawString());
+        // 同じ moc3 を読み込んだインスタンスがあれば、revive 済みの moc を共有する
+        const csmString mocKey = LAppPal::GetCanonicalPath(path.GetRawString()).c_str();
+
+        if (!LoadSharedModel(mocKey))
+        {
+            buffer = CreateBuffer(path.GetRawString(), &size);
+            // moc3 が読めなければ _model は NULL のままになり、読み込み失敗として扱われる
+            if (buffer != NULL)
+            {
+                LoadSharedModel(mocKey, buffer, size, _mocConsistency);
+            }
+            DeleteBuffer(buffer, path.GetRawString());
+        }
     }
+    AddLoadTiming(LoadCategory_Moc, GetMilliseconds() - start);
+    AdvanceLoadProgress();
 
     // Expression
+    start = GetMilliseconds();
     if (_modelSetting->GetExpressionCount() > 0)
     {
         const csmInt32 count = _modelSetting->GetExpressionCount();
@@ -179,29 +577,37 @@ void LAppModel::SetupModel(ICubismModelSetting *setting)
             }
 
             DeleteBuffer(buffer, path.GetRawString());
+            AdvanceLoadProgress();
         }
     }
+    AddLoadTiming(LoadCategory_Expression, GetMilliseconds() - start);
 
     // Physics
     if (strcmp(_modelSetting->GetPhysicsFileName(), "") != 0)
     {
+        start = GetMilliseconds();
         csmString path = _modelSetting->GetPhysicsFileName();
         path = _modelHomeDir + path;
 
         buffer = CreateBuffer(path.GetRawString(), &size);
         LoadPhysics(buffer, size);
         DeleteBuffer(buffer, path.GetRawString());
+        AddLoadTiming(LoadCategory_Physics, GetMilliseconds() - start);
+        AdvanceLoadProgress();
     }
 
     // Pose
     if (strcmp(_modelSetting->GetPoseFileName(), "") != 0)
     {
+        start = GetMilliseconds();
         csmString path = _modelSetting->GetPoseFileName();
         path = _modelHomeDir + path;
 
         buffer = CreateBuffer(path.GetRawString(), &size);
         LoadPose(buffer, size);
         DeleteBuffer(buffer, path.GetRawString());
+        AddLoadTiming(LoadCategory_Pose, GetMilliseconds() - start);
+        AdvanceLoadProgress();
     }
 
     // EyeBlink
@@ -230,11 +636,14 @@ void LAppModel::SetupModel(ICubismModelSetting *setting)
     // UserData
     if (strcmp(_modelSetting->GetUserDataFile(), "") != 0)
     {
+        start = GetMilliseconds();
         csmString path = _modelSetting->GetUserDataFile();
         path = _modelHomeDir + path;
         buffer = CreateBuffer(path.GetRawString(), &size);
         LoadUserData(buffer, size);
         DeleteBuffer(buffer, path.GetRawString());
+        AddLoadTiming(LoadCategory_UserData, GetMilliseconds() - start);
+        AdvanceLoadProgress();
     }
 
     // EyeBlinkIds
@@ -268,11 +677,14 @@ void LAppModel::SetupModel(ICubismModelSetting *setting)
 
     _model->SaveParameters();
 
-    for (csmInt32 i = 0; i < _modelSetting->GetMotionGroupCount(); i++)
+    // 遅延読み込みの場合は初回の StartMotion で読み込む
+    start = GetMilliseconds();
+    for (csmInt32 i = 0; i < _modelSetting->GetMotionGroupCount() && !_lazyMotionLoading; i++)
     {
         const csmChar *group = _modelSetting->GetMotionGroupName(i);
         PreloadMotionGroup(group);
     }
+    AddLoadTiming(LoadCategory_Motion, GetMilliseconds() - start);
 
     _motionManager->StopAllMotions();
 
@@ -292,6 +704,8 @@ void LAppModel::PreloadMotionGroup(const csmChar *group)
         csmString name = Utils::CubismString::GetFormatedString("%s_%d", group, i);
         csmString path = _modelSetting->GetMotionFileName(group, i);
 
+        AdvanceLoadProgress();
+
         // 定义了动作但是没有动作路径
         if (path.GetLength() == 0)
         {
@@ -303,37 +717,170 @@ void LAppModel::PreloadMotionGroup(const csmChar *group)
             Info("load motion: %s => [%s_%d] ", path.GetRawString(), group, i);
         }
 
-        path = _modelHomeDir + path;
-
-        csmByte *buffer;
-        csmSizeInt size;
-        buffer = CreateBuffer(path.GetRawString(), &size);
-        CubismMotion *tmpMotion = static_cast<CubismMotion *>(LoadMotion(buffer, size, name.GetRawString()));
+        CubismMotion *tmpMotion = LoadMotionJob(MakeMotionLoadJob(group, i));
 
         if (tmpMotion)
         {
-            csmFloat32 fadeTime = _modelSetting->GetMotionFadeInTimeValue(group, i);
-            if (fadeTime >= 0.0f)
+            CacheMotion(name.GetRawString(), tmpMotion);
+        }
+    }
+
+    EvictMotions();
+}
+
+LAppModel::MotionLoadJob LAppModel::MakeMotionLoadJob(const csmChar *group, csmInt32 no) const
+{
+    MotionLoadJob job;
+    job.name = Utils::CubismString::GetFormatedString("%s_%d", group, no).GetRawString();
+    job.path = _modelHomeDir + _modelSetting->GetMotionFileName(group, no);
+    job.fadeInTime = _modelSetting->GetMotionFadeInTimeValue(group, no);
+    job.fadeOutTime = _modelSetting->GetMotionFadeOutTimeValue(group, no);
+    job.bakeRate = _motionBakeRate;
+    job.bakeMaxError = _motionBakeMaxError;
+    return job;
+}
+
+CubismMotion *LAppModel::LoadMotionJob(const MotionLoadJob &job)
+{
+    CubismMotion *motion = LoadMotionFile(job.path);
+
+    if (motion)
+    {
+        if (job.fadeInTime >= 0.0f)
+        {
+            motion->SetFadeInTime(job.fadeInTime);
+        }
+
+        if (job.fadeOutTime >= 0.0f)
+        {
+            motion->SetFadeOutTime(job.fadeOutTime);
+        }
+        motion->SetEffectIds(_eyeBlinkIds, _lipSyncIds);
+
+        if (job.bakeRate > 0.0f)
+        {
+            motion->Bake(job.bakeRate, job.bakeMaxError);
+        }
+    }
+
+    return motion;
+}
+
+void LAppModel::CacheMotion(const std::string &name, CubismMotion *motion)
+{
+    const csmString key = name.c_str();
+    if (_motions.IsExist(key) && _motions[key] != motion)
+    {
+        ACubismMotion::Delete(_motions[key]);
+    }
+    _motions[key] = motion;
+
+    MotionCacheEntry &entry = _motionCacheEntries[name];
+    const size_t bytes = motion->GetDataSize();
+    _motionCacheBytes = _motionCacheBytes - entry.bytes + bytes;
+    entry.bytes = bytes;
+    entry.lastUsed = ++_motionCacheClock;
+}
+
+void LAppModel::EvictMotions()
+{
+    while (_motionCacheBudget > 0 && _motionCacheBytes > _motionCacheBudget)
+    {
+        // 再生中のモーションは解放できないため、それ以外で最も長く使われていないものを探す
+        std::unordered_map<std::string, MotionCacheEntry>::iterator victim = _motionCacheEntries.end();
+        ACubismMotion *victimMotion = NULL;
+        for (std::unordered_map<std::string, MotionCacheEntry>::iterator it = _motionCacheEntries.begin();
+             it != _motionCacheEntries.end(); ++it)
+        {
+            if (victim != _motionCacheEntries.end() && it->second.lastUsed >= victim->second.lastUsed)
             {
-                tmpMotion->SetFadeInTime(fadeTime);
+                continue;
             }
 
-            fadeTime = _modelSetting->GetMotionFadeOutTimeValue(group, i);
-            if (fadeTime >= 0.0f)
+            ACubismMotion *motion = _motions[it->first.c_str()];
+            if (_motionManager->IsMotionQueued(motion))
             {
-                tmpMotion->SetFadeOutTime(fadeTime);
+                continue;
             }
-            tmpMotion->SetEffectIds(_eyeBlinkIds, _lipSyncIds);
 
-            if (_motions[name] != NULL)
+            victim = it;
+            victimMotion = motion;
+        }
+
+        if (victim == _motionCacheEntries.end())
+        {
+            break;
+        }
+
+        for (csmMap<csmString, ACubismMotion *>::const_iterator iter = _motions.Begin(); iter != _motions.End(); ++iter)
+        {
+            if (iter->Second == victimMotion)
             {
-                ACubismMotion::Delete(_motions[name]);
+                _motions.Erase(iter);
+                break;
             }
-            _motions[name] = tmpMotion;
         }
+        ACubismMotion::Delete(victimMotion);
 
-        DeleteBuffer(buffer, path.GetRawString());
+        _motionCacheBytes -= victim->second.bytes;
+        _motionCacheEntries.erase(victim);
+        ++_motionCacheEvictions;
+    }
+}
+
+CubismMotion *LAppModel::LoadMotionFile(const csmString &path)
+{
+    csmByte *buffer = NULL;
+    csmSizeInt size = 0;
+
+    // 同じ場所にコンパイル済みモーション (xxx.motion3.bin) があれば、パースせずにマップして使う
+    // .json を編集した後の古い .bin は使わない。.json が無ければ .bin だけで読み込む
+    std::string binaryPath = path.GetRawString();
+    if (binaryPath.size() > 5 && binaryPath.compare(binaryPath.size() - 5, 5, ".json") == 0)
+    {
+        binaryPath.replace(binaryPath.size() - 5, 5, ".bin");
+
+        csmSizeInt binarySize;
+        csmByte *mapped = std::filesystem::exists(binaryPath) ? LAppPal::MapFile(binaryPath, &binarySize) : NULL;
+        if (mapped != NULL)
+        {
+            if (std::filesystem::exists(path.GetRawString()))
+            {
+                buffer = CreateBuffer(path.GetRawString(), &size);
+            }
+
+            if (buffer != NULL && !CubismMotion::IsBinaryCompiledFrom(mapped, binarySize, buffer, size))
+            {
+                Info("compiled motion is out of date, fall back to json: %s", binaryPath.c_str());
+                LAppPal::UnmapFile(mapped, binarySize);
+            }
+            else
+            {
+                CubismMotion *motion = CubismMotion::CreateFromBinary(mapped, binarySize, LAppPal::UnmapFile);
+                if (motion != NULL)
+                {
+                    Info("map compiled motion: %s", binaryPath.c_str());
+                    if (buffer != NULL)
+                    {
+                        DeleteBuffer(buffer, path.GetRawString());
+                    }
+                    return motion;
+                }
+
+                Info("invalid compiled motion, fall back to json: %s", binaryPath.c_str());
+                LAppPal::UnmapFile(mapped, binarySize);
+            }
+        }
+    }
+
+    if (buffer == NULL)
+    {
+        buffer = CreateBuffer(path.GetRawString(), &size);
     }
+    CubismMotion *motion = static_cast<CubismMotion *>(LoadMotion(buffer, size, NULL));
+    DeleteBuffer(buffer, path.GetRawString());
+
+    return motion;
 }
 
 void LAppModel::ReleaseMotionGroup(const csmChar *group) const
@@ -363,6 +910,8 @@ void LAppModel::ReleaseMotions()
     }
 
     _motions.Clear();
+    _motionCacheEntries.clear();
+    _motionCacheBytes = 0;
 }
 
 /**
@@ -382,32 +931,86 @@ void LAppModel::ReleaseExpressions()
 
 void LAppModel::Update()
 {
-    LAppPal::UpdateTime();
+    if (_loadState != LoadState_Finished)
+    {
+        return;
+    }
 
-    const csmFloat32 deltaTimeSeconds = LAppPal::GetDeltaTime();
-    _userTimeSeconds += deltaTimeSeconds;
+    // モデルごとの時計で経過時間を計測する
+    const double now = LAppPal::GetSystemTimeSeconds();
+    const csmFloat32 deltaTimeSeconds = _lastUpdateTime < 0.0 ? 0.0f : static_cast<csmFloat32>(now - _lastUpdateTime);
 
-    _dragManager->Update(deltaTimeSeconds);
-    _dragX = _dragManager->GetX();
-    _dragY = _dragManager->GetY();
+    Update(deltaTimeSeconds, now);
+}
 
-    // モーションによるパラメータ更新の有無
-    csmBool motionUpdated = false;
+void LAppModel::Update(csmFloat32 deltaTimeSeconds)
+{
+    Update(deltaTimeSeconds, LAppPal::GetSystemTimeSeconds());
+}
 
-    //-----------------------------------------------------------------
-    _model->LoadParameters(); // 前回セーブされた状態を
-    if (!_motionManager->IsFinished())
+void LAppModel::Update(csmFloat32 deltaTimeSeconds, double updateTime)
+{
+    if (_loadState != LoadState_Finished)
     {
-        motionUpdated = _motionManager->UpdateMotion(_model, deltaTimeSeconds); // モーションを更新
+        return;
     }
-    _model->SaveParameters(); // 状態を保存
-    //-----------------------------------------------------------------
 
-    // 不透明度
-    _opacity = _model->GetModelOpacity();
+    // 次の Update() はこの更新からの経過時間で進める
+    _lastUpdateTime = updateTime;
 
-    // まばたき
-    if (!motionUpdated)
+    if (!_pipelineThread.joinable() || _pipelineThread.get_id() == std::this_thread::get_id())
+    {
+        UpdateParameters(deltaTimeSeconds);
+        return;
+    }
+
+    WaitPendingUpdate();
+
+    // 初回はまだワーカーで頂点を計算していないため、現在のパラメータから計算しておく
+    if (!_model->IsDrawableSnapshotEnabled())
+    {
+        _model->Update();
+    }
+
+    // 前のフレームの計算結果を描画用にコピーしてから、次のフレームの計算を始める
+    _model->SnapshotDrawables();
+    _model->SetDrawableSnapshotEnabled(true);
+
+    {
+        std::lock_guard<std::mutex> lock(_pipelineMutex);
+        _pipelineDeltaTime = deltaTimeSeconds;
+        _pipelineUpdatePending = true;
+    }
+    _pipelineCondition.notify_all();
+}
+
+void LAppModel::UpdateParameters(csmFloat32 deltaTimeSeconds)
+{
+    AdoptPrefetchedMotions();
+
+    _userTimeSeconds += deltaTimeSeconds;
+
+    _dragManager->Update(deltaTimeSeconds);
+    _dragX = _dragManager->GetX();
+    _dragY = _dragManager->GetY();
+
+    // モーションによるパラメータ更新の有無
+    csmBool motionUpdated = false;
+
+    //-----------------------------------------------------------------
+    _model->LoadParameters(); // 前回セーブされた状態を
+    if (!_motionManager->IsFinished())
+    {
+        motionUpdated = _motionManager->UpdateMotion(_model, deltaTimeSeconds); // モーションを更新
+    }
+    _model->SaveParameters(); // 状態を保存
+    //-----------------------------------------------------------------
+
+    // 不透明度
+    _opacity = _model->GetModelOpacity();
+
+    // まばたき
+    if (!motionUpdated)
     {
         if (_autoBlink && _eyeBlink != NULL)
         {
@@ -453,6 +1056,123 @@ void LAppModel::Update()
     }
 }
 
+csmFloat32 LAppModel::GetUserTimeSeconds() const
+{
+    return _userTimeSeconds;
+}
+
+void LAppModel::UpdateDrawables()
+{
+    // パイプライン化している場合はワーカーが計算する
+    if (_loadState != LoadState_Finished || _model == NULL || _pipelineThread.joinable())
+    {
+        return;
+    }
+
+    _model->Update();
+    _drawablesUpdated = true;
+}
+
+std::recursive_mutex& LAppModel::GetMutex()
+{
+    return _mutex;
+}
+
+bool LAppModel::SetPipelined(bool enable)
+{
+    if (enable == _pipelineThread.joinable())
+    {
+        return true;
+    }
+
+    if (!enable)
+    {
+        if (_pipelineThread.get_id() == std::this_thread::get_id())
+        {
+            return false;
+        }
+
+        StopPipeline();
+        return true;
+    }
+
+    _pipelineStop = false;
+    _pipelineThread = std::thread(&LAppModel::PipelineWorker, this);
+    return true;
+}
+
+bool LAppModel::IsPipelined() const
+{
+    return _pipelineThread.joinable();
+}
+
+bool LAppModel::IsUpdatePending()
+{
+    if (!_pipelineThread.joinable() || _pipelineThread.get_id() == std::this_thread::get_id())
+    {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(_pipelineMutex);
+    return _pipelineUpdatePending;
+}
+
+void LAppModel::WaitPendingUpdate()
+{
+    if (!_pipelineThread.joinable() || _pipelineThread.get_id() == std::this_thread::get_id())
+    {
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(_pipelineMutex);
+    _pipelineCondition.wait(lock, [this] { return !_pipelineUpdatePending; });
+}
+
+void LAppModel::PipelineWorker()
+{
+    std::unique_lock<std::mutex> lock(_pipelineMutex);
+    for (;;)
+    {
+        _pipelineCondition.wait(lock, [this] { return _pipelineUpdatePending || _pipelineStop; });
+        if (!_pipelineUpdatePending)
+        {
+            return;
+        }
+
+        const csmFloat32 deltaTimeSeconds = _pipelineDeltaTime;
+        lock.unlock();
+
+        // 描画はスナップショットを読むので、コアのバッファは自由に書き換えてよい
+        UpdateParameters(deltaTimeSeconds);
+        _model->Update();
+
+        lock.lock();
+        _pipelineUpdatePending = false;
+        _pipelineCondition.notify_all();
+    }
+}
+
+void LAppModel::StopPipeline()
+{
+    if (!_pipelineThread.joinable())
+    {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_pipelineMutex);
+        _pipelineStop = true;
+    }
+    _pipelineCondition.notify_all();
+    _pipelineThread.join();
+
+    // ワーカーが計算した最新のフレームは次の Draw() で改めて計算される
+    if (_model != NULL)
+    {
+        _model->SetDrawableSnapshotEnabled(false);
+    }
+}
+
 CubismMotionQueueEntryHandle LAppModel::StartMotion(const csmChar *group, csmInt32 no, csmInt32 priority,
                                                     void *onStartedCallee,
                                                     ACubismMotion::BeganMotionCallback onStartMotionHandler,
@@ -472,11 +1192,13 @@ CubismMotionQueueEntryHandle LAppModel::StartMotion(const csmChar *group, csmInt
         return InvalidMotionQueueEntryHandleValue;
     }
 
+    AdoptPrefetchedMotions();
+
     const csmString fileName = _modelSetting->GetMotionFileName(group, no);
 
     // ex) idle_0
     csmString name = Utils::CubismString::GetFormatedString("%s_%d", group, no);
-    CubismMotion *motion = static_cast<CubismMotion *>(_motions[name.GetRawString()]);
+    CubismMotion *motion = NULL;
     csmBool autoDelete = false;
 
     csmBool hasMotion = true;
@@ -488,36 +1210,33 @@ CubismMotionQueueEntryHandle LAppModel::StartMotion(const csmChar *group, csmInt
         goto handler_label;
     }
 
-    if (motion == NULL)
+    if (_motions.IsExist(name))
     {
-        csmString path = fileName;
-
-        path = _modelHomeDir + path;
+        motion = static_cast<CubismMotion *>(_motions[name]);
+        ++_motionCacheHits;
 
-        csmByte *buffer;
-        csmSizeInt size;
-        buffer = CreateBuffer(path.GetRawString(), &size);
+        if (_motionCacheEntries.count(name.GetRawString()) > 0)
+        {
+            _motionCacheEntries[name.GetRawString()].lastUsed = ++_motionCacheClock;
+        }
+    }
+    else
+    {
+        ++_motionCacheMisses;
 
-        motion = static_cast<CubismMotion *>(LoadMotion(buffer, size, NULL));
+        motion = LoadMotionJob(MakeMotionLoadJob(group, no));
 
         if (motion)
         {
-            csmFloat32 fadeTime = _modelSetting->GetMotionFadeInTimeValue(group, no);
-            if (fadeTime >= 0.0f)
+            if (_lazyMotionLoading)
             {
-                motion->SetFadeInTime(fadeTime);
+                CacheMotion(name.GetRawString(), motion); // キャッシュに残し、予算超過時に LRU で解放
             }
-
-            fadeTime = _modelSetting->GetMotionFadeOutTimeValue(group, no);
-            if (fadeTime >= 0.0f)
+            else
             {
-                motion->SetFadeOutTime(fadeTime);
+                autoDelete = true; // 終了時にメモリから削除
             }
-            motion->SetEffectIds(_eyeBlinkIds, _lipSyncIds);
-            autoDelete = true; // 終了時にメモリから削除
         }
-
-        DeleteBuffer(buffer, path.GetRawString());
     }
 
     if (motion)
@@ -548,7 +1267,9 @@ handler_label:
         return InvalidMotionQueueEntryHandleValue;
     }
 
-    return _motionManager->StartMotionPriority(motion, autoDelete, priority);
+    CubismMotionQueueEntryHandle handle = _motionManager->StartMotionPriority(motion, autoDelete, priority);
+    EvictMotions();
+    return handle;
 }
 
 CubismMotionQueueEntryHandle LAppModel::StartRandomMotion(const csmChar *group, csmInt32 priority,
@@ -590,12 +1311,24 @@ void LAppModel::DoDraw()
 
 void LAppModel::Draw()
 {
-    if (_model == NULL)
+    if (_loadState != LoadState_Finished || _model == NULL)
     {
         return;
     }
 
-    _model->Update();
+    // パイプライン化している場合はスナップショットが毎回変わるのでキャッシュしない
+    if (_renderCacheEnabled && !_renderCacheBypassed && !_model->IsDrawableSnapshotEnabled() && DrawWithRenderCache())
+    {
+        return;
+    }
+
+    // UpdateDrawables() が呼ばれていなければここで計算する
+    // パイプライン化している場合は Update() で取ったスナップショットを描画する
+    if (!_drawablesUpdated && !_model->IsDrawableSnapshotEnabled())
+    {
+        _model->Update();
+    }
+    _drawablesUpdated = false;
 
     CubismMatrix44 &matrix = _matrixManager.GetMvp(this);
 
@@ -604,6 +1337,318 @@ void LAppModel::Draw()
     DoDraw();
 }
 
+bool LAppModel::DrawSoftware(csmUint8 *pixels, int width, int height)
+{
+    if (_loadState != LoadState_Finished || _model == NULL || pixels == NULL || width <= 0 || height <= 0)
+    {
+        return false;
+    }
+
+    if (_softwareRenderer == NULL)
+    {
+        _softwareRenderer = CSM_NEW Rendering::CubismRenderer_Software();
+        _softwareRenderer->Initialize(_model);
+#ifdef PREMULTIPLIED_ALPHA_ENABLE
+        _softwareRenderer->IsPremultipliedAlpha(true);
+#else
+        _softwareRenderer->IsPremultipliedAlpha(false);
+#endif
+
+        // GLに転送したテクスチャのピクセルは残していないため、ファイルからデコードし直す
+        for (csmInt32 i = 0; i < _modelSetting->GetTextureCount(); i++)
+        {
+            if (strcmp(_modelSetting->GetTextureFileName(i), "") == 0)
+            {
+                continue;
+            }
+
+            const csmString texturePath = _modelHomeDir + _modelSetting->GetTextureFileName(i);
+            LAppTextureManager::DecodedImage image;
+            if (_textureManager.DecodePngFile(texturePath.GetRawString(), image))
+            {
+                _softwareRenderer->BindTexture(i, image.pixels, image.width, image.height);
+            }
+            _textureManager.ReleaseDecodedImage(image);
+        }
+    }
+
+    // Draw() と同じく、UpdateDrawables() が呼ばれていなければここで計算する
+    if (!_drawablesUpdated && !_model->IsDrawableSnapshotEnabled())
+    {
+        _model->Update();
+    }
+    _drawablesUpdated = false;
+
+    CubismMatrix44 &matrix = _matrixManager.GetMvp(this);
+
+    _softwareRenderer->SetMvpMatrix(&matrix);
+    _softwareRenderer->SetRenderTarget(pixels, width, height);
+    _softwareRenderer->DrawModel();
+    return true;
+}
+
+bool LAppModel::DrawWithRenderCache()
+{
+    Rendering::CubismRenderer_OpenGLES2 *renderer = GetRenderer<Rendering::CubismRenderer_OpenGLES2>();
+
+    GLint viewport[4];
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    if (viewport[2] <= 0 || viewport[3] <= 0)
+    {
+        return false;
+    }
+
+    CubismMatrix44 &matrix = _matrixManager.GetMvp(this);
+
+    CollectRenderCacheInputs(matrix, viewport, _renderCacheScratch);
+    const bool hit = _renderCacheValid && _renderCacheScratch == _renderCacheInputs;
+
+    RenderCacheStateGuard guard(renderer->IsUsingVertexBufferObject());
+
+    if (!hit)
+    {
+        const csmUint32 width = static_cast<csmUint32>(viewport[2]);
+        const csmUint32 height = static_cast<csmUint32>(viewport[3]);
+        if (!_renderBuffer.IsValid() || _renderBuffer.GetBufferWidth() != width || _renderBuffer.GetBufferHeight() != height)
+        {
+            _renderBuffer.CreateOffscreenSurface(width, height);
+
+            // 描画先と画素が1対1に対応するので補間しない
+            glBindTexture(GL_TEXTURE_2D, _renderBuffer.GetColorBuffer());
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        }
+
+        if (!_drawablesUpdated)
+        {
+            _model->Update();
+        }
+
+        _renderBuffer.BeginDraw(guard.GetFramebuffer());
+        glViewport(0, 0, viewport[2], viewport[3]);
+        glDisable(GL_SCISSOR_TEST);
+        glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+        _renderBuffer.Clear(0.0f, 0.0f, 0.0f, 0.0f);
+
+        renderer->SetMvpMatrix(&matrix);
+        DoDraw();
+
+        _renderBuffer.EndDraw();
+        glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+
+        // 乗算色・スクリーン色は頂点の計算で更新されるので、計算後の値を記録する
+        CollectRenderCacheInputs(matrix, viewport, _renderCacheInputs);
+        UpdateRenderCacheBounds(matrix);
+        _renderCacheValid = true;
+        _renderCacheMisses++;
+    }
+    else
+    {
+        _renderCacheHits++;
+    }
+    _drawablesUpdated = false;
+
+    if (!CompositeRenderCache())
+    {
+        // シェーダを用意できない環境では以降キャッシュしない。今回の描画は呼び出し元でやり直す
+        _renderCacheEnabled = false;
+        _renderCacheValid = false;
+        return false;
+    }
+
+    return true;
+}
+
+void LAppModel::CollectRenderCacheInputs(CubismMatrix44 &mvp, const GLint *viewport, std::vector<float> &inputs)
+{
+    const csmInt32 parameterCount = _model->GetParameterCount();
+    const csmInt32 partCount = _model->GetPartCount();
+    const csmInt32 drawableCount = _model->GetDrawableCount();
+
+    inputs.clear();
+    inputs.reserve(parameterCount + partCount + drawableCount * 8 + 25);
+
+    for (csmInt32 i = 0; i < parameterCount; i++)
+    {
+        inputs.push_back(_model->GetParameterValue(i));
+    }
+    for (csmInt32 i = 0; i < partCount; i++)
+    {
+        inputs.push_back(_model->GetPartOpacity(i));
+    }
+
+    // パーツ単位の色の上書きもDrawableの色に反映されている
+    for (csmInt32 i = 0; i < drawableCount; i++)
+    {
+        const Rendering::CubismRenderer::CubismTextureColor multiplyColor = _model->GetMultiplyColor(i);
+        const Rendering::CubismRenderer::CubismTextureColor screenColor = _model->GetScreenColor(i);
+        inputs.push_back(multiplyColor.R);
+        inputs.push_back(multiplyColor.G);
+        inputs.push_back(multiplyColor.B);
+        inputs.push_back(multiplyColor.A);
+        inputs.push_back(screenColor.R);
+        inputs.push_back(screenColor.G);
+        inputs.push_back(screenColor.B);
+        inputs.push_back(screenColor.A);
+    }
+
+    inputs.push_back(_model->GetModelOpacity());
+
+    const Rendering::CubismRenderer::CubismTextureColor modelColor = GetRenderer<Rendering::CubismRenderer_OpenGLES2>()->GetModelColor();
+    inputs.push_back(modelColor.R);
+    inputs.push_back(modelColor.G);
+    inputs.push_back(modelColor.B);
+    inputs.push_back(modelColor.A);
+
+    const csmFloat32 *matrix = mvp.GetArray();
+    inputs.insert(inputs.end(), matrix, matrix + 16);
+
+    for (int i = 0; i < 4; i++)
+    {
+        inputs.push_back(static_cast<float>(viewport[i]));
+    }
+}
+
+void LAppModel::UpdateRenderCacheBounds(CubismMatrix44 &mvp)
+{
+    float left = 1.0f;
+    float bottom = 1.0f;
+    float right = -1.0f;
+    float top = -1.0f;
+
+    // MVP行列は拡大縮小と平行移動だけなので、モデル座標での矩形を変換すればよい
+    float minX = 0.0f;
+    float minY = 0.0f;
+    float maxX = 0.0f;
+    float maxY = 0.0f;
+    bool empty = true;
+    const csmInt32 drawableCount = _model->GetDrawableCount();
+    for (csmInt32 i = 0; i < drawableCount; i++)
+    {
+        const csmInt32 vertexCount = _model->GetDrawableVertexCount(i);
+        if (vertexCount == 0 || _model->GetDrawableOpacity(i) <= 0.0f || !_model->GetDrawableDynamicFlagIsVisible(i))
+        {
+            continue;
+        }
+
+        const csmFloat32 *vertices = _model->GetDrawableVertices(i);
+        for (csmInt32 j = 0; j < vertexCount; j++)
+        {
+            const float x = vertices[j * 2];
+            const float y = vertices[j * 2 + 1];
+            if (empty)
+            {
+                minX = maxX = x;
+                minY = maxY = y;
+                empty = false;
+                continue;
+            }
+            minX = x < minX ? x : minX;
+            maxX = x > maxX ? x : maxX;
+            minY = y < minY ? y : minY;
+            maxY = y > maxY ? y : maxY;
+        }
+    }
+
+    if (!empty)
+    {
+        const float x0 = mvp.TransformX(minX);
+        const float x1 = mvp.TransformX(maxX);
+        const float y0 = mvp.TransformY(minY);
+        const float y1 = mvp.TransformY(maxY);
+
+        // 画素の端で欠けないよう、ラスタライズの誤差の分だけ広げて画面内に収める
+        const float margin = 0.01f;
+        left = (x0 < x1 ? x0 : x1) - margin;
+        right = (x0 < x1 ? x1 : x0) + margin;
+        bottom = (y0 < y1 ? y0 : y1) - margin;
+        top = (y0 < y1 ? y1 : y0) + margin;
+        left = left < -1.0f ? -1.0f : left;
+        bottom = bottom < -1.0f ? -1.0f : bottom;
+        right = right > 1.0f ? 1.0f : right;
+        top = top > 1.0f ? 1.0f : top;
+    }
+
+    _renderCacheBounds[0] = left;
+    _renderCacheBounds[1] = bottom;
+    _renderCacheBounds[2] = right;
+    _renderCacheBounds[3] = top;
+}
+
+bool LAppModel::CompositeRenderCache()
+{
+    if (_renderCacheProgram == 0)
+    {
+        const GLuint vertexShader = CompileRenderCacheShader(GL_VERTEX_SHADER, RenderCacheVertexShader);
+        const GLuint fragmentShader = CompileRenderCacheShader(GL_FRAGMENT_SHADER, RenderCacheFragmentShader);
+        if (vertexShader == 0 || fragmentShader == 0)
+        {
+            glDeleteShader(vertexShader);
+            glDeleteShader(fragmentShader);
+            return false;
+        }
+
+        _renderCacheProgram = glCreateProgram();
+        glAttachShader(_renderCacheProgram, vertexShader);
+        glAttachShader(_renderCacheProgram, fragmentShader);
+        glBindAttribLocation(_renderCacheProgram, 0, "a_position");
+        glBindAttribLocation(_renderCacheProgram, 1, "a_texCoord");
+        glLinkProgram(_renderCacheProgram);
+        glDeleteShader(vertexShader);
+        glDeleteShader(fragmentShader);
+
+        GLint status = GL_FALSE;
+        glGetProgramiv(_renderCacheProgram, GL_LINK_STATUS, &status);
+        if (status == GL_FALSE)
+        {
+            Warn("[RenderCache] failed to link shader");
+            glDeleteProgram(_renderCacheProgram);
+            _renderCacheProgram = 0;
+            return false;
+        }
+
+        glUseProgram(_renderCacheProgram);
+        glUniform1i(glGetUniformLocation(_renderCacheProgram, "s_texture0"), 0);
+    }
+
+    const float left = _renderCacheBounds[0];
+    const float bottom = _renderCacheBounds[1];
+    const float right = _renderCacheBounds[2];
+    const float top = _renderCacheBounds[3];
+    if (left >= right || bottom >= top)
+    {
+        // 何も表示されていない
+        return true;
+    }
+
+    // モデルを囲む部分だけを合成する。キャッシュはビューポートと同じ大きさで下の行から格納されているので、UVは座標をそのまま写す
+    const GLfloat positions[] = {left, bottom, right, bottom, left, top, right, top};
+    const GLfloat uvs[] = {
+        (left + 1.0f) * 0.5f, (bottom + 1.0f) * 0.5f, (right + 1.0f) * 0.5f, (bottom + 1.0f) * 0.5f,
+        (left + 1.0f) * 0.5f, (top + 1.0f) * 0.5f, (right + 1.0f) * 0.5f, (top + 1.0f) * 0.5f};
+
+    glUseProgram(_renderCacheProgram);
+    glBindTexture(GL_TEXTURE_2D, _renderBuffer.GetColorBuffer());
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glEnableVertexAttribArray(0);
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 0, positions);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 0, uvs);
+
+    // キャッシュは透明な背景に通常の合成で描いた乗算済みアルファの画像なので、そのまま重ねれば直接描いた場合と同じになる
+    glDisable(GL_SCISSOR_TEST);
+    glDisable(GL_STENCIL_TEST);
+    glDisable(GL_DEPTH_TEST);
+    glDisable(GL_CULL_FACE);
+    glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+    glEnable(GL_BLEND);
+    glBlendFuncSeparate(GL_ONE, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+
+    return true;
+}
+
 csmBool LAppModel::HitTest(const csmChar *hitAreaName, csmFloat32 x, csmFloat32 y)
 {
     // 透明時は当たり判定なし。
@@ -712,17 +1757,29 @@ void LAppModel::SetRandomExpression()
 
 void LAppModel::ReloadRenderer()
 {
+    _renderCacheValid = false;
+
     DeleteRenderer();
 
     CreateRenderer();
 
+    // コンテキストが変わっていれば、元のコンテキストのテクスチャは使えない
+    _textureManager.ReleaseOtherContextTextures();
     SetupTextures();
 }
 
 void LAppModel::SetupTextures()
 {
+    // 読み込み時にワーカーでデコード済みならそれを転送するだけにする
+    const bool decoded = static_cast<csmInt32>(_decodedTextures.size()) == _modelSetting->GetTextureCount();
+
     for (csmInt32 modelTextureNumber = 0; modelTextureNumber < _modelSetting->GetTextureCount(); modelTextureNumber++)
     {
+        if (decoded)
+        {
+            AdvanceLoadProgress();
+        }
+
         // テクスチャ名が空文字だった場合はロード・バインド処理をスキップ
         if (strcmp(_modelSetting->GetTextureFileName(modelTextureNumber), "") == 0)
         {
@@ -733,13 +1790,26 @@ void LAppModel::SetupTextures()
         csmString texturePath = _modelSetting->GetTextureFileName(modelTextureNumber);
         texturePath = _modelHomeDir + texturePath;
 
-        LAppTextureManager::TextureInfo *texture = _textureManager.CreateTextureFromPngFile(texturePath.GetRawString());
+        LAppTextureManager::TextureInfo *texture;
+        if (decoded && _decodedTextures[modelTextureNumber].pixels != NULL)
+        {
+            texture = _textureManager.CreateTextureFromDecodedImage(texturePath.GetRawString(),
+                                                                   _decodedTextures[modelTextureNumber]);
+            _textureManager.ReleaseDecodedImage(_decodedTextures[modelTextureNumber]);
+        }
+        else
+        {
+            texture = _textureManager.CreateTextureFromPngFile(texturePath.GetRawString());
+        }
         const csmInt32 glTextueNumber = texture->id;
 
         // OpenGL
         GetRenderer<Rendering::CubismRenderer_OpenGLES2>()->BindTexture(modelTextureNumber, glTextueNumber);
     }
 
+    _decodedTextures.clear();
+    _texturePaths.clear();
+
 #ifdef PREMULTIPLIED_ALPHA_ENABLE
     GetRenderer<Rendering::CubismRenderer_OpenGLES2>()->IsPremultipliedAlpha(true);
 #else
@@ -811,6 +1881,230 @@ void LAppModel::SetAutoBlinkEnable(bool enable)
     _autoBlink = enable;
 }
 
+void LAppModel::SetMotionBaking(float sampleRate, float maxError)
+{
+    _motionBakeRate = sampleRate;
+    _motionBakeMaxError = maxError;
+
+    csmInt32 bakedCurves = 0;
+    csmSizeInt bakedSize = 0;
+    csmFloat32 bakedMaxError = 0.0f;
+
+    for (csmMap<csmString, ACubismMotion *>::const_iterator iter = _motions.Begin(); iter != _motions.End(); ++iter)
+    {
+        CubismMotion *motion = static_cast<CubismMotion *>(iter->Second);
+
+        if (sampleRate <= 0.0f)
+        {
+            motion->ReleaseBakedData();
+            continue;
+        }
+
+        bakedCurves += motion->Bake(sampleRate, maxError);
+        bakedSize += motion->GetBakedDataSize();
+        if (motion->GetBakedMaxError() > bakedMaxError)
+        {
+            bakedMaxError = motion->GetBakedMaxError();
+        }
+    }
+
+    // 焼き込みデータの増減をキャッシュの使用量に反映
+    for (csmMap<csmString, ACubismMotion *>::const_iterator iter = _motions.Begin(); iter != _motions.End(); ++iter)
+    {
+        if (_motionCacheEntries.count(iter->First.GetRawString()) > 0)
+        {
+            CacheMotion(iter->First.GetRawString(), static_cast<CubismMotion *>(iter->Second));
+        }
+    }
+    EvictMotions();
+
+    if (sampleRate > 0.0f)
+    {
+        // 焼き込みによるメモリ増加量と実測誤差を報告
+        Info("bake motions: %d curves, %.1f KB, max error %f (%s)", bakedCurves, bakedSize / 1024.0f,
+             bakedMaxError, _modelHomeDir.GetRawString());
+    }
+}
+
+void LAppModel::SetMotionCachePolicy(bool lazy, size_t budgetBytes)
+{
+    _lazyMotionLoading = lazy;
+    _motionCacheBudget = budgetBytes;
+
+    EvictMotions();
+}
+
+void LAppModel::PrefetchMotionGroup(const csmChar *group)
+{
+    if (_modelSetting == NULL)
+    {
+        return;
+    }
+
+    // 前回の先読みの終了を待ち、読み終えた分は捨てずにキャッシュに取り込む
+    if (_prefetchThread.joinable())
+    {
+        _prefetchThread.join();
+    }
+    AdoptPrefetchedMotions();
+
+    // 設定の参照は呼び出しスレッドで済ませ、ワーカーにはファイル読み込みとパースだけを任せる
+    std::vector<MotionLoadJob> jobs;
+    const csmInt32 count = _modelSetting->GetMotionCount(group);
+    for (csmInt32 i = 0; i < count; i++)
+    {
+        if (strlen(_modelSetting->GetMotionFileName(group, i)) == 0)
+        {
+            continue;
+        }
+
+        MotionLoadJob job = MakeMotionLoadJob(group, i);
+        if (!_motions.IsExist(job.name.c_str()))
+        {
+            jobs.push_back(job);
+        }
+    }
+
+    if (jobs.empty())
+    {
+        return;
+    }
+
+    _prefetchThread = std::thread([this, jobs]() {
+        for (size_t i = 0; i < jobs.size(); i++)
+        {
+            CubismMotion *motion = LoadMotionJob(jobs[i]);
+            if (motion)
+            {
+                std::lock_guard<std::mutex> lock(_prefetchMutex);
+                _prefetchedMotions.push_back(std::make_pair(jobs[i].name, motion));
+            }
+        }
+    });
+}
+
+Rendering::CubismRenderer_OpenGLES2::DrawStatistics LAppModel::GetDrawStatistics()
+{
+    Rendering::CubismRenderer_OpenGLES2* renderer = GetRenderer<Rendering::CubismRenderer_OpenGLES2>();
+    if (renderer == NULL)
+    {
+        Rendering::CubismRenderer_OpenGLES2::DrawStatistics empty = {};
+        return empty;
+    }
+
+    return renderer->GetDrawStatistics();
+}
+
+void LAppModel::SetRenderCacheEnable(bool enable)
+{
+    _renderCacheEnabled = enable;
+    _renderCacheValid = false;
+    UpdateRenderCacheBypass();
+    if (!enable)
+    {
+        _renderBuffer.DestroyOffscreenSurface();
+    }
+}
+
+bool LAppModel::IsRenderCacheEnabled() const
+{
+    return _renderCacheEnabled && !_renderCacheBypassed;
+}
+
+void LAppModel::UpdateRenderCacheBypass()
+{
+    _renderCacheBypassed = false;
+    if (_model == NULL)
+    {
+        return;
+    }
+
+    // 乗算ブレンドは描画先の色を使うので、透明なキャッシュに描いてから合成すると結果が変わる
+    for (csmInt32 i = 0; i < _model->GetDrawableCount(); ++i)
+    {
+        if (_model->GetDrawableBlendMode(i) == Rendering::CubismRenderer::CubismBlendMode_Multiplicative)
+        {
+            _renderCacheBypassed = true;
+            return;
+        }
+    }
+}
+
+void LAppModel::InvalidateRenderCache()
+{
+    _renderCacheValid = false;
+}
+
+void LAppModel::GetRenderCacheStats(unsigned long long &hits, unsigned long long &misses) const
+{
+    hits = _renderCacheHits;
+    misses = _renderCacheMisses;
+}
+
+void LAppModel::GetCoreUpdateStats(unsigned long long &performed, unsigned long long &skipped) const
+{
+    if (_model == NULL)
+    {
+        performed = 0;
+        skipped = 0;
+        return;
+    }
+
+    performed = _model->GetCoreUpdateCount();
+    skipped = _model->GetSkippedCoreUpdateCount();
+}
+
+void LAppModel::GetMotionCacheStats(unsigned long long &hits, unsigned long long &misses,
+                                    unsigned long long &evictions, size_t &residentBytes, int &residentCount) const
+{
+    hits = _motionCacheHits;
+    misses = _motionCacheMisses;
+    evictions = _motionCacheEvictions;
+    residentBytes = _motionCacheBytes;
+    residentCount = static_cast<int>(_motionCacheEntries.size());
+}
+
+void LAppModel::AdoptPrefetchedMotions()
+{
+    std::vector<std::pair<std::string, CubismMotion *>> motions;
+    {
+        std::lock_guard<std::mutex> lock(_prefetchMutex);
+        if (_prefetchedMotions.empty())
+        {
+            return;
+        }
+        motions.swap(_prefetchedMotions);
+    }
+
+    for (size_t i = 0; i < motions.size(); i++)
+    {
+        if (_motions.IsExist(motions[i].first.c_str()))
+        {
+            // 先読み中に StartMotion で読み込まれていた
+            ACubismMotion::Delete(motions[i].second);
+            continue;
+        }
+        CacheMotion(motions[i].first, motions[i].second);
+    }
+
+    EvictMotions();
+}
+
+void LAppModel::JoinPrefetch()
+{
+    if (_prefetchThread.joinable())
+    {
+        _prefetchThread.join();
+    }
+
+    std::lock_guard<std::mutex> lock(_prefetchMutex);
+    for (size_t i = 0; i < _prefetchedMotions.size(); i++)
+    {
+        ACubismMotion::Delete(_prefetchedMotions[i].second);
+    }
+    _prefetchedMotions.clear();
+}
+
 int LAppModel::GetParameterCount()
 {
     return _model->GetParameterCount();
@@ -9,13 +9,23 @@
 
 #include <CubismFramework.hpp>
 #include <Model/CubismUserModel.hpp>
+#include <Motion/CubismMotion.hpp>
 #include <ICubismModelSetting.hpp>
 #include <Type/csmRectF.hpp>
 #include <Rendering/OpenGL/CubismOffscreenSurface_OpenGLES2.hpp>
+#include <Rendering/OpenGL/CubismRenderer_OpenGLES2.hpp>
+#include <Rendering/Software/CubismRenderer_Software.hpp>
 
 #include "LAppTextureManager.hpp"
+#include <atomic>
+#include <condition_variable>
 #include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 #include "MatrixManager.hpp"
 
@@ -27,6 +37,36 @@
 class LAppModel : public Csm::CubismUserModel
 {
 public:
+    /**
+     * @brief 非同期読み込みの状態
+     */
+    enum LoadState
+    {
+        LoadState_None,       ///< 読み込みを開始していない
+        LoadState_Loading,    ///< ワーカーでファイル読み込み・パース・デコード中
+        LoadState_Ready,      ///< CPU側の処理が終わり、FinishLoadを待っている
+        LoadState_Finished,   ///< 読み込み完了
+        LoadState_Failed,     ///< 読み込み失敗
+    };
+
+    /**
+     * @brief 読み込み時間を計測する資産の種類
+     */
+    enum LoadCategory
+    {
+        LoadCategory_Setting,         ///< model3.json
+        LoadCategory_Moc,             ///< moc3の読み込みとrevive
+        LoadCategory_Expression,      ///< exp3.json
+        LoadCategory_Physics,         ///< physics3.json
+        LoadCategory_Pose,            ///< pose3.json
+        LoadCategory_UserData,        ///< userdata3.json
+        LoadCategory_Motion,          ///< motion3.json
+        LoadCategory_TextureDecode,   ///< PNGの読み込みとデコード
+        LoadCategory_TextureUpload,   ///< テクスチャの転送（GLスレッド）
+        LoadCategory_Renderer,        ///< レンダラの生成（GLスレッド）
+        LoadCategory_Count,
+    };
+
     /**
      * @brief コンストラクタ
      */
@@ -44,18 +84,123 @@ public:
      */
     void LoadAssets(const Csm::csmChar* fileName);
 
+    /**
+     * @brief モデルの読み込みをバックグラウンドで開始する<br>
+     *         ファイル読み込み、JSONのパース、mocのrevive、PNGのデコードをワーカーで行う。
+     *         GLを使う処理は残しておき、GLスレッドからFinishLoadを呼んで完了させる。
+     *         完了するまでUpdate/Draw以外のモデル操作は行わないこと
+     *
+     * @param[in]   fileName     model3.jsonのパス
+     * @param[in]   workerCount  ワーカー数。0以下ならハードウェアのスレッド数
+     */
+    void LoadAssetsAsync(const Csm::csmChar* fileName, int workerCount = 0);
+
+    /**
+     * @brief バックグラウンド読み込みを完了させる。GLスレッドから呼ぶ
+     *
+     * @param[in]   wait  trueならCPU側の処理が終わるまで待つ。falseなら終わっていない時はすぐに戻る
+     * @return      読み込みが完了（または失敗）していればtrue
+     */
+    bool FinishLoad(bool wait);
+
+    LoadState GetLoadState() const;
+
+    /**
+     * @brief 読み込みの進捗を返す
+     *
+     * @return 0.0〜1.0
+     */
+    float GetLoadProgress() const;
+
+    /**
+     * @brief 資産の種類ごとの読み込み時間[ms]を返す。テクスチャのデコードは各ワーカーでの時間の合計
+     *
+     * @param[out]  timings  LoadCategory_Count個の配列
+     */
+    void GetLoadTimings(double* timings) const;
+
     /**
      * @brief レンダラを再構築する
      *
+     * テクスチャは再デコードせず、読み込み済みのものを再バインドする
      */
     void ReloadRenderer();
 
     /**
      * @brief   モデルの更新処理。モデルのパラメータから描画状態を決定する。
      *
+     * 前回の Update() からの経過時間をモデル自身の時計で計測して Update(deltaTimeSeconds) を呼ぶ。
+     * 初回は経過時間 0 として扱う。
      */
     void Update();
 
+    /**
+     * @brief   指定した時間だけモデルを進める。オフラインでの固定ステップ更新などに使う
+     *
+     * モデルの時計もこの時刻に合わせるため、Update() と混在させても次の Update() はこの呼び出しからの経過時間だけ進める。
+     *
+     * @param[in]  deltaTimeSeconds  経過時間[秒]
+     */
+    void Update(Csm::csmFloat32 deltaTimeSeconds);
+
+    /**
+     * @brief   モデルの経過時間を取得する
+     *
+     * @return  Update で進めた時間の積算値[秒]
+     */
+    Csm::csmFloat32 GetUserTimeSeconds() const;
+
+    /**
+     * @brief   パラメータから描画用の頂点や不透明度を計算する（csmUpdateModel）
+     *
+     * 通常は Draw() の中で行われる。先に呼んでおくと次の Draw() では計算を省略するため、
+     * ワーカースレッドで Update() と合わせて実行できる。
+     */
+    void UpdateDrawables();
+
+    /**
+     * @brief   モデルを複数のスレッドから操作するときに使うロックを取得する
+     *
+     * LAppModel 自体はロックを取らない。呼び出し側が Update / Draw などの前後で保持すること。
+     * モーションのコールバックから同じモデルを操作できるよう再帰ロックにしている。
+     *
+     * @return  このモデルのロック
+     */
+    std::recursive_mutex& GetMutex();
+
+    /**
+     * @brief   Update と Draw をパイプライン化するかを設定する
+     *
+     * 有効にすると Update(deltaTimeSeconds) は直前の更新結果を描画用にコピーしたうえで、
+     * 次のフレームのパラメータ更新と頂点計算をモデル専用のワーカースレッドで開始してすぐに戻る。
+     * Draw() はコピーした結果を描画するため、ワーカーの計算と並行して実行できる。
+     * 表示は 1 フレーム遅れ、モーションのコールバックはワーカースレッドから呼ばれる。
+     *
+     * 更新中に呼んでよいのは Draw() と WaitPendingUpdate() だけで、
+     * それ以外の操作は WaitPendingUpdate() で更新の完了を待ってから行うこと。
+     *
+     * @param[in]  enable  true ならパイプライン化する
+     * @return  設定できたら true。ワーカースレッドで呼ばれるコールバックの中から無効にしようとした場合は、
+     *          ワーカーが自分の終了を待つことになるため何もせずに false を返す
+     */
+    bool SetPipelined(bool enable);
+
+    bool IsPipelined() const;
+
+    /**
+     * @brief   ワーカースレッドで実行中の更新があるか
+     *
+     * ワーカースレッド自身（モーションのコールバック内など）から呼んだ場合は常に false を返す。
+     */
+    bool IsUpdatePending();
+
+    /**
+     * @brief   ワーカースレッドで実行中の更新が終わるまで待つ
+     *
+     * ワーカースレッド自身から呼んだ場合は何もしない。
+     */
+    void WaitPendingUpdate();
+
     /**
      * @brief   モデルを描画する処理。モデルを描画する空間のView-Projection行列を渡す。
      *
@@ -63,6 +208,21 @@ public:
      */
     void Draw();
 
+    /**
+     * @brief   OpenGLを使わず、CPUでモデルを描画する
+     *
+     * Draw() と同じ行列で、呼び出し側が用意したRGBA各8bitのメモリに描く。行は上から下の順。
+     * 描画先の内容に重ねて描くため、必要なら事前にクリアしておく。
+     * 初回の呼び出しでソフトウェアレンダラを作成し、テクスチャをファイルからデコードし直して渡す。
+     * OpenGLを呼ばないため、コンテキストがカレントでなくてもよい。
+     *
+     * @param[in,out]  pixels  描画先
+     * @param[in]      width   幅
+     * @param[in]      height  高さ
+     * @return  描画した場合 true。読み込みが終わっていない場合は false
+     */
+    bool DrawSoftware(Csm::csmUint8* pixels, int width, int height);
+
     /**
      * @brief   引数で指定したモーションの再生を開始する。
      *
@@ -158,6 +318,78 @@ public:
 
     void SetAutoBlinkEnable(bool enable);
 
+    /**
+     * @brief   モーションを固定レートでサンプリングし、再生時は線形補間のみで評価する
+     *
+     * @param[in]   sampleRate  1秒あたりのサンプル数。0以下で焼き込みを解除する
+     * @param[in]   maxError    解析解との許容誤差。超えたカーブは従来通り評価する
+     */
+    void SetMotionBaking(float sampleRate, float maxError);
+
+    /**
+     * @brief   モーションのキャッシュ方針を設定する
+     *
+     * @param[in]   lazy        trueならモデル読み込み時に全モーションを読み込まず、初回のStartMotionで読み込む。LoadAssetsより前に設定する
+     * @param[in]   budgetBytes 保持するモーションの上限バイト数。超えた分は再生中でないものから最も長く使われていない順に解放する。0なら無制限
+     */
+    void SetMotionCachePolicy(bool lazy, size_t budgetBytes);
+
+    /**
+     * @brief   指定グループのモーションをバックグラウンドで読み込む。読み込んだモーションは次のUpdateかStartMotionでキャッシュに入る
+     *
+     * @param[in]   group   モーショングループ名
+     */
+    void PrefetchMotionGroup(const Csm::csmChar* group);
+
+    /**
+     * @brief   直近の Draw() でレンダラが行った処理の統計を取得する。レンダラが無ければ全て0
+     */
+    Csm::Rendering::CubismRenderer_OpenGLES2::DrawStatistics GetDrawStatistics();
+
+    /**
+     * @brief   描画結果のキャッシュを有効にする<br>
+     *           有効にすると、ビューポートと同じ大きさの _renderBuffer にモデルを描画し、それを描画先に合成する。
+     *           パラメータ、パーツの不透明度、乗算色・スクリーン色、MVP行列、ビューポートが前回の描画から変わっていなければ、
+     *           頂点の計算とモデルの描画を省略してキャッシュを合成するだけにする。パイプライン化している間は使わない。<br>
+     *           乗算ブレンドは描画先の色を使うため、透明なキャッシュに描くと結果が変わる。
+     *           乗算ブレンドのDrawableを持つモデルでは有効にしてもキャッシュせず、毎回直接描画する
+     *
+     * @param[in]   enable  trueならキャッシュする。falseにするとキャッシュを破棄する
+     */
+    void SetRenderCacheEnable(bool enable);
+
+    /**
+     * @brief   描画結果をキャッシュしているか。乗算ブレンドのためにキャッシュしていない場合は false
+     */
+    bool IsRenderCacheEnabled() const;
+
+    /**
+     * @brief   次の Draw() でキャッシュを描き直させる。テクスチャやレンダラの設定など、比較していない状態を変えた後に呼ぶ
+     */
+    void InvalidateRenderCache();
+
+    /**
+     * @brief   描画結果のキャッシュの統計を取得する
+     *
+     * @param[out]  hits    キャッシュを合成しただけの Draw() の回数
+     * @param[out]  misses  モデルを描画し直した Draw() の回数
+     */
+    void GetRenderCacheStats(unsigned long long& hits, unsigned long long& misses) const;
+
+    /**
+     * @brief   頂点計算の統計を取得する。パラメータとパーツの不透明度が前回の計算から変わっていなければ計算を省略している
+     *
+     * @param[out]  performed   コアで頂点などを計算した回数
+     * @param[out]  skipped     入力が変わっていないため計算を省略した回数
+     */
+    void GetCoreUpdateStats(unsigned long long& performed, unsigned long long& skipped) const;
+
+    /**
+     * @brief   モーションキャッシュの統計を取得する
+     */
+    void GetMotionCacheStats(unsigned long long& hits, unsigned long long& misses, unsigned long long& evictions,
+                             size_t& residentBytes, int& residentCount) const;
+
     int GetParameterCount();
 
     void GetParameter(int i, const char*& id, int& type, float& value, float& maxValue, float& minValue,
@@ -243,6 +475,84 @@ private:
      */
     void ReleaseMotionGroup(const Csm::csmChar* group) const;
 
+    /**
+     * @brief 読み込みのうちGLを使わない処理。LoadAssetsAsyncではワーカースレッドで実行される
+     *
+     * @param[in]   fileName     model3.jsonのパス
+     * @param[in]   workerCount  テクスチャのデコードに使うスレッド数（呼び出しスレッドを含む）
+     */
+    void LoadCpuAssets(const std::string& fileName, int workerCount);
+
+    /**
+     * @brief デコード待ちのテクスチャを取り出してデコードする。ワーカーから並列に呼ばれる
+     */
+    void DecodePendingTextures();
+
+    /**
+     * @brief 資産の種類ごとの読み込み時間を加算する
+     */
+    void AddLoadTiming(LoadCategory category, double milliseconds);
+
+    /**
+     * @brief 読み込みの進捗を1段階進める
+     */
+    void AdvanceLoadProgress();
+
+    /**
+     * @brief モーション1つ分の読み込み情報。ワーカースレッドでも読み込めるよう、必要な設定を読み込み前に取り出しておく
+     */
+    struct MotionLoadJob
+    {
+        std::string name; ///< ex) idle_0
+        Csm::csmString path; ///< モーションファイルのパス
+        Csm::csmFloat32 fadeInTime;
+        Csm::csmFloat32 fadeOutTime;
+        Csm::csmFloat32 bakeRate;
+        Csm::csmFloat32 bakeMaxError;
+    };
+
+    /**
+     * @brief キャッシュ内のモーションの管理情報
+     */
+    struct MotionCacheEntry
+    {
+        size_t bytes; ///< モーションが保持しているメモリ量
+        unsigned long long lastUsed; ///< 最後に使われた時刻（キャッシュ内の通し番号）
+    };
+
+    MotionLoadJob MakeMotionLoadJob(const Csm::csmChar* group, Csm::csmInt32 no) const;
+
+    Csm::CubismMotion* LoadMotionJob(const MotionLoadJob& job);
+
+    /**
+     * @brief モーションをキャッシュに登録し、保持サイズを計上する
+     */
+    void CacheMotion(const std::string& name, Csm::CubismMotion* motion);
+
+    /**
+     * @brief 上限を超えている間、再生中でないモーションを古い順に解放する
+     */
+    void EvictMotions();
+
+    /**
+     * @brief バックグラウンドで読み込み終えたモーションをキャッシュに取り込む
+     */
+    void AdoptPrefetchedMotions();
+
+    /**
+     * @brief バックグラウンド読み込みの終了を待ち、取り込まれていないモーションを破棄する。モデルの破棄時だけに使う
+     */
+    void JoinPrefetch();
+
+    /**
+     * @brief   モーションファイルを読み込む。<br>
+     *           同じ場所にコンパイル済みモーション(.motion3.bin)があれば、そちらをマップして使う。
+     *
+     * @param[in]   path  .motion3.jsonのパス
+     * @return      読み込んだモーション。失敗時はNULL
+     */
+    Csm::CubismMotion* LoadMotionFile(const Csm::csmString& path);
+
     /**
      * @brief すべてのモーションデータの解放
      *
@@ -257,9 +567,66 @@ private:
      */
     void ReleaseExpressions();
 
+    /**
+     * @brief   指定した時間だけモデルを進め、モデルの時計を更新時刻に合わせる。Update() と Update(deltaTimeSeconds) の共通部分
+     *
+     * @param[in]  deltaTimeSeconds  経過時間[秒]
+     * @param[in]  updateTime        更新時刻[秒]。次の Update() はこの時刻からの経過時間で進める
+     */
+    void Update(Csm::csmFloat32 deltaTimeSeconds, double updateTime);
+
+    /**
+     * @brief   パラメータの更新処理。Update(deltaTimeSeconds) の本体
+     */
+    void UpdateParameters(Csm::csmFloat32 deltaTimeSeconds);
+
+    /**
+     * @brief   キャッシュを使って描画する。Draw() の本体
+     *
+     * @return  キャッシュを使えなかった場合false。その場合は何も描画していない
+     */
+    bool DrawWithRenderCache();
+
+    /**
+     * @brief   乗算ブレンドのDrawableがあるかを調べて、キャッシュを使わないかを決める
+     */
+    void UpdateRenderCacheBypass();
+
+    /**
+     * @brief   描画結果を左右する入力を1つの配列に集める
+     *
+     * @param[in]   mvp         描画に使うMVP行列
+     * @param[in]   viewport    描画先のビューポート
+     * @param[out]  inputs      集めた値の書き込み先
+     */
+    void CollectRenderCacheInputs(Csm::CubismMatrix44& mvp, const GLint* viewport, std::vector<float>& inputs);
+
+    /**
+     * @brief   表示されているDrawableの頂点を囲む矩形を正規化デバイス座標で求め、_renderCacheBounds に書き込む
+     */
+    void UpdateRenderCacheBounds(Csm::CubismMatrix44& mvp);
+
+    /**
+     * @brief   _renderBuffer のうち _renderCacheBounds の範囲を現在のビューポートに乗算済みアルファで合成する
+     *
+     * @return  シェーダを用意できなかった場合false
+     */
+    bool CompositeRenderCache();
+
+    /**
+     * @brief   パイプライン更新用ワーカースレッドの処理
+     */
+    void PipelineWorker();
+
+    /**
+     * @brief   パイプライン更新用ワーカースレッドを終了させる
+     */
+    void StopPipeline();
+
     Csm::ICubismModelSetting* _modelSetting; ///< モデルセッティング情報
     Csm::csmString _modelHomeDir; ///< モデルセッティングが置かれたディレクトリ
     Csm::csmFloat32 _userTimeSeconds; ///< デルタ時間の積算値[秒]
+    double _lastUpdateTime; ///< 前回 Update() を呼んだ時刻[秒]。未更新なら負
     Csm::csmVector<Csm::CubismIdHandle> _eyeBlinkIds; ///< モデルに設定されたまばたき機能用パラメータID
     Csm::csmVector<Csm::CubismIdHandle> _lipSyncIds; ///< モデルに設定されたリップシンク機能用パラメータID
     Csm::csmMap<Csm::csmString, Csm::ACubismMotion*> _motions; ///< 読み込まれているモーションのリスト
@@ -283,5 +650,54 @@ private:
     bool _autoBreath;
     bool _autoBlink;
 
+    float _motionBakeRate; ///< モーション焼き込みのサンプルレート。0以下なら無効
+    float _motionBakeMaxError; ///< モーション焼き込みの許容誤差
+
+    bool _lazyMotionLoading; ///< モーションを初回再生時に読み込むか
+    size_t _motionCacheBudget; ///< 保持するモーションの上限バイト数。0なら無制限
+    size_t _motionCacheBytes; ///< キャッシュ内のモーションの合計バイト数
+    unsigned long long _motionCacheClock;
+    unsigned long long _motionCacheHits;
+    unsigned long long _motionCacheMisses;
+    unsigned long long _motionCacheEvictions;
+    std::unordered_map<std::string, MotionCacheEntry> _motionCacheEntries; ///< _motions と同じキーで管理情報を保持
+
+    std::thread _prefetchThread; ///< モーションのバックグラウンド読み込み
+    std::mutex _prefetchMutex;
+    std::vector<std::pair<std::string, Csm::CubismMotion*>> _prefetchedMotions; ///< 読み込み済みでキャッシュ未登録のモーション
+
+    std::thread _loadThread; ///< 非同期読み込み
+    std::atomic<int> _loadState; ///< LoadState
+    std::atomic<int> _loadStepsDone; ///< 読み込み済みの段階数
+    std::atomic<int> _loadStepsTotal; ///< 読み込みの総段階数。model3.jsonを読むまでは0
+    mutable std::mutex _loadMutex; ///< _loadTimings の保護
+    double _loadTimings[LoadCategory_Count]; ///< 資産の種類ごとの読み込み時間[ms]
+    std::vector<std::string> _texturePaths; ///< テクスチャのパス。空文字はスキップする
+    std::vector<LAppTextureManager::DecodedImage> _decodedTextures; ///< GLへの転送を待っているテクスチャ
+    std::atomic<int> _nextDecodeTexture; ///< 次にデコードするテクスチャ番号
+    void* _loadContext; ///< 読み込みを始めたときのGLコンテキスト。共有テクスチャのデコードを省けるかの判定に使う
+
+    bool _drawablesUpdated; ///< UpdateDrawables() 済みで Draw() での計算が不要か
+    std::recursive_mutex _mutex; ///< GetMutex() で返すロック
+
+    std::thread _pipelineThread; ///< パイプライン更新用のワーカー。無効時は起動しない
+    std::mutex _pipelineMutex;
+    std::condition_variable _pipelineCondition;
+    bool _pipelineUpdatePending; ///< ワーカーで更新を実行中か
+    bool _pipelineStop; ///< ワーカーの終了要求
+    Csm::csmFloat32 _pipelineDeltaTime; ///< ワーカーに渡す経過時間[秒]
+
+    bool _renderCacheEnabled; ///< 描画結果をキャッシュするか
+    bool _renderCacheValid; ///< _renderBuffer の内容が _renderCacheInputs で描画したものか
+    std::vector<float> _renderCacheInputs; ///< キャッシュを描画した時の入力
+    std::vector<float> _renderCacheScratch; ///< 今回の入力。比較用に毎回使い回す
+    unsigned long long _renderCacheHits;
+    unsigned long long _renderCacheMisses;
+    GLuint _renderCacheProgram; ///< キャッシュを合成するシェーダ。未作成なら0
+    float _renderCacheBounds[4]; ///< キャッシュに描いたDrawableを囲む矩形。正規化デバイス座標の左, 下, 右, 上
+    bool _renderCacheBypassed; ///< 乗算ブレンドのDrawableがあるため、キャッシュせずに描画する
+
+    Csm::Rendering::CubismRenderer_Software* _softwareRenderer; ///< DrawSoftware() 用のレンダラ。未作成ならNULL
+
     int* _tmpOrderedDrawIndices;
 };
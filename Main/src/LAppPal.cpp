@@ -15,8 +15,17 @@
 #include "LAppDefine.hpp"
 
 #include <chrono>
+#include <filesystem>
 #include <Log.hpp>
 
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
 using std::endl;
 using namespace Csm;
 using namespace std;
@@ -69,14 +78,109 @@ void LAppPal::ReleaseBytes(csmByte* byteData)
     delete[] byteData;
 }
 
+csmByte* LAppPal::MapFile(const string filePath, csmSizeInt* outSize)
+{
+#ifdef _WIN32
+    HANDLE file = CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return NULL;
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+    {
+        CloseHandle(file);
+        return NULL;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    CloseHandle(file);
+    if (mapping == NULL)
+    {
+        return NULL;
+    }
+
+    // ビューが残っている間はマッピングも維持されるため、ハンドルはすぐ閉じてよい
+    void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+    if (data == NULL)
+    {
+        return NULL;
+    }
+
+    if (outSize)
+    {
+        *outSize = static_cast<csmSizeInt>(size.QuadPart);
+    }
+#else
+    int fd = open(filePath.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        return NULL;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0)
+    {
+        close(fd);
+        return NULL;
+    }
+
+    void* data = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+    {
+        return NULL;
+    }
+
+    if (outSize)
+    {
+        *outSize = static_cast<csmSizeInt>(st.st_size);
+    }
+#endif
+
+    return static_cast<csmByte*>(data);
+}
+
+void LAppPal::UnmapFile(csmByte* mappedData, csmSizeInt size)
+{
+    if (mappedData == NULL)
+    {
+        return;
+    }
+
+#ifdef _WIN32
+    UnmapViewOfFile(mappedData);
+#else
+    munmap(mappedData, size);
+#endif
+}
+
+string LAppPal::GetCanonicalPath(const string& filePath)
+{
+    std::error_code error;
+    const std::filesystem::path canonicalPath = std::filesystem::weakly_canonical(filePath, error);
+    if (error)
+    {
+        return filePath;
+    }
+    return canonicalPath.generic_string();
+}
+
 csmFloat32  LAppPal::GetDeltaTime()
 {
     return static_cast<csmFloat32>(s_deltaTime);
 }
 
+double LAppPal::GetSystemTimeSeconds()
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
 void LAppPal::UpdateTime()
 {
-    s_currentFrame = std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    s_currentFrame = GetSystemTimeSeconds();
     s_deltaTime = s_currentFrame - s_lastFrame;
     s_lastFrame = s_currentFrame;
 }
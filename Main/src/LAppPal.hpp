@@ -40,6 +40,31 @@ public:
     */
     static void ReleaseBytes(Csm::csmByte* byteData);
 
+    /**
+    * @brief ファイルを読み取り専用でメモリにマップする
+    *
+    * @param[in]   filePath    マップするファイルのパス
+    * @param[out]  outSize     ファイルサイズ
+    * @return                  マップされた先頭アドレス。失敗時は NULL
+    */
+    static Csm::csmByte* MapFile(const std::string filePath, Csm::csmSizeInt* outSize);
+
+    /**
+    * @brief MapFile でマップした領域を解放する
+    *
+    * @param[in]   mappedData  MapFile が返したアドレス
+    * @param[in]   size        マップしたサイズ
+    */
+    static void UnmapFile(Csm::csmByte* mappedData, Csm::csmSizeInt size);
+
+    /**
+    * @brief ファイルを一意に識別するパスを取得する。共有キャッシュのキーに使う
+    *
+    * @param[in]   filePath    ファイルのパス
+    * @return                  シンボリックリンクや相対指定を解決したパス。解決できない場合は filePath
+    */
+    static std::string GetCanonicalPath(const std::string& filePath);
+
     /**
     * @biref   デルタ時間（前回フレームとの差分）を取得する
     *
@@ -48,6 +73,13 @@ public:
     */
     static Csm::csmFloat32 GetDeltaTime();
 
+    /**
+    * @brief   単調増加する現在時刻を取得する
+    *
+    * @return  現在時刻[秒]
+    */
+    static double GetSystemTimeSeconds();
+
     static void UpdateTime();
 
     static void PrintLn(const Csm::csmChar *message);
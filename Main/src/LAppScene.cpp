@@ -0,0 +1,141 @@
+#include "LAppScene.hpp"
+
+#include "LAppModel.hpp"
+#include "LAppPal.hpp"
+#include <algorithm>
+
+using namespace Csm;
+
+namespace
+{
+    // このスレッドでモデルを処理しているシーン
+    thread_local const LAppScene* t_processingScene = NULL;
+
+    /**
+     * @brief スコープの間、このスレッドで処理しているシーンを記録する
+     */
+    class ProcessingSceneGuard
+    {
+    public:
+        explicit ProcessingSceneGuard(const LAppScene* scene)
+            : _previous(t_processingScene)
+        {
+            t_processingScene = scene;
+        }
+
+        ~ProcessingSceneGuard()
+        {
+            t_processingScene = _previous;
+        }
+
+    private:
+        const LAppScene* _previous;
+    };
+}
+
+LAppScene::LAppScene(int threadCount)
+    : _pool(threadCount)
+{
+    _timings.update = 0.0;
+    _timings.updateTotal = 0.0;
+    _timings.draw = 0.0;
+}
+
+LAppScene::~LAppScene()
+{
+}
+
+void LAppScene::AddModel(LAppModel* model)
+{
+    _models.push_back(model);
+    _modelUpdateTimes.push_back(0.0);
+}
+
+bool LAppScene::RemoveModel(LAppModel* model)
+{
+    std::vector<LAppModel*>::iterator it = std::find(_models.begin(), _models.end(), model);
+    if (it == _models.end())
+    {
+        return false;
+    }
+
+    _modelUpdateTimes.erase(_modelUpdateTimes.begin() + (it - _models.begin()));
+    _models.erase(it);
+    return true;
+}
+
+int LAppScene::GetModelCount() const
+{
+    return static_cast<int>(_models.size());
+}
+
+LAppModel* LAppScene::GetModel(int index) const
+{
+    return _models[index];
+}
+
+int LAppScene::GetThreadCount() const
+{
+    return _pool.GetThreadCount();
+}
+
+void LAppScene::Update(csmFloat32 deltaTimeSeconds)
+{
+    const double start = LAppPal::GetSystemTimeSeconds();
+
+    _pool.ParallelFor(static_cast<int>(_models.size()), [this, deltaTimeSeconds](int i)
+    {
+        LAppModel* model = _models[i];
+        ProcessingSceneGuard processing(this);
+        std::lock_guard<std::recursive_mutex> lock(model->GetMutex());
+
+        const double modelStart = LAppPal::GetSystemTimeSeconds();
+        if (deltaTimeSeconds < 0.0f)
+        {
+            model->Update();
+        }
+        else
+        {
+            model->Update(deltaTimeSeconds);
+        }
+        model->UpdateDrawables();
+
+        _modelUpdateTimes[i] = (LAppPal::GetSystemTimeSeconds() - modelStart) * 1000.0;
+    });
+
+    _timings.update = (LAppPal::GetSystemTimeSeconds() - start) * 1000.0;
+    _timings.updateTotal = 0.0;
+    for (size_t i = 0; i < _modelUpdateTimes.size(); i++)
+    {
+        _timings.updateTotal += _modelUpdateTimes[i];
+    }
+}
+
+void LAppScene::Draw()
+{
+    const double start = LAppPal::GetSystemTimeSeconds();
+    ProcessingSceneGuard processing(this);
+
+    for (size_t i = 0; i < _models.size(); i++)
+    {
+        std::lock_guard<std::recursive_mutex> lock(_models[i]->GetMutex());
+        _models[i]->Draw();
+    }
+
+    _timings.draw = (LAppPal::GetSystemTimeSeconds() - start) * 1000.0;
+}
+
+const LAppScene::Timings& LAppScene::GetTimings() const
+{
+    return _timings;
+}
+
+double LAppScene::GetModelUpdateTime(int index) const
+{
+    return _modelUpdateTimes[index];
+}
+
+bool LAppScene::IsProcessingOnCurrentThread() const
+{
+    return t_processingScene == this;
+}
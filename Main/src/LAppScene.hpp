@@ -0,0 +1,98 @@
+#pragma once
+
+#include <CubismFramework.hpp>
+
+#include "LAppThreadPool.hpp"
+#include <vector>
+
+class LAppModel;
+
+/**
+ * @brief 複数のモデルをまとめて更新・描画するシーン
+ *
+ * Update() は各モデルの Update と頂点計算（csmUpdateModel）をスレッドプールで並列に行い、
+ * Draw() は呼び出し元のスレッドで順番に描画する。OpenGL の呼び出しは Draw() の中だけで行う。
+ * モデルの所有権は呼び出し側に残る。
+ */
+class LAppScene
+{
+public:
+    /**
+     * @brief 時間計測の結果
+     */
+    struct Timings
+    {
+        double update; ///< Update() 全体の経過時間[ms]
+        double updateTotal; ///< 各モデルの更新時間の合計[ms]
+        double draw; ///< Draw() 全体の経過時間[ms]
+    };
+
+    /**
+     * @brief コンストラクタ
+     *
+     * @param[in]   threadCount     更新に使うスレッド数（呼び出し元を含む）。0以下ならハードウェアのスレッド数
+     */
+    explicit LAppScene(int threadCount = 0);
+
+    ~LAppScene();
+
+    /**
+     * @brief モデルを追加する。描画は追加した順に行う
+     */
+    void AddModel(LAppModel* model);
+
+    /**
+     * @brief モデルを取り除く
+     *
+     * @return  取り除いた場合 true
+     */
+    bool RemoveModel(LAppModel* model);
+
+    int GetModelCount() const;
+
+    LAppModel* GetModel(int index) const;
+
+    int GetThreadCount() const;
+
+    /**
+     * @brief すべてのモデルを並列に更新する
+     *
+     * @param[in]   deltaTimeSeconds    経過時間[秒]。負なら各モデルの時計で計った時間
+     */
+    void Update(Csm::csmFloat32 deltaTimeSeconds = -1.0f);
+
+    /**
+     * @brief すべてのモデルを呼び出し元のスレッドで順に描画する
+     */
+    void Draw();
+
+    /**
+     * @brief 直前の Update / Draw の時間を取得する
+     */
+    const Timings& GetTimings() const;
+
+    /**
+     * @brief 直前の Update でのモデルごとの更新時間を取得する
+     *
+     * @param[in]   index   モデルの番号
+     * @return              更新時間[ms]
+     */
+    double GetModelUpdateTime(int index) const;
+
+    /**
+     * @brief 呼び出し元のスレッドがこのシーンの Update / Draw でモデルを処理している最中か
+     *
+     * モデルのコールバックからシーンを操作しようとしたことの検出に使う。
+     * コールバックはワーカースレッドで呼ばれることもあるため、スレッドごとに記録する
+     */
+    bool IsProcessingOnCurrentThread() const;
+
+private:
+    LAppScene(const LAppScene&);
+    LAppScene& operator=(const LAppScene&);
+
+    LAppThreadPool _pool;
+    std::vector<LAppModel*> _models;
+    std::vector<double> _modelUpdateTimes; ///< モデルごとの更新時間[ms]
+    Timings _timings;
+};
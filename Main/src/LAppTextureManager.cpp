@@ -12,6 +12,12 @@
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
 #include "LAppPal.hpp"
+#include <Rendering/OpenGL/CubismRenderer_OpenGLES2.hpp>
+
+std::map<LAppTextureManager::SharedTextureKey, LAppTextureManager::TextureInfo*> LAppTextureManager::s_sharedTextures;
+std::map<void*, std::vector<GLuint> > LAppTextureManager::s_pendingDeletes;
+std::mutex LAppTextureManager::s_sharedTexturesMutex;
+size_t LAppTextureManager::s_residentTextureBytes = 0;
 
 LAppTextureManager::LAppTextureManager()
 {
@@ -25,75 +31,223 @@ LAppTextureManager::~LAppTextureManager()
 LAppTextureManager::TextureInfo* LAppTextureManager::CreateTextureFromPngFile(std::string fileName)
 {
     //search loaded texture already.
-    for (Csm::csmUint32 i = 0; i < _textures.GetSize(); i++)
+    const std::string key = LAppPal::GetCanonicalPath(fileName);
+    LAppTextureManager::TextureInfo* textureInfo = AcquireTexture(key);
+    if (textureInfo != NULL)
     {
-        if (_textures[i]->fileName == fileName)
-        {
-            return _textures[i];
-        }
+        return textureInfo;
     }
 
-    GLuint textureId;
-    int width, height, channels;
+    DecodedImage image;
+    DecodePngFile(fileName, image);
+
+    textureInfo = UploadTexture(key, image);
+
+    // 解放処理
+    ReleaseDecodedImage(image);
+
+    return textureInfo;
+
+}
+
+bool LAppTextureManager::DecodePngFile(const std::string& fileName, DecodedImage& image)
+{
+    int channels;
     unsigned int size;
-    unsigned char* png;
     unsigned char* address;
 
+    image.pixels = NULL;
+    image.width = 0;
+    image.height = 0;
+
     address = LAppPal::LoadFileAsBytes(fileName, &size);
 
     // png情報を取得する
-    png = stbi_load_from_memory(
+    image.pixels = stbi_load_from_memory(
         address,
         static_cast<int>(size),
-        &width,
-        &height,
+        &image.width,
+        &image.height,
         &channels,
         STBI_rgb_alpha);
+    LAppPal::ReleaseBytes(address);
+
+    if (image.pixels == NULL)
     {
+        return false;
+    }
 
 #ifdef PREMULTIPLIED_ALPHA_ENABLE
-        unsigned int* fourBytes = reinterpret_cast<unsigned int*>(png);
-        for (int i = 0; i < width * height; i++)
+    unsigned int* fourBytes = reinterpret_cast<unsigned int*>(image.pixels);
+    for (int i = 0; i < image.width * image.height; i++)
+    {
+        unsigned char* p = image.pixels + i * 4;
+        fourBytes[i] = Premultiply(p[0], p[1], p[2], p[3]);
+    }
+#endif
+
+    return true;
+}
+
+void LAppTextureManager::ReleaseDecodedImage(DecodedImage& image)
+{
+    if (image.pixels != NULL)
+    {
+        stbi_image_free(image.pixels);
+        image.pixels = NULL;
+    }
+}
+
+LAppTextureManager::TextureInfo* LAppTextureManager::CreateTextureFromDecodedImage(const std::string& fileName,
+                                                                                   const DecodedImage& image)
+{
+    //search loaded texture already.
+    const std::string key = LAppPal::GetCanonicalPath(fileName);
+    LAppTextureManager::TextureInfo* textureInfo = AcquireTexture(key);
+    if (textureInfo != NULL)
+    {
+        return textureInfo;
+    }
+
+    return UploadTexture(key, image);
+}
+
+LAppTextureManager::TextureInfo* LAppTextureManager::AcquireTexture(const std::string& key)
+{
+    DeletePendingTextures();
+
+    void* context = GetCurrentContext();
+    for (Csm::csmUint32 i = 0; i < _textures.GetSize(); i++)
+    {
+        if (_textures[i]->fileName == key && _textures[i]->context == context)
         {
-            unsigned char* p = png + i * 4;
-            fourBytes[i] = Premultiply(p[0], p[1], p[2], p[3]);
+            return _textures[i];
         }
-#endif
     }
 
+    std::lock_guard<std::mutex> lock(s_sharedTexturesMutex);
+    std::map<SharedTextureKey, TextureInfo*>::iterator iter = s_sharedTextures.find(SharedTextureKey(context, key));
+    if (iter == s_sharedTextures.end())
+    {
+        return NULL;
+    }
+
+    ++iter->second->refCount;
+    _textures.PushBack(iter->second);
+    return iter->second;
+}
+
+LAppTextureManager::TextureInfo* LAppTextureManager::UploadTexture(const std::string& key, const DecodedImage& image)
+{
+    GLuint textureId;
+
     // OpenGL用のテクスチャを生成する
     glGenTextures(1, &textureId);
     glBindTexture(GL_TEXTURE_2D, textureId);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, png);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, image.width, image.height, 0, GL_RGBA, GL_UNSIGNED_BYTE, image.pixels);
     glGenerateMipmap(GL_TEXTURE_2D);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
     glBindTexture(GL_TEXTURE_2D, 0);
 
-    // 解放処理
-    stbi_image_free(png);
-    LAppPal::ReleaseBytes(address);
+    // レンダラが覚えているテクスチャのバインドと食い違うため破棄させる
+    Csm::Rendering::CubismRenderer_OpenGLES2::InvalidateStateCache();
 
-    LAppTextureManager::TextureInfo* textureInfo = new LAppTextureManager::TextureInfo();
-    if (textureInfo != NULL)
+    // ミップマップを含めたGLメモリ使用量
+    size_t bytes = 0;
+    for (int width = image.width, height = image.height; width > 0 && height > 0;
+         width = width > 1 ? width / 2 : 1, height = height > 1 ? height / 2 : 1)
     {
-        textureInfo->fileName = fileName;
-        textureInfo->width = width;
-        textureInfo->height = height;
-        textureInfo->id = textureId;
+        bytes += static_cast<size_t>(width) * height * 4;
+        if (width == 1 && height == 1)
+        {
+            break;
+        }
+    }
 
-        _textures.PushBack(textureInfo);
+    LAppTextureManager::TextureInfo* textureInfo = new LAppTextureManager::TextureInfo();
+    textureInfo->fileName = key;
+    textureInfo->width = image.width;
+    textureInfo->height = image.height;
+    textureInfo->id = textureId;
+    textureInfo->bytes = bytes;
+    textureInfo->refCount = 1;
+    textureInfo->context = GetCurrentContext();
+
+    {
+        std::lock_guard<std::mutex> lock(s_sharedTexturesMutex);
+        s_sharedTextures[SharedTextureKey(textureInfo->context, key)] = textureInfo;
+        s_residentTextureBytes += bytes;
     }
 
+    _textures.PushBack(textureInfo);
+
     return textureInfo;
+}
+
+void LAppTextureManager::ReleaseSharedTexture(TextureInfo* texture, bool deleteLater)
+{
+    void* context = GetCurrentContext();
+
+    {
+        std::lock_guard<std::mutex> lock(s_sharedTexturesMutex);
+        if (--texture->refCount > 0)
+        {
+            return;
+        }
 
+        s_sharedTextures.erase(SharedTextureKey(texture->context, texture->fileName));
+        s_residentTextureBytes -= texture->bytes;
+
+        // 別のコンテキストでは同じIDが別のテクスチャを指すため、作成したコンテキストがカレントになるまで削除を待つ
+        if (texture->context != context)
+        {
+            if (deleteLater)
+            {
+                s_pendingDeletes[texture->context].push_back(texture->id);
+            }
+            delete texture;
+            return;
+        }
+    }
+
+    glDeleteTextures(1, &texture->id);
+    Csm::Rendering::CubismRenderer_OpenGLES2::InvalidateStateCache();
+    delete texture;
+}
+
+void LAppTextureManager::DeletePendingTextures()
+{
+    void* context = GetCurrentContext();
+    if (context == NULL)
+    {
+        return;
+    }
+
+    std::vector<GLuint> textureIds;
+    {
+        std::lock_guard<std::mutex> lock(s_sharedTexturesMutex);
+        std::map<void*, std::vector<GLuint> >::iterator iter = s_pendingDeletes.find(context);
+        if (iter == s_pendingDeletes.end())
+        {
+            return;
+        }
+
+        textureIds.swap(iter->second);
+        s_pendingDeletes.erase(iter);
+    }
+
+    glDeleteTextures(static_cast<GLsizei>(textureIds.size()), textureIds.data());
+    Csm::Rendering::CubismRenderer_OpenGLES2::InvalidateStateCache();
 }
 
 void LAppTextureManager::ReleaseTextures()
 {
+    DeletePendingTextures();
+
     for (Csm::csmUint32 i = 0; i < _textures.GetSize(); i++)
     {
-        delete _textures[i];
+        ReleaseSharedTexture(_textures[i]);
     }
 
     _textures.Clear();
@@ -101,13 +255,16 @@ void LAppTextureManager::ReleaseTextures()
 
 void LAppTextureManager::ReleaseTexture(Csm::csmUint32 textureId)
 {
+    DeletePendingTextures();
+
+    void* context = GetCurrentContext();
     for (Csm::csmUint32 i = 0; i < _textures.GetSize(); i++)
     {
-        if (_textures[i]->id != textureId)
+        if (_textures[i]->id != textureId || _textures[i]->context != context)
         {
             continue;
         }
-        delete _textures[i];
+        ReleaseSharedTexture(_textures[i]);
         _textures.Remove(i);
         break;
     }
@@ -115,22 +272,45 @@ void LAppTextureManager::ReleaseTexture(Csm::csmUint32 textureId)
 
 void LAppTextureManager::ReleaseTexture(std::string fileName)
 {
+    DeletePendingTextures();
+
+    const std::string key = LAppPal::GetCanonicalPath(fileName);
+    void* context = GetCurrentContext();
     for (Csm::csmUint32 i = 0; i < _textures.GetSize(); i++)
     {
-        if (_textures[i]->fileName == fileName)
+        if (_textures[i]->fileName == key && _textures[i]->context == context)
         {
-            delete _textures[i];
+            ReleaseSharedTexture(_textures[i]);
             _textures.Remove(i);
             break;
         }
     }
 }
 
+void LAppTextureManager::ReleaseOtherContextTextures()
+{
+    DeletePendingTextures();
+
+    void* context = GetCurrentContext();
+    for (Csm::csmUint32 i = 0; i < _textures.GetSize();)
+    {
+        if (_textures[i]->context == context)
+        {
+            i++;
+            continue;
+        }
+        // 元のコンテキストは破棄されているため削除待ちにはしない
+        ReleaseSharedTexture(_textures[i], false);
+        _textures.Remove(i);
+    }
+}
+
 LAppTextureManager::TextureInfo* LAppTextureManager::GetTextureInfoById(GLuint textureId) const
 {
+    void* context = GetCurrentContext();
     for (Csm::csmUint32 i = 0; i < _textures.GetSize(); i++)
     {
-        if (_textures[i]->id == textureId)
+        if (_textures[i]->id == textureId && _textures[i]->context == context)
         {
             return _textures[i];
         }
@@ -138,3 +318,28 @@ LAppTextureManager::TextureInfo* LAppTextureManager::GetTextureInfoById(GLuint t
 
     return NULL;
 }
+
+bool LAppTextureManager::IsTextureCached(const std::string& fileName, void* context)
+{
+    const std::string key = LAppPal::GetCanonicalPath(fileName);
+    std::lock_guard<std::mutex> lock(s_sharedTexturesMutex);
+    return s_sharedTextures.find(SharedTextureKey(context, key)) != s_sharedTextures.end();
+}
+
+void* LAppTextureManager::GetCurrentContext()
+{
+    // レンダラがステートの写しを区別するのと同じ方法で取得する
+    return Csm::Rendering::CubismRenderer_OpenGLES2::GetCurrentContext();
+}
+
+int LAppTextureManager::GetResidentTextureCount()
+{
+    std::lock_guard<std::mutex> lock(s_sharedTexturesMutex);
+    return static_cast<int>(s_sharedTextures.size());
+}
+
+size_t LAppTextureManager::GetResidentTextureBytes()
+{
+    std::lock_guard<std::mutex> lock(s_sharedTexturesMutex);
+    return s_residentTextureBytes;
+}
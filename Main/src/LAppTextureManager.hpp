@@ -7,7 +7,11 @@
 
 #pragma once
 
+#include <map>
+#include <mutex>
 #include <string>
+#include <utility>
+#include <vector>
 #ifndef CSM_TARGET_ANDROID_ES2
 #include <GL/glew.h>
 #else
@@ -20,6 +24,12 @@
 * @brief テクスチャ管理クラス
 *
 * 画像読み込み、管理を行うクラス。
+* テクスチャはプロセス全体で共有され、同じ画像ファイルを使うモデル間では一度だけデコード・転送する。
+* テクスチャIDはGLコンテキストごとの名前なので、共有はテクスチャを作成したときのカレントコンテキストが同じモデル間に限る。
+* コンテキスト同士がテクスチャを共有する設定（共有グループ）でも、別のコンテキストではそれぞれ転送する。
+* 各インスタンスは自分が使っているテクスチャへの参照を持ち、最後の参照が外れた時にGLのテクスチャを解放する。
+* 最後の参照が作成時と別のコンテキスト（またはコンテキストなし）で外れた場合は削除待ちにして、
+* 次にそのコンテキストがカレントの状態でテクスチャ管理の関数が呼ばれた時に削除する。
 */
 class LAppTextureManager
 {
@@ -33,7 +43,20 @@ public:
         GLuint id;              ///< テクスチャID
         int width;              ///< 横幅
         int height;             ///< 高さ
-        std::string fileName;   ///< ファイル名
+        std::string fileName;   ///< ファイル名（正規化したパス）
+        size_t bytes;           ///< GLメモリ使用量（ミップマップを含む）
+        int refCount;           ///< このテクスチャを使っているLAppTextureManagerの数
+        void* context;          ///< テクスチャを作成したGLコンテキスト
+    };
+
+    /**
+    * @brief デコード済み画像構造体
+    */
+    struct DecodedImage
+    {
+        unsigned char* pixels;  ///< RGBAピクセル。失敗時はNULL
+        int width;              ///< 横幅
+        int height;             ///< 高さ
     };
 
     /**
@@ -76,6 +99,35 @@ public:
     */
     TextureInfo* CreateTextureFromPngFile(std::string fileName);
 
+    /**
+    * @brief 画像のデコード
+    *
+    * ファイルの読み込みとPNGのデコードだけを行う。OpenGLを呼ばないため任意のスレッドから呼べる
+    *
+    * @param[in] fileName  読み込む画像ファイルパス名
+    * @param[out] image  デコードした画像。ReleaseDecodedImageで解放する
+    * @return 成功したらtrue
+    */
+    bool DecodePngFile(const std::string& fileName, DecodedImage& image);
+
+    /**
+    * @brief デコード済み画像の解放
+    *
+    * @param[in] image  解放する画像
+    */
+    void ReleaseDecodedImage(DecodedImage& image);
+
+    /**
+    * @brief デコード済み画像からテクスチャを生成する
+    *
+    * OpenGLのコンテキストがあるスレッドから呼ぶ。同じファイル名のテクスチャが既にあればそれを返す
+    *
+    * @param[in] fileName  画像ファイルパス名
+    * @param[in] image  DecodePngFileでデコードした画像
+    * @return 画像情報。読み込み失敗時はNULLを返す
+    */
+    TextureInfo* CreateTextureFromDecodedImage(const std::string& fileName, const DecodedImage& image);
+
     /**
     * @brief 画像の解放
     *
@@ -99,6 +151,14 @@ public:
     **/
     void ReleaseTexture(std::string fileName);
 
+    /**
+    * @brief カレントコンテキスト以外で作成したテクスチャへの参照を外す
+    *
+    * コンテキストを作り直した後のレンダラの再作成で使う。
+    * 元のコンテキストのテクスチャはそのコンテキストと一緒に破棄されるため、GLのテクスチャは削除しない
+    **/
+    void ReleaseOtherContextTextures();
+
     /**
      * @brief テクスチャIDからテクスチャ情報を得る
      *
@@ -107,6 +167,67 @@ public:
      */
     TextureInfo* GetTextureInfoById(GLuint textureId) const;
 
+    /**
+     * @brief 共有キャッシュにテクスチャがあるか
+     *
+     * 任意のスレッドから呼べる。読み込み時にデコードを省けるかの判定に使う
+     * @param[in] fileName  画像ファイルパス名
+     * @param[in] context  テクスチャを使うGLコンテキスト（GetCurrentContextで得た値）
+     */
+    static bool IsTextureCached(const std::string& fileName, void* context);
+
+    /**
+     * @brief 呼び出したスレッドのカレントGLコンテキスト。なければNULL
+     */
+    static void* GetCurrentContext();
+
+    /**
+     * @brief カレントコンテキストで削除待ちになっているテクスチャを削除する
+     *
+     * テクスチャの作成・解放の際にも呼ばれる。コンテキストを破棄する前に呼んでおく
+     */
+    static void DeletePendingTextures();
+
+    /**
+     * @brief 共有キャッシュ内のテクスチャ数
+     */
+    static int GetResidentTextureCount();
+
+    /**
+     * @brief 共有キャッシュ内のテクスチャが使っているGLメモリの合計バイト数
+     */
+    static size_t GetResidentTextureBytes();
+
 private:
-    Csm::csmVector<TextureInfo*> _textures;
+    /**
+     * @brief 使用中または共有キャッシュのテクスチャを探し、このインスタンスの参照に加える
+     *
+     * @param[in] key  正規化した画像ファイルパス名
+     * @return 見つからなければNULL
+     */
+    TextureInfo* AcquireTexture(const std::string& key);
+
+    /**
+     * @brief 画像をGLに転送して共有キャッシュに登録する
+     */
+    TextureInfo* UploadTexture(const std::string& key, const DecodedImage& image);
+
+    /**
+     * @brief 共有キャッシュの参照を1つ外し、最後の参照ならGLのテクスチャを解放する
+     *
+     * 作成したコンテキストがカレントでなければ、そのコンテキストの削除待ちに加える
+     *
+     * @param[in] texture  参照を外すテクスチャ
+     * @param[in] deleteLater  作成したコンテキストがカレントでない場合に削除待ちにするか。falseならIDを手放す
+     */
+    static void ReleaseSharedTexture(TextureInfo* texture, bool deleteLater = true);
+
+    Csm::csmVector<TextureInfo*> _textures; ///< このインスタンスが参照しているテクスチャ
+
+    typedef std::pair<void*, std::string> SharedTextureKey; ///< GLコンテキストと正規化したパス
+
+    static std::map<SharedTextureKey, TextureInfo*> s_sharedTextures; ///< コンテキストごとの共有テクスチャ
+    static std::map<void*, std::vector<GLuint> > s_pendingDeletes; ///< コンテキストごとの削除待ちのテクスチャID
+    static std::mutex s_sharedTexturesMutex;
+    static size_t s_residentTextureBytes;
 };
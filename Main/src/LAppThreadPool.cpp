@@ -0,0 +1,157 @@
+#include "LAppThreadPool.hpp"
+
+LAppThreadPool::LAppThreadPool(int threadCount)
+    : _task(nullptr), _generation(0), _remaining(0), _stop(false)
+{
+    if (threadCount <= 0)
+    {
+        threadCount = static_cast<int>(std::thread::hardware_concurrency());
+    }
+    if (threadCount < 1)
+    {
+        threadCount = 1;
+    }
+
+    for (int i = 0; i < threadCount; i++)
+    {
+        _queues.emplace_back(new TaskQueue());
+    }
+
+    for (int i = 1; i < threadCount; i++)
+    {
+        _threads.emplace_back(&LAppThreadPool::WorkerMain, this, i);
+    }
+}
+
+LAppThreadPool::~LAppThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stop = true;
+    }
+    _wake.notify_all();
+
+    for (size_t i = 0; i < _threads.size(); i++)
+    {
+        _threads[i].join();
+    }
+}
+
+int LAppThreadPool::GetThreadCount() const
+{
+    return static_cast<int>(_queues.size());
+}
+
+void LAppThreadPool::ParallelFor(int count, const std::function<void(int)>& task)
+{
+    if (count <= 0)
+    {
+        return;
+    }
+
+    // ワーカーがいなければそのまま実行する
+    if (_threads.empty() || count == 1)
+    {
+        for (int i = 0; i < count; i++)
+        {
+            task(i);
+        }
+        return;
+    }
+
+    // キューに積む前に設定しておく。前回の作業を探しているワーカーが先に取り出すことがあるため
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _task = &task;
+        _remaining.store(count);
+    }
+
+    // 連続した番号をまとめて各キューに割り当てる
+    const int queueCount = static_cast<int>(_queues.size());
+    for (int q = 0; q < queueCount; q++)
+    {
+        std::lock_guard<std::mutex> lock(_queues[q]->mutex);
+        for (int i = count * q / queueCount; i < count * (q + 1) / queueCount; i++)
+        {
+            _queues[q]->indices.push_back(i);
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _generation++;
+    }
+    _wake.notify_all();
+
+    while (RunOne(0))
+    {
+    }
+
+    std::unique_lock<std::mutex> lock(_mutex);
+    _done.wait(lock, [this] { return _remaining.load() == 0; });
+    _task = nullptr;
+}
+
+void LAppThreadPool::WorkerMain(int queueIndex)
+{
+    unsigned long long generation = 0;
+
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _wake.wait(lock, [this, generation] { return _stop || _generation != generation; });
+            if (_stop)
+            {
+                return;
+            }
+            generation = _generation;
+        }
+
+        while (RunOne(queueIndex))
+        {
+        }
+    }
+}
+
+bool LAppThreadPool::RunOne(int queueIndex)
+{
+    const int queueCount = static_cast<int>(_queues.size());
+    int index = -1;
+
+    // 自分のキューは先頭から、他のキューは末尾から取り出す
+    for (int n = 0; n < queueCount && index < 0; n++)
+    {
+        TaskQueue& queue = *_queues[(queueIndex + n) % queueCount];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.indices.empty())
+        {
+            continue;
+        }
+        if (n == 0)
+        {
+            index = queue.indices.front();
+            queue.indices.pop_front();
+        }
+        else
+        {
+            index = queue.indices.back();
+            queue.indices.pop_back();
+        }
+    }
+
+    if (index < 0)
+    {
+        return false;
+    }
+
+    (*_task)(index);
+
+    if (_remaining.fetch_sub(1) == 1)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _done.notify_all();
+    }
+
+    return true;
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief 作業盗用（work stealing）方式のスレッドプール
+ *
+ * ParallelFor で渡した番号をスレッドごとのキューに振り分け、自分のキューが空になったスレッドは
+ * 他のキューの末尾から盗んで実行する。呼び出し元のスレッドも作業に参加する。
+ */
+class LAppThreadPool
+{
+public:
+    /**
+     * @brief コンストラクタ
+     *
+     * @param[in]   threadCount     呼び出し元を含めたスレッド数。0以下ならハードウェアのスレッド数
+     */
+    explicit LAppThreadPool(int threadCount = 0);
+
+    ~LAppThreadPool();
+
+    /**
+     * @brief 呼び出し元を含めたスレッド数を取得する
+     */
+    int GetThreadCount() const;
+
+    /**
+     * @brief 0 から count - 1 までの番号について task を並列に実行し、すべて終わるまで待つ
+     *
+     * 同時に呼べるのは1スレッドのみ。
+     *
+     * @param[in]   count   実行する数
+     * @param[in]   task    番号を受け取って実行する処理
+     */
+    void ParallelFor(int count, const std::function<void(int)>& task);
+
+private:
+    LAppThreadPool(const LAppThreadPool&);
+    LAppThreadPool& operator=(const LAppThreadPool&);
+
+    struct TaskQueue
+    {
+        std::mutex mutex;
+        std::deque<int> indices;
+    };
+
+    void WorkerMain(int queueIndex);
+
+    /**
+     * @brief 自分のキューの先頭、なければ他のキューの末尾から1つ取り出して実行する
+     *
+     * @return  実行した場合 true。どのキューも空なら false
+     */
+    bool RunOne(int queueIndex);
+
+    std::vector<std::thread> _threads;
+    std::vector<std::unique_ptr<TaskQueue>> _queues; ///< 0番は呼び出し元、以降はワーカー
+    std::mutex _mutex;
+    std::condition_variable _wake; ///< 新しい作業の通知
+    std::condition_variable _done; ///< 全作業の完了通知
+    const std::function<void(int)>* _task;
+    unsigned long long _generation; ///< ParallelFor の呼び出しごとに増える
+    std::atomic<int> _remaining; ///< 未完了の作業数
+    bool _stop;
+};
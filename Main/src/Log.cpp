@@ -4,13 +4,20 @@
 
 bool live2dLogEnable = true;
 
-static char buffer[20];
+// 多个线程同时输出日志时各自使用自己的缓冲区
+static thread_local char buffer[20];
 
 const char* currentTime()
 {
     // 2024-11-07 14:05:06
     time_t t = time(nullptr);
-    strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", localtime(&t));
+    struct tm local;
+#ifdef _WIN32
+    localtime_s(&local, &t);
+#else
+    localtime_r(&t, &local);
+#endif
+    strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", &local);
     return buffer;
 }
 
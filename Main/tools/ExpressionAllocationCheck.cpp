@@ -0,0 +1,225 @@
+﻿/**
+ * 表情の再生中に CubismExpressionMotionManager::UpdateMotion がメモリを確保しないことを確認するテスト
+ *
+ * usage: ExpressionAllocationCheck <file.model3.json>...
+ *
+ * モデルの表情を疑似乱数の順に切り替えながら再生し、フレームワークのアロケータ経由の確保を数える。
+ * 表情を開始したフレームはバインドの作成で確保してよいので数えない。
+ * それ以外のフレームで1回でも確保があれば失敗する。表情のないモデルは飛ばす。
+ */
+
+#include <CubismFramework.hpp>
+#include <CubismModelSettingJson.hpp>
+#include <ICubismAllocator.hpp>
+#include <Model/CubismMoc.hpp>
+#include <Model/CubismModel.hpp>
+#include <Motion/CubismExpressionMotion.hpp>
+#include <Motion/CubismExpressionMotionManager.hpp>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "LAppAllocator.hpp"
+#include "LAppPal.hpp"
+
+using namespace Csm;
+
+namespace
+{
+    const csmInt32 FrameCount = 4000;
+    const csmInt32 SwitchInterval = 150;    ///< この間隔ごとに必ず表情を切り替える
+
+    /**
+     * @brief LAppAllocator に委ねつつ、数えている間の確保の回数を記録するアロケータ
+     */
+    class CountingAllocator : public ICubismAllocator
+    {
+    public:
+        CountingAllocator() : counting(false), count(0)
+        {
+        }
+
+        void* Allocate(const csmSizeType size)
+        {
+            if (counting)
+            {
+                ++count;
+            }
+            return static_cast<ICubismAllocator&>(_allocator).Allocate(size);
+        }
+
+        void Deallocate(void* memory)
+        {
+            static_cast<ICubismAllocator&>(_allocator).Deallocate(memory);
+        }
+
+        void* AllocateAligned(const csmSizeType size, const csmUint32 alignment)
+        {
+            if (counting)
+            {
+                ++count;
+            }
+            return static_cast<ICubismAllocator&>(_allocator).AllocateAligned(size, alignment);
+        }
+
+        void DeallocateAligned(void* alignedMemory)
+        {
+            static_cast<ICubismAllocator&>(_allocator).DeallocateAligned(alignedMemory);
+        }
+
+        bool counting;
+        long long count;
+
+    private:
+        LAppAllocator _allocator;
+    };
+
+    CountingAllocator s_allocator;
+
+    CubismExpressionMotion* LoadExpression(const std::string& path)
+    {
+        csmSizeInt size;
+        csmByte* buffer = LAppPal::LoadFileAsBytes(path, &size);
+        if (buffer == NULL)
+        {
+            return NULL;
+        }
+
+        CubismExpressionMotion* expression = CubismExpressionMotion::Create(buffer, size);
+        LAppPal::ReleaseBytes(buffer);
+        return expression;
+    }
+
+    bool CheckModel(const std::string& settingPath)
+    {
+        csmSizeInt size;
+        csmByte* buffer = LAppPal::LoadFileAsBytes(settingPath, &size);
+        if (buffer == NULL)
+        {
+            fprintf(stderr, "failed to read: %s\n", settingPath.c_str());
+            return false;
+        }
+        CubismModelSettingJson setting(buffer, size);
+        LAppPal::ReleaseBytes(buffer);
+
+        if (setting.GetExpressionCount() == 0)
+        {
+            printf("%s: no expressions\n", settingPath.c_str());
+            return true;
+        }
+
+        const std::string directory = settingPath.substr(0, settingPath.find_last_of("/\\") + 1);
+
+        buffer = LAppPal::LoadFileAsBytes(directory + setting.GetModelFileName(), &size);
+        if (buffer == NULL)
+        {
+            fprintf(stderr, "failed to read: %s\n", setting.GetModelFileName());
+            return false;
+        }
+        CubismMoc* moc = CubismMoc::Create(buffer, size);
+        LAppPal::ReleaseBytes(buffer);
+        if (moc == NULL)
+        {
+            fprintf(stderr, "invalid moc: %s\n", setting.GetModelFileName());
+            return false;
+        }
+
+        CubismModel* model = moc->CreateModel();
+        model->SaveParameters();
+
+        bool passed = true;
+        std::vector<CubismExpressionMotion*> expressions;
+        for (csmInt32 i = 0; i < setting.GetExpressionCount(); ++i)
+        {
+            const std::string path = directory + setting.GetExpressionFileName(i);
+            CubismExpressionMotion* expression = LoadExpression(path);
+            if (expression == NULL)
+            {
+                fprintf(stderr, "failed to load: %s\n", path.c_str());
+                passed = false;
+                continue;
+            }
+            expressions.push_back(expression);
+        }
+
+        long long allocations = 0;
+        csmInt32 countedFrames = 0;
+        if (!expressions.empty())
+        {
+            CubismExpressionMotionManager manager;
+            csmUint32 random = 12345;
+            for (csmInt32 frame = 0; frame < FrameCount; ++frame)
+            {
+                random = random * 1103515245u + 12345u;
+                const bool start = frame % SwitchInterval == 0 || (random >> 16) % 97 == 0;
+                if (start)
+                {
+                    manager.StartMotion(expressions[(random >> 8) % expressions.size()], false);
+                }
+
+                // 切り替え中のフェードも通るように、刻みを 0～59 ms で揺らす
+                const csmFloat32 deltaTime = static_cast<csmFloat32>((random >> 8) % 60) / 1000.0f;
+
+                model->LoadParameters();
+
+                s_allocator.counting = !start;
+                const long long before = s_allocator.count;
+                manager.UpdateMotion(model, deltaTime);
+                s_allocator.counting = false;
+
+                if (!start)
+                {
+                    allocations += s_allocator.count - before;
+                    ++countedFrames;
+                }
+            }
+
+            manager.StopAllMotions();
+        }
+
+        if (allocations > 0)
+        {
+            fprintf(stderr, "%lld allocations in %d frames: %s\n", allocations, countedFrames, settingPath.c_str());
+            passed = false;
+        }
+
+        printf("%s: %d expressions, %d frames, %lld allocations\n",
+               settingPath.c_str(), static_cast<int>(expressions.size()), countedFrames, allocations);
+
+        for (size_t i = 0; i < expressions.size(); ++i)
+        {
+            ACubismMotion::Delete(expressions[i]);
+        }
+        moc->DeleteModel(model);
+        CubismMoc::Delete(moc);
+        return passed;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        fprintf(stderr, "usage: %s <file.model3.json>...\n", argv[0]);
+        return 1;
+    }
+
+    CubismFramework::Option option;
+    option.LogFunction = LAppPal::PrintLn;
+    option.LoggingLevel = CubismFramework::Option::LogLevel_Warning;
+    CubismFramework::StartUp(&s_allocator, &option);
+    CubismFramework::Initialize();
+
+    int failed = 0;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (!CheckModel(argv[i]))
+        {
+            ++failed;
+        }
+    }
+
+    CubismFramework::Dispose();
+
+    return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,229 @@
+﻿/**
+ * CubismIdManager の ID の取得が複数のスレッドから同時に呼んでも正しいことを確認するベンチマーク
+ *
+ * usage: IdManagerBench <file.model3.json>...
+ *
+ * モデルを読み込んで ID を登録した後、パラメータ名から GetId で引く時間を1スレッドと複数スレッドで計る。
+ * 続けて、複数のスレッドが同じ新しい名前を同時に登録しながら引き、どのスレッドにも名前ごとに同じ ID が返るかを調べる。
+ * 返った ID が名前と違う、スレッドによって違う、登録数が名前の数と合わない場合は失敗する。
+ */
+
+#include <CubismFramework.hpp>
+#include <CubismModelSettingJson.hpp>
+#include <Id/CubismIdManager.hpp>
+#include <Model/CubismMoc.hpp>
+#include <Model/CubismModel.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "LAppAllocator.hpp"
+#include "LAppPal.hpp"
+
+using namespace Csm;
+
+namespace
+{
+    const csmInt32 LookupCount = 200000;        ///< 1スレッドあたりの GetId の回数
+    const csmInt32 MaxThreadCount = 4;
+    const csmInt32 RegisterNameCount = 5000;    ///< 同時に登録する新しい名前の数
+
+    LAppAllocator s_allocator;
+
+    double GetMilliseconds()
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    /**
+     * @brief モデルを読み込んで、パラメータ名を names に加える。モデルの ID は読み込みで登録される
+     */
+    bool LoadParameterNames(const std::string& settingPath, std::vector<std::string>& names)
+    {
+        csmSizeInt size;
+        csmByte* buffer = LAppPal::LoadFileAsBytes(settingPath, &size);
+        if (buffer == NULL)
+        {
+            fprintf(stderr, "failed to read: %s\n", settingPath.c_str());
+            return false;
+        }
+        CubismModelSettingJson setting(buffer, size);
+        LAppPal::ReleaseBytes(buffer);
+
+        const std::string directory = settingPath.substr(0, settingPath.find_last_of("/\\") + 1);
+
+        buffer = LAppPal::LoadFileAsBytes(directory + setting.GetModelFileName(), &size);
+        if (buffer == NULL)
+        {
+            fprintf(stderr, "failed to read: %s\n", setting.GetModelFileName());
+            return false;
+        }
+        CubismMoc* moc = CubismMoc::Create(buffer, size);
+        LAppPal::ReleaseBytes(buffer);
+        if (moc == NULL)
+        {
+            fprintf(stderr, "invalid moc: %s\n", setting.GetModelFileName());
+            return false;
+        }
+
+        CubismModel* model = moc->CreateModel();
+        for (csmInt32 i = 0; i < model->GetParameterCount(); ++i)
+        {
+            names.push_back(model->GetParameterId(i)->GetString().GetRawString());
+        }
+
+        moc->DeleteModel(model);
+        CubismMoc::Delete(moc);
+        return true;
+    }
+
+    /**
+     * @brief names を順に GetId で引き、名前と違う ID が返った回数を返す
+     */
+    csmInt32 LookupNames(const std::vector<std::string>& names, csmInt32 count)
+    {
+        CubismIdManager* idManager = CubismFramework::GetIdManager();
+        csmInt32 mismatches = 0;
+        for (csmInt32 i = 0; i < count; ++i)
+        {
+            const std::string& name = names[i % names.size()];
+            if (!(idManager->GetId(name.c_str())->GetString() == name.c_str()))
+            {
+                ++mismatches;
+            }
+        }
+        return mismatches;
+    }
+
+    bool CheckLookup(const std::vector<std::string>& names)
+    {
+        csmInt32 mismatches = 0;
+
+        double start = GetMilliseconds();
+        mismatches += LookupNames(names, LookupCount);
+        printf("GetId 1 thread: %.1f ns/lookup\n", (GetMilliseconds() - start) * 1e6 / LookupCount);
+
+        for (csmInt32 threadCount = 2; threadCount <= MaxThreadCount; threadCount *= 2)
+        {
+            std::atomic<csmInt32> threadMismatches(0);
+            std::vector<std::thread> threads;
+            start = GetMilliseconds();
+            for (csmInt32 t = 0; t < threadCount; ++t)
+            {
+                threads.push_back(std::thread([&names, &threadMismatches]
+                {
+                    threadMismatches += LookupNames(names, LookupCount);
+                }));
+            }
+            for (size_t t = 0; t < threads.size(); ++t)
+            {
+                threads[t].join();
+            }
+            printf("GetId %d threads: %.1f ns/lookup per thread\n", threadCount, (GetMilliseconds() - start) * 1e6 / LookupCount);
+            mismatches += threadMismatches;
+        }
+
+        if (mismatches > 0)
+        {
+            fprintf(stderr, "%d lookups returned another id\n", mismatches);
+        }
+        return mismatches == 0;
+    }
+
+    bool CheckConcurrentRegistration()
+    {
+        CubismIdManager* idManager = CubismFramework::GetIdManager();
+        const csmUint32 countBefore = idManager->GetIdCount();
+
+        // 全スレッドが同じ名前を同時に登録する。スレッドごとに登録の順番をずらす
+        std::vector<std::vector<const CubismId*> > results(MaxThreadCount, std::vector<const CubismId*>(RegisterNameCount, NULL));
+        std::vector<std::thread> threads;
+        const double start = GetMilliseconds();
+        for (csmInt32 t = 0; t < MaxThreadCount; ++t)
+        {
+            threads.push_back(std::thread([t, &results, idManager]
+            {
+                char name[64];
+                for (csmInt32 i = 0; i < RegisterNameCount; ++i)
+                {
+                    const csmInt32 index = (i + t * RegisterNameCount / MaxThreadCount) % RegisterNameCount;
+                    snprintf(name, sizeof(name), "IdManagerBench_%d", index);
+                    results[t][index] = idManager->GetId(name);
+                }
+            }));
+        }
+        for (size_t t = 0; t < threads.size(); ++t)
+        {
+            threads[t].join();
+        }
+        const double elapsed = GetMilliseconds() - start;
+
+        csmInt32 mismatches = 0;
+        char name[64];
+        for (csmInt32 i = 0; i < RegisterNameCount; ++i)
+        {
+            snprintf(name, sizeof(name), "IdManagerBench_%d", i);
+            for (csmInt32 t = 0; t < MaxThreadCount; ++t)
+            {
+                if (results[t][i] != results[0][i] || !(results[t][i]->GetString() == name))
+                {
+                    ++mismatches;
+                }
+            }
+        }
+
+        const csmUint32 registered = idManager->GetIdCount() - countBefore;
+        printf("concurrent registration: %d threads, %d names, %u registered, %.3f ms, %d mismatches\n",
+               MaxThreadCount, RegisterNameCount, registered, elapsed, mismatches);
+
+        if (registered != static_cast<csmUint32>(RegisterNameCount))
+        {
+            fprintf(stderr, "registered %u ids for %d names\n", registered, RegisterNameCount);
+            return false;
+        }
+        return mismatches == 0;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        fprintf(stderr, "usage: %s <file.model3.json>...\n", argv[0]);
+        return 1;
+    }
+
+    CubismFramework::Option option;
+    option.LogFunction = LAppPal::PrintLn;
+    option.LoggingLevel = CubismFramework::Option::LogLevel_Warning;
+    CubismFramework::StartUp(&s_allocator, &option);
+    CubismFramework::Initialize();
+
+    int failed = 0;
+    std::vector<std::string> names;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (!LoadParameterNames(argv[i], names))
+        {
+            ++failed;
+        }
+    }
+    printf("%u ids registered by %d models\n", CubismFramework::GetIdManager()->GetIdCount(), argc - 1);
+
+    if (names.empty() || !CheckLookup(names))
+    {
+        ++failed;
+    }
+
+    if (!CheckConcurrentRegistration())
+    {
+        ++failed;
+    }
+
+    CubismFramework::Dispose();
+
+    return failed == 0 ? 0 : 1;
+}
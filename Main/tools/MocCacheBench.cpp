@@ -0,0 +1,253 @@
+﻿/**
+ * CubismMocCache で MOC を共有したときに、モデルごとに MOC を作る場合よりメモリと時間が減ることを確認するベンチマーク
+ *
+ * usage: MocCacheBench <file.model3.json>...
+ *
+ * 同じ MOC からモデルを何体か作り、MOC をモデルごとに作る場合とキャッシュで共有する場合で、
+ * フレームワークのアロケータ経由で確保した量と時間を比べる。
+ * 共有した MOC が1つにならない、共有しても確保量が減らない、全て解放した後にキャッシュに MOC が残る場合は失敗する。
+ */
+
+#include <CubismFramework.hpp>
+#include <CubismModelSettingJson.hpp>
+#include <ICubismAllocator.hpp>
+#include <Model/CubismMoc.hpp>
+#include <Model/CubismMocCache.hpp>
+#include <Model/CubismModel.hpp>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "LAppAllocator.hpp"
+#include "LAppPal.hpp"
+
+using namespace Csm;
+
+namespace
+{
+    const csmInt32 InstanceCount = 8;   ///< 1つの MOC から作るモデルの数
+
+    /**
+     * @brief LAppAllocator に委ねつつ、数えている間に確保したバイト数を記録するアロケータ
+     */
+    class CountingAllocator : public ICubismAllocator
+    {
+    public:
+        CountingAllocator() : counting(false), bytes(0)
+        {
+        }
+
+        void* Allocate(const csmSizeType size)
+        {
+            if (counting)
+            {
+                bytes += size;
+            }
+            return static_cast<ICubismAllocator&>(_allocator).Allocate(size);
+        }
+
+        void Deallocate(void* memory)
+        {
+            static_cast<ICubismAllocator&>(_allocator).Deallocate(memory);
+        }
+
+        void* AllocateAligned(const csmSizeType size, const csmUint32 alignment)
+        {
+            if (counting)
+            {
+                bytes += size;
+            }
+            return static_cast<ICubismAllocator&>(_allocator).AllocateAligned(size, alignment);
+        }
+
+        void DeallocateAligned(void* alignedMemory)
+        {
+            static_cast<ICubismAllocator&>(_allocator).DeallocateAligned(alignedMemory);
+        }
+
+        bool counting;
+        long long bytes;
+
+    private:
+        LAppAllocator _allocator;
+    };
+
+    CountingAllocator s_allocator;
+
+    double GetMilliseconds()
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    /**
+     * @brief MOC ファイルを読み込み、モデルごとに MOC を作る
+     */
+    CubismMoc* CreatePrivateMoc(const std::string& mocPath)
+    {
+        csmSizeInt size;
+        csmByte* buffer = LAppPal::LoadFileAsBytes(mocPath, &size);
+        if (buffer == NULL)
+        {
+            return NULL;
+        }
+        CubismMoc* moc = CubismMoc::Create(buffer, size, true);
+        LAppPal::ReleaseBytes(buffer);
+        return moc;
+    }
+
+    /**
+     * @brief CubismUserModel::LoadModel と同じく、キャッシュに無いときだけ MOC ファイルを読み込んで登録する
+     */
+    CubismMoc* AcquireSharedMoc(const std::string& mocPath)
+    {
+        CubismMocCache* cache = CubismFramework::GetMocCache();
+        CubismMoc* moc = cache->Acquire(mocPath.c_str());
+        if (moc != NULL)
+        {
+            return moc;
+        }
+
+        csmSizeInt size;
+        csmByte* buffer = LAppPal::LoadFileAsBytes(mocPath, &size);
+        if (buffer == NULL)
+        {
+            return NULL;
+        }
+        moc = cache->Register(mocPath.c_str(), buffer, size, true);
+        LAppPal::ReleaseBytes(buffer);
+        return moc;
+    }
+
+    /**
+     * @brief InstanceCount 体のモデルを作って消し、確保したバイト数と時間を返す。作れなければ false
+     */
+    bool CreateInstances(const std::string& mocPath, bool shared, long long& bytes, double& milliseconds, csmInt32& mocCount)
+    {
+        std::vector<CubismMoc*> mocs;
+        std::vector<CubismModel*> models;
+        bool created = true;
+
+        s_allocator.bytes = 0;
+        s_allocator.counting = true;
+        const double start = GetMilliseconds();
+        for (csmInt32 i = 0; i < InstanceCount; ++i)
+        {
+            CubismMoc* moc = shared ? AcquireSharedMoc(mocPath) : CreatePrivateMoc(mocPath);
+            if (moc == NULL)
+            {
+                created = false;
+                break;
+            }
+            mocs.push_back(moc);
+            models.push_back(moc->CreateModel());
+        }
+        milliseconds = GetMilliseconds() - start;
+        s_allocator.counting = false;
+        bytes = s_allocator.bytes;
+
+        mocCount = 0;
+        for (size_t i = 0; i < mocs.size(); ++i)
+        {
+            if (i == 0 || mocs[i] != mocs[i - 1])
+            {
+                ++mocCount;
+            }
+        }
+
+        for (size_t i = 0; i < mocs.size(); ++i)
+        {
+            mocs[i]->DeleteModel(models[i]);
+            if (shared)
+            {
+                CubismFramework::GetMocCache()->Release(mocs[i]);
+            }
+            else
+            {
+                CubismMoc::Delete(mocs[i]);
+            }
+        }
+        return created;
+    }
+
+    bool CheckModel(const std::string& settingPath)
+    {
+        csmSizeInt size;
+        csmByte* buffer = LAppPal::LoadFileAsBytes(settingPath, &size);
+        if (buffer == NULL)
+        {
+            fprintf(stderr, "failed to read: %s\n", settingPath.c_str());
+            return false;
+        }
+        CubismModelSettingJson setting(buffer, size);
+        LAppPal::ReleaseBytes(buffer);
+
+        const std::string directory = settingPath.substr(0, settingPath.find_last_of("/\\") + 1);
+        const std::string mocPath = directory + setting.GetModelFileName();
+
+        long long privateBytes = 0;
+        long long sharedBytes = 0;
+        double privateMilliseconds = 0.0;
+        double sharedMilliseconds = 0.0;
+        csmInt32 privateMocCount = 0;
+        csmInt32 sharedMocCount = 0;
+        if (!CreateInstances(mocPath, false, privateBytes, privateMilliseconds, privateMocCount)
+            || !CreateInstances(mocPath, true, sharedBytes, sharedMilliseconds, sharedMocCount))
+        {
+            fprintf(stderr, "failed to create models: %s\n", setting.GetModelFileName());
+            return false;
+        }
+
+        const csmInt32 cachedCount = CubismFramework::GetMocCache()->GetMocCount();
+        printf("%s: %d instances, private %d mocs %lld KB %.3f ms, shared %d mocs %lld KB %.3f ms, %d cached after release\n",
+               settingPath.c_str(), InstanceCount,
+               privateMocCount, privateBytes / 1024, privateMilliseconds,
+               sharedMocCount, sharedBytes / 1024, sharedMilliseconds, cachedCount);
+
+        bool passed = true;
+        if (sharedMocCount != 1)
+        {
+            fprintf(stderr, "%d instances got %d mocs from the cache\n", InstanceCount, sharedMocCount);
+            passed = false;
+        }
+        if (sharedBytes >= privateBytes)
+        {
+            fprintf(stderr, "sharing allocated %lld bytes, not less than %lld\n", sharedBytes, privateBytes);
+            passed = false;
+        }
+        if (cachedCount != 0)
+        {
+            fprintf(stderr, "%d mocs left in the cache\n", cachedCount);
+            passed = false;
+        }
+        return passed;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        fprintf(stderr, "usage: %s <file.model3.json>...\n", argv[0]);
+        return 1;
+    }
+
+    CubismFramework::Option option;
+    option.LogFunction = LAppPal::PrintLn;
+    option.LoggingLevel = CubismFramework::Option::LogLevel_Warning;
+    CubismFramework::StartUp(&s_allocator, &option);
+    CubismFramework::Initialize();
+
+    int failed = 0;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (!CheckModel(argv[i]))
+        {
+            ++failed;
+        }
+    }
+
+    CubismFramework::Dispose();
+
+    return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,192 @@
+﻿/**
+ * CubismModel の ID からインデックスを引く関数が正しく、線形探索より速いことを確認するベンチマーク
+ *
+ * usage: ModelIndexBench <file.model3.json>...
+ *
+ * 全てのパラメータ、パーツ、Drawable について ID から引いたインデックスが元のインデックスと一致するかを調べる。
+ * モデルに無いパラメータの ID は、何度引いても同じ仮のインデックスが返ることを確認する。
+ * 1つでも一致しなければ失敗する。あわせて以前の線形探索と現在の検索の1回あたりの時間を表示する。
+ */
+
+#include <CubismFramework.hpp>
+#include <CubismModelSettingJson.hpp>
+#include <Id/CubismIdManager.hpp>
+#include <Model/CubismMoc.hpp>
+#include <Model/CubismModel.hpp>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "LAppAllocator.hpp"
+#include "LAppPal.hpp"
+
+using namespace Csm;
+
+namespace
+{
+    const csmInt32 RoundCount = 200;    ///< 時間を計るときに全 ID を引く回数
+
+    LAppAllocator s_allocator;
+
+    double GetMilliseconds()
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    /**
+     * @brief 索引を作る前の GetParameterIndex と同じ線形探索
+     */
+    csmInt32 FindParameterIndexLinear(CubismModel* model, CubismIdHandle parameterId)
+    {
+        const csmInt32 parameterCount = model->GetParameterCount();
+        for (csmInt32 i = 0; i < parameterCount; ++i)
+        {
+            if (model->GetParameterId(i) == parameterId)
+            {
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    bool CheckModel(const std::string& settingPath)
+    {
+        csmSizeInt size;
+        csmByte* buffer = LAppPal::LoadFileAsBytes(settingPath, &size);
+        if (buffer == NULL)
+        {
+            fprintf(stderr, "failed to read: %s\n", settingPath.c_str());
+            return false;
+        }
+        CubismModelSettingJson setting(buffer, size);
+        LAppPal::ReleaseBytes(buffer);
+
+        const std::string directory = settingPath.substr(0, settingPath.find_last_of("/\\") + 1);
+
+        buffer = LAppPal::LoadFileAsBytes(directory + setting.GetModelFileName(), &size);
+        if (buffer == NULL)
+        {
+            fprintf(stderr, "failed to read: %s\n", setting.GetModelFileName());
+            return false;
+        }
+        CubismMoc* moc = CubismMoc::Create(buffer, size);
+        LAppPal::ReleaseBytes(buffer);
+        if (moc == NULL)
+        {
+            fprintf(stderr, "invalid moc: %s\n", setting.GetModelFileName());
+            return false;
+        }
+
+        CubismModel* model = moc->CreateModel();
+        const csmInt32 parameterCount = model->GetParameterCount();
+        const csmInt32 partCount = model->GetPartCount();
+        const csmInt32 drawableCount = model->GetDrawableCount();
+
+        csmInt32 mismatches = 0;
+        std::vector<CubismIdHandle> parameterIds;
+        for (csmInt32 i = 0; i < parameterCount; ++i)
+        {
+            parameterIds.push_back(model->GetParameterId(i));
+            if (model->GetParameterIndex(parameterIds[i]) != i)
+            {
+                fprintf(stderr, "parameter %d: %s\n", i, parameterIds[i]->GetString().GetRawString());
+                ++mismatches;
+            }
+        }
+        for (csmInt32 i = 0; i < partCount; ++i)
+        {
+            if (model->GetPartIndex(model->GetPartId(i)) != i)
+            {
+                fprintf(stderr, "part %d: %s\n", i, model->GetPartId(i)->GetString().GetRawString());
+                ++mismatches;
+            }
+        }
+        std::vector<CubismIdHandle> drawableIds;
+        for (csmInt32 i = 0; i < drawableCount; ++i)
+        {
+            drawableIds.push_back(model->GetDrawableId(i));
+            if (model->GetDrawableIndex(drawableIds[i]) != i)
+            {
+                fprintf(stderr, "drawable %d: %s\n", i, drawableIds[i]->GetString().GetRawString());
+                ++mismatches;
+            }
+        }
+
+        // モデルに無いパラメータは範囲外の仮のインデックスに割り当てられ、以後も同じインデックスが返る
+        CubismIdHandle missingId = CubismFramework::GetIdManager()->GetId("ModelIndexBench_NotExist");
+        const csmInt32 missingIndex = model->GetParameterIndex(missingId);
+        if (missingIndex < parameterCount || model->GetParameterIndex(missingId) != missingIndex)
+        {
+            fprintf(stderr, "missing parameter index: %d\n", missingIndex);
+            ++mismatches;
+        }
+
+        // 結果を使わないと最適化で検索が消えるため合計しておく
+        volatile csmInt32 sink = 0;
+        const double linearStart = GetMilliseconds();
+        for (csmInt32 round = 0; round < RoundCount; ++round)
+        {
+            for (csmInt32 i = 0; i < parameterCount; ++i)
+            {
+                sink = sink + FindParameterIndexLinear(model, parameterIds[i]);
+            }
+        }
+        const double hashedStart = GetMilliseconds();
+        for (csmInt32 round = 0; round < RoundCount; ++round)
+        {
+            for (csmInt32 i = 0; i < parameterCount; ++i)
+            {
+                sink = sink + model->GetParameterIndex(parameterIds[i]);
+            }
+        }
+        const double drawableStart = GetMilliseconds();
+        for (csmInt32 round = 0; round < RoundCount; ++round)
+        {
+            for (csmInt32 i = 0; i < drawableCount; ++i)
+            {
+                sink = sink + model->GetDrawableIndex(drawableIds[i]);
+            }
+        }
+        const double end = GetMilliseconds();
+
+        const double parameterLookups = static_cast<double>(RoundCount) * (parameterCount > 0 ? parameterCount : 1);
+        const double drawableLookups = static_cast<double>(RoundCount) * (drawableCount > 0 ? drawableCount : 1);
+        printf("%s: %d parameters, %d parts, %d drawables, parameter lookup linear %.1f ns, indexed %.1f ns, drawable lookup %.1f ns, %d mismatches\n",
+               settingPath.c_str(), parameterCount, partCount, drawableCount,
+               (hashedStart - linearStart) * 1e6 / parameterLookups, (drawableStart - hashedStart) * 1e6 / parameterLookups,
+               (end - drawableStart) * 1e6 / drawableLookups, mismatches);
+
+        moc->DeleteModel(model);
+        CubismMoc::Delete(moc);
+        return mismatches == 0;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        fprintf(stderr, "usage: %s <file.model3.json>...\n", argv[0]);
+        return 1;
+    }
+
+    CubismFramework::Option option;
+    option.LogFunction = LAppPal::PrintLn;
+    option.LoggingLevel = CubismFramework::Option::LogLevel_Warning;
+    CubismFramework::StartUp(&s_allocator, &option);
+    CubismFramework::Initialize();
+
+    int failed = 0;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (!CheckModel(argv[i]))
+        {
+            ++failed;
+        }
+    }
+
+    CubismFramework::Dispose();
+
+    return failed == 0 ? 0 : 1;
+}
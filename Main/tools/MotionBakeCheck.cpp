@@ -0,0 +1,213 @@
+﻿/**
+ * 焼き込んだモーションが解析的な評価から maxError 以内に収まることを確認するテスト
+ *
+ * usage: MotionBakeCheck <file.model3.json>...
+ *
+ * モデルの全モーションを、焼き込みなしと焼き込みありの2つのモデルで同じ時刻に再生し、
+ * 毎フレームのパラメータ、パーツの不透明度、モデルの不透明度を比較する。
+ * 時刻はサンプル間隔と揃わないように刻む。1つでも maxError を超えれば失敗する。
+ */
+
+#include <CubismFramework.hpp>
+#include <CubismModelSettingJson.hpp>
+#include <Model/CubismMoc.hpp>
+#include <Model/CubismModel.hpp>
+#include <Motion/CubismMotion.hpp>
+#include <Motion/CubismMotionManager.hpp>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#include "LAppAllocator.hpp"
+#include "LAppPal.hpp"
+
+using namespace Csm;
+
+namespace
+{
+    const csmFloat32 SampleRate = 30.0f;
+    const csmFloat32 MaxError = 0.01f;
+    const csmFloat32 DeltaTime = 1.0f / 97.0f;  ///< サンプル間隔 1/30 と揃わない刻み
+    const csmFloat32 MaxPlayTime = 30.0f;       ///< ループするモーションを打ち切る時刻
+    const csmFloat32 Tolerance = 1e-5f;         ///< 浮動小数点の丸め誤差の分
+
+    void IgnoreEvent(const CubismMotionQueueManager* /*caller*/, const csmString& /*eventValue*/, void* /*customData*/)
+    {
+    }
+
+    CubismMotion* LoadMotion(const std::string& path)
+    {
+        csmSizeInt size;
+        csmByte* buffer = LAppPal::LoadFileAsBytes(path, &size);
+        if (buffer == NULL)
+        {
+            return NULL;
+        }
+
+        CubismMotion* motion = CubismMotion::Create(buffer, size);
+        LAppPal::ReleaseBytes(buffer);
+        return motion;
+    }
+
+    csmFloat32 Difference(CubismModel* analytic, CubismModel* baked)
+    {
+        csmFloat32 difference = fabsf(analytic->GetModelOpacity() - baked->GetModelOpacity());
+        for (csmInt32 i = 0; i < analytic->GetParameterCount(); ++i)
+        {
+            difference = fmaxf(difference, fabsf(analytic->GetParameterValue(i) - baked->GetParameterValue(i)));
+        }
+        for (csmInt32 i = 0; i < analytic->GetPartCount(); ++i)
+        {
+            difference = fmaxf(difference, fabsf(analytic->GetPartOpacity(i) - baked->GetPartOpacity(i)));
+        }
+        return difference;
+    }
+
+    /**
+     * @brief 1つのモーションを最後まで再生して、焼き込みによる最大の差を返す。読み込めなければ負
+     */
+    csmFloat32 CheckMotion(CubismModel* analyticModel, CubismModel* bakedModel, const std::string& path, csmInt32& bakedCurves)
+    {
+        CubismMotion* analytic = LoadMotion(path);
+        CubismMotion* baked = LoadMotion(path);
+        if (analytic == NULL || baked == NULL)
+        {
+            ACubismMotion::Delete(analytic);
+            ACubismMotion::Delete(baked);
+            return -1.0f;
+        }
+        bakedCurves = baked->Bake(SampleRate, MaxError);
+
+        CubismMotionManager analyticManager;
+        CubismMotionManager bakedManager;
+        // ユーザーデータのイベントがあるモーションはコールバックを呼ぶ
+        analyticManager.SetEventCallback(IgnoreEvent);
+        bakedManager.SetEventCallback(IgnoreEvent);
+        analyticManager.StartMotionPriority(analytic, false, 1);
+        bakedManager.StartMotionPriority(baked, false, 1);
+
+        csmFloat32 worst = 0.0f;
+        for (csmFloat32 time = 0.0f; time < MaxPlayTime && !analyticManager.IsFinished(); time += DeltaTime)
+        {
+            // LAppModel と同じく、毎フレーム保存した状態から始める
+            analyticModel->LoadParameters();
+            bakedModel->LoadParameters();
+            analyticManager.UpdateMotion(analyticModel, DeltaTime);
+            bakedManager.UpdateMotion(bakedModel, DeltaTime);
+            worst = fmaxf(worst, Difference(analyticModel, bakedModel));
+        }
+
+        analyticManager.StopAllMotions();
+        bakedManager.StopAllMotions();
+        ACubismMotion::Delete(analytic);
+        ACubismMotion::Delete(baked);
+        return worst;
+    }
+
+    bool CheckModel(const std::string& settingPath)
+    {
+        csmSizeInt size;
+        csmByte* buffer = LAppPal::LoadFileAsBytes(settingPath, &size);
+        if (buffer == NULL)
+        {
+            fprintf(stderr, "failed to read: %s\n", settingPath.c_str());
+            return false;
+        }
+        CubismModelSettingJson setting(buffer, size);
+        LAppPal::ReleaseBytes(buffer);
+
+        const std::string directory = settingPath.substr(0, settingPath.find_last_of("/\\") + 1);
+
+        buffer = LAppPal::LoadFileAsBytes(directory + setting.GetModelFileName(), &size);
+        if (buffer == NULL)
+        {
+            fprintf(stderr, "failed to read: %s\n", setting.GetModelFileName());
+            return false;
+        }
+        CubismMoc* moc = CubismMoc::Create(buffer, size);
+        LAppPal::ReleaseBytes(buffer);
+        if (moc == NULL)
+        {
+            fprintf(stderr, "invalid moc: %s\n", setting.GetModelFileName());
+            return false;
+        }
+
+        CubismModel* analyticModel = moc->CreateModel();
+        CubismModel* bakedModel = moc->CreateModel();
+        analyticModel->SaveParameters();
+        bakedModel->SaveParameters();
+
+        bool passed = true;
+        csmFloat32 worst = 0.0f;
+        csmInt32 motionCount = 0;
+        csmInt32 curveCount = 0;
+        for (csmInt32 i = 0; i < setting.GetMotionGroupCount(); ++i)
+        {
+            const csmChar* group = setting.GetMotionGroupName(i);
+            for (csmInt32 j = 0; j < setting.GetMotionCount(group); ++j)
+            {
+                // LAppModel と同じく、ファイルの無いモーションは飛ばす
+                if (strlen(setting.GetMotionFileName(group, j)) == 0)
+                {
+                    continue;
+                }
+
+                const std::string path = directory + setting.GetMotionFileName(group, j);
+                csmInt32 bakedCurves = 0;
+                const csmFloat32 difference = CheckMotion(analyticModel, bakedModel, path, bakedCurves);
+                if (difference < 0.0f)
+                {
+                    fprintf(stderr, "failed to load: %s\n", path.c_str());
+                    passed = false;
+                    continue;
+                }
+                if (difference > MaxError + Tolerance)
+                {
+                    fprintf(stderr, "error %.5f exceeds %.5f: %s\n", difference, MaxError, path.c_str());
+                    passed = false;
+                }
+                worst = fmaxf(worst, difference);
+                curveCount += bakedCurves;
+                ++motionCount;
+            }
+        }
+
+        printf("%s: %d motions, %d baked curves, max error %.5f (bound %.5f)\n",
+               settingPath.c_str(), motionCount, curveCount, worst, MaxError);
+
+        moc->DeleteModel(analyticModel);
+        moc->DeleteModel(bakedModel);
+        CubismMoc::Delete(moc);
+        return passed;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        fprintf(stderr, "usage: %s <file.model3.json>...\n", argv[0]);
+        return 1;
+    }
+
+    LAppAllocator allocator;
+    CubismFramework::Option option;
+    option.LogFunction = LAppPal::PrintLn;
+    option.LoggingLevel = CubismFramework::Option::LogLevel_Warning;
+    CubismFramework::StartUp(&allocator, &option);
+    CubismFramework::Initialize();
+
+    int failed = 0;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (!CheckModel(argv[i]))
+        {
+            ++failed;
+        }
+    }
+
+    CubismFramework::Dispose();
+
+    return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,91 @@
+﻿/**
+ * .motion3.json をコンパイル済みモーション (.motion3.bin) に変換するツール
+ *
+ * usage: MotionCompiler <file.motion3.json>...
+ *
+ * 出力は入力と同じ場所に拡張子 .json を .bin に置き換えて書き出す。
+ * LAppModel は .motion3.json と同じ場所に .motion3.bin があればそちらを読み込む。
+ * .bin には元の .json のサイズとハッシュを記録しており、.json を編集した後の古い .bin は無視される。
+ */
+
+#include <CubismFramework.hpp>
+#include <Motion/CubismMotion.hpp>
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+#include "LAppAllocator.hpp"
+#include "LAppPal.hpp"
+
+using namespace Csm;
+
+namespace
+{
+    bool Compile(const std::string& inputPath)
+    {
+        csmSizeInt size;
+        csmByte* json = LAppPal::LoadFileAsBytes(inputPath, &size);
+        if (json == NULL)
+        {
+            fprintf(stderr, "failed to read: %s\n", inputPath.c_str());
+            return false;
+        }
+
+        csmVector<csmByte> binary;
+        const csmBool converted = CubismMotion::ConvertToBinary(json, size, binary);
+        LAppPal::ReleaseBytes(json);
+
+        if (!converted)
+        {
+            fprintf(stderr, "invalid motion: %s\n", inputPath.c_str());
+            return false;
+        }
+
+        std::string outputPath = inputPath;
+        if (outputPath.size() > 5 && outputPath.compare(outputPath.size() - 5, 5, ".json") == 0)
+        {
+            outputPath.erase(outputPath.size() - 5);
+        }
+        outputPath += ".bin";
+
+        std::ofstream output(outputPath, std::ios::out | std::ios::binary | std::ios::trunc);
+        output.write(reinterpret_cast<const char*>(binary.GetPtr()), binary.GetSize());
+        if (!output)
+        {
+            fprintf(stderr, "failed to write: %s\n", outputPath.c_str());
+            return false;
+        }
+
+        printf("%s -> %s (%u -> %d bytes)\n", inputPath.c_str(), outputPath.c_str(), size, binary.GetSize());
+        return true;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        fprintf(stderr, "usage: %s <file.motion3.json>...\n", argv[0]);
+        return 1;
+    }
+
+    LAppAllocator allocator;
+    CubismFramework::Option option;
+    option.LogFunction = LAppPal::PrintLn;
+    option.LoggingLevel = CubismFramework::Option::LogLevel_Warning;
+    CubismFramework::StartUp(&allocator, &option);
+    CubismFramework::Initialize();
+
+    int failed = 0;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (!Compile(argv[i]))
+        {
+            ++failed;
+        }
+    }
+
+    CubismFramework::Dispose();
+
+    return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,260 @@
+﻿/**
+ * モーションカーブのセグメントを前フレームの位置から探す評価が、毎回探索し直す評価とビット単位で一致することを確認するテスト
+ *
+ * usage: MotionCursorCheck <file.model3.json>...
+ *
+ * モデルの全モーションをループ再生し、同じキューエントリを使い続けるモデルと、
+ * 毎フレーム新しいキューエントリで評価するモデル（セグメントを全体から二分探索する）の2つで同じ時刻に評価する。
+ * 時刻の刻みは乱数で決め、ときどき再生位置を前後に飛ばす。
+ * パラメータ、パーツの不透明度、モデルの不透明度が1ビットでも違えば失敗する。あわせて両者の評価時間を表示する。
+ */
+
+#include <CubismFramework.hpp>
+#include <CubismModelSettingJson.hpp>
+#include <Model/CubismMoc.hpp>
+#include <Model/CubismModel.hpp>
+#include <Motion/CubismMotion.hpp>
+#include <Motion/CubismMotionQueueEntry.hpp>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#include "LAppAllocator.hpp"
+#include "LAppPal.hpp"
+
+using namespace Csm;
+
+namespace
+{
+    const csmInt32 FrameCount = 3000;       ///< 1つのモーションを評価するフレーム数
+    const csmInt32 SeekInterval = 97;       ///< 再生位置を飛ばす間隔の目安（フレーム）
+    const csmFloat32 MaxDeltaTime = 0.1f;   ///< 1フレームの刻みの上限 [秒]
+
+    LAppAllocator s_allocator;
+
+    double GetMilliseconds()
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    /**
+     * @brief 再現できるように固定の種から作る線形合同法の乱数。[0, 1) を返す
+     */
+    csmFloat32 NextRandom(csmUint32& state)
+    {
+        state = state * 1103515245u + 12345u;
+        return static_cast<csmFloat32>((state >> 8) & 0xFFFF) / 65536.0f;
+    }
+
+    CubismMotion* LoadMotion(const std::string& path)
+    {
+        csmSizeInt size;
+        csmByte* buffer = LAppPal::LoadFileAsBytes(path, &size);
+        if (buffer == NULL)
+        {
+            return NULL;
+        }
+
+        CubismMotion* motion = CubismMotion::Create(buffer, size);
+        LAppPal::ReleaseBytes(buffer);
+        return motion;
+    }
+
+    bool SameBits(csmFloat32 a, csmFloat32 b)
+    {
+        return memcmp(&a, &b, sizeof(csmFloat32)) == 0;
+    }
+
+    /**
+     * @brief 2つのモデルの値がビット単位で違う箇所の数を返す
+     */
+    csmInt32 CountMismatches(CubismModel* cursorModel, CubismModel* searchModel)
+    {
+        csmInt32 mismatches = SameBits(cursorModel->GetModelOpacity(), searchModel->GetModelOpacity()) ? 0 : 1;
+        for (csmInt32 i = 0; i < cursorModel->GetParameterCount(); ++i)
+        {
+            if (!SameBits(cursorModel->GetParameterValue(i), searchModel->GetParameterValue(i)))
+            {
+                ++mismatches;
+            }
+        }
+        for (csmInt32 i = 0; i < cursorModel->GetPartCount(); ++i)
+        {
+            if (!SameBits(cursorModel->GetPartOpacity(i), searchModel->GetPartOpacity(i)))
+            {
+                ++mismatches;
+            }
+        }
+        return mismatches;
+    }
+
+    /**
+     * @brief 1つのモーションを評価して、値が違ったフレームの数を返す。読み込めなければ負
+     */
+    csmInt32 CheckMotion(CubismModel* cursorModel, CubismModel* searchModel, const std::string& path, csmUint32& random,
+                         double& cursorMilliseconds, double& searchMilliseconds)
+    {
+        CubismMotion* motion = LoadMotion(path);
+        if (motion == NULL)
+        {
+            return -1;
+        }
+
+        // 長さが0のモーションはループ再生できない（時刻を長さで割り戻せない）ため比べない
+        const csmFloat32 duration = motion->GetDuration();
+        if (duration <= 0.0f)
+        {
+            ACubismMotion::Delete(motion);
+            return 0;
+        }
+        motion->IsLoop(true);
+
+        CubismMotionQueueEntry cursorEntry;
+        cursorEntry.IsAvailable(true);
+
+        csmInt32 mismatchFrames = 0;
+        csmFloat32 time = 0.0f;
+        for (csmInt32 frame = 0; frame < FrameCount; ++frame)
+        {
+            time += NextRandom(random) * MaxDeltaTime;
+
+            // ときどき再生位置を前後に飛ばす。開始時刻をずらすとモーション内の時刻が変わる
+            if (cursorEntry.IsStarted() && NextRandom(random) * SeekInterval < 1.0f)
+            {
+                cursorEntry.SetStartTime(time - NextRandom(random) * duration);
+            }
+
+            // 毎フレーム新しいエントリに同じ再生状態を写す。新しいエントリはセグメントの位置を持たない
+            CubismMotionQueueEntry searchEntry;
+            searchEntry.IsAvailable(true);
+            searchEntry.IsStarted(cursorEntry.IsStarted());
+            searchEntry.SetStartTime(cursorEntry.GetStartTime());
+            searchEntry.SetFadeInStartTime(cursorEntry.GetFadeInStartTime());
+            searchEntry.SetEndTime(cursorEntry.GetEndTime());
+
+            cursorModel->LoadParameters();
+            searchModel->LoadParameters();
+
+            const double cursorStart = GetMilliseconds();
+            motion->UpdateParameters(cursorModel, &cursorEntry, time);
+            const double searchStart = GetMilliseconds();
+            motion->UpdateParameters(searchModel, &searchEntry, time);
+            const double end = GetMilliseconds();
+
+            cursorMilliseconds += searchStart - cursorStart;
+            searchMilliseconds += end - searchStart;
+
+            if (CountMismatches(cursorModel, searchModel) > 0)
+            {
+                ++mismatchFrames;
+            }
+        }
+
+        ACubismMotion::Delete(motion);
+        return mismatchFrames;
+    }
+
+    bool CheckModel(const std::string& settingPath)
+    {
+        csmSizeInt size;
+        csmByte* buffer = LAppPal::LoadFileAsBytes(settingPath, &size);
+        if (buffer == NULL)
+        {
+            fprintf(stderr, "failed to read: %s\n", settingPath.c_str());
+            return false;
+        }
+        CubismModelSettingJson setting(buffer, size);
+        LAppPal::ReleaseBytes(buffer);
+
+        const std::string directory = settingPath.substr(0, settingPath.find_last_of("/\\") + 1);
+
+        buffer = LAppPal::LoadFileAsBytes(directory + setting.GetModelFileName(), &size);
+        if (buffer == NULL)
+        {
+            fprintf(stderr, "failed to read: %s\n", setting.GetModelFileName());
+            return false;
+        }
+        CubismMoc* moc = CubismMoc::Create(buffer, size);
+        LAppPal::ReleaseBytes(buffer);
+        if (moc == NULL)
+        {
+            fprintf(stderr, "invalid moc: %s\n", setting.GetModelFileName());
+            return false;
+        }
+
+        CubismModel* cursorModel = moc->CreateModel();
+        CubismModel* searchModel = moc->CreateModel();
+        cursorModel->SaveParameters();
+        searchModel->SaveParameters();
+
+        bool passed = true;
+        csmUint32 random = 12345u;
+        csmInt32 motionCount = 0;
+        double cursorMilliseconds = 0.0;
+        double searchMilliseconds = 0.0;
+        for (csmInt32 i = 0; i < setting.GetMotionGroupCount(); ++i)
+        {
+            const csmChar* group = setting.GetMotionGroupName(i);
+            for (csmInt32 j = 0; j < setting.GetMotionCount(group); ++j)
+            {
+                // LAppModel と同じく、ファイルの無いモーションは飛ばす
+                if (strlen(setting.GetMotionFileName(group, j)) == 0)
+                {
+                    continue;
+                }
+
+                const std::string path = directory + setting.GetMotionFileName(group, j);
+                const csmInt32 mismatchFrames = CheckMotion(cursorModel, searchModel, path, random, cursorMilliseconds, searchMilliseconds);
+                if (mismatchFrames < 0)
+                {
+                    fprintf(stderr, "failed to load: %s\n", path.c_str());
+                    passed = false;
+                    continue;
+                }
+                if (mismatchFrames > 0)
+                {
+                    fprintf(stderr, "%d of %d frames differ: %s\n", mismatchFrames, FrameCount, path.c_str());
+                    passed = false;
+                }
+                ++motionCount;
+            }
+        }
+
+        printf("%s: %d motions, %d frames each, cursor %.3f ms, search %.3f ms\n",
+               settingPath.c_str(), motionCount, FrameCount, cursorMilliseconds, searchMilliseconds);
+
+        moc->DeleteModel(cursorModel);
+        moc->DeleteModel(searchModel);
+        CubismMoc::Delete(moc);
+        return passed;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        fprintf(stderr, "usage: %s <file.model3.json>...\n", argv[0]);
+        return 1;
+    }
+
+    CubismFramework::Option option;
+    option.LogFunction = LAppPal::PrintLn;
+    option.LoggingLevel = CubismFramework::Option::LogLevel_Warning;
+    CubismFramework::StartUp(&s_allocator, &option);
+    CubismFramework::Initialize();
+
+    int failed = 0;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (!CheckModel(argv[i]))
+        {
+            ++failed;
+        }
+    }
+
+    CubismFramework::Dispose();
+
+    return failed == 0 ? 0 : 1;
+}
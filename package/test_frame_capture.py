@@ -0,0 +1,99 @@
+# 测试异步读取画面
+# FrameCapture.Capture 只发起读取，不等待 GPU；Read 按顺序取出已完成的帧，一般晚一到两帧
+# 取出的 bytearray 可以用 numpy.frombuffer(data, numpy.uint8).reshape(height, width, 4) 零拷贝转换，行从下到上
+
+import os
+import time
+
+import glfw
+from OpenGL.GL import glClear, glClearColor, glFinish, GL_COLOR_BUFFER_BIT, glReadPixels, GL_RGBA, GL_UNSIGNED_BYTE
+
+import live2d.v3 as live2d
+import resources
+
+MODEL_PATH = os.path.join(resources.RESOURCES_DIRECTORY, "v3/Hiyori/Hiyori.model3.json")
+FRAMES = 120
+DT = 1 / 60
+WIDTH, HEIGHT = 1920, 1080
+
+
+def load_model():
+    model = live2d.LAppModel()
+    model.LoadModelJson(MODEL_PATH)
+    model.Resize(WIDTH, HEIGHT)
+    # 眨眼依赖随机数，关闭后两次运行的画面可以逐帧比较
+    model.SetAutoBlinkEnable(False)
+    model.StartMotion("Idle", 0, 3)
+    return model
+
+
+def render(model):
+    glClearColor(0, 0, 0, 0)
+    glClear(GL_COLOR_BUFFER_BIT)
+    model.Update(DT)
+    model.Draw()
+
+
+def run_sync(model, frames):
+    for _ in range(FRAMES):
+        render(model)
+        pixels = glReadPixels(0, 0, WIDTH, HEIGHT, GL_RGBA, GL_UNSIGNED_BYTE)
+        if frames is not None:
+            frames.append(pixels)
+
+
+def run_async(model, capture, frames):
+    for _ in range(FRAMES):
+        render(model)
+        capture.Capture(0, 0, WIDTH, HEIGHT)
+        frame = capture.Read()
+        while frame is not None:
+            # 没有其他引用的 bytearray 会被之后的 Read 复用，需要保留时复制
+            if frames is not None:
+                frames.append(bytes(frame[2]))
+            frame = capture.Read()
+    while capture.GetPendingCount() > 0:
+        frame = capture.Read(wait=True)
+        if frames is not None:
+            frames.append(bytes(frame[2]))
+
+
+if not glfw.init():
+    exit()
+
+glfw.window_hint(glfw.VISIBLE, glfw.FALSE)
+window = glfw.create_window(WIDTH, HEIGHT, "test context", None, None)
+if not window:
+    glfw.terminate()
+    exit()
+
+glfw.make_context_current(window)
+
+live2d.init()
+live2d.glewInit()
+live2d.setLogEnable(False)
+
+# 取出的帧应与同步读取的结果逐帧相同
+expected = []
+run_sync(load_model(), expected)
+frames = []
+run_async(load_model(), live2d.FrameCapture(), frames)
+assert frames == expected, "captured frames differ from glReadPixels"
+
+# 持续读取的帧率
+model = load_model()
+start = time.perf_counter()
+run_sync(model, None)
+glFinish()
+print(f"sync  {FRAMES / (time.perf_counter() - start):6.1f} fps")
+
+model = load_model()
+capture = live2d.FrameCapture(buffers=3)
+start = time.perf_counter()
+run_async(model, capture, None)
+print(f"async {FRAMES / (time.perf_counter() - start):6.1f} fps")
+print(capture.GetStats())
+
+glfw.terminate()
+
+live2d.dispose()
@@ -0,0 +1,57 @@
+# 测试无窗口渲染
+# HeadlessContext 用 EGL 创建不依赖显示服务器的 OpenGL 上下文（没有 GPU 时使用 Mesa llvmpipe），
+# 绘制到上下文自带的离屏帧缓冲，适合在服务器或 CI 中批量生成缩略图
+
+import os
+import time
+
+from PIL import Image
+
+import live2d.v3 as live2d
+import resources
+
+WIDTH, HEIGHT = 512, 512
+FRAMES = 60
+DT = 1 / 30
+OUTPUT_DIRECTORY = os.path.join(os.path.dirname(os.path.abspath(__file__)), "headless_output")
+
+live2d.init()
+live2d.setLogEnable(False)
+
+if not live2d.headlessSupported():
+    print("headless context is not supported on this platform")
+    exit()
+
+# 创建后上下文即为当前上下文，并已绑定离屏帧缓冲，不需要再调用 glewInit
+context = live2d.HeadlessContext(WIDTH, HEIGHT)
+
+os.makedirs(OUTPUT_DIRECTORY, exist_ok=True)
+
+models_directory = os.path.join(resources.RESOURCES_DIRECTORY, "v3")
+for name in sorted(os.listdir(models_directory)):
+    model_json = os.path.join(models_directory, name, name + ".model3.json")
+    if not os.path.exists(model_json):
+        continue
+
+    model = live2d.LAppModel()
+    model.LoadModelJson(model_json)
+    model.Resize(WIDTH, HEIGHT)
+
+    start = time.perf_counter()
+    for _ in range(FRAMES):
+        live2d.clearBuffer()
+        model.Update(DT)
+        model.Draw()
+    width, height, pixels = context.ReadPixels()
+    elapsed = time.perf_counter() - start
+
+    assert any(pixels[3::4]), f"{name}: nothing was drawn"
+
+    # 读取的行从下到上
+    image = Image.frombytes("RGBA", (width, height), bytes(pixels)).transpose(Image.Transpose.FLIP_TOP_BOTTOM)
+    image.save(os.path.join(OUTPUT_DIRECTORY, name + ".png"))
+    print(f"{name:8s} {FRAMES / elapsed:6.1f} fps")
+
+context.Release()
+
+live2d.dispose()
@@ -0,0 +1,80 @@
+# 测试流水线更新
+# SetPipelined(True) 后 Update 在模型自己的工作线程中计算下一帧，Draw 绘制上一帧的结果
+# 显示延迟一帧，参数与普通模式一致
+
+import os
+import time
+
+import glfw
+from OpenGL.GL import glClear, glClearColor, glFinish, GL_COLOR_BUFFER_BIT, glReadPixels, GL_RGBA, GL_UNSIGNED_BYTE
+
+import live2d.v3 as live2d
+import resources
+
+MODEL_PATH = os.path.join(resources.RESOURCES_DIRECTORY, "v3/Haru/Haru.model3.json")
+FRAMES = 120
+DT = 1 / 60
+WIDTH, HEIGHT = 300, 300
+
+
+def load_model(pipelined):
+    model = live2d.LAppModel()
+    model.LoadModelJson(MODEL_PATH)
+    model.Resize(WIDTH, HEIGHT)
+    # 眨眼依赖随机数，关闭后两个模型的结果可以逐帧比较
+    model.SetAutoBlinkEnable(False)
+    model.StartMotion("Idle", 0, 3)
+    model.SetPipelined(pipelined)
+    return model
+
+
+def render(model):
+    glClearColor(0, 0, 0, 0)
+    glClear(GL_COLOR_BUFFER_BIT)
+    model.Update(DT)
+    model.Draw()
+    return glReadPixels(0, 0, WIDTH, HEIGHT, GL_RGBA, GL_UNSIGNED_BYTE)
+
+
+if not glfw.init():
+    exit()
+
+glfw.window_hint(glfw.VISIBLE, glfw.FALSE)
+window = glfw.create_window(WIDTH, HEIGHT, "test context", None, None)
+if not window:
+    glfw.terminate()
+    exit()
+
+glfw.make_context_current(window)
+
+live2d.init()
+live2d.glewInit()
+live2d.setLogEnable(False)
+
+serial = load_model(False)
+pipelined = load_model(True)
+
+# 流水线模式第 N+1 帧的画面应与普通模式第 N 帧相同
+expected = [render(serial) for _ in range(FRAMES)]
+frames = [render(pipelined) for _ in range(FRAMES)]
+for i in range(FRAMES - 1):
+    assert frames[i + 1] == expected[i], f"frame {i + 1} is not exactly one frame behind"
+
+# 读取参数时会等待后台更新结束，结果与普通模式一致
+params = [pipelined.GetParameter(i).value for i in range(pipelined.GetParameterCount())]
+assert params == [serial.GetParameter(i).value for i in range(serial.GetParameterCount())]
+
+# 每帧耗时
+for model, name in ((serial, "serial"), (pipelined, "pipelined")):
+    start = time.perf_counter()
+    for _ in range(FRAMES):
+        model.Update(DT)
+        model.Draw()
+        glFinish()
+    print(f"{name:9s} {(time.perf_counter() - start) * 1000 / FRAMES:6.2f} ms/frame")
+
+pipelined.SetPipelined(False)
+
+glfw.terminate()
+
+live2d.dispose()
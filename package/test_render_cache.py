@@ -0,0 +1,112 @@
+# 测试绘制结果缓存
+# SetRenderCacheEnable(True) 后，参数、部件透明度、颜色、位置和缩放都没有变化时 Draw 只合成上一次绘制的结果
+# 缓存经过一次 8 位纹理，与直接绘制相比每个通道可能有 1~2 的舍入误差
+# 含正片叠底混合部件的模型（Mao）不使用缓存，结果与直接绘制完全相同
+
+import os
+import time
+
+import glfw
+from OpenGL.GL import glClear, glClearColor, glFinish, GL_COLOR_BUFFER_BIT, glReadPixels, GL_RGBA, GL_UNSIGNED_BYTE
+
+import live2d.v3 as live2d
+import resources
+
+MODEL_PATH = os.path.join(resources.RESOURCES_DIRECTORY, "v3/Haru/Haru.model3.json")
+MULTIPLY_MODEL_PATH = os.path.join(resources.RESOURCES_DIRECTORY, "v3/Mao/Mao.model3.json")
+FRAMES = 120
+DT = 1 / 60
+WIDTH, HEIGHT = 300, 300
+
+
+def load_model(cached, path=MODEL_PATH):
+    model = live2d.LAppModel()
+    model.LoadModelJson(path)
+    model.Resize(WIDTH, HEIGHT)
+    # 关闭眨眼和呼吸，没有动作时模型保持静止
+    model.SetAutoBlinkEnable(False)
+    model.SetAutoBreathEnable(False)
+    model.SetRenderCacheEnable(cached)
+    return model
+
+
+def render(model):
+    glClearColor(0.2, 0.3, 0.4, 1)
+    glClear(GL_COLOR_BUFFER_BIT)
+    model.Draw()
+    return glReadPixels(0, 0, WIDTH, HEIGHT, GL_RGBA, GL_UNSIGNED_BYTE)
+
+
+def max_difference(a, b):
+    return max(abs(x - y) for x, y in zip(a, b))
+
+
+def check(what, expect_hit, change):
+    change(direct)
+    change(cached)
+    before = cached.GetRenderCacheStats()
+    image = render(cached)
+    after = cached.GetRenderCacheStats()
+    hit = after["hits"] > before["hits"]
+    difference = max_difference(image, render(direct))
+    print(f"{what:20s} {'hit' if hit else 'miss':4s} max difference {difference}")
+    assert hit == expect_hit, f"{what}: expected {'hit' if expect_hit else 'miss'}"
+    assert difference <= 3, f"{what}: cached image differs"
+
+
+if not glfw.init():
+    exit()
+
+glfw.window_hint(glfw.VISIBLE, glfw.FALSE)
+window = glfw.create_window(WIDTH, HEIGHT, "test context", None, None)
+if not window:
+    glfw.terminate()
+    exit()
+
+glfw.make_context_current(window)
+
+live2d.init()
+live2d.glewInit()
+live2d.setLogEnable(False)
+
+direct = load_model(False)
+cached = load_model(True)
+
+check("first draw", False, lambda m: None)
+check("unchanged", True, lambda m: None)
+check("SetParameterValue", False, lambda m: m.SetParameterValue("ParamAngleX", 20, 1))
+check("unchanged", True, lambda m: None)
+check("SetOffset", False, lambda m: m.SetOffset(0.1, 0))
+check("SetScale", False, lambda m: m.SetScale(0.8))
+check("SetPartOpacity", False, lambda m: m.SetPartOpacity(3, 0.3))
+check("SetPartMultiplyColor", False, lambda m: m.SetPartMultiplyColor(5, 1, 0.2, 0.2, 1))
+check("unchanged", True, lambda m: None)
+check("motion", False, lambda m: (m.StartMotion("Idle", 0, 3), m.Update(DT)))
+check("InvalidateRenderCache", False, lambda m: m.InvalidateRenderCache())
+
+# 正片叠底的部件需要与画面混合，开启缓存也每次直接绘制
+multiply_direct = load_model(False, MULTIPLY_MODEL_PATH)
+multiply_cached = load_model(True, MULTIPLY_MODEL_PATH)
+render(multiply_cached)
+difference = max_difference(render(multiply_cached), render(multiply_direct))
+stats = multiply_cached.GetRenderCacheStats()
+print(f"{'multiply blend':20s} {stats} max difference {difference}")
+assert not stats["enabled"] and stats["hits"] == 0, "multiply blend: cache should be bypassed"
+assert difference == 0, "multiply blend: image differs"
+
+# 静止时每帧耗时和命中率
+for model in (direct, cached):
+    model.StopAllMotions()
+    model.Update(DT)
+    render(model)
+    start = time.perf_counter()
+    for _ in range(FRAMES):
+        render(model)
+        glFinish()
+    name = "cached" if model is cached else "direct"
+    print(f"{name:7s} {(time.perf_counter() - start) * 1000 / FRAMES:6.2f} ms/frame")
+print(cached.GetRenderCacheStats())
+
+glfw.terminate()
+
+live2d.dispose()
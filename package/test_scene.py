@@ -0,0 +1,150 @@
+# 测试 Scene
+# Update 在线程池中并行更新所有模型，Draw 在当前线程按加入顺序绘制，结果与逐个调用模型的 Update / Draw 一致
+# Update / Draw / Frame 期间，模型回调中再调用场景的方法会抛出 RuntimeError，而不是死锁
+
+import os
+import threading as t
+
+import glfw
+from OpenGL.GL import glClear, glClearColor, GL_COLOR_BUFFER_BIT, glReadPixels, GL_RGBA, GL_UNSIGNED_BYTE
+
+import live2d.v3 as live2d
+import resources
+
+MODEL_NAMES = ["Haru/Haru", "Hiyori/Hiyori", "Mao/Mao"]
+FRAMES = 120
+DT = 1 / 60
+WIDTH, HEIGHT = 300, 300
+
+
+def load_model(name):
+    model = live2d.LAppModel()
+    model.LoadModelJson(os.path.join(resources.RESOURCES_DIRECTORY, f"v3/{name}.model3.json"))
+    model.Resize(WIDTH, HEIGHT)
+    # 眨眼依赖随机数，关闭后场景中的模型与单独更新的模型可以逐帧比较
+    model.SetAutoBlinkEnable(False)
+    model.StartMotion("Idle", 0, 3)
+    return model
+
+
+def snapshot(model):
+    return [model.GetParameter(i).value for i in range(model.GetParameterCount())]
+
+
+def clear():
+    glClearColor(0, 0, 0, 0)
+    glClear(GL_COLOR_BUFFER_BIT)
+
+
+def read():
+    return glReadPixels(0, 0, WIDTH, HEIGHT, GL_RGBA, GL_UNSIGNED_BYTE)
+
+
+if not glfw.init():
+    exit()
+
+glfw.window_hint(glfw.VISIBLE, glfw.FALSE)
+window = glfw.create_window(WIDTH, HEIGHT, "test context", None, None)
+if not window:
+    glfw.terminate()
+    exit()
+
+glfw.make_context_current(window)
+
+live2d.init()
+live2d.glewInit()
+live2d.setLogEnable(False)
+
+scene = live2d.Scene()
+models = [load_model(name) for name in MODEL_NAMES]
+for m in models:
+    scene.AddModel(m)
+assert scene.GetModelCount() == len(models)
+
+# 单独更新、绘制的模型作为基准
+references = [load_model(name) for name in MODEL_NAMES]
+
+for i in range(FRAMES):
+    clear()
+    # Frame 等同于 Update 后 Draw，两种写法交替使用
+    if i % 2 == 0:
+        scene.Frame(DT)
+    else:
+        scene.Update(DT)
+        scene.Draw()
+    frame = read()
+
+    clear()
+    for r in references:
+        r.Update(DT)
+        r.Draw()
+    assert frame == read(), f"frame {i} differs from drawing the models one by one"
+
+for m, r in zip(models, references):
+    assert snapshot(m) == snapshot(r), "scene update diverged from updating the model alone"
+
+timings = scene.GetTimings()
+print(timings)
+assert timings["threads"] >= 1
+assert len(timings["models"]) == len(models)
+assert min(timings["update"], timings["updateTotal"], timings["draw"], *timings["models"]) >= 0
+
+# 回调可能在工作线程中执行，场景的方法在其中都会抛出 RuntimeError
+errors = []
+
+
+def on_finish():
+    for call in (scene.GetModelCount, lambda: scene.Update(DT), scene.Draw, scene.GetTimings):
+        try:
+            call()
+            errors.append(None)
+        except RuntimeError:
+            errors.append(t.current_thread().name)
+
+
+models[0].StartMotion("TapBody", 0, 3, onFinishMotionHandler=on_finish)
+for _ in range(30):
+    scene.Update(1.0)
+    if errors:
+        break
+assert len(errors) == 4 and None not in errors, f"scene call from a callback did not raise: {errors}"
+
+# 回调之外可以继续使用场景
+scene.Frame(DT)
+assert scene.GetModelCount() == len(models)
+
+# 其他线程同时调用场景的方法会等待，而不是抛出异常
+counts = []
+
+
+def count_models():
+    for _ in range(50):
+        counts.append(scene.GetModelCount())
+
+
+thread = t.Thread(target=count_models)
+thread.start()
+for _ in range(20):
+    scene.Update(DT)
+thread.join()
+assert counts == [len(models)] * 50, "scene call from another thread failed"
+
+try:
+    scene.Update(-1)
+    assert False, "negative delta time accepted"
+except ValueError:
+    pass
+
+try:
+    scene.AddModel(1)
+    assert False, "non-model accepted"
+except TypeError:
+    pass
+
+assert scene.RemoveModel(models[0])
+assert not scene.RemoveModel(models[0])
+assert scene.GetModelCount() == len(models) - 1
+
+glfw.terminate()
+
+live2d.dispose()
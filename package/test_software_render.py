@@ -0,0 +1,91 @@
+# 测试 CPU 绘制
+# DrawSoftware(width, height) 不使用 OpenGL，用与 Draw 相同的矩阵把模型画到 bytearray 中（RGBA，行从上到下）
+# 与 OpenGL 绘制的结果比较：三角形边缘的覆盖和纹理采样的舍入不同，只允许极少数像素有较大差异
+
+import os
+import time
+
+import glfw
+from OpenGL.GL import glClear, glClearColor, glFinish, GL_COLOR_BUFFER_BIT, glReadPixels, GL_RGBA, GL_UNSIGNED_BYTE
+
+import live2d.v3 as live2d
+import resources
+
+MODELS = ["Haru/Haru.model3.json", "Mao/Mao.model3.json", "Rice/Rice.model3.json"]
+FRAMES = 30
+DT = 1 / 30
+WIDTH, HEIGHT = 400, 400
+
+
+def draw_gl(model):
+    glClearColor(0, 0, 0, 0)
+    glClear(GL_COLOR_BUFFER_BIT)
+    model.Draw()
+    # glReadPixels 的行从下到上
+    pixels = glReadPixels(0, 0, WIDTH, HEIGHT, GL_RGBA, GL_UNSIGNED_BYTE)
+    row = WIDTH * 4
+    return b"".join(pixels[y * row:(y + 1) * row] for y in reversed(range(HEIGHT)))
+
+
+def compare(a, b):
+    # 每个像素取 RGBA 中最大的差
+    total = 0
+    large = 0
+    for i in range(0, len(a), 4):
+        d = max(abs(a[i + c] - b[i + c]) for c in range(4))
+        total += d
+        if d > 16:
+            large += 1
+    pixels = len(a) // 4
+    return total / pixels, large / pixels
+
+
+if not glfw.init():
+    exit()
+
+glfw.window_hint(glfw.VISIBLE, glfw.FALSE)
+window = glfw.create_window(WIDTH, HEIGHT, "test context", None, None)
+if not window:
+    glfw.terminate()
+    exit()
+
+glfw.make_context_current(window)
+
+live2d.init()
+live2d.glewInit()
+live2d.setLogEnable(False)
+
+for name in MODELS:
+    model = live2d.LAppModel()
+    model.LoadModelJson(os.path.join(resources.RESOURCES_DIRECTORY, "v3", name))
+    model.Resize(WIDTH, HEIGHT)
+    model.SetAutoBlinkEnable(False)
+    model.StartMotion("Idle", 0, 3)
+
+    worst_mean, worst_large = 0, 0
+    gl_time, software_time = 0, 0
+    for _ in range(FRAMES):
+        model.Update(DT)
+
+        start = time.perf_counter()
+        gl = draw_gl(model)
+        glFinish()
+        gl_time += time.perf_counter() - start
+
+        start = time.perf_counter()
+        software = model.DrawSoftware(WIDTH, HEIGHT)
+        software_time += time.perf_counter() - start
+
+        mean, large = compare(gl, software)
+        worst_mean = max(worst_mean, mean)
+        worst_large = max(worst_large, large)
+
+    print(f"{name:24s} mean difference {worst_mean:.3f}, pixels differing by more than 16: {worst_large * 100:.3f}%"
+          f"  gl {gl_time * 1000 / FRAMES:.1f} ms, software {software_time * 1000 / FRAMES:.1f} ms")
+    assert any(software[3::4]), f"{name}: nothing was drawn"
+    assert worst_mean < 0.5, f"{name}: software rendering differs from OpenGL"
+    assert worst_large < 0.001, f"{name}: software rendering differs from OpenGL"
+
+glfw.terminate()
+
+live2d.dispose()
@@ -0,0 +1,98 @@
+# 测试多线程更新
+# Update / Draw 执行期间会释放 GIL，不同模型可以在各自的线程中同时更新
+# 同一模型的调用会被串行化
+
+import os
+import threading as t
+import time
+
+import glfw
+
+import live2d.v3 as live2d
+import resources
+
+MODEL_PATH = os.path.join(resources.RESOURCES_DIRECTORY, "v3/Haru/Haru.model3.json")
+FRAMES = 600
+DT = 1 / 60
+
+
+finished = []
+
+
+def load_model():
+    model = live2d.LAppModel()
+    model.LoadModelJson(MODEL_PATH)
+    # 自动眨眼的间隔是随机的，关闭后各模型的参数才能逐帧比较
+    model.SetAutoBlinkEnable(False)
+    # 动作结束回调在更新线程中重新获取 GIL 后执行
+    model.StartMotion("Idle", 0, 3, onFinishMotionHandler=lambda: finished.append(model))
+    return model
+
+
+def step(model, frames):
+    for _ in range(frames):
+        model.Update(DT)
+
+
+def snapshot(model):
+    return [model.GetParameter(i).value for i in range(model.GetParameterCount())]
+
+
+if not glfw.init():
+    exit()
+
+glfw.window_hint(glfw.VISIBLE, glfw.FALSE)
+window = glfw.create_window(200, 200, "test context", None, None)
+if not window:
+    glfw.terminate()
+    exit()
+
+glfw.make_context_current(window)
+
+live2d.init()
+live2d.glewInit()
+live2d.setLogEnable(False)
+
+cores = os.cpu_count() or 1
+models = [load_model() for _ in range(cores + 1)]
+
+# 单线程更新的结果作为基准
+step(models[0], FRAMES)
+expected = snapshot(models[0])
+
+# 多线程同时更新不同模型，结果应与单线程一致
+threads = [t.Thread(target=step, args=(m, FRAMES)) for m in models[1:]]
+for i in threads:
+    i.start()
+for i in threads:
+    i.join()
+
+for m in models[1:]:
+    assert snapshot(m) == expected, "threaded update diverged from single-threaded update"
+    assert finished.count(m) == finished.count(models[0]), "motion callback missing"
+
+# 多个线程同时更新同一模型不会崩溃
+shared = models[0]
+threads = [t.Thread(target=step, args=(shared, 100)) for _ in range(4)]
+for i in threads:
+    i.start()
+for i in threads:
+    i.join()
+
+# 1 到 N 个线程的扩展性
+print("threads  updates/s  speedup")
+base = None
+for n in range(1, cores + 1):
+    threads = [t.Thread(target=step, args=(models[i + 1], FRAMES)) for i in range(n)]
+    start = time.perf_counter()
+    for i in threads:
+        i.start()
+    for i in threads:
+        i.join()
+    rate = n * FRAMES / (time.perf_counter() - start)
+    base = base or rate
+    print(f"{n:7d}  {rate:9.0f}  {rate / base:6.2f}x")
+
+glfw.terminate()
+
+live2d.dispose()